@@ -24,6 +24,7 @@ set(AGG_FILES
 
 set(DOCUMENT_FILES
     ${LOMSE_SRC_DIR}/document/lomse_command.cpp
+    ${LOMSE_SRC_DIR}/document/lomse_command_journal.cpp
     ${LOMSE_SRC_DIR}/document/lomse_document.cpp
     ${LOMSE_SRC_DIR}/document/lomse_document_cursor.cpp
     ${LOMSE_SRC_DIR}/document/lomse_document_iterator.cpp
@@ -67,6 +68,7 @@ set(GRAPHIC_MODEL_FILES
     ${LOMSE_SRC_DIR}/graphic_model/lomse_shape_tuplet.cpp
     ${LOMSE_SRC_DIR}/graphic_model/lomse_shape_volta_bracket.cpp
     ${LOMSE_SRC_DIR}/graphic_model/lomse_shapes.cpp
+    ${LOMSE_SRC_DIR}/graphic_model/lomse_shapes_grid.cpp
     ${LOMSE_SRC_DIR}/graphic_model/lomse_shapes_storage.cpp
     ${LOMSE_SRC_DIR}/graphic_model/lomse_sizers.cpp
     ${LOMSE_SRC_DIR}/graphic_model/lomse_tempo_line.cpp
@@ -133,6 +135,7 @@ set(INTERNAL_MODEL_FILES
     ${LOMSE_SRC_DIR}/internal_model/lomse_im_note.cpp
     ${LOMSE_SRC_DIR}/internal_model/lomse_internal_model.cpp
     ${LOMSE_SRC_DIR}/internal_model/lomse_measures_table.cpp
+    ${LOMSE_SRC_DIR}/internal_model/lomse_model_arena.cpp
     ${LOMSE_SRC_DIR}/internal_model/lomse_model_builder.cpp
     ${LOMSE_SRC_DIR}/internal_model/lomse_score_algorithms.cpp
     ${LOMSE_SRC_DIR}/internal_model/lomse_score_utilities.cpp
@@ -191,6 +194,7 @@ set(RENDER_FILES
     ${LOMSE_SRC_DIR}/render/lomse_font_storage.cpp
     ${LOMSE_SRC_DIR}/render/lomse_renderer.cpp
     ${LOMSE_SRC_DIR}/render/lomse_screen_drawer.cpp
+    ${LOMSE_SRC_DIR}/render/lomse_tiles_cache.cpp
 )
 
 set(SCORE_FILES
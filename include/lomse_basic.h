@@ -263,8 +263,15 @@ struct Rectangle
     }
 
 
-//    // return true if the rectangles have a non empty intersection
-//    bool intersects(const Rectangle& rect) const;
+    // return true if the rectangles have a non empty intersection. Borders are
+    // included so that degenerated rectangles (i.e. a horizontal line) also intersect
+    bool intersects(const Rectangle& rect) const
+    {
+        return x <= rect.x + rect.width
+               && rect.x <= x + width
+               && y <= rect.y + rect.height
+               && rect.y <= y + height;
+    }
 };
 
 //---------------------------------------------------------------------------------------
@@ -58,11 +58,11 @@ class FontStorage;
 class Calligrapher
 {
 protected:
-    FontStorage* m_pFonts;
+    LibraryScope& m_libraryScope;
     Renderer* m_pRenderer;
 
 public:
-    Calligrapher(FontStorage* fonts, Renderer* renderer);
+    Calligrapher(LibraryScope& libraryScope, Renderer* renderer);
     ~Calligrapher();
 
     int draw_text(double x, double y, const std::string& str, Color color,
@@ -84,7 +84,7 @@ protected:
 class TextMeter
 {
 protected:
-    FontStorage* m_pFonts;
+    LibraryScope& m_libraryScope;
     double m_scale;
 
 public:
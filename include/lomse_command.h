@@ -202,10 +202,11 @@ public:
 
 protected:
     void create_checkpoint(Document* pDoc);
+    void set_checkpoint_target(ImoInstrument* pInstr);
     void log_forensic_data(Document* pDoc, DocCursor* pCursor);
     void set_command_name(const string& name, ImoObj* pImo);
     int validate_source(const string& source);
-    virtual void log_command(ofstream &logger);
+    virtual void log_command(ostream &logger);
 
 };
 
@@ -424,7 +425,7 @@ public:
 
 protected:
     void update_selection(SelectionSet* pSelection);
-    void log_command(ofstream &logger);
+    void log_command(ostream &logger);
 
 };
 
@@ -535,7 +536,7 @@ protected:
 
     //overrides and mandatory virtual methods
     void set_command_name();
-    void log_command(ofstream &logger);
+    void log_command(ostream &logger);
 
 };
 
@@ -593,7 +594,7 @@ public:
     ///@endcond
 
 protected:
-    void log_command(ofstream &logger);
+    void log_command(ostream &logger);
 };
 
 //---------------------------------------------------------------------------------------
@@ -661,7 +662,7 @@ public:
     ///@endcond
 
 protected:
-    void log_command(ofstream &logger);
+    void log_command(ostream &logger);
 };
 
 //---------------------------------------------------------------------------------------
@@ -718,7 +719,7 @@ public:
     ///@endcond
 
 protected:
-    void log_command(ofstream &logger);
+    void log_command(ostream &logger);
 };
 
 //---------------------------------------------------------------------------------------
@@ -776,7 +777,7 @@ public:
     ///@endcond
 
 protected:
-    void log_command(ofstream &logger);
+    void log_command(ostream &logger);
 };
 
 //---------------------------------------------------------------------------------------
@@ -1835,7 +1836,7 @@ public:
     ///@endcond
 
 protected:
-    void log_command(ofstream &logger);
+    void log_command(ostream &logger);
 };
 
 //---------------------------------------------------------------------------------------
@@ -0,0 +1,104 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the Lomse library.
+// Lomse is copyrighted work (c) 2010-2016. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice, this
+//      list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright notice, this
+//      list of conditions and the following disclaimer in the documentation and/or
+//      other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+// TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+// BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+// ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+// For any comment, suggestion or feature request, please contact the manager of
+// the project at cecilios@users.sourceforge.net
+//---------------------------------------------------------------------------------------
+
+#ifndef __LOMSE_COMMAND_JOURNAL_H__
+#define __LOMSE_COMMAND_JOURNAL_H__
+
+#include "lomse_build_options.h"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <string>
+#include <vector>
+using namespace std;
+
+namespace lomse
+{
+
+//---------------------------------------------------------------------------------------
+typedef std::thread JournalThread;
+typedef std::mutex JournalMutex;
+typedef std::unique_lock<std::mutex> JournalLock;
+
+
+//=======================================================================================
+// CommandJournal
+//  Journal of executed and undone edition commands, for forensic analysis of
+//  editing problems. It is optional and is maintained in Lomse LibraryScope object.
+//  Records are enqueued by the thread executing the commands and are written to
+//  the journal file by a dedicated thread. When a maximum number of records is
+//  specified, only the most recent records are retained in memory (ring buffer)
+//  and the file is rewritten with them. Otherwise, records are only appended to
+//  the file and are not retained. A journal without file is always a ring buffer,
+//  with k_default_max_records when no maximum is specified.
+//=======================================================================================
+class CommandJournal
+{
+protected:
+    string m_filename;              //empty: do not write records to file
+    size_t m_maxRecords;            //0: no records retained in memory
+    JournalThread* m_pThread;       //writer thread
+    JournalMutex m_mutex;           //to control access to records
+    std::condition_variable m_queueFlag;    //signaled when new records or stop
+    std::condition_variable m_flushedFlag;  //signaled when pending records written
+    bool m_fStop;
+    bool m_fWriting;                //writer thread is saving a batch
+    bool m_fTruncate;               //next write must create a new file
+    deque<string> m_pending;        //records not yet written
+    deque<string> m_records;        //retained records
+
+public:
+    enum { k_default_max_records = 1000 };
+
+    CommandJournal(const string& filename, size_t maxRecords=0);
+    ~CommandJournal();
+
+    void add_record(const string& record);
+    void flush();
+    void clear();
+
+    //access to retained records. Oldest first. Empty when not in ring buffer mode
+    vector<string> get_records();
+    inline const string& get_filename() const { return m_filename; }
+    inline size_t get_max_records() const { return m_maxRecords; }
+
+protected:
+    void start_writer();
+    void stop_writer();
+    void thread_main();
+    void write_records(deque<string>& batch, bool fRewrite);
+
+};
+
+
+}   //namespace lomse
+
+#endif      //__LOMSE_COMMAND_JOURNAL_H__
@@ -155,6 +155,8 @@ protected:
     int             m_modified;
     int             m_beatType;
     TimeUnits       m_beatDuration;
+    unsigned        m_stylesEpoch;      //incremented when any style is modified
+    unsigned        m_dirtyEpoch;       //incremented when dirty flags in imos are cleared
 
 public:
     /// Constructor
@@ -559,6 +561,11 @@ public:
     /** Returns the scope object associated to the library.  */
     inline LibraryScope& get_library_scope() { return m_libraryScope; }
 
+    /** Returns the arena in which the internal model objects are allocated or
+        @nullptr when they are allocated in the heap.
+        See LibraryScope::set_use_model_arena().  */
+    inline ModelArena* get_model_arena() { return m_docScope.model_arena(); }
+
     /** Returns a shared pointer for this %Document. */
     inline std::shared_ptr<Document> get_shared_ptr_from_this() { return shared_from_this(); }
 
@@ -643,6 +650,12 @@ public:
 
     inline void clear_dirty() { m_flags &= ~k_dirty; }
 
+    //dirty flags in the internal model objects. They are cleared after laying out the
+    //document, so that next layout can know which objects have been modified. The
+    //epoch allows a graphic model to know if the flags were cleared by other layout
+    void clear_dirty_objects();
+    inline unsigned get_dirty_epoch() const { return m_dirtyEpoch; }
+
         //events
     /** Mandatory override from Observable. Returns the EventNotifier associated to
         this Observable object. For %Document class the EventNotifier is itself, so
@@ -656,6 +669,11 @@ public:
     //internal model and ID management
     void on_removed_from_model(ImoObj* pImo);
 
+    //styles epoch. Any change in any style of the document invalidates all cached
+    //resolved style values
+    inline void invalidate_resolved_styles() { ++m_stylesEpoch; }
+    inline unsigned get_styles_epoch() const { return m_stylesEpoch; }
+
     //undo/redo support
     int from_checkpoint(const string& data);
     int replace_object_from_checkpoint_data(ImoId id, const string& data);
@@ -684,6 +702,9 @@ protected:
     void initialize();
     Compiler* get_compiler_for_format(int format);
     void fix_malformed_musicxml();
+    string get_checkpoint_data_for(ImoMusicData* pMD);
+    int replace_music_data_from_checkpoint_data(ImoMusicData* pMD, const string& data);
+    void clear_dirty_objects(ImoObj* pImo);
 
     friend class ImFactory;
     void assign_id(ImoObj* pImo);
@@ -445,9 +445,6 @@ public:
     inline void post_event(SpEventInfo pEvent) { m_pFunc_notify(m_pObj_notify, pEvent); }
     inline void post_request(Request* pRequest) { m_pFunc_request(m_pObj_request, pRequest); }
 
-protected:
-    void clear_forensic_log();
-
 ///@endcond
 };
 
@@ -124,6 +124,11 @@ struct RenderOptions
     bool read_only_mode;
     int highlighted_voice;          //0 for none
 
+    //viewport culling. When cull_flag is true, boxes and shapes not intersecting
+    //cull_rect (page coordinates) are not drawn
+    bool cull_flag;
+    URect cull_rect;
+
 
     RenderOptions()
         : draw_anchor_objects(false)
@@ -146,6 +151,8 @@ struct RenderOptions
         , draw_voices_coloured(false)
         , read_only_mode(true)
         , highlighted_voice(0)                  //0=none, 1..n= voice 1..n
+        , cull_flag(false)
+        , cull_rect(0.0f, 0.0f, 0.0f, 0.0f)
     {
         boxes.reset();
 
@@ -252,7 +259,6 @@ class Drawer
 {
 protected:
     LibraryScope& m_libraryScope;
-    FontStorage* m_pFonts;
     Color m_textColor;
 
 public:
@@ -1139,6 +1139,7 @@ public:
         m_items.push_back( make_pair(k_move_tempo_line, -1) );
         m_timepos = timepos;
     }
+    bool coalesce(EventVisualTracking* pNext);
 ///@endcond
 };
 
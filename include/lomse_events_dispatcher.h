@@ -36,13 +36,15 @@
 
 #include <thread>
 #include <mutex>
-#include <queue>
+#include <condition_variable>
+#include <deque>
 using namespace std;
 
 namespace lomse
 {
 
 //forward declarations
+class LomseDoorway;
 
 
 //---------------------------------------------------------------------------------------
@@ -55,30 +57,53 @@ typedef std::unique_lock<std::mutex> QueueLock;
 //=======================================================================================
 // EventsDispatcher
 //  Class to manage the event-dispatch loop.
-//  This class is a singleton maintained in Lomse LibraryScope object
+//  This class is a singleton maintained in Lomse LibraryScope object.
+//
+//  By default events are delivered synchronously, in the thread that posts them.
+//  When the events thread is enabled (LibraryScope::set_async_events_dispatch())
+//  events are enqueued and delivered, in batches, by a dedicated thread that sleeps
+//  on a condition variable while the queue is empty. Consecutive visual tracking
+//  events for the same Interactor that are still pending are coalesced into a single
+//  event, so that a slow application never stalls the ScorePlayer.
 class EventsDispatcher
 {
 protected:
+    //an enqueued event. When pObserver is nullptr the event is for the user
+    //application and it is delivered through the LomseDoorway callback
+    struct QueuedEvent
+    {
+        SpEventInfo pEvent;
+        Observer* pObserver;
+
+        QueuedEvent(SpEventInfo event, Observer* observer)
+            : pEvent(event), pObserver(observer) {}
+    };
+
+    LomseDoorway* m_pDoorway;       //for events to user application
     EventsThread* m_pThread;        //execution thread
     QueueMutex m_mutex;             //to control queue access
+    std::condition_variable m_queueFlag;    //signaled when queue changes or stop
     bool m_fStopLoop;
-    queue< pair<SpEventInfo, Observer*> > m_events;
+    deque<QueuedEvent> m_events;
 
 public:
-    EventsDispatcher();
+    EventsDispatcher(LomseDoorway* pDoorway=nullptr);
     ~EventsDispatcher();
 
     void start_events_loop();
     void stop_events_loop();
+    inline bool is_events_loop_running() { return m_pThread != nullptr; }
 
     void post_event(Observer* pObserver, SpEventInfo pEvent);
+    void post_event(SpEventInfo pEvent);
 
 protected:
-    inline bool stop_event_received() { return m_fStopLoop; }
+    void enqueue(SpEventInfo pEvent, Observer* pObserver);
+    void deliver(SpEventInfo pEvent, Observer* pObserver);
+    bool coalesce_with_last(SpEventInfo pEvent, Observer* pObserver);
     void run_events_loop();
     void thread_main();
-    inline bool pending_events() { return !m_events.empty(); }
-    void dispatch_next_event();
+    void dispatch_pending_events(deque<QueuedEvent>& batch);
 
 };
 
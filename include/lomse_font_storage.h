@@ -45,6 +45,9 @@
 #include "lomse_agg_types.h"
 #include "lomse_injectors.h"
 #include <string>
+#include <map>
+#include <unordered_map>
+#include <mutex>
 using namespace std;
 
 using namespace agg;
@@ -64,7 +67,54 @@ typedef lomse::font_cache_manager<FontEngine>::gray8_adaptor_type   Gray8Adaptor
 typedef lomse::font_cache_manager<FontEngine>::gray8_scanline_type  Gary8Scanline;
 
 
+//---------------------------------------------------------------------------------------
+// GlyphMetrics: the information about a glyph that is needed for measuring text
+struct GlyphMetrics
+{
+    double      advance_x;
+    double      advance_y;
+    agg::rect_i bounds;
+};
+
+//---------------------------------------------------------------------------------------
+// GlyphMetricsTable: metrics for the glyphs of a font, for a given size and transform.
+// Entries are never modified once added, so they can be shared by all threads.
+// It is only accessed when a thread does not find a glyph in its own copy of the
+// table (see FontStorage::get_glyph_metrics()), so the lock is rarely taken.
+class GlyphMetricsTable
+{
+protected:
+    std::mutex m_mutex;
+    std::unordered_map<unsigned int, GlyphMetrics> m_glyphs;
+
+public:
+    GlyphMetricsTable() {}
+    ~GlyphMetricsTable() {}
+
+    bool find(unsigned int nChar, GlyphMetrics* pMetrics);
+    void add(unsigned int nChar, const GlyphMetrics& metrics);
+};
+
+//---------------------------------------------------------------------------------------
+// GlyphMetricsStore: glyph metrics shared by all FontStorage objects of a LibraryScope.
+// Tables are indexed by font signature (font file, size, resolution, transform...)
+// and live as long as the store, so pointers to them are stable.
+class GlyphMetricsStore
+{
+protected:
+    std::mutex m_mutex;
+    std::map<std::string, GlyphMetricsTable*> m_tables;
+
+public:
+    GlyphMetricsStore() {}
+    ~GlyphMetricsStore();
+
+    GlyphMetricsTable* get_table(const char* fontSignature);
+};
+
+
 // FontStorage: Provides fonts and glyphs
+// A FontStorage is not thread safe: LibraryScope creates one for each thread.
 //---------------------------------------------------------------------------------------
 class FontStorage
 {
@@ -72,6 +122,14 @@ protected:
     FontEngine          m_fontEngine;
     FontCacheManager    m_fontCacheManager;
     LibraryScope*       m_pLibScope;
+    GlyphMetricsStore*  m_pMetricsStore;
+    GlyphMetricsTable*  m_pMetrics;         //shared table for current font
+    std::unordered_map<unsigned int, GlyphMetrics>* m_pLocalMetrics; //own copy
+    std::map<GlyphMetricsTable*, std::unordered_map<unsigned int, GlyphMetrics> >
+                        m_localMetrics;     //copies of the used shared tables
+    int                 m_metricsStamp;     //engine change stamp for m_pMetrics
+    std::string         m_fontFile;
+    agg::trans_affine   m_transform;
 
     double  m_fontHeight;
     double  m_fontWidth;
@@ -126,9 +184,18 @@ public:
         return m_fontCacheManager.gray8_scanline();
     }
     inline void set_transform(agg::trans_affine& mtx) {
-        m_fontEngine.transform(mtx);
+        //changing the transform implies rebuilding the font signature. Skip it
+        //when nothing changes
+        if (!mtx.is_equal(m_transform))
+        {
+            m_transform = mtx;
+            m_fontEngine.transform(mtx);
+        }
     }
 
+    //metrics for measuring text. They are shared with other threads' FontStorage
+    bool get_glyph_metrics(unsigned int nChar, GlyphMetrics* pMetrics);
+
 protected:
     bool set_font(const std::string& fontFullName, double height,
                   EFontCacheType type = k_raster_font_cache);
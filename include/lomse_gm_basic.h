@@ -33,6 +33,7 @@
 #include "lomse_basic.h"
 #include "lomse_observable.h"
 #include "lomse_events.h"
+#include "lomse_shapes_grid.h"
 
 #include <vector>
 #include <list>
@@ -69,6 +70,66 @@ class ScoreStub;
 class GraphicModel;
 
 
+//---------------------------------------------------------------------------------------
+// Information saved when laying out a score, so that after an edition that only
+// modifies the content of one system, that system can be engraved again without
+// laying out the whole document. See ScoreLayouter::update_modified_system()
+
+//information about one column
+struct ColumnLayoutInfo
+{
+    size_t contentKey;      //hash of the column content, to detect modified columns
+    size_t spacingKey;      //hash of the column spacing data, before justification
+    int iFirstRelatedCol;   //first and last columns containing objects related to
+    int iLastRelatedCol;    //objects in this column (beams, ties, slurs, lyrics, ...)
+
+    ColumnLayoutInfo()
+        : contentKey(0)
+        , spacingKey(0)
+        , iFirstRelatedCol(0)
+        , iLastRelatedCol(0)
+    {
+    }
+};
+
+//information about one system
+struct SystemLayoutInfo
+{
+    int iCreationPage;      //page and cursor position when the system was engraved
+    UPoint creationCursor;
+    bool fFirstInPage;      //it was the first system in page when engraved
+    int iPage;              //page and cursor position when the system was added
+    UPoint cursor;          //to the page
+
+    SystemLayoutInfo()
+        : iCreationPage(0)
+        , fFirstInPage(true)
+        , iPage(0)
+    {
+    }
+};
+
+//information about the whole score
+struct ScoreLayoutInfo
+{
+    bool fValid;            //the score layout was completed
+    int constrains;         //constrains used for the layout
+    vector<int> breaks;     //first column of each system
+    vector<ColumnLayoutInfo> columns;
+    vector<SystemLayoutInfo> systems;
+    int iLastSystem;        //system used for adjusting the height of last page
+    LUnits yMax;            //and its bottom limit
+
+    ScoreLayoutInfo()
+        : fValid(false)
+        , constrains(0)
+        , iLastSystem(-1)
+        , yMax(0.0f)
+    {
+    }
+};
+
+
 //---------------------------------------------------------------------------------------
 /** %ScoreStub is a helper class containing information related to graphical model for
     one score.
@@ -82,6 +143,7 @@ class ScoreStub
 protected:
     ImoId m_scoreId;
     vector<GmoBoxScorePage*> m_pages;
+    ScoreLayoutInfo m_layoutInfo;
 
 public:
     ScoreStub(ImoId id) : m_scoreId(id) {}
@@ -89,6 +151,9 @@ public:
     inline void add_page(GmoBoxScorePage* pPage) { m_pages.push_back(pPage); }
     inline vector<GmoBoxScorePage*>& get_pages() { return m_pages; }
 
+    //information for updating the layout after an edition
+    inline ScoreLayoutInfo& get_layout_info() { return m_layoutInfo; }
+
     /** Returns the GmoBoxScorePage containing timepos @c time. If @c time is not in
         the score, returns @nullptr. This method gives preference to find pages for
         events instead of non-timed staff objects. For example, the last
@@ -267,6 +332,7 @@ public:
     void set_top(LUnits yTop);
     virtual void shift_origin(const USize& shift);
     void shift_origin(LUnits x, LUnits y);
+    void invalidate_owner_drawing_bounds();
 
     //bounds
     bool bounds_contains_point(UPoint& p);
@@ -390,6 +456,11 @@ protected:
     LUnits m_uLeftMargin;
     LUnits m_uRightMargin;
 
+    //area covered by the box and all its content. Shapes can overflow their box
+    //(i.e. a slur above the staff) so it can be bigger than the box bounds
+    URect m_drawBounds;
+    bool m_fDrawBoundsValid;
+
 public:
     virtual ~GmoBox();
 
@@ -439,12 +510,14 @@ public:
 
     //position
     void shift_origin_and_content(const USize& shift);
-    inline void new_left(LUnits xLeft) { m_origin.x = xLeft; }
-    inline void new_top(LUnits yTop) { m_origin.y = yTop; }
-    inline void new_origin(UPoint& pos) { m_origin = pos; }
+    inline void new_left(LUnits xLeft) { m_origin.x = xLeft; invalidate_drawing_bounds(); }
+    inline void new_top(LUnits yTop) { m_origin.y = yTop; invalidate_drawing_bounds(); }
+    inline void new_origin(UPoint& pos) { m_origin = pos; invalidate_drawing_bounds(); }
 
     //drawing
     virtual void on_draw(Drawer* pDrawer, RenderOptions& opt);
+    URect get_drawing_bounds();
+    void invalidate_drawing_bounds();
 
     //hit testing
     GmoBox* find_inner_box_at(LUnits x, LUnits y);
@@ -501,7 +574,10 @@ class GmoBoxDocPage : public GmoBox
 {
 protected:
     int m_numPage;      //1..n
-    std::list<GmoShape*> m_allShapes;		//contained shapes, ordered by layer and creation order
+    std::vector< std::vector<GmoShape*> > m_layers;   //contained shapes, one bucket per
+                                                      //layer, in creation order
+    ShapesGrid m_shapesGrid;        //spatial index for contained shapes
+    bool m_fShapesGridValid;
 
 public:
     GmoBoxDocPage(ImoObj* pCreatorImo);
@@ -516,6 +592,7 @@ public:
 
     //shapes
     void add_to_tables(GmoShape* pShape);
+    void get_all_shapes(std::vector<GmoShape*>* pShapes);
     GmoShape* get_first_shape_for_layer(int order);
     GmoShape* find_shape_for_object(ImoStaffObj* pSO);
     void store_in_map_imo_shape(GmoShape* pShape);
@@ -528,6 +605,10 @@ public:
     void select_objects_in_rectangle(SelectionSet* selection, const URect& selRect,
                                      unsigned flags=0);
 
+    //spatial index. Rebuilt when needed after adding or moving shapes
+    inline void invalidate_shapes_grid() { m_fShapesGridValid = false; }
+    ShapesGrid* get_shapes_grid();
+
 protected:
     void draw_page_background(Drawer* pDrawer, RenderOptions& opt);
 };
@@ -52,6 +52,7 @@ namespace lomse
 //forward declarations
 class ScreenDrawer;
 class Drawer;
+class TilesCache;
 class Interactor;
 class GraphicModel;
 class Document;
@@ -156,6 +157,10 @@ protected:
     RenderingBuffer* m_pRenderBuf;
     OverlaysGenerator* m_pOverlaysGenerator;
 
+    //optional cache of rasterized tiles, and drawer for rasterizing them
+    TilesCache* m_pTilesCache;
+    ScreenDrawer* m_pTilesDrawer;
+
     //renderization parameters
     double m_expand;
     double m_gamma;
@@ -224,6 +229,9 @@ public:
     void draw_selected_objects();
     void draw_handler(Handler* pHandler);
     void set_background(Color color) { m_backgroundColor = color; }
+    void enable_tiles_cache(bool value, size_t maxMemory);
+    inline bool is_tiles_cache_enabled() { return m_pTilesCache != nullptr; }
+    void invalidate_tiles_cache();
 
     ///@}    //Renderization related
 
@@ -412,6 +420,10 @@ protected:
     void generate_paths();
     virtual void collect_page_bounds() = 0;
     void draw_visible_pages(int minPage, int maxPage);
+    URect get_viewport_culling_rectangle();
+    void draw_graphic_model_from_tiles();
+    void rasterize_tile(RenderingBuffer* pTile, Pixels x, Pixels y);
+    void copy_tile_to_canvas(RenderingBuffer* pTile, Pixels x, Pixels y);
     URect get_page_bounds(int iPage);
     int find_page_at_point(LUnits x, LUnits y);
     bool shift_right_x_to_be_on_page(double* xLeft);
@@ -33,6 +33,7 @@
 #include "lomse_basic.h"
 #include "lomse_observable.h"
 #include "lomse_events.h"
+#include "lomse_id_map.h"
 
 #include <vector>
 #include <list>
@@ -128,9 +129,10 @@ protected:
     GmoBoxDocument* m_root;
     long m_modelId;
     bool m_modified;
-    map<ImoId, GmoBox*> m_imoToBox;
-    map<ImoId, GmoShape*> m_imoToMainShape;
-    map< pair<ImoId, ShapeId>, GmoShape*> m_imoToSecondaryShape;
+    long m_numChanges;      //times the model has been modified, for caches validation
+    IdMap<GmoBox> m_imoToBox;
+    IdMap<GmoShape> m_imoToMainShape;
+    ImoShapeIdMap<GmoShape> m_imoToSecondaryShape;
     map<GmoRef, GmoObj*> m_ctrolToPtr;
     map<ImoId, ScoreStub*> m_scores;
     AreaInfo m_areaInfo;
@@ -143,7 +145,8 @@ public:
     inline GmoBoxDocument* get_root() { return m_root; }
     int get_num_pages();
     GmoBoxDocPage* get_page(int i);
-    inline void set_modified(bool value) { m_modified = value; }
+    inline void set_modified(bool value) { m_modified = value; if (value) ++m_numChanges; }
+    inline long get_num_changes() { return m_numChanges; }
     inline bool is_modified() { return m_modified; }
     inline long get_model_id() { return m_modelId; }
     int get_page_number_containing(GmoObj* pGmo);
@@ -31,6 +31,7 @@
 #define __LOMSE_ID_ASSIGNER_H__
 
 #include "lomse_basic.h"
+#include "lomse_id_map.h"
 
 #include <map>
 #include <string>
@@ -50,8 +51,8 @@ class IdAssigner
 {
 protected:
     ImoId m_idCounter;
-    std::map<ImoId, ImoObj*> m_idToImo;
-    std::map<ImoId, Control*> m_idToControl;
+    IdMap<ImoObj> m_idToImo;
+    IdMap<Control> m_idToControl;
 
 public:
     IdAssigner();
@@ -0,0 +1,277 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the Lomse library.
+// Lomse is copyrighted work (c) 2010-2016. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice, this
+//      list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright notice, this
+//      list of conditions and the following disclaimer in the documentation and/or
+//      other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+// TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+// BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+// ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+// For any comment, suggestion or feature request, please contact the manager of
+// the project at cecilios@users.sourceforge.net
+//---------------------------------------------------------------------------------------
+
+#ifndef __LOMSE_ID_MAP_H__
+#define __LOMSE_ID_MAP_H__
+
+#include "lomse_build_options.h"
+#include "lomse_basic.h"
+
+#include <map>
+#include <vector>
+#include <cstdint>
+
+namespace lomse
+{
+
+//---------------------------------------------------------------------------------------
+// IdMap: associates ImoId values to object pointers.
+// Ids are assigned from a counter and, therefore, are nearly dense. Ids in range
+// [0, k_max_paged_id) are stored in pages of k_page_size slots, allocated on
+// demand and indexed by id. Other ids (k_no_imoid or big ids set by the user in the
+// source file) are stored in a map.
+template <class T>
+class IdMap
+{
+protected:
+    enum {
+        k_page_bits = 8,
+        k_page_size = 1 << k_page_bits,
+        k_max_paged_id = 1 << 24,
+    };
+
+    std::vector<T**> m_pages;
+    std::map<ImoId, T*> m_others;
+    size_t m_size;
+
+public:
+    IdMap() : m_size(0) {}
+    ~IdMap() { clear(); }
+
+    inline size_t size() const { return m_size; }
+
+    //---------------------------------------------------------------------------------
+    T* find(ImoId id) const
+    {
+        if (is_paged(id))
+        {
+            size_t iPage = size_t(id) >> k_page_bits;
+            if (iPage < m_pages.size() && m_pages[iPage])
+                return m_pages[iPage][id & (k_page_size - 1)];
+            return nullptr;
+        }
+
+        typename std::map<ImoId, T*>::const_iterator it = m_others.find(id);
+        return (it != m_others.end() ? it->second : nullptr);
+    }
+
+    //---------------------------------------------------------------------------------
+    void set(ImoId id, T* ptr)
+    {
+        if (is_paged(id))
+        {
+            T*& slot = get_slot(id);
+            if (slot == nullptr && ptr != nullptr)
+                ++m_size;
+            else if (slot != nullptr && ptr == nullptr)
+                --m_size;
+            slot = ptr;
+        }
+        else if (ptr == nullptr)
+            erase(id);
+        else
+        {
+            std::pair<typename std::map<ImoId, T*>::iterator, bool> result
+                = m_others.insert( std::make_pair(id, ptr) );
+            if (result.second)
+                ++m_size;
+            else
+                result.first->second = ptr;
+        }
+    }
+
+    //---------------------------------------------------------------------------------
+    void erase(ImoId id)
+    {
+        if (is_paged(id))
+            set(id, nullptr);
+        else if (m_others.erase(id) > 0)
+            --m_size;
+    }
+
+    //---------------------------------------------------------------------------------
+    void clear()
+    {
+        for (size_t i=0; i < m_pages.size(); ++i)
+            delete[] m_pages[i];
+        m_pages.clear();
+        m_others.clear();
+        m_size = 0;
+    }
+
+    //---------------------------------------------------------------------------------
+    //Appends all stored entries to 'entries', in ascending id order
+    void get_entries(std::vector< std::pair<ImoId, T*> >& entries) const
+    {
+        entries.reserve(entries.size() + m_size);
+
+        typename std::map<ImoId, T*>::const_iterator it = m_others.begin();
+        for (; it != m_others.end() && it->first < 0; ++it)
+            entries.push_back(*it);
+
+        for (size_t iPage=0; iPage < m_pages.size(); ++iPage)
+        {
+            T** pPage = m_pages[iPage];
+            if (pPage == nullptr)
+                continue;
+            for (int i=0; i < k_page_size; ++i)
+            {
+                if (pPage[i])
+                    entries.push_back( std::make_pair(ImoId((iPage << k_page_bits) + i),
+                                                      pPage[i]) );
+            }
+        }
+
+        for (; it != m_others.end(); ++it)
+            entries.push_back(*it);
+    }
+
+protected:
+    static inline bool is_paged(ImoId id) { return id >= 0 && id < k_max_paged_id; }
+
+    T*& get_slot(ImoId id)
+    {
+        size_t iPage = size_t(id) >> k_page_bits;
+        if (iPage >= m_pages.size())
+            m_pages.resize(iPage + 1, nullptr);
+        if (m_pages[iPage] == nullptr)
+            m_pages[iPage] = LOMSE_NEW T*[k_page_size]();
+        return m_pages[iPage][id & (k_page_size - 1)];
+    }
+
+private:
+    IdMap(const IdMap&);
+    IdMap& operator=(const IdMap&);
+};
+
+
+//---------------------------------------------------------------------------------------
+// ImoShapeIdMap: associates (ImoId, ShapeId) pairs to object pointers. It is an open
+// addressing hash table with linear probing, used for the secondary shapes
+// (ShapeId > 0) created by an ImoObj. Entries are never removed.
+template <class T>
+class ImoShapeIdMap
+{
+protected:
+    struct Slot
+    {
+        ImoId id;
+        ShapeId shapeId;    //0 for empty slots
+        T* ptr;
+    };
+
+    std::vector<Slot> m_slots;      //capacity is a power of two
+    size_t m_size;
+
+public:
+    ImoShapeIdMap() : m_size(0) {}
+
+    inline size_t size() const { return m_size; }
+
+    //---------------------------------------------------------------------------------
+    T* find(ImoId id, ShapeId shapeId) const
+    {
+        if (m_slots.empty() || shapeId <= 0)
+            return nullptr;
+
+        size_t mask = m_slots.size() - 1;
+        for (size_t i = hash(id, shapeId) & mask; ; i = (i + 1) & mask)
+        {
+            const Slot& slot = m_slots[i];
+            if (slot.shapeId == 0)
+                return nullptr;
+            if (slot.id == id && slot.shapeId == shapeId)
+                return slot.ptr;
+        }
+    }
+
+    //---------------------------------------------------------------------------------
+    void set(ImoId id, ShapeId shapeId, T* ptr)
+    {
+        //shapeId must be > 0
+        if (shapeId <= 0)
+            return;
+
+        if ((m_size + 1) * 4 > m_slots.size() * 3)
+            grow();
+
+        Slot& slot = find_slot(id, shapeId);
+        if (slot.shapeId == 0)
+        {
+            slot.id = id;
+            slot.shapeId = shapeId;
+            ++m_size;
+        }
+        slot.ptr = ptr;
+    }
+
+    //---------------------------------------------------------------------------------
+    void clear()
+    {
+        m_slots.clear();
+        m_size = 0;
+    }
+
+protected:
+    static inline size_t hash(ImoId id, ShapeId shapeId)
+    {
+        uint32_t h = uint32_t(id) * 0x9E3779B1u;
+        h ^= uint32_t(shapeId) * 0x85EBCA77u;
+        return size_t(h ^ (h >> 15));
+    }
+
+    Slot& find_slot(ImoId id, ShapeId shapeId)
+    {
+        size_t mask = m_slots.size() - 1;
+        for (size_t i = hash(id, shapeId) & mask; ; i = (i + 1) & mask)
+        {
+            Slot& slot = m_slots[i];
+            if (slot.shapeId == 0 || (slot.id == id && slot.shapeId == shapeId))
+                return slot;
+        }
+    }
+
+    void grow()
+    {
+        std::vector<Slot> old;
+        old.swap(m_slots);
+        Slot empty = { k_no_imoid, 0, nullptr };
+        m_slots.assign(old.empty() ? 16 : old.size() * 2, empty);
+        for (size_t i=0; i < old.size(); ++i)
+        {
+            if (old[i].shapeId != 0)
+                find_slot(old[i].id, old[i].shapeId) = old[i];
+        }
+    }
+};
+
+
+}   //namespace lomse
+
+#endif      //__LOMSE_ID_MAP_H__
@@ -58,6 +58,7 @@ class ModelBuilder;
 class Document;
 class LdpFactory;
 class FontStorage;
+class GlyphMetricsStore;
 class MusicGlyphs;
 class View;
 class SimpleView;
@@ -79,6 +80,8 @@ class DocCursor;
 class DocCommandExecuter;
 class CaretPositioner;
 class MusicGlyphs;
+class CommandJournal;
+class ModelArena;
 
 //---------------------------------------------------------------------------------------
 // Trace levels for lines breaker algorithm
@@ -98,9 +101,11 @@ protected:
     LomseDoorway* m_pDoorway;
     LomseDoorway* m_pNullDoorway;
     LdpFactory* m_pLdpFactory;
-    FontStorage* m_pFontStorage;
+    unsigned long m_scopeId;                //to find this scope FontStorage in a thread
+    GlyphMetricsStore* m_pGlyphMetrics;     //shared by all FontStorage objects
     Metronome* m_pGlobalMetronome;
     EventsDispatcher* m_pDispatcher;
+    CommandJournal* m_pJournal;
     string m_sMusicFontFile;
     string m_sMusicFontName;
     string m_sMusicFontPath;
@@ -110,6 +115,10 @@ protected:
     //options
     bool m_fReplaceLocalMetronome;
     MusicXmlOptions m_importOptions;
+    bool m_fAsyncEvents;            //deliver events from a dedicated thread
+    bool m_fModelArena;             //allocate documents' internal model in an arena
+    bool m_fIncrementalLayout;      //re-engrave only the modified system, when possible
+    int m_renderingThreads;         //threads for rendering paths. 0: one per core
 
     //debug options
     bool m_fJustifySystems;         //if false, prevents systems justification
@@ -119,6 +128,7 @@ protected:
     bool m_fShowShapeBounds;        //draw a box around each shape
     bool m_fUnitTests;              //library is running for Unit Tests
     int m_traceLinesBreaker;        //trace level for lines breaker algorithm
+    bool m_fVerifyUpdates;          //check incremental updates against full rebuild
 
     //spacing algorithm
     bool m_fUseDbgValues;           //use values defined here for spacing params.
@@ -136,6 +146,7 @@ public:
     inline LomseDoorway* platform_interface() { return m_pDoorway; }
     LdpFactory* ldp_factory();
     FontStorage* font_storage();
+    inline GlyphMetricsStore* glyph_metrics_store() { return m_pGlyphMetrics; }
     inline string& fonts_path() { return m_sFontsPath; }
     EventsDispatcher* get_events_dispatcher();
 
@@ -176,6 +187,40 @@ public:
     inline bool global_metronome_replaces_local() { return m_fReplaceLocalMetronome; }
     inline MusicXmlOptions* get_musicxml_options() { return &m_importOptions; }
 
+    //events dispatching. When true, events are delivered from a dedicated thread
+    //instead of from the thread that generates them (i.e. the playback thread)
+    void set_async_events_dispatch(bool value);
+    inline bool async_events_dispatch() { return m_fAsyncEvents; }
+
+    //rendering. When more than one thread, the rendering buffer is split in
+    //horizontal bands that are rendered in parallel. Result is the same than when
+    //using a single thread (the default). Value 0 means one thread per core.
+    //Only affects the drawers created after setting the value
+    inline void set_rendering_threads(int numThreads) { m_renderingThreads = numThreads; }
+    inline int get_rendering_threads() { return m_renderingThreads; }
+
+    //memory for the internal model. When true, the objects of the internal model of
+    //each Document are allocated in an arena owned by the Document, for faster
+    //allocation and deletion. Disabled by default. Only affects the documents
+    //created after setting the value
+    inline void set_use_model_arena(bool value) { m_fModelArena = value; }
+    inline bool use_model_arena() { return m_fModelArena; }
+
+    //layout after edition. When true, and the changes in a document only affect
+    //columns of one system of one score, and that system line break still holds, only
+    //that system is re-engraved and the rest of the graphic model is kept. Otherwise
+    //the whole document is laid out again. Enabled by default
+    inline void set_incremental_layout(bool value) { m_fIncrementalLayout = value; }
+    inline bool incremental_layout() { return m_fIncrementalLayout; }
+
+    //journal of edition commands, for forensic analysis. Disabled by default. When
+    //maxRecords > 0 only the most recent records are retained. An empty filename
+    //keeps the records only in memory, with a default limit when maxRecords is 0
+    void enable_command_journal(const string& filename="forensic_log.txt",
+                                size_t maxRecords=0);
+    void disable_command_journal();
+    inline CommandJournal* get_command_journal() { return m_pJournal; }
+
     //spacing and lines breaker algorithm parameters
     inline bool use_debug_values() { return m_fUseDbgValues; }
     inline float get_optimum_force() { return m_spacingOptForce; }
@@ -221,6 +266,8 @@ public:
         m_traceLinesBreaker = level;
     }
     inline int get_trace_level_for_lines_breaker() { return m_traceLinesBreaker; }
+    inline void set_verify_incremental_updates(bool value) { m_fVerifyUpdates = value; }
+    inline bool verify_incremental_updates() { return m_fVerifyUpdates; }
 
 };
 
@@ -230,6 +277,7 @@ class DocumentScope
 protected:
     ostream& m_reporter;
     IdAssigner* m_idAssigner;
+    ModelArena* m_pArena;
 
 public:
     DocumentScope(ostream& reporter=cout);
@@ -237,6 +285,8 @@ public:
 
     ostream& default_reporter() { return m_reporter; }
     IdAssigner* id_assigner() { return m_idAssigner; }
+    void create_model_arena();
+    ModelArena* model_arena() { return m_pArena; }
 
 };
 
@@ -64,7 +64,6 @@ class PartsEngraver : public Engraver
 protected:
     ImoInstrGroups* m_pGroups;
     ImoScore* m_pScore;
-    FontStorage* m_pFontStorage;
     ScoreLayouter* m_pScoreLyt;
 
     std::vector<GroupEngraver*> m_groupEngravers;
@@ -139,7 +138,6 @@ class InstrumentEngraver : public Engraver
 protected:
     ImoInstrument* m_pInstr;
     ImoScore* m_pScore;
-    FontStorage* m_pFontStorage;
     UPoint m_org;
     LUnits m_uBracketGap;
 
@@ -227,7 +225,6 @@ protected:
     ImoInstrGroup* m_pGroup;
     ImoScore* m_pScore;
     PartsEngraver* m_pParts;
-    FontStorage* m_pFontStorage;
     UPoint m_org;
 
     //vertical positions are relative to SystemBox origin
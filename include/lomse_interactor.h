@@ -531,6 +531,19 @@ public:
     */
     void set_view_background(Color color);
 
+    /** Enable or disable a cache of rasterized fragments (tiles) of the document for
+        the view associated to this %Interactor. When enabled, the document is
+        rasterized only once for each scale, in square tiles, and scrolling only
+        requires copying the cached tiles into the rendering buffer. Tiles are
+        discarded when the document is modified or when the scale or the rendering
+        options change. By default the cache is disabled.
+
+        @param value @TRUE for enabling the cache or @FALSE for disabling it.
+        @param maxMemory Maximum memory, in bytes, to use for the tiles. When this
+            limit is reached, the least recently used tiles are discarded.
+    */
+    void enable_tiles_cache(bool value, size_t maxMemory=64*1024*1024);
+
         //@}    //interface to GraphicView. Rendering
 
 
@@ -45,6 +45,7 @@
 #include "lomse_injectors.h"
 #include "lomse_image.h"
 #include "lomse_logger.h"
+#include "lomse_model_arena.h"
 typedef int TIntAttribute;
 
 using namespace std;
@@ -1186,7 +1187,7 @@ public:
 
 //---------------------------------------------------------------------------------------
 // the root. Any object must derive from it
-class ImoObj : public Visitable, public TreeNode<ImoObj>
+class ImoObj : public Visitable, public TreeNode<ImoObj>, public ArenaObject
 {
 protected:
     Document* m_pDoc;
@@ -1197,6 +1198,7 @@ protected:
 
 protected:
     ImoObj(int objtype, ImoId id=k_no_imoid);
+    ImoObj(const ImoObj& a);
 
     friend class ImFactory;
     inline void set_owner_document(Document* pDoc)
@@ -1217,6 +1219,7 @@ public:
         k_editable          = 0x0008,   //in edition, this node can be edited
         k_deletable         = 0x0010,   //if editable, this node can be also deleted
         k_expandable        = 0x0020,   //if editable, more children can be added/inserted
+        k_in_arena          = 0x0040,   //allocated in the document ModelArena
     };
 
     //dirty
@@ -1298,6 +1301,7 @@ public:
     void remove_child_imo(ImoObj* pImo);
     Document* get_the_document();
     ImoDocument* get_document();
+    ModelArena* get_model_arena();
     Observable* get_observable_parent();
     ImoContentObj* get_contentobj_parent();
     ImoBlockLevelObj* find_block_level_parent();
@@ -1650,11 +1654,16 @@ protected:
     std::map<int, int> m_intProps;
     std::map<int, Color> m_colorProps;
 
+    struct ResolvedProps;
+    ResolvedProps* m_pResolved;     //own and inherited values, indexed by property
+    unsigned m_resolvedEpoch;       //styles epoch when m_pResolved was built
+
     friend class ImFactory;
-    ImoStyle() : ImoSimpleObj(k_imo_style), m_name(), m_pParent(nullptr) {}
+    ImoStyle() : ImoSimpleObj(k_imo_style), m_name(), m_pParent(nullptr)
+               , m_pResolved(nullptr), m_resolvedEpoch(0) {}
 
 public:
-    virtual ~ImoStyle() {}
+    virtual ~ImoStyle();
 
     //text style
     enum { k_spacing_normal=0, k_length, };
@@ -1724,6 +1733,8 @@ public:
 
         //table
         k_table_col_width,
+
+        k_max_style_property,   //AWARE: must be the last one
     };
 
     //general
@@ -1738,8 +1749,14 @@ public:
     inline void set_parent_style(ImoStyle* pStyle)
     {
         m_pParent = pStyle;
+        invalidate_resolved_styles(m_pDoc);
     }
 
+    //resolved values cache. Any change in any style of a document invalidates all
+    //caches for that document
+    static void invalidate_resolved_styles(Document* pDoc);
+    static unsigned resolved_styles_epoch(Document* pDoc);
+
     //utility
     LUnits em_to_LUnits(float em)
     {
@@ -2084,22 +2101,27 @@ protected:
     void set_string_property(int prop, const string& value)
     {
         m_stringProps[prop] = value;
+        invalidate_resolved_styles(m_pDoc);
     }
     void set_float_property(int prop, float value)
     {
         m_floatProps[prop] = value;
+        invalidate_resolved_styles(m_pDoc);
     }
     void set_int_property(int prop, int value)
     {
         m_intProps[prop] = value;
+        invalidate_resolved_styles(m_pDoc);
     }
     void set_lunits_property(int prop, LUnits value)
     {
         m_lunitsProps[prop] = value;
+        invalidate_resolved_styles(m_pDoc);
     }
     void set_color_property(int prop, Color value)
     {
         m_colorProps[prop] = value;
+        invalidate_resolved_styles(m_pDoc);
     }
 
     //special setters
@@ -2190,14 +2212,38 @@ protected:
             return false;
     }
 
+    //resolved values: own values plus values inherited from the parents chain, stored
+    //in flat arrays indexed by property. Built on first use and rebuilt only after a
+    //change in any style.
+    struct ResolvedProps
+    {
+        bool fFloat[k_max_style_property];
+        bool fLUnits[k_max_style_property];
+        bool fString[k_max_style_property];
+        bool fInt[k_max_style_property];
+        bool fColor[k_max_style_property];
+        float floats[k_max_style_property];
+        LUnits lunits[k_max_style_property];
+        const string* strings[k_max_style_property];
+        int ints[k_max_style_property];
+        Color colors[k_max_style_property];
+    };
+
+    inline ResolvedProps* resolved_props()
+    {
+        if (m_pResolved == nullptr || m_resolvedEpoch != resolved_styles_epoch(m_pDoc))
+            resolve_props();
+        return m_pResolved;
+    }
+    void resolve_props();
+    void add_own_props(ResolvedProps* pProps);
+
     //getters. If value not stored, inherites from parent
     float get_float_property(int prop)
     {
-        map<int, float>::const_iterator it = m_floatProps.find(prop);
-        if (it != m_floatProps.end())
-            return it->second;
-        else if (m_pParent)
-            return m_pParent->get_float_property(prop);
+        ResolvedProps* pProps = resolved_props();
+        if (pProps->fFloat[prop])
+            return pProps->floats[prop];
         else
         {
             LOMSE_LOG_ERROR("Aborting. Style has no parent.");
@@ -2207,11 +2253,9 @@ protected:
 
     LUnits get_lunits_property(int prop)
     {
-        map<int, LUnits>::const_iterator it = m_lunitsProps.find(prop);
-        if (it != m_lunitsProps.end())
-            return it->second;
-        else if (m_pParent)
-            return m_pParent->get_lunits_property(prop);
+        ResolvedProps* pProps = resolved_props();
+        if (pProps->fLUnits[prop])
+            return pProps->lunits[prop];
         else
         {
             LOMSE_LOG_ERROR("Aborting. Style has no parent.");
@@ -2221,11 +2265,9 @@ protected:
 
     const string& get_string_property(int prop)
     {
-        map<int, string>::const_iterator it = m_stringProps.find(prop);
-        if (it != m_stringProps.end())
-            return it->second;
-        else if (m_pParent)
-            return m_pParent->get_string_property(prop);
+        ResolvedProps* pProps = resolved_props();
+        if (pProps->fString[prop])
+            return *(pProps->strings[prop]);
         else
         {
             LOMSE_LOG_ERROR("Aborting. Style has no parent.");
@@ -2235,11 +2277,9 @@ protected:
 
     int get_int_property(int prop)
     {
-        map<int, int>::const_iterator it = m_intProps.find(prop);
-        if (it != m_intProps.end())
-            return it->second;
-        else if (m_pParent)
-            return m_pParent->get_int_property(prop);
+        ResolvedProps* pProps = resolved_props();
+        if (pProps->fInt[prop])
+            return pProps->ints[prop];
         else
         {
             LOMSE_LOG_ERROR("Aborting. Style has no parent.");
@@ -2249,11 +2289,9 @@ protected:
 
     Color get_color_property(int prop)
     {
-        map<int, Color>::const_iterator it = m_colorProps.find(prop);
-        if (it != m_colorProps.end())
-            return it->second;
-        else if (m_pParent)
-            return m_pParent->get_color_property(prop);
+        ResolvedProps* pProps = resolved_props();
+        if (pProps->fColor[prop])
+            return pProps->colors[prop];
         else
             throw std::runtime_error( "[ImoStyle::get_color_property]. No parent" );
     }
@@ -2272,6 +2310,8 @@ class ImoContentObj : public ImoObj
 {
 protected:
     ImoStyle* m_pStyle;
+    ImoStyle* m_pNamedStyle;        //cached style found by name (paragraphs, etc.)
+    unsigned m_namedStyleEpoch;     //styles epoch when m_pNamedStyle was found
     Tenths m_txUserLocation;
     Tenths m_tyUserLocation;
     Tenths m_txUserRefPoint;
@@ -5714,6 +5754,7 @@ public:
     inline void set_level(int level)
     {
         m_level = level;
+        ImoStyle::invalidate_resolved_styles(m_pDoc);
     }
 
     //required by Visitable parent class
@@ -6130,6 +6171,13 @@ public:
         that will invoke this method on all scores. */
     void end_of_changes();
 
+    /** Same as end_of_changes() but for when only the music data of instrument
+        pInstr has been modified. Structures are then updated instead of rebuilt,
+        which is much faster for large scores. If all changes are insertions or
+        modifications of consecutive staffobjs, pass the first one in pFirstChanged
+        and only the affected measures will be processed. */
+    void end_of_changes(ImoInstrument* pInstr, ImoStaffObj* pFirstChanged=nullptr);
+
 
 protected:
     void add_option(ImoOptionInfo* pOpt);
@@ -56,6 +56,7 @@ protected:
     bool m_fRemoveNewlines;
 
     //temporary
+    ostream* m_pOutput;         //stream in which generators write the source
     ImoScore* m_pCurrScore;     //current score being exported
     bool m_fProcessingChord;
 
@@ -76,8 +77,9 @@ public:
     inline bool get_add_id() { return m_fAddId; }
     inline bool get_remove_newlines() { return m_fRemoveNewlines; }
 
-    //the main method
+    //the main methods
     string get_source(ImoObj* pImo, ImoObj* pParent=nullptr);
+    void get_source(ostream& out, ImoObj* pImo, ImoObj* pParent=nullptr);
 
     //static methods for ldp names to types conversion
     static string clef_type_to_ldp(int clefType);
@@ -94,6 +96,7 @@ public:
     inline ImoScore* get_current_score() { return m_pCurrScore; }
     inline void set_processing_chord(bool value) { m_fProcessingChord = value; }
     inline bool is_processing_chord() { return m_fProcessingChord; }
+    inline ostream& get_output_stream() { return *m_pOutput; }
 
 protected:
     LdpGenerator* new_generator(ImoObj* pImo);
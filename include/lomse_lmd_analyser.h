@@ -203,7 +203,6 @@ protected:
     ImoNote* m_pLastNote;
 
     //tags for xml elements
-    std::map<std::string, int>	m_NameToTag;
 
 public:
     LmdAnalyser(ostream& reporter, LibraryScope& libraryScope, Document* pDoc,
@@ -320,14 +319,13 @@ public:
     }
 
     //-----------------------------------------------------------------------------------
-    inline int get_tag(XmlNode* node) { return name_to_tag( node->name() ); }
+    inline int get_tag(XmlNode* node) { return name_to_tag( node->name_c_str() ); }
 
-    int name_to_tag(const string& name) const;
+    int name_to_tag(const char* name) const;
     bool to_integer(const string& text, int* pResult);
 
 
 protected:
-    LmdElementAnalyser* new_analyser(const string& name, ImoObj* pAnchor=nullptr);
     void delete_relation_builders();
 
     //auxiliary. for ldp notes analysis
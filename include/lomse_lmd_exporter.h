@@ -55,6 +55,7 @@ protected:
     bool m_fRemoveNewlines;
     string m_lomseVersion;
     string m_exportTime;
+    ostream* m_pOutput;         //stream in which generators write the source
 
     //controlling open tags
     stack<string> m_openTags;
@@ -82,12 +83,14 @@ public:
     inline int get_score_format() { return m_scoreFormat; }
     inline bool get_remove_newlines() { return m_fRemoveNewlines; }
 
-    //the main method
+    //the main methods
     string get_source(ImoObj* pImo);
+    void get_source(ostream& out, ImoObj* pImo);
 
     //auxiliary
     string get_version_and_time_string();
     inline LibraryScope& get_library_scope() { return m_libraryScope; }
+    inline ostream& get_output_stream() { return *m_pOutput; }
 
     //static methods for types ldp names to conversion
     static string clef_type_to_ldp(int clefType);
@@ -40,6 +40,7 @@ namespace lomse
 {
 
 class ColStaffObjsEntry;
+class ImoKeySignature;
 
 //---------------------------------------------------------------------------------------
 // ImMeasuresTableEntry: an entry in the ImMeasuresTable table
@@ -55,6 +56,8 @@ protected:
 
 	ColStaffObjsEntry* m_pCsoEntry; //ptr to barline (end of this measure) or nullptr
 	                                //when no end barline
+    ImoKeySignature* m_pKey;        //key signature in force at measure start, or
+                                    //nullptr if none
 
 public:
     ImMeasuresTableEntry(ColStaffObjsEntry* pEntry);
@@ -67,6 +70,7 @@ public:
 	inline TimeUnits get_implied_beat_duration() const { return m_bottomBeat; }
 	inline TimeUnits get_bottom_ts_beat_duration() const { return m_impliedBeat; }
     inline ColStaffObjsEntry* get_entry() const { return m_pCsoEntry; }
+    inline ImoKeySignature* get_key() const { return m_pKey; }
 
     //debug
     string dump();
@@ -82,6 +86,7 @@ protected:
 	inline void set_implied_beat_duration(TimeUnits duration) { m_bottomBeat = duration; }
 	inline void set_bottom_ts_beat_duration(TimeUnits duration) { m_impliedBeat = duration; }
 	inline void set_entry(ColStaffObjsEntry* entry) { m_pCsoEntry = entry; }
+    inline void set_key(ImoKeySignature* pKey) { m_pKey = pKey; }
 
 };
 
@@ -105,6 +110,8 @@ public:
 
     //table management
     ImMeasuresTableEntry* add_entry(ColStaffObjsEntry* pCsoEntry);
+    void replace_entries(int iFirst, int numOld,
+                         std::vector<ImMeasuresTableEntry*>& entries);
 
     //access to entries
     ImMeasuresTableEntry* get_measure(int iMeasure);
@@ -113,6 +120,7 @@ public:
 
     //search
     ImMeasuresTableEntry* get_measure_at(TimeUnits timepos);
+    ImMeasuresTableEntry* get_measure_before(TimeUnits timepos);
 
     //debug
     string dump();
@@ -170,7 +170,8 @@ class SoundEventsTable
 protected:
     ImoScore* m_pScore;
     int m_numMeasures;
-    vector<SoundEvent*> m_events;
+    vector<SoundEvent> m_storage;       //the events, contiguous, owned by the table
+    vector<SoundEvent*> m_events;       //index over m_storage, in table order
     vector<int> m_measures;
     vector<int> m_channels;
     vector<JumpEntry*> m_jumps;
@@ -220,6 +221,8 @@ protected:
     void add_rythm_change(StaffObjsCursor& cursor, int measure, ImoTimeSignature* pTS);
     void add_jump(StaffObjsCursor& cursor, int measure, JumpEntry* pJump);
     void delete_events_table();
+    void reserve_events_space();
+    void rebuild_events_index();
     int compute_volume(TimeUnits timePos, ImoTimeSignature* pTS, TimeUnits timeShift);
     void reset_accidentals(ImoKeySignature* pKey);
     void update_context_accidentals(ImoNote* pNote);
@@ -283,7 +283,6 @@ protected:
 //    int m_nShowTupletNumber;
 
     //conversion from xml element name to int
-    map<string, int>	m_NameToEnum;
 
 
 public:
@@ -433,7 +432,7 @@ public:
     int get_line_number(XmlNode* node);
 
 
-    int name_to_enum(const string& name) const;
+    int name_to_enum(const char* name) const;
     bool to_integer(const string& text, int* pResult);
 
     //public utilities
@@ -444,7 +443,7 @@ public:
 
 protected:
     friend class MnxElementAnalyser;
-    MnxElementAnalyser* new_analyser(const string& name, ImoObj* pAnchor=nullptr);
+    bool analyse_node_as(const char* name, XmlNode* pNode, ImoObj* pAnchor);
     void set_result(void* pValue) { m_pResult = pValue; }
 
     void delete_relation_builders();
@@ -54,6 +54,7 @@ protected:
     bool m_fRemoveNewlines;
     string m_lomseVersion;
     string m_exportTime;
+    ostream* m_pOutput;         //stream in which generators write the source
 
     //temporary
     bool m_fProcessingChord;
@@ -78,11 +79,13 @@ public:
     inline bool get_add_id() { return m_fAddId; }
     inline bool get_remove_newlines() { return m_fRemoveNewlines; }
 
-    //the main method
+    //the main methods
     string get_source(ImoObj* pImo);
+    void get_source(ostream& out, ImoObj* pImo);
 
     //auxiliary
     string get_version_and_time_string();
+    inline ostream& get_output_stream() { return *m_pOutput; }
 
     //static methods for types mnx names to conversion
     static string clef_type_to_mnx(int clefType);
@@ -0,0 +1,129 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the Lomse library.
+// Lomse is copyrighted work (c) 2010-2016. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice, this
+//      list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright notice, this
+//      list of conditions and the following disclaimer in the documentation and/or
+//      other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+// TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+// BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+// ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+// For any comment, suggestion or feature request, please contact the manager of
+// the project at cecilios@users.sourceforge.net
+//---------------------------------------------------------------------------------------
+
+#ifndef __LOMSE_MODEL_ARENA_H__
+#define __LOMSE_MODEL_ARENA_H__
+
+#include "lomse_build_options.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace lomse
+{
+
+//---------------------------------------------------------------------------------------
+// ModelArena: bump allocator for the objects of the internal model of a Document.
+// Memory is requested to the system in big chunks and it is only returned when
+// the arena is deleted. Blocks released while editing are kept in free lists, one
+// per block size, and are reused for new objects of the same size.
+// Not thread safe, as the Document.
+class ModelArena
+{
+protected:
+    std::vector<char*> m_chunks;
+    char* m_pNext;                  //first free byte in current chunk
+    size_t m_available;             //free bytes in current chunk
+    std::vector<void*> m_freeLists; //index: block size / k_align
+    size_t m_inUse;                 //bytes in allocated blocks
+    bool m_fDiscarding;             //being deleted: released blocks are not reused
+
+public:
+    ModelArena();
+    ~ModelArena();
+
+    enum {
+        k_align = 16,
+        k_chunk_size = 64 * 1024,
+        k_max_block = 2048,         //bigger blocks are not allocated in the arena
+    };
+
+    void* allocate(size_t size);
+    void release(void* pBlock, size_t size);
+
+    //when the whole model is going to be deleted, released blocks are not linked
+    //into the free lists. Memory is returned to the system with the chunks
+    inline void discard_released_blocks() { m_fDiscarding = true; }
+
+    //info
+    inline bool accepts(size_t size) const { return size <= k_max_block; }
+    inline size_t num_chunks() const { return m_chunks.size(); }
+    inline size_t bytes_in_use() const { return m_inUse; }
+
+protected:
+    static inline size_t round_size(size_t size) {
+        return (size + k_align - 1) & ~size_t(k_align - 1);
+    }
+    void new_chunk();
+
+};
+
+//---------------------------------------------------------------------------------------
+// ArenaObject: base class for objects that can be allocated in a ModelArena.
+// Use 'new (pArena) Object()' to allocate in an arena. A null arena, or the
+// plain 'new' operator, allocates in the heap. Blocks have no header: the derived
+// class must remember if it was allocated in an arena (ask allocated_in_arena() in
+// its constructor) and, at the end of its destructor, must inform about the arena
+// in which the block must be released (call release_in_arena()).
+// AWARE: objects allocated in an arena must be deleted before deleting the arena.
+class ArenaObject
+{
+public:
+    static void* operator new(size_t size);
+    static void* operator new(size_t size, ModelArena* pArena);
+    static void operator delete(void* p, size_t size);
+    static void operator delete(void* p, ModelArena* pArena);
+
+#if (LOMSE_COMPILER_MSVC == 1) && (LOMSE_DEBUG == 1)
+    //for LOMSE_NEW when detecting memory leaks with Visual C++
+    static void* operator new(size_t size, int blockType, const char* file, int line);
+    static void operator delete(void* p, int blockType, const char* file, int line);
+#endif
+
+protected:
+    static thread_local void* m_pLastArenaBlock;    //last block allocated in an arena
+    static thread_local ModelArena* m_pReleaseArena; //arena for next operator delete
+
+    static inline bool allocated_in_arena(void* pObj)
+    {
+        if (pObj != m_pLastArenaBlock)
+            return false;
+        m_pLastArenaBlock = nullptr;
+        return true;
+    }
+    static inline void release_in_arena(ModelArena* pArena)
+    {
+        m_pReleaseArena = pArena;
+    }
+};
+
+
+}   //namespace lomse
+
+#endif      //__LOMSE_MODEL_ARENA_H__
@@ -50,7 +50,9 @@ class ImoNote;
 class ImoObj;
 class ImoScore;
 class ImoSoundInfo;
+class ImoStaffObj;
 class ColStaffObjsEntry;
+struct ColStaffObjsChanges;
 class ImMeasuresTable;
 class ImMeasuresTableEntry;
 
@@ -67,6 +69,11 @@ public:
     ImoDocument* build_model(ImoDocument* pImoDoc);
     void structurize(ImoObj* pImo);
 
+    /** Updates score structures after modifying only the music data of instrument
+        iInstr. pFirstChanged is the first inserted or modified staffobj, or nullptr
+        if not known. */
+    void structurize(ImoScore* pScore, int iInstr, ImoStaffObj* pFirstChanged=nullptr);
+
 };
 
 //---------------------------------------------------------------------------------------
@@ -84,6 +91,7 @@ public:
     virtual ~PitchAssigner() {}
 
     void assign_pitch(ImoScore* pScore);
+    void assign_pitch(ImoScore* pScore, int iInstr, ColStaffObjsChanges& changes);
 
 protected:
     void reset_accidentals(ImoKeySignature* pKey, int idx);
@@ -126,18 +134,23 @@ class MeasuresTableBuilder
 protected:
     vector<ImoInstrument*> m_instruments;
     vector<ImMeasuresTableEntry*> m_measures;   //current open measures
+    vector<ImoKeySignature*> m_keys;            //key signature in force
 
 public:
     MeasuresTableBuilder();
     virtual ~MeasuresTableBuilder();
 
 	void build(ImoScore* pScore);
+	void build(ImoScore* pScore, int onlyInstr);
+	void update(ImoScore* pScore, int iInstr, ColStaffObjsChanges& changes);
 
 protected:
     void start_measures_table_for(int iInstr, ImoInstrument* pInstr,
                                   ColStaffObjsEntry* pCsoEntry);
     void finish_current_measure(int iInstr);
     void start_new_measure(int iInstr, ColStaffObjsEntry* pCsoEntry);
+    void init_measure(int iInstr, ImMeasuresTableEntry* prevMeasure);
+    void process_entry(int iInstr, ImoStaffObj* pSO);
 };
 
 
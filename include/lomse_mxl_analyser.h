@@ -258,7 +258,6 @@ protected:
 //    int m_nShowTupletNumber;
 
     //conversion from xml element name to int
-    std::map<std::string, int>	m_NameToEnum;
 
 public:
     MxlAnalyser(ostream& reporter, LibraryScope& libraryScope, Document* pDoc,
@@ -399,12 +398,11 @@ public:
     int get_line_number(XmlNode* node);
 
 
-    int name_to_enum(const string& name) const;
+    int name_to_enum(const char* name) const;
     bool to_integer(const string& text, int* pResult);
 
 
 protected:
-    MxlElementAnalyser* new_analyser(const string& name, ImoObj* pAnchor=nullptr);
     void delete_relation_builders();
     void add_marging_space_for_lyrics(ImoNote* pNote, ImoLyric* pLyric);
 };
@@ -66,6 +66,7 @@ protected:
     int8u* m_pSaveBytes;                //the real buffer for the clean copy
     URect m_damagedRect;
     URect m_prevDamagedRect;
+    VRect m_overlaysArea;               //canvas pixels currently covered by overlays
     GmoObj* m_pHandlersOwner;           //object owning current defined handlers
 
 public:
@@ -88,6 +89,8 @@ public:
 protected:
     void save_rendering_buffer();
     void expand_damaged_rectangle();
+    void restore_overlays_area(ScreenDrawer* pDrawer);
+    void determine_overlays_area(ScreenDrawer* pDrawer);
 
 
 };
@@ -48,8 +48,18 @@ class InputStream;
 // LdpReader: Base class for any provider of LDP source code to be parsed
 class LdpReader
 {
+protected:
+    //Readers holding the whole source in a contiguous buffer set these pointers, so
+    //that the tokenizer can scan the buffer directly instead of invoking the virtual
+    //methods for each char.
+    const char* m_pStart;
+    const char* m_pEnd;
+    const char* m_pNext;
+    bool m_fPastEnd;        //EOF was returned by last get
+
 public:
-    LdpReader() {}
+    LdpReader() : m_pStart(nullptr), m_pEnd(nullptr), m_pNext(nullptr)
+                , m_fPastEnd(false) {}
     virtual ~LdpReader() {}
 
     // Returns the next char from the source
@@ -65,30 +75,57 @@ public:
     // Returns the file locator associated to this reader
     virtual string get_locator() = 0;
 
+    //direct access to the buffer, for readers having one
+    inline bool is_buffered() const { return m_pStart != nullptr; }
+    inline char next_buffered_char()
+    {
+        if (m_pNext < m_pEnd)
+            return *m_pNext++;
+        m_fPastEnd = true;
+        return char(EOF);
+    }
+    inline void repeat_buffered_char()
+    {
+        if (m_fPastEnd)
+            m_fPastEnd = false;
+        else if (m_pNext > m_pStart)
+            --m_pNext;
+    }
+    inline bool buffer_exhausted() const { return m_pNext >= m_pEnd; }
+
+protected:
+    void set_buffer(const std::string& text);
+
 };
 
 
 //---------------------------------------------------------------------------------------
-// LdpFileReader: An LDP reader using a file as origin of source code
+// LdpFileReader: An LDP reader using a file as origin of source code.
+// The whole file is loaded in memory when the reader is created. Line numbers are
+// computed on demand by counting line feeds since the last requested position.
 class LdpFileReader : public LdpReader
 {
 private:
-    InputStream* m_file;
     const std::string m_locator;
-    int m_numLine;
-    bool m_repeating_last_char;
+    std::string m_text;
+    bool m_fReady;
+    const char* m_pLineCount;   //position up to which lines have been counted
+    int m_numLine;              //line number at m_pLineCount
 
 public:
     LdpFileReader(const std::string& locator);
-    virtual ~LdpFileReader();
+    virtual ~LdpFileReader() {}
 
     virtual char get_next_char();
     virtual void repeat_last_char();
     virtual bool is_ready();
     virtual bool end_of_data();
-    virtual int get_line_number() { return m_numLine; }
+    virtual int get_line_number();
     virtual string get_locator() { return m_locator; }
 
+protected:
+    void load_file();
+
 };
 
 
@@ -108,7 +145,7 @@ public:
     virtual string get_locator() { return "string:"; }
 
 private:
-    stringstream   m_stream;
+    std::string m_text;
 
 };
 
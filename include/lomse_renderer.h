@@ -54,6 +54,8 @@
 
 #include "agg_rounded_rect.h"
 
+#include <thread>
+#include <vector>
 
 namespace lomse
 {
@@ -84,6 +86,129 @@ typedef agg::pixfmt_abgr64      PixFormat_abgr64;
 typedef agg::pixfmt_bgra64      PixFormat_bgra64;
 
 
+//---------------------------------------------------------------------------------------
+// Helpers for rendering the stored paths in parallel, split in horizontal bands.
+// Each band uses its own rasterizer, fed only with the lines touching the band rows.
+// As the cells for a row are only generated by the lines crossing that row, band
+// pixels are identical to the pixels obtained when rendering the whole buffer.
+//---------------------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------------------
+// PathReader: vertex source for reading the stored paths. The PathStorage iterator
+// can not be shared by several threads. Therefore, each band uses its own reader.
+class PathReader
+{
+protected:
+    const PathStorage& m_path;
+    unsigned m_iterator;
+
+public:
+    PathReader(const PathStorage& path) : m_path(path), m_iterator(0) {}
+
+    inline void rewind(unsigned path_id) { m_iterator = path_id; }
+    inline unsigned vertex(double* x, double* y)
+    {
+        if (m_iterator >= m_path.total_vertices())
+            return agg::path_cmd_stop;
+        return m_path.vertex(m_iterator++, x, y);
+    }
+};
+
+//---------------------------------------------------------------------------------------
+// PathsPipeline: the converters for rendering the stored paths. They keep state while
+// processing a path, so each band needs its own pipeline.
+template <typename VertexSource>
+struct PathsPipeline
+{
+    typedef conv_curve<VertexSource>        Curved;
+    typedef conv_stroke<Curved>             CurvedStroked;
+    typedef conv_transform<CurvedStroked>   CurvedStrokedTrans;
+    typedef conv_transform<Curved>          CurvedTrans;
+    typedef conv_contour<CurvedTrans>       CurvedTransContour;
+
+    TransAffine         transform;
+    Curved              curved;
+    CurvedStroked       curved_stroked;
+    CurvedStrokedTrans  curved_stroked_trans;
+    CurvedTrans         curved_trans;
+    CurvedTransContour  curved_trans_contour;
+
+    PathsPipeline(VertexSource& source)
+        : transform()
+        , curved(source)
+        , curved_stroked(curved)
+        , curved_stroked_trans(curved_stroked, transform)
+        , curved_trans(curved, transform)
+        , curved_trans_contour(curved_trans)
+    {
+    }
+};
+
+//---------------------------------------------------------------------------------------
+// BandLinesFilter: forwards to the cells rasterizer only the lines touching the band
+template <typename Cells>
+class BandLinesFilter
+{
+protected:
+    Cells& m_cells;
+    int m_y1;           //first band row (pixels)
+    int m_y2;           //last band row (pixels)
+
+public:
+    BandLinesFilter(Cells& cells, int y1, int y2)
+        : m_cells(cells), m_y1(y1), m_y2(y2)
+    {
+    }
+
+    inline void line(int x1, int y1, int x2, int y2)
+    {
+        int yMin = (y1 < y2 ? y1 : y2) >> agg::poly_subpixel_shift;
+        int yMax = (y1 < y2 ? y2 : y1) >> agg::poly_subpixel_shift;
+        if (yMax >= m_y1 && yMin <= m_y2)
+            m_cells.line(x1, y1, x2, y2);
+    }
+};
+
+//---------------------------------------------------------------------------------------
+// BandClipper: clipping policy for agg::rasterizer_scanline_aa. Lines are clipped as
+// when rendering the whole buffer and then filtered by band.
+// AWARE: agg::rasterizer_scanline_aa does not give access to its clipper. Therefore,
+// the band is stored per thread, and must be set before adding paths to the rasterizer
+class BandClipper
+{
+public:
+    typedef agg::ras_conv_int   conv_type;
+    typedef int                 coord_type;
+
+protected:
+    agg::rasterizer_sl_clip_int m_clipper;
+    int m_y1;
+    int m_y2;
+
+    static thread_local int m_bandY1;
+    static thread_local int m_bandY2;
+
+public:
+    BandClipper() : m_clipper(), m_y1(m_bandY1), m_y2(m_bandY2) {}
+
+    static inline void set_band(int y1, int y2) { m_bandY1 = y1; m_bandY2 = y2; }
+    inline void reset_clipping() { m_clipper.reset_clipping(); }
+    inline void clip_box(coord_type x1, coord_type y1, coord_type x2, coord_type y2) {
+        m_clipper.clip_box(x1, y1, x2, y2);
+    }
+    inline void move_to(coord_type x1, coord_type y1) { m_clipper.move_to(x1, y1); }
+
+    template <typename Cells>
+    inline void line_to(Cells& cells, coord_type x2, coord_type y2)
+    {
+        BandLinesFilter<Cells> filter(cells, m_y1, m_y2);
+        m_clipper.line_to(filter, x2, y2);
+    }
+};
+
+typedef agg::rasterizer_scanline_aa<BandClipper>    BandRasterizer;
+
+
 //---------------------------------------------------------------------------------------
 class Renderer
 {
@@ -102,6 +227,8 @@ protected:
     double m_vxOrg;             //current viewport origin (pixels)
     double m_vyOrg;
 
+    int m_numThreads;           //for rendering paths in bands. 0: one per core
+
     TransAffine m_transform;    //specific transform for paths
     TransAffine m_mtx;          //global transform
 
@@ -142,6 +269,9 @@ public:
 
     virtual void get_bounding_rect(double* x1, double* y1, double* x2, double* y2) = 0;
 
+    //size of a pixel in the rendering buffer, as defined by the pixel format
+    virtual unsigned bytes_per_pixel() = 0;
+
     inline void set_viewport(Pixels x, Pixels y)
     {
         m_vxOrg = double(x);
@@ -159,8 +289,12 @@ public:
     inline TransAffine& get_transform() { return m_mtx; }
     void set_transform(TransAffine& transform);
 
+    inline void set_rendering_threads(int numThreads) { m_numThreads = numThreads; }
+    inline int get_rendering_threads() { return m_numThreads; }
+
 protected:
     TransAffine& set_transformation();
+    int determine_number_of_bands(int height);
 
     //void clear_all(Color c);
     void reset();
@@ -203,11 +337,7 @@ protected:
     RendererSolid           m_renSolid;     //solid renderer associated to m_rbuf
     RendererBasePre         m_renBasePre;
 
-    CurvedConverter         m_curved;
-    CurvedStroked           m_curved_stroked;
-    CurvedStrokedTrans      m_curved_stroked_trans;
-    CurvedTrans             m_curved_trans;
-    CurvedTransContour      m_curved_trans_contour;
+    PathsPipeline<PathStorage>  m_pipeline;     //converters for serial rendering
 
 public:
     RendererTemplate(double ppi, AttrStorage& attr_storage, PathStorage& path)
@@ -219,11 +349,7 @@ public:
         , m_renSolid(m_renBase)     //attach the base renderer (and the buffer)
         , m_renBasePre(m_pixFormatPre)
 
-        , m_curved(m_path)
-        , m_curved_stroked(m_curved)
-        , m_curved_stroked_trans(m_curved_stroked, m_transform)
-        , m_curved_trans(m_curved, m_transform)
-        , m_curved_trans_contour(m_curved_trans)
+        , m_pipeline(m_path)
     {
     }
 
@@ -245,12 +371,6 @@ public:
     //-----------------------------------------------------------------------------------
     void render()
     {
-        agg::rasterizer_scanline_aa<> ras;
-        agg::scanline_p8 sl;
-
-        //set gamma
-        ras.gamma(agg::gamma_power(m_gamma));
-
         //set affine transformation (rotation, scale, translation, skew)
         set_transformation();
 
@@ -260,7 +380,17 @@ public:
         //do renderization. Method doing renderization is a template member, so that
         //it can be created for different Renderer types.
         double alpha = 1.0;
-        render(ras, sl, m_renSolid, m_mtx, m_renBase.clip_box(), alpha);
+        const AggRectInt& clipBox = m_renBase.clip_box();
+        int numBands = determine_number_of_bands(clipBox.y2 - clipBox.y1 + 1);
+        if (numBands > 1)
+            render_in_bands(numBands, alpha);
+        else
+        {
+            agg::rasterizer_scanline_aa<> ras;
+            agg::scanline_p8 sl;
+            ras.gamma(agg::gamma_power(m_gamma));
+            render(m_pipeline, ras, sl, m_renBase, m_renSolid, m_mtx, clipBox, alpha);
+        }
 
         ////////render controls
         //////ras.gamma(agg::gamma_none());
@@ -303,7 +433,7 @@ public:
 
     //-----------------------------------------------------------------------------------
     // Expand all polygons
-    void expand(double value) { m_curved_trans_contour.width(value); }
+    void expand(double value) { m_pipeline.curved_trans_contour.width(value); }
 
     //-----------------------------------------------------------------------------------
     void get_bounding_rect(double* x1, double* y1, double* x2, double* y2)
@@ -312,6 +442,9 @@ public:
         agg::bounding_rect(trans, *this, 0, m_attr_storage.size(), x1, y1, x2, y2);
     }
 
+    //-----------------------------------------------------------------------------------
+    unsigned bytes_per_pixel() { return unsigned(PixFormat::pix_width); }
+
     //-----------------------------------------------------------------------------------
     void copy_from(RenderingBuffer& bmap, const AggRectInt* srcRect, int xDest, int yDest)
     {
@@ -352,13 +485,65 @@ public:
 
 protected:
 
+    //-----------------------------------------------------------------------------------
+    void render_in_bands(int numBands, double alpha)
+    {
+        //Split the buffer in horizontal bands and render each band in its own thread.
+        //The current thread renders the first band.
+
+        const AggRectInt& clipBox = m_renBase.clip_box();
+        int height = clipBox.y2 - clipBox.y1 + 1;
+
+        vector<std::thread> workers;
+        workers.reserve(numBands - 1);
+        for (int i=1; i < numBands; ++i)
+        {
+            int y1 = clipBox.y1 + (height * i) / numBands;
+            int y2 = clipBox.y1 + (height * (i + 1)) / numBands - 1;
+            workers.push_back( std::thread(&RendererTemplate::render_band, this,
+                                           y1, y2, alpha) );
+        }
+        render_band(clipBox.y1, clipBox.y1 + height / numBands - 1, alpha);
+
+        for (std::thread& worker : workers)
+            worker.join();
+    }
+
+    //-----------------------------------------------------------------------------------
+    void render_band(int y1, int y2, double alpha)
+    {
+        //Renders the stored paths but only paints rows y1 to y2. The paths storage and
+        //its attributes are shared but not modified; all other objects are owned by
+        //the band.
+
+        PathReader reader(m_path);
+        PathsPipeline<PathReader> pipeline(reader);
+        pipeline.curved_trans_contour.width(m_pipeline.curved_trans_contour.width());
+
+        const AggRectInt& clipBox = m_renBase.clip_box();
+        PixFormat pixFormat(m_rbuf);
+        RendererBase renBase(pixFormat);
+        renBase.clip_box(clipBox.x1, y1, clipBox.x2, y2);
+        RendererSolid renSolid(renBase);
+
+        //the rasterizer is clipped as for the whole buffer, and then filtered by band
+        BandClipper::set_band(y1, y2);
+        BandRasterizer ras;
+        ras.gamma(agg::gamma_power(m_gamma));
+        agg::scanline_p8 sl;
+
+        render(pipeline, ras, sl, renBase, renSolid, m_mtx, clipBox, alpha);
+    }
+
     //-----------------------------------------------------------------------------------
     // Rendering. You can specify two additional parameters:
     // trans_affine and opacity. They can be used to transform the whole
     // image and/or to make it translucent.
-    template<class Rasterizer, class Scanline, class Renderer>
-    void render(Rasterizer& ras,
+    template<class Pipeline, class Rasterizer, class Scanline, class Renderer>
+    void render(Pipeline& pipe,
+                Rasterizer& ras,
                 Scanline& sl,
+                RendererBase& renBase,
                 Renderer& ren,
                 const TransAffine& mtx,
                 const AggRectInt& clipBox,
@@ -366,17 +551,22 @@ protected:
     {
         unsigned i;
 
-        ras.clip_box(clipBox.x1, clipBox.y1, clipBox.x2, clipBox.y2);
+        //AWARE: clipping the paths changes the antialiasing of the pixels next to the
+        //clipping border. Paths are clipped a few pixels outside the rendering area,
+        //so that pixels do not depend on the buffer limits, as when rendering tiles
+        const int margin = 4;
+        ras.clip_box(clipBox.x1 - margin, clipBox.y1 - margin,
+                     clipBox.x2 + margin, clipBox.y2 + margin);
 
         for(i = 0; i < m_attr_storage.size(); i++)
         {
             const PathAttributes& attr = m_attr_storage[i];
-            m_transform = attr.transform;
-            m_transform *= mtx;
-            double scl = m_transform.scale();
-            //m_curved.approximation_method(curve_inc);
-            m_curved.approximation_scale(scl);
-            m_curved.angle_tolerance(0.0);
+            pipe.transform = attr.transform;
+            pipe.transform *= mtx;
+            double scl = pipe.transform.scale();
+            //pipe.curved.approximation_method(curve_inc);
+            pipe.curved.approximation_scale(scl);
+            pipe.curved.angle_tolerance(0.0);
 
             rgba8 color;
 
@@ -384,14 +574,14 @@ protected:
             {
                 ras.reset();
                 ras.filling_rule(attr.even_odd_flag ? fill_even_odd : fill_non_zero);
-                if(fabs(m_curved_trans_contour.width()) < 0.0001)
+                if(fabs(pipe.curved_trans_contour.width()) < 0.0001)
                 {
-                    ras.add_path(m_curved_trans, attr.path_index);
+                    ras.add_path(pipe.curved_trans, attr.path_index);
                 }
                 else
                 {
-                    m_curved_trans_contour.miter_limit(attr.miter_limit);
-                    ras.add_path(m_curved_trans_contour, attr.path_index);
+                    pipe.curved_trans_contour.miter_limit(attr.miter_limit);
+                    ras.add_path(pipe.curved_trans_contour, attr.path_index);
                 }
 
                 color = to_rgba(attr.fill_color);
@@ -404,21 +594,21 @@ protected:
             {
                 ras.reset();
                 ras.filling_rule(attr.even_odd_flag ? fill_even_odd : fill_non_zero);
-                if(fabs(m_curved_trans_contour.width()) < 0.0001)
+                if(fabs(pipe.curved_trans_contour.width()) < 0.0001)
                 {
-                    ras.add_path(m_curved_trans, attr.path_index);
+                    ras.add_path(pipe.curved_trans, attr.path_index);
                 }
                 else
                 {
-                    m_curved_trans_contour.miter_limit(attr.miter_limit);
-                    ras.add_path(m_curved_trans_contour, attr.path_index);
+                    pipe.curved_trans_contour.miter_limit(attr.miter_limit);
+                    ras.add_path(pipe.curved_trans_contour, attr.path_index);
                 }
 
                 //TODO apply 'opacity' received param to gradient colors
                 //------------------------------------
                 //define a linear interpolator, to interpolate colors
                 TransAffine mtx = attr.fill_gradient->transform;
-                mtx *= m_transform;
+                mtx *= pipe.transform;
                 mtx.invert();
                 agg::span_interpolator_linear<> interpolator(mtx);
 
@@ -443,7 +633,7 @@ protected:
                                                   SpanAllocatorType,
                                                   LinearGradientSpan> RendererLinearGradient;
 
-                RendererLinearGradient renderer(m_renBase, spanAllocator, span);
+                RendererLinearGradient renderer(renBase, spanAllocator, span);
 
                 //procceed to render using defined renderer
                 agg::render_scanlines(ras, sl, renderer);
@@ -451,24 +641,24 @@ protected:
 
             if(attr.stroke_flag)
             {
-                m_curved_stroked.width(attr.stroke_width);
-                //m_curved_stroked.line_join((attr.line_join == miter_join) ? miter_join_round : attr.line_join);
-                m_curved_stroked.line_join(attr.line_join);
-                m_curved_stroked.line_cap(attr.line_cap);
-                m_curved_stroked.miter_limit(attr.miter_limit);
-                m_curved_stroked.inner_join(inner_round);
-                m_curved_stroked.approximation_scale(scl);
+                pipe.curved_stroked.width(attr.stroke_width);
+                //pipe.curved_stroked.line_join((attr.line_join == miter_join) ? miter_join_round : attr.line_join);
+                pipe.curved_stroked.line_join(attr.line_join);
+                pipe.curved_stroked.line_cap(attr.line_cap);
+                pipe.curved_stroked.miter_limit(attr.miter_limit);
+                pipe.curved_stroked.inner_join(inner_round);
+                pipe.curved_stroked.approximation_scale(scl);
 
                 // If the *visual* line width is considerable we
                 // turn on processing of curve cusps.
                 //---------------------
                 if(attr.stroke_width * scl > 1.0)
                 {
-                    m_curved.angle_tolerance(0.2);
+                    pipe.curved.angle_tolerance(0.2);
                 }
                 ras.reset();
                 ras.filling_rule(fill_non_zero);
-                ras.add_path(m_curved_stroked_trans, attr.path_index);
+                ras.add_path(pipe.curved_stroked_trans, attr.path_index);
                 color = to_rgba(attr.stroke_color);
                 color.opacity(color.opacity() * opacity);
                 ren.color(color);
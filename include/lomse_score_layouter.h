@@ -197,6 +197,7 @@ public:
     void delete_not_used_objects();
     void trace_column(int iCol, int level);
     ColumnData* get_column(int i);
+    inline SpacingAlgorithm* get_spacing_algorithm() { return m_pSpAlgorithm; }
 
 protected:
     void add_error_message(const string& msg);
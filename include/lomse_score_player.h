@@ -31,10 +31,13 @@
 #define __LOMSE_SCORE_PLAYER_H__
 
 #include "lomse_basic.h"
+#include "lomse_events.h"
 
 
 #include <vector>
 #include <thread>
+#include <chrono>
+#include <mutex>
 #include <condition_variable>
 
 ///@cond INTERNALS
@@ -65,6 +68,71 @@ typedef std::thread SoundThread;
 typedef std::condition_variable SoundFlag;
 
 
+//---------------------------------------------------------------------------------------
+/** %PlaybackTimingStats contains statistics about the accuracy of the playback
+    scheduler, that is, how late the sound events were delivered to the
+    MidiServerBase object with respect to the time at which they should have been
+    delivered. Statistics are reset when a new playback starts and can be read at
+    any moment, even while playing, by invoking ScorePlayer::get_timing_stats().
+
+    All times are expressed in microseconds.
+*/
+struct PlaybackTimingStats
+{
+    long numEvents;         ///< Number of scheduled deadlines reached so far
+    long numLateEvents;     ///< Number of deadlines missed by more than one millisecond
+    double meanLateness;    ///< Mean delay with respect to the scheduled time
+    double maxLateness;     ///< Maximum delay with respect to the scheduled time
+    double jitter;          ///< Standard deviation of the delay
+
+    PlaybackTimingStats()
+        : numEvents(0L), numLateEvents(0L), meanLateness(0.0), maxLateness(0.0)
+        , jitter(0.0)
+    {
+    }
+};
+
+///@cond INTERNALS
+//---------------------------------------------------------------------------------------
+// PlaybackScheduler: helper for ScorePlayer. It converts score times (milliseconds
+// from the start of the score, with sub-millisecond resolution) into absolute
+// deadlines on a monotonic clock, so that errors in a wait are not accumulated in
+// the next ones. It also collects lateness statistics.
+class PlaybackScheduler
+{
+protected:
+    typedef std::chrono::steady_clock Clock;
+
+    Clock::time_point   m_origin;       //wall time for score time 0
+    Clock::time_point   m_suspendTime;  //wall time when playback was paused
+    std::mutex          m_statsMutex;   //statistics are read from other threads
+
+    //statistics
+    long    m_numEvents;
+    long    m_numLateEvents;
+    double  m_sumLateness;
+    double  m_sumSquaredLateness;
+    double  m_maxLateness;
+
+public:
+    PlaybackScheduler();
+
+    void start(double scoreTime);
+    void wait_until(double scoreTime);
+    void rebase(double oldScoreTime, double newScoreTime);
+    void suspend();
+    void resume();
+
+    void reset_stats();
+    PlaybackTimingStats get_stats();
+
+protected:
+    Clock::time_point deadline_for(double scoreTime);
+    void add_lateness(double microseconds);
+};
+///@endcond
+
+
 //---------------------------------------------------------------------------------------
 /** Class %MidiServerBase is a base class defining the interface for any class
     that would like to process the requests from ScorePlayer to generate
@@ -181,6 +249,7 @@ protected:
     ImoScore*           m_pScore;       //score to play
     SoundEventsTable*   m_pTable;
     SoundFlag           m_canPlay;      //playback is not paused
+    PlaybackScheduler   m_scheduler;    //absolute deadlines for sound events
 
     //metronome: MIDI parameters
     int m_MtrChannel;
@@ -324,6 +393,11 @@ public:
     */
     inline bool is_playing() { return m_fPlaying; }
 
+    /** Returns statistics about the timing accuracy of the current playback or, if
+        not playing, of the last finished playback. See PlaybackTimingStats.
+    */
+    inline PlaybackTimingStats get_timing_stats() { return m_scheduler.get_stats(); }
+
 
 ///@cond INTERNALS
 //excluded from public API. Only for internal use.
@@ -343,13 +417,14 @@ protected:
                      Interactor* pInteractor);
     void end_of_playback_housekeeping(bool fVisualTracking, Interactor* pInteractor);
     void set_new_beat_information(SoundEvent* pEvent);
+    void send_event(SpEventInfo pEvent, Interactor* pInteractor);
 
     //helper, for do_play()
     //-----------------------------------------------------------------------------------
     long m_nMtrPulseDuration;       //a beat duration, in Time Units
     int m_beatType;                 //beat definition to use
     TimeUnits m_beatDuration;       //for no time signature or beatType == k_beat_specified
-    float m_conversionFactor;       //to convert TimeUnits (delta time) to millisecs
+    double m_conversionFactor;      //to convert TimeUnits (delta time) to millisecs
     long m_nPrevMeasureDuration;    //previous TS: measure duration, in TU
     long m_nCurMeasureDuration;     //current TS: measure duration, in TU
     long m_nPrevNumPulses;          //previous TS: number of metronome pulses per measure                                            //assume 4/4 time signature
@@ -358,8 +433,8 @@ protected:
     long m_nCurMtrIntval;           //current TS: metronome click interval, in milliseconds
     long m_prevGuiBpm;              //last known value of metronome setting in GUI
 
-    inline long time_units_to_milliseconds(long deltaTime) {
-        return long( float(deltaTime) * m_conversionFactor );
+    inline double time_units_to_milliseconds(long deltaTime) {
+        return double(deltaTime) * m_conversionFactor;
     }
 
 
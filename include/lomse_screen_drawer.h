@@ -207,6 +207,7 @@ public:
     //units conversion
     LUnits Pixels_to_LUnits(Pixels value);
     Pixels LUnits_to_Pixels(double value);
+    unsigned bytes_per_pixel();
 
     // settings
     //-----------------------
@@ -54,7 +54,6 @@ class GmoShapeBeam;
 class GmoShapeNote : public GmoCompositeShape, public VoiceRelatedShape
 {
 protected:
-    FontStorage* m_pFontStorage;
     LibraryScope& m_libraryScope;
     GmoShapeNotehead* m_pNoteheadShape;
 	GmoShapeStem* m_pStemShape;
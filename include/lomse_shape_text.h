@@ -52,7 +52,6 @@ protected:
     string m_text;
     string m_language;
     ImoStyle* m_pStyle;
-    FontStorage* m_pFontStorage;
     LibraryScope& m_libraryScope;
 
     friend class TextEngraver;
@@ -82,7 +81,6 @@ protected:
     const wstring m_text;
     const string m_language;
     ImoStyle* m_pStyle;
-    FontStorage* m_pFontStorage;
     LibraryScope& m_libraryScope;
     LUnits m_halfLeading;
     LUnits m_baseline;          //relative to m_origin.y
@@ -119,7 +117,6 @@ protected:
     string m_text;
     string m_language;
     ImoStyle* m_pStyle;
-    FontStorage* m_pFontStorage;
     LibraryScope& m_libraryScope;
 
     friend class MeasureNumberEngraver;
@@ -49,7 +49,6 @@ class GmoShapeGlyph : public GmoSimpleShape
 protected:
     unsigned int m_glyph;
     USize m_shiftToDraw;
-    FontStorage* m_pFontStorage;
     LibraryScope& m_libraryScope;
     double m_fontHeight;
 
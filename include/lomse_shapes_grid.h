@@ -0,0 +1,85 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the Lomse library.
+// Lomse is copyrighted work (c) 2010-2016. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice, this
+//      list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright notice, this
+//      list of conditions and the following disclaimer in the documentation and/or
+//      other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+// TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+// BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+// ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+// For any comment, suggestion or feature request, please contact the manager of
+// the project at cecilios@users.sourceforge.net
+//---------------------------------------------------------------------------------------
+
+#ifndef __LOMSE_SHAPES_GRID_H__        //to avoid nested includes
+#define __LOMSE_SHAPES_GRID_H__
+
+#include "lomse_basic.h"
+#include <vector>
+using namespace std;
+
+namespace lomse
+{
+
+//forward declarations
+class GmoShape;
+
+
+//---------------------------------------------------------------------------------------
+// ShapesGrid: spatial index for the shapes in a page.
+// The area covered by the shapes is split into a uniform grid of cells. Each cell
+// keeps the indexes of the shapes whose bounds overlap it. Shapes are indexed in
+// the order received (layer and creation order) so that the top most shape is the
+// last one in each cell.
+class ShapesGrid
+{
+protected:
+    std::vector<GmoShape*> m_shapes;
+    std::vector< std::vector<int> > m_cells;
+    URect m_area;           //area covered by the grid
+    int m_numCols;
+    int m_numRows;
+    LUnits m_cellWidth;
+    LUnits m_cellHeight;
+
+public:
+    ShapesGrid();
+    ~ShapesGrid() {}
+
+    void build(const std::vector<GmoShape*>& shapes);
+    void clear();
+
+    //queries
+    GmoShape* find_shape_at(LUnits x, LUnits y);
+    void find_shapes_in_rectangle(const URect& rect, std::vector<GmoShape*>* pFound);
+
+    //info
+    inline int get_num_shapes() { return int(m_shapes.size()); }
+    inline int get_num_cells() { return int(m_cells.size()); }
+
+protected:
+    int col_for(LUnits x);
+    int row_for(LUnits y);
+
+};
+
+
+}   //namespace lomse
+
+#endif    // __LOMSE_SHAPES_GRID_H__
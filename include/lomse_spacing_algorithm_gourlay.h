@@ -103,6 +103,16 @@ protected:
     float  m_dmin;      //min note duration for which fixed spacing will be used
     float  m_log2dmin;  //precomputed value for log2(dmin)
     float  m_Fopt;      //Optimum force (user defined and dependent on personal taste)
+    bool   m_fSpringsReady; //springs computed and slices ordered for all columns
+
+    //merged data for columns [m_iMergedFirst, m_iMergedLast], so that the penalty for
+    //line [i, j] is computed by adding column j to the data for line [i, j-1]
+    int    m_iMergedFirst;
+    int    m_iMergedLast;
+    float  m_mergedSlope;
+    LUnits m_mergedFixed;
+    LUnits m_mergedMinWidth;
+    long   m_numMergedColumns;  //statistics, for performance tests
 
 public:
     SpAlgGourlay(LibraryScope& libraryScope, ScoreMeter* pScoreMeter,
@@ -120,6 +130,7 @@ public:
     float determine_penalty_for_line(int iSystem, int i, int j);
     bool is_better_option(float prevPenalty, float newPenalty, float nextPenalty,
                           int i, int j);
+    inline long get_num_merged_columns() { return m_numMergedColumns; }
 
     //information about a column
     bool is_empty_column(int iCol);
@@ -155,6 +166,7 @@ protected:
     void apply_force(float F);
     void determine_spacing_parameters();
     bool accept_for_prolog_slice(ColStaffObjsEntry* pEntry);
+    void merge_columns(int iFirstCol, int iLastCol);
 
 };
 
@@ -33,6 +33,7 @@
 #include <vector>
 #include <ostream>
 #include <map>
+#include <unordered_map>
 #include "lomse_document.h"
 #include "lomse_time.h"
 
@@ -66,17 +67,25 @@ protected:
     int                 m_line;
     int                 m_staff;
     ImoStaffObj*        m_pImo;
+    int                 m_index;    //position in the table
+    int                 m_order;    //creation order, within the instrument
+    TimeUnits           m_noteDuration; //duration taken into account for the min.
+                                        //note duration, or 0.0 if none
 
     ColStaffObjsEntry*  m_pNext;    //next entry in the collection
     ColStaffObjsEntry*  m_pPrev;    //prev. entry in the collection
 
 public:
-    ColStaffObjsEntry(int measure, int instr, int line, int staff, ImoStaffObj* pImo)
+    ColStaffObjsEntry(int measure, int instr, int line, int staff, ImoStaffObj* pImo,
+                      int order=0)
         : m_measure(measure)
         , m_instr(instr)
         , m_line(line)
         , m_staff(staff)
         , m_pImo(pImo)
+        , m_index(-1)
+        , m_order(order)
+        , m_noteDuration(0.0)
         , m_pNext(nullptr)
         , m_pPrev(nullptr)
     {
@@ -91,6 +100,8 @@ public:
     inline ImoStaffObj* imo_object() const { return m_pImo; }
     inline long element_id() { return m_pImo->get_id(); }
     inline TimeUnits duration() const { return m_pImo->get_duration(); }
+    inline int order() const { return m_order; }
+    inline TimeUnits note_duration() const { return m_noteDuration; }
 
     //setters
     inline void decrement_time(TimeUnits timeShift) {
@@ -108,10 +119,31 @@ public:
 
 protected:
     friend class ColStaffObjs;
+    inline int index() const { return m_index; }
+    inline void set_index(int i) { m_index = i; }
     inline void set_next(ColStaffObjsEntry* pEntry) { m_pNext = pEntry; }
     inline void set_prev(ColStaffObjsEntry* pEntry) { m_pPrev = pEntry; }
 
+    friend class ColStaffObjsBuilder;
+    friend class ColStaffObjsBuilderEngine;
+    inline void set_measure(int measure) { m_measure = measure; }
+    inline void set_order(int order) { m_order = order; }
+    inline void set_note_duration(TimeUnits duration) { m_noteDuration = duration; }
+
+};
+
+
+//---------------------------------------------------------------------------------------
+// StaffVoiceLine: first request of a line for a voice and staff, when building
+// the ColStaffObjs table. Lines are assigned in order of first request.
+//---------------------------------------------------------------------------------------
+struct StaffVoiceLine
+{
+    int order;      //creation order of the entry requesting the line
+    int voice;
+    int staff;
 
+    StaffVoiceLine(int o, int v, int s) : order(o), voice(v), staff(s) {}
 };
 
 
@@ -132,6 +164,38 @@ protected:
     ColStaffObjsEntry* m_pFirst;
     ColStaffObjsEntry* m_pLast;
 
+    //Entries are linked in a list, so that pointers to entries remain valid
+    //while the table is modified. For fast access they are also indexed:
+    // - m_entryForImo: entry for each staffobj. Always up to date.
+    // - m_entries: entries in table order. Rebuilt, when needed, after any change
+    //   in the table. m_maxNoteDuration is also updated at that moment.
+    // - m_barlines, m_timeSignatures: for each instrument, entries for its barlines
+    //   and time signatures, in table order. m_firstInStaff: for each instrument
+    //   and staff, the first entry in that staff. Rebuilt together with m_entries.
+    std::unordered_map<ImoStaffObj*, ColStaffObjsEntry*> m_entryForImo;
+    std::vector<ColStaffObjsEntry*> m_entries;
+    std::vector< std::vector<ColStaffObjsEntry*> > m_barlines;
+    std::vector< std::vector<ColStaffObjsEntry*> > m_timeSignatures;
+    std::vector< std::vector<ColStaffObjsEntry*> > m_firstInStaff;
+    bool m_fIndexValid;
+    TimeUnits m_maxNoteDuration;
+
+    //Information saved when building the table, to allow updating only the entries
+    //for one instrument (see ColStaffObjsBuilder::update())
+    struct InstrumentData
+    {
+        int firstLine;
+        int lastLine;
+        TimeUnits minNoteDuration;
+        std::vector<StaffVoiceLine> lineRequests;   //in creation order
+        std::map<TimeUnits, int> noteDurations;     //number of entries for each
+                                                    //note duration
+
+        InstrumentData(int first, int last, TimeUnits minNote)
+            : firstLine(first), lastLine(last), minNoteDuration(minNote) {}
+    };
+    std::vector<InstrumentData> m_instrData;
+
 public:
     ColStaffObjs();
     ~ColStaffObjs();
@@ -142,9 +206,11 @@ public:
     inline bool is_anacrusis_start() { return is_greater_time(m_rMissingTime, 0.0); }
     inline TimeUnits anacrusis_missing_time() { return m_rMissingTime; }
     inline TimeUnits min_note_duration() { return m_minNoteDuration; }
+    TimeUnits max_note_duration();
 
     //table management
-    void add_entry(int measure, int instr, int voice, int staff, ImoStaffObj* pImo);
+    ColStaffObjsEntry* add_entry(int measure, int instr, int voice, int staff,
+                                 ImoStaffObj* pImo, int order=0);
     void delete_entry_for(ImoStaffObj* pSO);
 
     //iterator related
@@ -224,6 +290,19 @@ public:
     inline ColStaffObjsEntry* back() { return m_pLast; }
     inline ColStaffObjsEntry* front() { return m_pFirst; }
     inline iterator find(ImoStaffObj* pSO) { return iterator(find_entry_for(pSO)); }
+    iterator find_first(ImoStaffObj* pSO);
+    iterator find_first_at_or_after(TimeUnits time);
+
+    //indexed search in one instrument. In the find_xxx_before() methods,
+    //pEntry==nullptr means 'after last entry'
+    iterator find_barline_for_measure(int instr, int measure);
+    iterator find_first_in_staff(int instr, int staff);
+    ColStaffObjsEntry* find_barline_before(int instr, ColStaffObjsEntry* pEntry);
+    ColStaffObjsEntry* find_time_signature_before(int instr, ColStaffObjsEntry* pEntry);
+
+    //random access
+    ColStaffObjsEntry* get_entry(int i);    //i = 0..num_entries()-1
+    int get_index_of(ColStaffObjsEntry* pEntry);
 
     //debug
     string dump(bool fWithIds=true);
@@ -243,6 +322,18 @@ protected:
 
     void add_entry_to_list(ColStaffObjsEntry* pEntry);
     ColStaffObjsEntry* find_entry_for(ImoStaffObj* pSO);
+    inline void invalidate_index() { m_fIndexValid = false; }
+    void update_index();
+    ColStaffObjsEntry* find_last_before(std::vector<ColStaffObjsEntry*>& entries,
+                                        ColStaffObjsEntry* pEntry);
+
+    //support for incremental updates
+    void unlink_entry(ColStaffObjsEntry* pEntry);
+    void insert_entries_after(ColStaffObjsEntry* pPrev,
+                              std::vector<ColStaffObjsEntry*>& entries);
+    void reorder_entries_from(ColStaffObjsEntry* pEntry, TimeUnits maxTime);
+    void reorder_group(std::vector<ColStaffObjsEntry*>& group);
+    ColStaffObjsEntry* first_with_equal_time(ColStaffObjsEntry* pEntry);
 
 };
 
@@ -264,7 +355,9 @@ public:
 
     int get_line_assigned_to(int nVoice, int nStaff);
     void new_instrument();
+    void new_instrument_at_line(int line);
     inline int get_number_of_lines() { return m_lastAssignedLine; }
+    bool is_assigned(int nVoice, int nStaff);
 
 private:
     int assign_line_to(int nVoice, int nStaff);
@@ -273,6 +366,52 @@ private:
 };
 
 
+//---------------------------------------------------------------------------------------
+// ColStaffObjsChanges: the entries for one instrument replaced when updating a
+// ColStaffObjs table (see ColStaffObjsBuilder::update())
+//---------------------------------------------------------------------------------------
+struct ColStaffObjsChanges
+{
+    ColStaffObjsEntry* pStart;  //barline entry before the replaced entries, or nullptr
+                                //when replaced from the first entry
+    ColStaffObjsEntry* pEnd;    //last replaced entry, or nullptr when replaced up to
+                                //the last entry
+    int firstOrder;             //creation order of new entries: from firstOrder
+    int lastOrder;              //to lastOrder
+
+    ColStaffObjsChanges()
+        : pStart(nullptr), pEnd(nullptr), firstOrder(0), lastOrder(-1)
+    {
+    }
+};
+
+//---------------------------------------------------------------------------------------
+// ColStaffObjsReplay: entries determined again for part of one instrument, and the
+// information needed to replace the old ones (see
+// ColStaffObjsBuilderEngine::replay_entries())
+//---------------------------------------------------------------------------------------
+struct ColStaffObjsReplay
+{
+    std::vector<ColStaffObjsEntry> entries;     //new entries, in creation order
+    std::vector<StaffVoiceLine> lineRequests;   //new line requests
+    ColStaffObjsEntry* pStart;  //barline entry before the replayed staffobjs, or nullptr
+    int startOrder;             //creation order for the first new entry
+    ImoStaffObj* pLast;         //barline after which entries do not change, or
+                                //nullptr when replayed up to the last staffobj
+    int lastOrder;              //old creation order of pLast entry
+    TimeUnits lastTime;         //old time of pLast entry
+    int measureShift;           //change in measure number for entries after pLast
+    int orderShift;             //change in creation order for entries after pLast
+    int lastLine;               //last line used by the instrument
+
+    ColStaffObjsReplay()
+        : pStart(nullptr), startOrder(0), pLast(nullptr), lastOrder(0)
+        , lastTime(0.0), measureShift(0), orderShift(0), lastLine(0)
+    {
+    }
+};
+
+
 //---------------------------------------------------------------------------------------
 // ColStaffObjsBuilder: generic algorithm to create a ColStaffObjs table
 //---------------------------------------------------------------------------------------
@@ -286,8 +425,38 @@ public:
 
     ColStaffObjs* build(ImoScore* pScore);
 
+    /** Updates the table after modifying the music data for only one instrument,
+        instead of building it again. Entries for other instruments are not
+        modified. For the modified instrument, entries are determined again only
+        from the barline before pFirstChanged, the first inserted or modified
+        staffobj, up to the first barline after which entries do not change. Next
+        entries are kept; at most, their measure number and creation order are
+        shifted.
+        When pFirstChanged is nullptr, all entries for the instrument are determined
+        again. If provided, pChanges receives the replaced part of the table.
+
+        If the changes affect other instruments (i.e. the number of lines used by the
+        instrument changes) or the score is LDP 1.x, the table is fully rebuilt.
+        Returns @true if the table has been incrementally updated.
+    */
+    bool update(ImoScore* pScore, int iInstr, ImoStaffObj* pFirstChanged=nullptr,
+                ColStaffObjsChanges* pChanges=nullptr);
+
+    /** Checks that the current table for the score is equal to the table that
+        would be obtained by fully building it again. For tests and debug. */
+    bool verify(ImoScore* pScore);
+
 protected:
     ColStaffObjsBuilderEngine* create_builder_engine(ImoScore* pScore);
+    bool update_entries(ImoScore* pScore, ColStaffObjs* pColStaffObjs, int iInstr,
+                        ImoStaffObj* pFirstChanged, ColStaffObjsChanges* pChanges);
+    void remove_replaced_entries(ColStaffObjs* pColStaffObjs, int iInstr,
+                                 ColStaffObjsReplay& replay);
+    void shift_next_entries(ColStaffObjs* pColStaffObjs, ColStaffObjsReplay& replay);
+    ColStaffObjsEntry* add_new_entries(ColStaffObjs* pColStaffObjs, int iInstr,
+                                       ColStaffObjsReplay& replay);
+    void update_line_requests(ColStaffObjs* pColStaffObjs, int iInstr,
+                              ColStaffObjsReplay& replay);
 };
 
 //---------------------------------------------------------------------------------------
@@ -305,6 +474,16 @@ protected:
     TimeUnits   m_rStartSegmentTime;
     TimeUnits   m_minNoteDuration;
     StaffVoiceLineTable  m_lines;
+    int         m_order;        //creation order for next entry, within the instrument
+    TimeUnits   m_noteDuration; //duration to count for next entry, or 0.0
+
+    //for the instrument being processed: first line requests, and number of entries
+    //for each note duration
+    std::vector<StaffVoiceLine> m_lineRequests;
+    std::map<TimeUnits, int> m_noteDurations;
+
+    //when not null, entries are saved here instead of adding them to the table
+    std::vector<ColStaffObjsEntry>* m_pCollected;
 
     ColStaffObjsBuilderEngine(ImoScore* pScore)
         : m_pColStaffObjs(nullptr)
@@ -313,12 +492,18 @@ protected:
         , m_rMaxSegmentTime(0.0)
         , m_rStartSegmentTime(0.0)
         , m_minNoteDuration(LOMSE_NO_NOTE_DURATION)
+        , m_order(0)
+        , m_noteDuration(0.0)
+        , m_pCollected(nullptr)
     {}
 
 public:
     virtual ~ColStaffObjsBuilderEngine() {}
 
     ColStaffObjs* do_build();
+    virtual bool replay_entries(ColStaffObjs* pColStaffObjs, int iInstr,
+                                ImoStaffObj* pFirstChanged, ColStaffObjsReplay* pReplay);
+    void update_table_info();
 
 protected:
     virtual void initializations()=0;
@@ -328,6 +513,7 @@ protected:
 
     void create_table();
     void collect_anacrusis_info();
+    void add_entry(int measure, int nInstr, int nLine, int nStaff, ImoStaffObj* pSO);
     int get_line_for(int nVoice, int nStaff);
     void set_num_lines();
     void add_entries_for_key_or_time_signature(ImoObj* pImo, int nInstr);
@@ -391,10 +577,18 @@ public:
     }
     virtual ~ColStaffObjsBuilderEngine2x() {}
 
+    bool replay_entries(ColStaffObjs* pColStaffObjs, int iInstr,
+                        ImoStaffObj* pFirstChanged, ColStaffObjsReplay* pReplay);
+
 private:
     void initializations();
     void create_entries(int nInstr);
+    void add_entries_for(ImoObj* pImo, int nInstr);
     void reset_counters();
+    void restart_after(ColStaffObjsEntry* pBarline, ImoObj* pImo,
+                       ColStaffObjs::InstrumentData& data);
+    bool same_line_requests(ColStaffObjs::InstrumentData& data, int startOrder,
+                            int lastOrder);
     void determine_timepos(ImoStaffObj* pSO);
     void update_measure();
     void add_entry_for_staffobj(ImoObj* pImo, int nInstr);
@@ -54,7 +54,6 @@ class TextEngraver : public Engraver
 protected:
     const string& m_text;
     ImoStyle* m_pStyle;
-    FontStorage* m_pFontStorage;
     string m_language;
 
 public:
@@ -73,7 +72,6 @@ class TextBoxEngraver : public Engraver
 protected:
     const string& m_text;
     ImoStyle* m_pStyle;
-    FontStorage* m_pFontStorage;
     string m_language;
 
 public:
@@ -92,7 +90,6 @@ class MeasureNumberEngraver : public Engraver
 protected:
     const string& m_text;
     ImoStyle* m_pStyle;
-    FontStorage* m_pFontStorage;
 
 public:
     MeasureNumberEngraver(LibraryScope& libraryScope, ScoreMeter* pScoreMeter,
@@ -0,0 +1,125 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the Lomse library.
+// Lomse is copyrighted work (c) 2010-2016. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice, this
+//      list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright notice, this
+//      list of conditions and the following disclaimer in the documentation and/or
+//      other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+// TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+// BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+// ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+// For any comment, suggestion or feature request, please contact the manager of
+// the project at cecilios@users.sourceforge.net
+//---------------------------------------------------------------------------------------
+
+#ifndef __LOMSE_TILES_CACHE_H__
+#define __LOMSE_TILES_CACHE_H__
+
+#include "lomse_build_options.h"
+#include "lomse_agg_types.h"
+#include "lomse_basic.h"
+
+#include <list>
+#include <map>
+#include <vector>
+using namespace std;
+
+namespace lomse
+{
+
+//---------------------------------------------------------------------------------------
+// TilesContext: parameters used for rasterizing the tiles. When any of them changes,
+// all tiles in the cache are no longer valid
+struct TilesContext
+{
+    long    modelId;            //graphic model
+    long    modelChanges;       //graphic model modifications counter
+    double  scale;              //view scale
+    unsigned bytesPerPixel;
+    Color   background;
+    unsigned flags;             //rendering options affecting the result
+
+    TilesContext()
+        : modelId(-1L), modelChanges(0L), scale(0.0), bytesPerPixel(0)
+        , background(0, 0, 0), flags(0)
+    {
+    }
+
+    bool operator ==(const TilesContext& c) const
+    {
+        return modelId == c.modelId && modelChanges == c.modelChanges
+               && scale == c.scale && bytesPerPixel == c.bytesPerPixel
+               && background.r == c.background.r && background.g == c.background.g
+               && background.b == c.background.b && background.a == c.background.a
+               && flags == c.flags;
+    }
+    bool operator !=(const TilesContext& c) const { return !(*this == c); }
+};
+
+//=======================================================================================
+// TilesCache
+//  Storage for rasterized fragments (tiles) of the document, so that scrolling
+//  only requires copying pixels. The document, at current scale, is split into
+//  square tiles of fixed size. A tile is identified by its column and row: tile
+//  (col, row) contains the document pixels starting at (col * size, row * size).
+//  Memory is bounded: when full, least recently used tiles are discarded.
+//=======================================================================================
+class TilesCache
+{
+protected:
+    struct Tile
+    {
+        int col;
+        int row;
+        vector<int8u> bytes;
+        RenderingBuffer rbuf;
+    };
+
+    int m_tileSize;                 //in pixels
+    size_t m_maxBytes;              //memory limit
+    size_t m_usedBytes;
+    TilesContext m_context;
+    list<Tile*> m_tiles;            //most recently used first
+    map<pair<int, int>, list<Tile*>::iterator> m_index;
+
+public:
+    TilesCache(size_t maxBytes, int tileSize=256);
+    ~TilesCache();
+
+    //tiles
+    RenderingBuffer* get_tile(int col, int row);
+    RenderingBuffer* add_tile(int col, int row, unsigned bytesPerPixel);
+    void clear();
+
+    //validity
+    void set_context(const TilesContext& context);
+
+    //info
+    inline int get_tile_size() const { return m_tileSize; }
+    inline int num_tiles() const { return int(m_tiles.size()); }
+    inline size_t get_used_memory() const { return m_usedBytes; }
+
+protected:
+    void discard_least_recently_used();
+
+};
+
+
+}   //namespace lomse
+
+#endif      //__LOMSE_TILES_CACHE_H__
@@ -95,6 +95,8 @@ enum ETokenType {
     private:
         LdpToken* parse_new_token();
         char get_next_char();
+        void repeat_last_char();
+        bool end_of_data();
         static bool is_number(char ch);
         static bool is_letter(char ch);
 
@@ -108,6 +110,9 @@ enum ETokenType {
         bool        m_expectingValuePart;
         bool        m_expectingNamePart;
         LdpToken*   m_pTokenNamePart;
+
+        //reader provides a contiguous buffer: scan it without virtual calls
+        bool        m_fBuffered;
     };
 
 
@@ -34,6 +34,8 @@
 #include "lomse_internal_model.h"
 
 #include <string>
+#include <cstring>
+#include <algorithm>
 using namespace std;
 
 #include "pugixml/pugiconfig.hpp"
@@ -45,6 +47,7 @@ namespace lomse
 {
 
 //forward declarations and definitions
+class InputStream;
 typedef pugi::xml_document          XmlDocument;
 typedef pugi::xml_attribute         XmlAttribute;
 
@@ -64,6 +67,7 @@ public:
     XmlNode(const XmlNode* node) : m_node(node->m_node) {}
 
     string name() { return string(m_node.name()); }
+    const char* name_c_str() { return m_node.name(); }
     string value();
     XmlAttribute attribute(const string& name) {
         return m_node.attribute(name.c_str());
@@ -110,6 +114,28 @@ protected:
 
 };
 
+//---------------------------------------------------------------------------------------
+// XmlTagName: entry of a table for converting element names to tag values.
+// Tables must be sorted by name (strcmp order), as lookup is a binary search.
+struct XmlTagName
+{
+    const char* name;
+    int tag;
+};
+
+template <size_t N>
+inline int find_xml_tag(const XmlTagName (&table)[N], const char* name, int notFound)
+{
+    const XmlTagName* it = std::lower_bound(table, table + N, name,
+        [](const XmlTagName& entry, const char* key) {
+            return strcmp(entry.name, key) < 0;
+        });
+
+    if (it != table + N && strcmp(it->name, name) == 0)
+        return it->tag;
+    return notFound;
+}
+
 //---------------------------------------------------------------------------------------
 class XmlParser : public Parser
 {
@@ -130,6 +156,7 @@ public:
     void parse_file(const std::string& filename, bool fErrorMsg = true);
     void parse_text(const std::string& sourceText);
     void parse_cstring(char* sourceText);
+    void parse_stream(InputStream* pStream, long size);
 
     inline const string& get_error() { return m_errorMsg; }
     inline const string& get_encoding() { return m_encoding; }
@@ -138,6 +165,7 @@ public:
 
 protected:
     void parse_char_string(char* string);
+    void parse_buffer_inplace(char* buffer, size_t size);
     void find_root();
     bool build_offset_data(const char* file);
     std::pair<int, int> get_location(ptrdiff_t offset);
@@ -29,6 +29,7 @@
 
 #define LOMSE_INTERNAL_API
 #include "lomse_command.h"
+#include "lomse_command_journal.h"
 #include "lomse_build_options.h"
 
 #include "lomse_document.h"
@@ -70,25 +71,36 @@ void DocCommand::create_checkpoint(Document* pDoc)
     }
 }
 
+//---------------------------------------------------------------------------------------
+void DocCommand::set_checkpoint_target(ImoInstrument* pInstr)
+{
+    //Commands that only modify the content of one instrument only need to save
+    //the instrument music data, instead of the whole score
+
+    m_idChk = pInstr->get_musicdata()->get_id();
+}
+
 //---------------------------------------------------------------------------------------
 void DocCommand::undo_action(Document* pDoc, DocCursor* UNUSED(pCursor))
 {
     //default implementation based on restoring from saved checkpoint data
 
     //log command for forensic analysis
-    ofstream logger;
-    logger.open("forensic_log.txt", std::ofstream::out | std::ofstream::app);
-
-    logger << "---------------------------------------------"
-           << "---------------------------------------------" << endl;
-    logger << "Before Undo, time="
-           << to_simple_string(chrono::system_clock::now()) << endl;
-    if (get_undo_policy() == k_undo_policy_partial_checkpoint)
-        logger << "Undo policy: Partial checkpoint. Obj: " << m_idChk << endl;
-    else
-        logger << "Undo policy: Full checkpoint" << endl;
+    CommandJournal* pJournal = pDoc->get_library_scope().get_command_journal();
+    stringstream logger;
+    if (pJournal)
+    {
+        logger << "---------------------------------------------"
+               << "---------------------------------------------" << endl;
+        logger << "Before Undo, time="
+               << to_simple_string(chrono::system_clock::now()) << endl;
+        if (get_undo_policy() == k_undo_policy_partial_checkpoint)
+            logger << "Undo policy: Partial checkpoint. Obj: " << m_idChk << endl;
+        else
+            logger << "Undo policy: Full checkpoint" << endl;
 
-    logger << "IdAssigner. Before: " << pDoc->dump_ids() << endl;
+        logger << "IdAssigner. Before: " << pDoc->dump_ids() << endl;
+    }
 
     //execute undo
     if (get_undo_policy() == k_undo_policy_partial_checkpoint)
@@ -96,18 +108,23 @@ void DocCommand::undo_action(Document* pDoc, DocCursor* UNUSED(pCursor))
     else
         pDoc->from_checkpoint(m_checkpoint);
 
-    logger << "IdAssigner. After: " << pDoc->dump_ids() << endl;
-    logger.close();
+    if (pJournal)
+    {
+        logger << "IdAssigner. After: " << pDoc->dump_ids() << endl;
+        pJournal->add_record( logger.str() );
+    }
 }
 
 //---------------------------------------------------------------------------------------
-void DocCommand::log_forensic_data(Document* UNUSED(pDoc), DocCursor* pCursor)
+void DocCommand::log_forensic_data(Document* pDoc, DocCursor* pCursor)
 {
     //save data for forensic analysis if a crash
 
-    ofstream logger;
-    logger.open("forensic_log.txt", std::ofstream::out | std::ofstream::app);
+    CommandJournal* pJournal = pDoc->get_library_scope().get_command_journal();
+    if (!pJournal)
+        return;
 
+    stringstream logger;
     logger << "---------------------------------------------"
            << "---------------------------------------------" << endl;
     logger << "Before executing command, time="
@@ -116,11 +133,11 @@ void DocCommand::log_forensic_data(Document* UNUSED(pDoc), DocCursor* pCursor)
     logger << "Cursor: " << pCursor->dump_cursor();
     logger << "Checkpoint data (last id " << m_idChk << "):" << endl;
     logger << m_checkpoint << endl;
-    logger.close();
+    pJournal->add_record( logger.str() );
 }
 
 //---------------------------------------------------------------------------------------
-void DocCommand::log_command(ofstream &logger)
+void DocCommand::log_command(ostream &logger)
 {
     //default implementation. Should be overriden in specific commands
     logger << "Command. Name: " << this->get_name() << endl;
@@ -499,7 +516,7 @@ CmdAddChordNote::CmdAddChordNote(const string& pitch, const string& name)
 }
 
 //---------------------------------------------------------------------------------------
-void CmdAddChordNote::log_command(ofstream &logger)
+void CmdAddChordNote::log_command(ostream &logger)
 {
     logger << "Command CmdAddChordNote. Name: '" << this->get_name()
         << ", pitch: " << m_pitch << endl;
@@ -531,8 +548,7 @@ int CmdAddChordNote::set_target(Document* UNUSED(pDoc), DocCursor* UNUSED(pCurso
     m_dots = td.dots;
 
     //undo based on partial checkpoint: get id of element to save
-    ImoScore* pScore = pBaseNote->get_score();
-    m_idChk = pScore->get_id();
+    set_checkpoint_target( pBaseNote->get_instrument() );
 
     //validate pitch and extract components
     if (LdpAnalyser::ldp_pitch_to_components(m_pitch, &m_step, &m_octave, &m_accidentals))
@@ -609,7 +625,7 @@ CmdAddNoteRest::CmdAddNoteRest(const string& source, int UNUSED(editMode),
 }
 
 //---------------------------------------------------------------------------------------
-void CmdAddNoteRest::log_command(ofstream &logger)
+void CmdAddNoteRest::log_command(ostream &logger)
 {
     logger << "Command CmdAddNoteRest. Name: '" << this->get_name()
         << ", source: " << m_source << endl;
@@ -623,7 +639,9 @@ int CmdAddNoteRest::set_target(Document* UNUSED(pDoc), DocCursor* pCursor,
     ImoObj* pParent = pCursor->get_parent_object();
     if (pCursor->get_parent_object()->is_score())
     {
-        m_idChk = pParent->get_id();
+        ImoScore* pScore = static_cast<ImoScore*>(pParent);
+        ScoreCursor* pSC = static_cast<ScoreCursor*>( pCursor->get_inner_cursor() );
+        set_checkpoint_target( pScore->get_instrument(pSC->instrument()) );
 
         //target will be set when performing the action. Here just a couple of checks
         return validate_source(m_source);
@@ -937,7 +955,7 @@ int CmdAddTie::set_target(Document* UNUSED(pDoc), DocCursor* UNUSED(pCursor),
 }
 
 //---------------------------------------------------------------------------------------
-void CmdAddTie::log_command(ofstream &logger)
+void CmdAddTie::log_command(ostream &logger)
 {
     logger << "Command CmdAddTie. Name: '" << this->get_name()
         << ", start & end notes: " << m_startId << ", " << m_endId << endl;
@@ -1011,7 +1029,7 @@ int CmdAddTuplet::set_target(Document* UNUSED(pDoc), DocCursor* UNUSED(pCursor),
 }
 
 //---------------------------------------------------------------------------------------
-void CmdAddTuplet::log_command(ofstream &logger)
+void CmdAddTuplet::log_command(ostream &logger)
 {
     logger << "Command CmdAddTuplet. Name: '" << this->get_name()
         << ", start & end notes: " << m_startId << ", " << m_endId
@@ -1067,13 +1085,12 @@ CmdBreakBeam::CmdBreakBeam(const string& name)
 int CmdBreakBeam::set_target(Document* UNUSED(pDoc), DocCursor* pCursor,
                              SelectionSet* UNUSED(pSelection))
 {
-    ImoObj* pParent = pCursor->get_parent_object();
     if (pCursor->get_parent_object()->is_score())
     {
-        m_idChk = pParent->get_id();
         ImoNoteRest* pBeforeNR = dynamic_cast<ImoNoteRest*>( pCursor->get_pointee() );
         if (pBeforeNR)
         {
+            set_checkpoint_target( pBeforeNR->get_instrument() );
             m_beforeId = pBeforeNR->get_id();
             return k_success;
         }
@@ -1082,7 +1099,7 @@ int CmdBreakBeam::set_target(Document* UNUSED(pDoc), DocCursor* pCursor,
 }
 
 //---------------------------------------------------------------------------------------
-void CmdBreakBeam::log_command(ofstream &logger)
+void CmdBreakBeam::log_command(ostream &logger)
 {
     logger << "Command CmdBreakBeam. Name: '" << this->get_name()
         << ", before note: " << m_beforeId << endl;
@@ -1222,7 +1239,7 @@ int CmdChangeAccidentals::set_target(Document* UNUSED(pDoc), DocCursor* UNUSED(p
 }
 
 //---------------------------------------------------------------------------------------
-void CmdChangeAccidentals::log_command(ofstream &logger)
+void CmdChangeAccidentals::log_command(ostream &logger)
 {
     logger << "Command CmdChangeAccidentals. Name: '" << this->get_name() << endl;
 }
@@ -2135,7 +2152,7 @@ int CmdDeleteStaffObj::set_target(Document* UNUSED(pDoc), DocCursor* pCursor,
     ImoStaffObj* pImo = dynamic_cast<ImoStaffObj*>( pCursor->get_pointee() );
     if (pImo)
     {
-        m_idChk = pImo->get_score()->get_id();
+        set_checkpoint_target( pImo->get_instrument() );
         m_id = pImo->get_id();
         return k_success;
     }
@@ -2340,8 +2357,9 @@ int CmdInsertManyStaffObjs::set_target(Document* UNUSED(pDoc), DocCursor* pCurso
     ImoObj* pParent = pCursor->get_parent_object();
     if (pParent->is_score())
     {
-        m_idChk = pParent->get_id();
+        ImoScore* pScore = static_cast<ImoScore*>(pParent);
         ScoreCursor* pSC = static_cast<ScoreCursor*>( pCursor->get_inner_cursor() );
+        set_checkpoint_target( pScore->get_instrument(pSC->instrument()) );
         m_idAt = pSC->staffobj_id_internal();
         return k_success;
     }
@@ -2373,7 +2391,7 @@ int CmdInsertManyStaffObjs::perform_action(Document* pDoc, DocCursor* pCursor)
         list<ImoStaffObj*> objects = pInstr->insert_staff_objects_at(pAt, m_source, errormsg);
         if (objects.size() > 0)
         {
-            pScore->end_of_changes();        //update ColStaffObjs table
+            pScore->end_of_changes(pInstr, objects.front());   //update ColStaffObjs table
             save_source_code_with_ids(pDoc, objects);
             m_lastInsertedId = objects.back()->get_id();
             objects.clear();
@@ -2481,7 +2499,7 @@ int CmdInsertStaffObj::perform_action(Document* pDoc, DocCursor* pCursor)
             }
 
             //update ColStaffObjs table
-            pScore->end_of_changes();
+            pScore->end_of_changes(pInstr, pImo);
 
             //assign name to this command
             if (m_name == "")
@@ -2524,7 +2542,7 @@ int CmdJoinBeam::set_target(Document* UNUSED(pDoc), DocCursor* UNUSED(pCursor),
 }
 
 //---------------------------------------------------------------------------------------
-void CmdJoinBeam::log_command(ofstream &logger)
+void CmdJoinBeam::log_command(ostream &logger)
 {
     logger << "Command CmdJoinBeam. Name: '" << this->get_name()
         << ", notes:";
@@ -0,0 +1,187 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the Lomse library.
+// Lomse is copyrighted work (c) 2010-2016. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice, this
+//      list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright notice, this
+//      list of conditions and the following disclaimer in the documentation and/or
+//      other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+// TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+// BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+// ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+// For any comment, suggestion or feature request, please contact the manager of
+// the project at cecilios@users.sourceforge.net
+//---------------------------------------------------------------------------------------
+
+#include "lomse_command_journal.h"
+
+#include "lomse_logger.h"
+
+#include <fstream>
+
+namespace lomse
+{
+
+//=======================================================================================
+// CommandJournal implementation
+//=======================================================================================
+CommandJournal::CommandJournal(const string& filename, size_t maxRecords)
+    : m_filename(filename)
+    , m_maxRecords(maxRecords == 0 && filename.empty() ? size_t(k_default_max_records)
+                                                       : maxRecords)
+    , m_pThread(nullptr)
+    , m_fStop(false)
+    , m_fWriting(false)
+    , m_fTruncate(true)
+{
+    if (!m_filename.empty())
+        start_writer();
+}
+
+//---------------------------------------------------------------------------------------
+CommandJournal::~CommandJournal()
+{
+    //pending records are saved before finishing
+    stop_writer();
+}
+
+//---------------------------------------------------------------------------------------
+void CommandJournal::start_writer()
+{
+    m_fStop = false;
+    m_pThread = LOMSE_NEW JournalThread(&CommandJournal::thread_main, this);
+}
+
+//---------------------------------------------------------------------------------------
+void CommandJournal::stop_writer()
+{
+    if (!m_pThread)
+        return;
+
+    {
+        JournalLock lock(m_mutex);
+        m_fStop = true;
+    }
+    m_queueFlag.notify_one();
+
+    m_pThread->join();
+    delete m_pThread;
+    m_pThread = nullptr;
+}
+
+//---------------------------------------------------------------------------------------
+void CommandJournal::add_record(const string& record)
+{
+    {
+        JournalLock lock(m_mutex);
+        if (m_maxRecords > 0)
+        {
+            m_records.push_back(record);
+            if (m_records.size() > m_maxRecords)
+                m_records.pop_front();
+        }
+
+        if (!m_pThread)
+            return;
+        m_pending.push_back(record);
+    }
+    m_queueFlag.notify_one();
+}
+
+//---------------------------------------------------------------------------------------
+void CommandJournal::flush()
+{
+    //wait until all pending records are saved
+
+    JournalLock lock(m_mutex);
+    m_flushedFlag.wait(lock, [this]{ return !m_pThread
+                                            || (m_pending.empty() && !m_fWriting); });
+}
+
+//---------------------------------------------------------------------------------------
+void CommandJournal::clear()
+{
+    JournalLock lock(m_mutex);
+    m_records.clear();
+    m_pending.clear();
+    m_fTruncate = true;
+}
+
+//---------------------------------------------------------------------------------------
+vector<string> CommandJournal::get_records()
+{
+    JournalLock lock(m_mutex);
+    return vector<string>(m_records.begin(), m_records.end());
+}
+
+//---------------------------------------------------------------------------------------
+// Methods to be executed in the writer thread
+//---------------------------------------------------------------------------------------
+
+void CommandJournal::thread_main()
+{
+    deque<string> batch;
+
+    while (true)
+    {
+        bool fRewrite;
+        {
+            JournalLock lock(m_mutex);
+            m_fWriting = false;
+            m_flushedFlag.notify_all();
+            m_queueFlag.wait(lock, [this]{ return m_fStop || !m_pending.empty(); });
+            if (m_pending.empty())
+                return;     //stop requested and nothing pending
+
+            //with retention limit the file is rewritten with the retained records.
+            //Otherwise, only new records are appended
+            fRewrite = m_fTruncate || m_maxRecords > 0;
+            if (m_maxRecords > 0)
+            {
+                m_pending.clear();
+                batch.assign(m_records.begin(), m_records.end());
+            }
+            else
+                batch.swap(m_pending);
+            m_fTruncate = false;
+            m_fWriting = true;
+        }
+
+        write_records(batch, fRewrite);
+        batch.clear();
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void CommandJournal::write_records(deque<string>& batch, bool fRewrite)
+{
+    ofstream file;
+    file.open(m_filename, fRewrite ? std::ofstream::out | std::ofstream::trunc
+                                   : std::ofstream::out | std::ofstream::app);
+    if (!file.is_open())
+    {
+        LOMSE_LOG_ERROR("Command journal: error opening file '%s'", m_filename.c_str());
+        return;
+    }
+
+    for (const string& record : batch)
+        file << record;
+    file.close();
+}
+
+
+}   //namespace lomse
@@ -152,12 +152,21 @@ Document::Document(LibraryScope& libraryScope, ostream& reporter)
     , m_modified(0)
     , m_beatType(k_beat_implied)
     , m_beatDuration( TimeUnits(k_duration_quarter) )
+    , m_stylesEpoch(1)
+    , m_dirtyEpoch(1)
 {
+    if (libraryScope.use_model_arena())
+        m_docScope.create_model_arena();
 }
 
 //---------------------------------------------------------------------------------------
 Document::~Document()
 {
+    //AWARE: the internal model must be deleted before deleting the arena, owned by
+    //the DocumentScope
+    ModelArena* pArena = get_model_arena();
+    if (pArena)
+        pArena->discard_released_blocks();
     delete m_pImoDoc;
     delete_observers();
 }
@@ -263,6 +272,11 @@ int Document::replace_object_from_checkpoint_data(ImoId id, const string& data)
 {
     //object to replace
     ImoObj* pOldImo = get_pointer_to_imo(id);
+    if (pOldImo->is_music_data())
+    {
+        return replace_music_data_from_checkpoint_data(
+                                static_cast<ImoMusicData*>(pOldImo), data);
+    }
     ImoObj* pParent = pOldImo->get_parent();
 
     //new object
@@ -284,6 +298,83 @@ int Document::replace_object_from_checkpoint_data(ImoId id, const string& data)
     return 0;
 }
 
+//---------------------------------------------------------------------------------------
+int Document::replace_music_data_from_checkpoint_data(ImoMusicData* pMD,
+                                                      const string& data)
+{
+    //The ImoMusicData object is preserved and only its content is replaced. The
+    //checkpoint data is analysed in the context of its score and instrument.
+
+    ImoInstrument* pInstr = pMD->get_instrument();
+    ImoScore* pScore = pInstr->get_score();
+
+    //delete current content
+    ImoObj::children_iterator it = pMD->begin();
+    while (it != pMD->end())
+    {
+        ImoObj* pImo = *it;
+        pMD->remove_child(pImo);
+        delete pImo;
+        it = pMD->begin();
+    }
+
+    //analysis will reserve again space for lyrics. Save current staves margins
+    vector<LUnits> margins;
+    int numInstrs = pScore->get_num_instruments();
+    for (int i=0; i < numInstrs; ++i)
+    {
+        ImoInstrument* pI = pScore->get_instrument(i);
+        for (int iStaff=0; iStaff < pI->get_num_staves(); ++iStaff)
+            margins.push_back( pI->get_staff(iStaff)->get_staff_margin() );
+    }
+
+    //create the new content. The temporary music data takes the id of the preserved
+    //one, so that no new id is consumed and ids assigned later are not shifted
+    size_t i = data.find_first_of(" )");
+    stringstream source;
+    source << "(musicData#" << pMD->get_id()
+           << (i != string::npos ? data.substr(i) : ")");
+    LdpParser parser(m_reporter, m_libraryScope.ldp_factory());
+    parser.parse_text(source.str());
+    LdpTree* tree = parser.get_ldp_tree();
+    if (!tree)
+        return 1;
+
+    LdpAnalyser a(m_reporter, m_libraryScope, this);
+    a.set_score_version("2.0");     //exporter always generates LDP 2.0 source
+    a.score_analysis_begin(pScore);
+    a.set_current_instrument(pInstr);
+    ImoMusicData* pNewMD = nullptr;
+    try
+    {
+        pNewMD = static_cast<ImoMusicData*>( a.analyse_tree_and_get_object(tree) );
+    }
+    catch (...)
+    {
+        pNewMD = nullptr;
+    }
+    delete tree->get_root();
+    if (!pNewMD)
+        return 1;
+
+    //move the new content to the music data. Deleting the temporary music data
+    //unregisters the shared id
+    pInstr->insert_staff_objects_at(nullptr, pNewMD);
+    assign_id(pMD);
+
+    //restore staves margins
+    vector<LUnits>::iterator itM = margins.begin();
+    for (int i=0; i < numInstrs; ++i)
+    {
+        ImoInstrument* pI = pScore->get_instrument(i);
+        for (int iStaff=0; iStaff < pI->get_num_staves(); ++iStaff, ++itM)
+            pI->get_staff(iStaff)->set_staff_margin(*itM);
+    }
+
+    pScore->end_of_changes(pInstr);
+    return 0;
+}
+
 //---------------------------------------------------------------------------------------
 int Document::from_input(LdpReader& reader)
 {
@@ -366,6 +457,9 @@ string Document::get_checkpoint_data_for(ImoId id)
     ImoObj* pImo = get_pointer_to_imo(id);
     //TODO: check that ImoObj is a terminal node?
 
+    if (pImo->is_music_data())
+        return get_checkpoint_data_for( static_cast<ImoMusicData*>(pImo) );
+
     LmdExporter exporter(m_libraryScope);
     //exporter.set_remove_newlines(true);   //TODO: Commented out to facilitate debugging
     exporter.set_add_id(true);
@@ -379,6 +473,19 @@ string Document::get_checkpoint_data_for(ImoId id)
         //return exporter.get_source(m_pImo);
 }
 
+//---------------------------------------------------------------------------------------
+string Document::get_checkpoint_data_for(ImoMusicData* pMD)
+{
+    //Checkpoint for changes in only one instrument. Music data is saved as
+    //compact LDP source, without the LMD wrapper
+
+    LdpExporter exporter(&m_libraryScope);
+    exporter.set_remove_newlines(true);
+    exporter.set_add_id(true);
+    exporter.set_current_score( pMD->get_instrument()->get_score() );
+    return exporter.get_source(pMD);
+}
+
 //---------------------------------------------------------------------------------------
 Compiler* Document::get_compiler_for_format(int format)
 {
@@ -653,6 +760,32 @@ void Document::notify_if_document_modified()
     notify_observers(pEvent, this);
 }
 
+//---------------------------------------------------------------------------------------
+void Document::clear_dirty_objects()
+{
+    if (m_pImoDoc)
+        clear_dirty_objects(m_pImoDoc);
+    ++m_dirtyEpoch;
+}
+
+//---------------------------------------------------------------------------------------
+void Document::clear_dirty_objects(ImoObj* pImo)
+{
+    //clean branches are not explored
+    if (!pImo->is_dirty() && !pImo->are_children_dirty())
+        return;
+
+    pImo->set_dirty(false);
+    pImo->set_children_dirty(false);
+
+    ImoObj* pChild = pImo->get_first_child();
+    while (pChild)
+    {
+        clear_dirty_objects(pChild);
+        pChild = pChild->get_next_sibling();
+    }
+}
+
 //---------------------------------------------------------------------------------------
 Observable* Document::get_observable_child(int childType, ImoId childId)
 {
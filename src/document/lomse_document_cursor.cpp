@@ -2404,9 +2404,10 @@ void ScoreCursor::to_time(int iInstr, int iStaff, TimeUnits rTargetTime)
     m_currentState.instrument(iInstr);
     m_currentState.staff(iStaff);
 
-    //optimization: avoid search from start if current time lower than target time
-    if (!p_there_is_iter_object() || is_greater_time(p_iter_object_time(), rTargetTime))
-        m_it = m_pColStaffObjs->begin();
+    //optimization: unless already at target time, jump to the first entry at
+    //target time instead of searching from current position or from start
+    if (!p_there_is_iter_object() || !is_equal_time(p_iter_object_time(), rTargetTime))
+        m_it = m_pColStaffObjs->find_first_at_or_after(rTargetTime);
 
     p_forward_to_instr_with_time_not_lower_than(rTargetTime);
 
@@ -2459,39 +2460,29 @@ void ScoreCursor::to_measure(int measure, int instr, int staff)
         return;
     }
 
-    m_startOfBarTimepos = 0.0;
-    m_curBeatDuration = k_duration_quarter;
+    //use the table index to locate the barline ending previous measure
+    int iInstr = m_currentState.instrument();
+    m_it = m_pColStaffObjs->find_barline_for_measure(iInstr, measure - 1);
+    ColStaffObjsEntry* pBarline = (p_there_is_iter_object() ? *m_it : nullptr);
 
-    m_it = m_pColStaffObjs->begin();
-    while (p_there_is_iter_object())
+    ColStaffObjsEntry* pEntry = pBarline;
+    if (!pEntry)
+        pEntry = m_pColStaffObjs->find_barline_before(iInstr, nullptr);
+    m_startOfBarTimepos = (pEntry ? pEntry->time() : 0.0);
+
+    pEntry = m_pColStaffObjs->find_time_signature_before(iInstr, pBarline);
+    m_curBeatDuration = k_duration_quarter;
+    if (pEntry)
     {
-        if (p_iter_object_instrument() == m_currentState.instrument())
-        {
-            if (p_iter_object()->is_barline())
-            {
-                m_startOfBarTimepos = p_iter_object_time();
-                if (p_iter_object_measure() == measure - 1)
-                {
-                    m_currentState.time( p_iter_object_time() );
-                    p_update_pointed_object();
-                    to_next_staffobj(true);
-                    return;
-                }
-            }
-            if (p_iter_object()->is_time_signature())
-            {
-                ImoTimeSignature* pTS =
-                        static_cast<ImoTimeSignature*>( p_iter_object() );
-                m_curBeatDuration = pTS->get_beat_duration();
-            }
-        }
-        p_move_iterator_to_next();
+        ImoTimeSignature* pTS = static_cast<ImoTimeSignature*>( pEntry->imo_object() );
+        m_curBeatDuration = pTS->get_beat_duration();
     }
 
-    if (p_there_is_iter_object())
+    if (pBarline)
     {
         m_currentState.time( p_iter_object_time() );
         p_update_pointed_object();
+        to_next_staffobj(true);
     }
     else
     {
@@ -2668,12 +2659,12 @@ void ScoreCursor::p_move_iterator_to_next()
 //---------------------------------------------------------------------------------------
 void ScoreCursor::p_move_iterator_to(ImoId id)
 {
-    if (id <= k_no_imoid)
-        m_it = m_pColStaffObjs->end();
-    else
+    m_it = m_pColStaffObjs->end();
+    if (id > k_no_imoid)
     {
-        m_it = m_pColStaffObjs->begin();
-        for (; m_it != m_pColStaffObjs->end() && (*m_it)->element_id() != id; ++m_it);
+        ImoObj* pImo = m_pDoc->get_pointer_to_imo(id);
+        if (pImo && pImo->is_staffobj())
+            m_it = m_pColStaffObjs->find_first( static_cast<ImoStaffObj*>(pImo) );
     }
 }
 //
@@ -2709,9 +2700,9 @@ void ScoreCursor::p_move_iterator_to(ImoId id)
 void ScoreCursor::p_to_start_of_staff(int instr, int staff)
 {
     m_currentState.instrument(instr).staff(staff).measure(0).time(0.0);
-    m_it = m_pColStaffObjs->begin();
-    if (p_there_is_iter_object())
+    if (m_pColStaffObjs->num_entries() > 0)
     {
+        m_it = m_pColStaffObjs->find_first_in_staff(instr, staff);
         p_advance_if_not_right_staff();
         p_update_pointed_object();
     }
@@ -3546,35 +3537,26 @@ void ScoreCursor::p_determine_total_duration()
 //---------------------------------------------------------------------------------------
 void ScoreCursor::p_find_start_of_measure_and_time_signature()
 {
-    bool fBarlineFound = false;
-    bool fTimeFound = false;
+    //AWARE: When the iterator is at end, search in all the table only if the end
+    //was reached by advancing the iterator
     m_startOfBarTimepos = 0.0;
     m_curBeatDuration = k_duration_quarter;
+    if (!p_there_is_iter_object() && m_it.prev() == nullptr)
+        return;
 
-    ColStaffObjsIterator itSave = m_it;
-    p_move_iterator_to_prev();
-    while (p_there_is_iter_object())
+    int instr = m_currentState.instrument();
+    ColStaffObjsEntry* pLimit = (p_there_is_iter_object() ? *m_it : nullptr);
+
+    ColStaffObjsEntry* pEntry = m_pColStaffObjs->find_barline_before(instr, pLimit);
+    if (pEntry)
+        m_startOfBarTimepos = pEntry->time();
+
+    pEntry = m_pColStaffObjs->find_time_signature_before(instr, pLimit);
+    if (pEntry)
     {
-        if (p_iter_object_instrument() == m_currentState.instrument())
-        {
-            if (!fBarlineFound && p_iter_object()->is_barline())
-            {
-                m_startOfBarTimepos = p_iter_object_time();
-                fBarlineFound = true;
-            }
-            if (!fTimeFound && p_iter_object()->is_time_signature())
-            {
-                ImoTimeSignature* pTS =
-                        static_cast<ImoTimeSignature*>( p_iter_object() );
-                m_curBeatDuration = pTS->get_beat_duration();
-                fTimeFound = true;
-            }
-        }
-        if (fBarlineFound && fTimeFound)
-            break;
-        p_move_iterator_to_prev();
+        ImoTimeSignature* pTS = static_cast<ImoTimeSignature*>( pEntry->imo_object() );
+        m_curBeatDuration = pTS->get_beat_duration();
     }
-    m_it = itSave;
 }
 
 
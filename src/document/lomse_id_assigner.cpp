@@ -59,11 +59,11 @@ void IdAssigner::assign_id(ImoObj* pImo)
     if (id == k_no_imoid)
     {
         pImo->set_id(++m_idCounter);
-        m_idToImo[m_idCounter] = pImo;
+        m_idToImo.set(m_idCounter, pImo);
     }
     else
     {
-        m_idToImo[id] = pImo;
+        m_idToImo.set(id, pImo);
         m_idCounter = max(id, m_idCounter);
     }
 }
@@ -91,7 +91,7 @@ void IdAssigner::assign_id(Control* pControl)
     else
         m_idCounter = max(id, m_idCounter);
 
-    m_idToControl[m_idCounter] = pControl;
+    m_idToControl.set(m_idCounter, pControl);
 }
 
 //---------------------------------------------------------------------------------------
@@ -100,7 +100,9 @@ void IdAssigner::remove(ImoObj* pImo)
     ImoId id = pImo->get_id();
     if (id != k_no_imoid)
     {
-        m_idToImo.erase(id);
+        //AWARE: DTOs are not registered but can share the id of the real object
+        if (m_idToImo.find(id) == pImo)
+            m_idToImo.erase(id);
         pImo->set_id(k_no_imoid);
     }
 }
@@ -108,21 +110,13 @@ void IdAssigner::remove(ImoObj* pImo)
 //---------------------------------------------------------------------------------------
 ImoObj* IdAssigner::get_pointer_to_imo(ImoId id) const
 {
-	map<ImoId, ImoObj*>::const_iterator it = m_idToImo.find( id );
-	if (it != m_idToImo.end())
-		return it->second;
-    else
-      return nullptr;
+    return m_idToImo.find(id);
 }
 
 //---------------------------------------------------------------------------------------
 Control* IdAssigner::get_pointer_to_control(ImoId id) const
 {
-	map<ImoId, Control*>::const_iterator it = m_idToControl.find( id );
-	if (it != m_idToControl.end())
-		return it->second;
-    else
-      return nullptr;
+    return m_idToControl.find(id);
 }
 
 //---------------------------------------------------------------------------------------
@@ -130,16 +124,20 @@ string IdAssigner::dump() const
 {
     stringstream data;
     data << "Imo: " << endl;
-	map<ImoId, ImoObj*>::const_iterator it;
-	for (it = m_idToImo.begin(); it != m_idToImo.end(); ++it)
-		data << it->first << "-" << it->second->get_name() << endl;
+    vector< pair<ImoId, ImoObj*> > imos;
+    m_idToImo.get_entries(imos);
+    vector< pair<ImoId, ImoObj*> >::const_iterator it;
+    for (it = imos.begin(); it != imos.end(); ++it)
+        data << it->first << "-" << it->second->get_name() << endl;
     data << endl;
 
-	map<ImoId, Control*>::const_iterator itC = m_idToControl.begin();
-	if (itC != m_idToControl.end())
+    vector< pair<ImoId, Control*> > controls;
+    m_idToControl.get_entries(controls);
+    if (!controls.empty())
     {
         data << "Control: " << endl;
-        for (; itC != m_idToControl.end(); ++itC)
+        vector< pair<ImoId, Control*> >::const_iterator itC;
+        for (itC = controls.begin(); itC != controls.end(); ++itC)
             data << itC->first << endl;
     }
 
@@ -149,28 +147,32 @@ string IdAssigner::dump() const
 //---------------------------------------------------------------------------------------
 void IdAssigner::copy_ids_to(IdAssigner* assigner, ImoId idMin)
 {
-	map<ImoId, ImoObj*>::const_iterator it;
-	for (it = m_idToImo.begin(); it != m_idToImo.end(); ++it)
+    vector< pair<ImoId, ImoObj*> > imos;
+    m_idToImo.get_entries(imos);
+    vector< pair<ImoId, ImoObj*> >::const_iterator it;
+    for (it = imos.begin(); it != imos.end(); ++it)
     {
         if (it->first >= idMin)
             assigner->add_id(it->first, it->second);
     }
 
-	map<ImoId, Control*>::const_iterator itC;
-	for (itC = m_idToControl.begin(); itC != m_idToControl.end(); ++itC)
+    vector< pair<ImoId, Control*> > controls;
+    m_idToControl.get_entries(controls);
+    vector< pair<ImoId, Control*> >::const_iterator itC;
+    for (itC = controls.begin(); itC != controls.end(); ++itC)
         assigner->add_control_id(itC->first, itC->second);
 }
 
 //---------------------------------------------------------------------------------------
 void IdAssigner::add_id(ImoId id, ImoObj* pImo)
 {
-    m_idToImo[id] = pImo;
+    m_idToImo.set(id, pImo);
 }
 
 //---------------------------------------------------------------------------------------
 void IdAssigner::add_control_id(ImoId id, Control* pControl)
 {
-    m_idToControl[id] = pControl;
+    m_idToControl.set(id, pControl);
 }
 
 
@@ -31,6 +31,7 @@
 
 #include <iostream>
 #include <iomanip>
+#include <cstdio>       //for snprintf
 #include "lomse_internal_model.h"
 #include "lomse_im_note.h"
 #include "lomse_staffobjs_table.h"
@@ -49,18 +50,19 @@ class LdpGenerator
 {
 protected:
     LdpExporter* m_pExporter;
-    stringstream m_source;
+    ostream& m_source;          //the exporter output stream
     bool m_fAddSpace;           //add space when opening new element
 
 public:
     LdpGenerator(LdpExporter* pExporter, bool fSpaceNeeded=false)
         : m_pExporter(pExporter)
+        , m_source( pExporter->get_output_stream() )
         , m_fAddSpace(fSpaceNeeded)
     {
     }
     virtual ~LdpGenerator() {}
 
-    virtual string generate_source(ImoObj* pParent=nullptr) = 0;
+    virtual void generate_source(ImoObj* pParent=nullptr) = 0;
 
 protected:
     void start_element(const string& name, ImoId id, bool fInNewLine=true);
@@ -87,7 +89,7 @@ protected:
     void increment_indent();
     void decrement_indent();
 
-    void add_duration(stringstream& source, int noteType, int dots);
+    void add_duration(ostream& source, int noteType, int dots);
     void add_visible(bool fVisible);
     void add_color_if_not_black(Color color);
     void add_location_if_not_zero(Tenths x, Tenths y);
@@ -128,11 +130,10 @@ public:
         //m_pObj = static_cast<ImoXXXXX*>(pImo);
     }
 
-    string generate_source(ImoObj* UNUSED(pParent) =nullptr)
+    void generate_source(ImoObj* UNUSED(pParent) =nullptr)
     {
         //start_element("xxxxx", m_pObj->get_id());
         end_element();
-        return m_source.str();
     }
 };
 
@@ -149,14 +150,13 @@ public:
         m_pObj = static_cast<ImoArticulationSymbol*>(pImo);
     }
 
-    string generate_source(ImoObj* UNUSED(pParent) =nullptr)
+    void generate_source(ImoObj* UNUSED(pParent) =nullptr)
     {
         start_articulation();
         if (m_pObj->is_accent() || m_pObj->is_stress())
             add_placement( m_pObj->get_placement() );
         source_for_base_scoreobj(m_pObj);
         end_element(k_in_same_line);
-        return m_source.str();
     }
 
 protected:
@@ -326,14 +326,13 @@ public:
         m_pObj = static_cast<ImoBarline*>(pImo);
     }
 
-    string generate_source(ImoObj* UNUSED(pParent) =nullptr)
+    void generate_source(ImoObj* UNUSED(pParent) =nullptr)
     {
         start_element("barline", m_pObj->get_id());
         add_barline_type_and_middle();
         source_for_staffobj_options(m_pObj);
         source_for_attachments(m_pObj);
         end_element(k_in_same_line);
-        return m_source.str();
     }
 
 protected:
@@ -375,7 +374,7 @@ public:
     {
     }
 
-    string generate_source(ImoObj* pParent=nullptr)
+    void generate_source(ImoObj* pParent=nullptr)
     {
         m_pNR = static_cast<ImoNoteRest*>( pParent );
 
@@ -390,34 +389,32 @@ public:
         if (!fSkip)
         {
             if ( m_pNR == m_pRO->get_start_object() )
-                return source_for_first();
+                source_for_first();
             else if ( m_pNR == m_pRO->get_end_object() )
-                return source_for_last();
+                source_for_last();
             else
-                return source_for_middle();
+                source_for_middle();
         }
-        return m_source.str();
     }
 
 protected:
 
-    string source_for_first()
+    void source_for_first()
     {
         start_element("beam", m_pRO->get_id(), k_in_same_line);
         add_beam_number();
         add_segments_info();
         end_element(k_in_same_line);
-        return m_source.str();
     }
 
-    string source_for_middle()
+    void source_for_middle()
     {
-        return source_for_first();
+        source_for_first();
     }
 
-    string source_for_last()
+    void source_for_last()
     {
-        return source_for_first();
+        source_for_first();
     }
 
     void add_beam_number()
@@ -461,7 +458,7 @@ public:
         m_pObj = static_cast<ImoClef*>(pImo);
     }
 
-    string generate_source(ImoObj* UNUSED(pParent) =nullptr)
+    void generate_source(ImoObj* UNUSED(pParent) =nullptr)
     {
         start_element("clef", m_pObj->get_id());
         add_type();
@@ -469,7 +466,6 @@ public:
         source_for_staffobj_options(m_pObj);
         source_for_attachments(m_pObj);
         end_element(k_in_same_line);
-        return m_source.str();
     }
 
 protected:
@@ -511,12 +507,11 @@ public:
         m_pObj = static_cast<ImoContentObj*>(pImo);
     }
 
-    string generate_source(ImoObj* UNUSED(pParent) =nullptr)
+    void generate_source(ImoObj* UNUSED(pParent) =nullptr)
     {
         add_user_location();
         add_attachments();
         source_for_base_imobj(m_pObj);
-        return m_source.str();
     }
 
 protected:
@@ -587,13 +582,12 @@ public:
         m_pObj = static_cast<ImoStyle*>(pImo);
     }
 
-    string generate_source(ImoObj* UNUSED(pParent) =nullptr)
+    void generate_source(ImoObj* UNUSED(pParent) =nullptr)
     {
         start_element("defineStyle", k_no_imoid, k_in_new_line);
         add_name();
         add_properties();
         end_element();
-        return m_source.str();
     }
 
 protected:
@@ -865,20 +859,19 @@ public:
         m_pObj = static_cast<ImoDirection*>(pImo);
     }
 
-    string generate_source(ImoObj* UNUSED(pParent) =nullptr)
+    void generate_source(ImoObj* UNUSED(pParent) =nullptr)
     {
         if (m_pObj->has_attachments())
             start_element("dir", m_pObj->get_id());
         else if (m_pObj->get_width() > 0.0f)
             start_element("spacer", m_pObj->get_id());
         else
-            return string("");
+            return;
 
         add_space_width();
         source_for_staffobj_options(m_pObj);
         source_for_attachments(m_pObj);
         end_element(k_in_same_line);
-        return m_source.str();
     }
 
 protected:
@@ -903,7 +896,7 @@ public:
         m_pObj = static_cast<ImoDynamicsMark*>(pImo);
     }
 
-    string generate_source(ImoObj* UNUSED(pParent) =nullptr)
+    void generate_source(ImoObj* UNUSED(pParent) =nullptr)
     {
         start_element("dyn", m_pObj->get_id());
         add_dynamics_string();
@@ -911,7 +904,6 @@ public:
         add_placement( m_pObj->get_placement() );
         source_for_base_scoreobj(m_pObj);
         end_element(k_in_same_line);
-        return m_source.str();
     }
 
 protected:
@@ -936,14 +928,13 @@ public:
     {
     }
 
-    string generate_source(ImoObj* UNUSED(pParent) =nullptr)
+    void generate_source(ImoObj* UNUSED(pParent) =nullptr)
     {
         start_element("TODO: ", m_pImo->get_id());
         m_source << " No LdpGenerator for Imo. Imo name=" << m_pImo->get_name()
                  << ", Imo type=" << m_pImo->get_obj_type()
                  << ", id=" << m_pImo->get_id();
         end_element(k_in_same_line);
-        return m_source.str();
     }
 };
 
@@ -959,14 +950,13 @@ public:
         m_pObj = static_cast<ImoFermata*>(pImo);
     }
 
-    string generate_source(ImoObj* UNUSED(pParent) =nullptr)
+    void generate_source(ImoObj* UNUSED(pParent) =nullptr)
     {
         start_element("fermata", m_pObj->get_id());
         add_symbol();
         add_placement( m_pObj->get_placement() );
         source_for_base_scoreobj(m_pObj);
         end_element(k_in_same_line);
-        return m_source.str();
     }
 
 protected:
@@ -1014,9 +1004,8 @@ public:
         m_pObj = pImo;
     }
 
-    string generate_source(ImoObj* UNUSED(pParent) =nullptr)
+    void generate_source(ImoObj* UNUSED(pParent) =nullptr)
     {
-        return m_source.str();
     }
 };
 
@@ -1034,7 +1023,7 @@ public:
 
     //TODO: This exporter must generate 2.0 code. Therefore, it is invalid to generate
     // goBack. Instead must convert it to 2.0
-    string generate_source(ImoObj* UNUSED(pParent) =nullptr)
+    void generate_source(ImoObj* UNUSED(pParent) =nullptr)
     {
         empty_line();
         bool fFwd = m_pObj->is_forward();
@@ -1042,7 +1031,6 @@ public:
         add_time(fFwd);
         source_for_base_staffobj(m_pObj);
         end_element(k_in_same_line);
-        return m_source.str();
     }
 
 protected:
@@ -1076,7 +1064,7 @@ public:
         m_pObj = static_cast<ImoInstrument*>(pImo);
     }
 
-    string generate_source(ImoObj* UNUSED(pParent) =nullptr)
+    void generate_source(ImoObj* UNUSED(pParent) =nullptr)
     {
         start_element("instrument", m_pObj->get_id());
         add_part_id();
@@ -1085,7 +1073,6 @@ public:
         add_sound_info();
         add_music_data();
         end_element();
-        return m_source.str();
     }
 
 protected:
@@ -1255,7 +1242,7 @@ public:
         m_pObj = static_cast<ImoKeySignature*>(pImo);
     }
 
-    string generate_source(ImoObj* UNUSED(pParent) =nullptr)
+    void generate_source(ImoObj* UNUSED(pParent) =nullptr)
     {
         start_element("key", m_pObj->get_id());
 
@@ -1263,7 +1250,6 @@ public:
         source_for_staffobj_options(m_pObj);
         source_for_attachments(m_pObj);
         end_element(k_in_same_line);
-        return m_source.str();
     }
 
 protected:
@@ -1289,7 +1275,7 @@ public:
         m_pObj = static_cast<ImoDocument*>(pImo);
     }
 
-    string generate_source(ImoObj* UNUSED(pParent) =nullptr)
+    void generate_source(ImoObj* UNUSED(pParent) =nullptr)
     {
         start_element("lenmusdoc", m_pObj->get_id());
         m_source << " ";
@@ -1297,7 +1283,6 @@ public:
         add_comment();
         add_content();
         end_element();
-        return m_source.str();
     }
 
 protected:
@@ -1353,7 +1338,7 @@ public:
         m_pObj = static_cast<ImoLyric*>(pImo);
     }
 
-    string generate_source(ImoObj* UNUSED(pParent) =nullptr)
+    void generate_source(ImoObj* UNUSED(pParent) =nullptr)
     {
         start_element("lyric", m_pObj->get_id());
         add_lyric_number();
@@ -1362,7 +1347,6 @@ public:
         add_placement( m_pObj->get_placement() );
         source_for_base_scoreobj(m_pObj);
         end_element(k_in_same_line);
-        return m_source.str();
     }
 
 protected:
@@ -1414,13 +1398,12 @@ public:
         m_pScore = pExporter->get_current_score();
     }
 
-    string generate_source(ImoObj* UNUSED(pParent) =nullptr)
+    void generate_source(ImoObj* UNUSED(pParent) =nullptr)
     {
         start_element("musicData", m_pObj->get_id());
         space_needed();
         add_staffobjs();
         end_element();
-        return m_source.str();
     }
 
 protected:
@@ -1758,14 +1741,13 @@ public:
         m_pImo = static_cast<ImoMetronomeMark*>( pImo );
     }
 
-    string generate_source(ImoObj* UNUSED(pParent) =nullptr)
+    void generate_source(ImoObj* UNUSED(pParent) =nullptr)
     {
         start_element("metronome", m_pImo->get_id());
         add_marks();
         add_parenthesis();
         source_for_print_options(m_pImo);
         end_element(k_in_same_line);
-        return m_source.str();
     }
 
 protected:
@@ -1824,7 +1806,7 @@ public:
         m_pObj = static_cast<ImoNote*>(pImo);
     }
 
-    string generate_source(ImoObj* UNUSED(pParent) =nullptr)
+    void generate_source(ImoObj* UNUSED(pParent) =nullptr)
     {
         if (m_pObj->is_start_of_chord())
         {
@@ -1851,7 +1833,6 @@ public:
             m_pExporter->set_processing_chord(false);
         }
 
-        return m_source.str();
     }
 
 protected:
@@ -1946,7 +1927,7 @@ protected:
                 if (pAO->is_lyric())
                 {
                     add_space_if_needed();
-                    m_source << m_pExporter->get_source(pAO);
+                    m_pExporter->get_source(m_source, pAO);
                 }
             }
         }
@@ -1980,12 +1961,11 @@ public:
         m_pObj = static_cast<ImoScoreObj*>(pImo);
     }
 
-    string generate_source(ImoObj* UNUSED(pParent) =nullptr)
+    void generate_source(ImoObj* UNUSED(pParent) =nullptr)
     {
         add_user_location();
         add_visible( m_pObj->is_visible() );
         add_color_if_not_black( m_pObj->get_color() );
-        return m_source.str();
     }
 
 protected:
@@ -2020,14 +2000,13 @@ public:
         m_pObj = static_cast<ImoRest*>(pImo);
     }
 
-    string generate_source(ImoObj* UNUSED(pParent) =nullptr)
+    void generate_source(ImoObj* UNUSED(pParent) =nullptr)
     {
         if (is_rest())
             generate_rest();
         else
             generate_go_fwd();
 
-        return m_source.str();
     }
 
 protected:
@@ -2080,7 +2059,7 @@ public:
         m_pObj = static_cast<ImoScoreLine*>(pImo);
     }
 
-    string generate_source(ImoObj* UNUSED(pParent) =nullptr)
+    void generate_source(ImoObj* UNUSED(pParent) =nullptr)
     {
         start_element("line", m_pObj->get_id());
         add_start_point();
@@ -2091,7 +2070,6 @@ public:
         add_cap("lineCapStart", m_pObj->get_start_cap());
         add_cap("lineCapEnd", m_pObj->get_end_cap());
         end_element();
-        return m_source.str();
     }
 
 protected:
@@ -2194,12 +2172,11 @@ public:
         m_pObj = static_cast<ImoScoreObj*>(pImo);
     }
 
-    string generate_source(ImoObj* UNUSED(pParent) =nullptr)
+    void generate_source(ImoObj* UNUSED(pParent) =nullptr)
     {
         add_visible( m_pObj->is_visible() );
         add_color_if_not_black( m_pObj->get_color() );
         source_for_base_contentobj(m_pObj);
-        return m_source.str();
     }
 
 };
@@ -2216,7 +2193,7 @@ public:
         m_pObj = static_cast<ImoScoreText*>(pImo);
     }
 
-    string generate_source(ImoObj* UNUSED(pParent) =nullptr)
+    void generate_source(ImoObj* UNUSED(pParent) =nullptr)
     {
         start_element("text", m_pObj->get_id());
         add_text();
@@ -2224,7 +2201,6 @@ public:
         add_location_if_not_zero(m_pObj->get_user_location_x(),
                                  m_pObj->get_user_location_y());
         end_element();
-        return m_source.str();
     }
 
 protected:
@@ -2252,7 +2228,7 @@ public:
     {
     }
 
-    string generate_source(ImoObj* pParent =nullptr)
+    void generate_source(ImoObj* pParent =nullptr)
     {
         m_pNote = static_cast<ImoNote*>( pParent );
 
@@ -2267,7 +2243,6 @@ public:
         add_bezier_info(pInfo);
 
         end_element(k_in_same_line);
-        return m_source.str();
     }
 
 protected:
@@ -2334,12 +2309,11 @@ public:
         m_pObj = static_cast<ImoStaffObj*>(pImo);
     }
 
-    string generate_source(ImoObj* UNUSED(pParent) =nullptr)
+    void generate_source(ImoObj* UNUSED(pParent) =nullptr)
     {
         add_staff_num();
         add_relobjs();
         source_for_base_scoreobj(m_pObj);
-        return m_source.str();
     }
 
 protected:
@@ -2402,11 +2376,10 @@ public:
         m_pObj = static_cast<ImoStaffObj*>(pImo);
     }
 
-    string generate_source(ImoObj* UNUSED(pParent) =nullptr)
+    void generate_source(ImoObj* UNUSED(pParent) =nullptr)
     {
         add_staff_num();
         source_for_print_options(m_pObj);
-        return m_source.str();
     }
 
 protected:
@@ -2439,11 +2412,10 @@ public:
         m_pImo = static_cast<ImoSystemBreak*>( pImo );
     }
 
-    string generate_source(ImoObj* UNUSED(pParent) =nullptr)
+    void generate_source(ImoObj* UNUSED(pParent) =nullptr)
     {
         start_element("newSystem", m_pImo->get_id());
         end_element(k_in_same_line);
-        return m_source.str();
     }
 };
 
@@ -2462,7 +2434,7 @@ public:
     {
     }
 
-    string generate_source(ImoObj* pParent=nullptr)
+    void generate_source(ImoObj* pParent=nullptr)
     {
         m_pNote = static_cast<ImoNote*>( pParent );
 
@@ -2472,7 +2444,6 @@ public:
         add_tie_type(fStart);
         add_bezier_info(fStart);
         end_element(k_in_same_line);
-        return m_source.str();
     }
 
 protected:
@@ -2544,14 +2515,13 @@ public:
         m_pObj = static_cast<ImoTimeSignature*>(pImo);
     }
 
-    string generate_source(ImoObj* UNUSED(pParent) =nullptr)
+    void generate_source(ImoObj* UNUSED(pParent) =nullptr)
     {
         start_element("time", m_pObj->get_id());
         add_content();
         source_for_staffobj_options(m_pObj);
         source_for_attachments(m_pObj);
         end_element(k_in_same_line);
-        return m_source.str();
     }
 
 protected:
@@ -2586,7 +2556,7 @@ public:
         m_pObj = static_cast<ImoScoreTitle*>(pImo);
     }
 
-    string generate_source(ImoObj* UNUSED(pParent) =nullptr)
+    void generate_source(ImoObj* UNUSED(pParent) =nullptr)
     {
         start_element("title", m_pObj->get_id());
         add_text();
@@ -2594,7 +2564,6 @@ public:
         add_location_if_not_zero(m_pObj->get_user_location_x(),
                                  m_pObj->get_user_location_y());
         end_element();
-        return m_source.str();
     }
 
 protected:
@@ -2621,7 +2590,7 @@ public:
     {
     }
 
-    string generate_source(ImoObj* pParent=nullptr)
+    void generate_source(ImoObj* pParent=nullptr)
     {
         m_pNR = static_cast<ImoNoteRest*>( pParent );
 
@@ -2642,11 +2611,6 @@ public:
             add_tuplet_type(false);
             end_element(k_in_same_line);
         }
-        else
-        {
-            m_source.clear();
-        }
-        return m_source.str();
     }
 
 protected:
@@ -2733,7 +2697,7 @@ public:
         pExporter->set_current_score(m_pObj);
     }
 
-    string generate_source(ImoObj* UNUSED(pParent) =nullptr)
+    void generate_source(ImoObj* UNUSED(pParent) =nullptr)
     {
         //TODO: commented elements
 
@@ -2750,7 +2714,6 @@ public:
         add_parts();
         add_instruments();
         end_element();
-        return m_source.str();
     }
 
 protected:
@@ -2793,7 +2756,7 @@ protected:
 //                ))
             {
                 DefineStyleLdpGenerator gen(it->second, m_pExporter, is_space_needed());
-                m_source << gen.generate_source();
+                gen.generate_source();
             }
         }
     }
@@ -2805,7 +2768,7 @@ protected:
         for (it = titles.begin(); it != titles.end(); ++it)
         {
             TitleLdpGenerator gen(*it, m_pExporter, is_space_needed());
-            m_source << gen.generate_source();
+            gen.generate_source();
         }
     }
 
@@ -3051,14 +3014,12 @@ void LdpGenerator::end_comment()
 //---------------------------------------------------------------------------------------
 void LdpGenerator::empty_line()
 {
-    m_source.clear();
     new_line();
 }
 
 //---------------------------------------------------------------------------------------
 void LdpGenerator::new_line_and_indent_spaces(bool fStartLine)
 {
-    m_source.clear();
     if (!m_pExporter->get_remove_newlines())
     {
         if (fStartLine)
@@ -3083,7 +3044,7 @@ void LdpGenerator::new_line()
 void LdpGenerator::add_source_for(ImoObj* pImo)
 {
     add_space_if_needed();
-    m_source << m_pExporter->get_source(pImo);
+    m_pExporter->get_source(m_source, pImo);
 }
 
 //---------------------------------------------------------------------------------------
@@ -3109,27 +3070,8 @@ void LdpGenerator::source_for_noterest_options(ImoNoteRest* pNR)
         for (int i=0; i < size; ++i)
         {
             ImoRelObj* pRO = pRelObjs->get_item(i);
-            if (pRO->is_tuplet() )
-            {
-                TupletLdpGenerator gen(pRO, m_pExporter);
-                string src = gen.generate_source(pNR);
-                if (!src.empty())
-                {
-                    add_space_if_needed();
-                    m_source << src;
-                }
-            }
-
-            else if (pRO->is_beam() )
-            {
-                BeamLdpGenerator gen(pRO, m_pExporter);
-                string src = gen.generate_source(pNR);
-                if (!src.empty())
-                {
-                    add_space_if_needed();
-                    m_source << src;
-                }
-            }
+            if (pRO->is_tuplet() || pRO->is_beam())
+                source_for_relobj(pRO, pNR);
         }
     }
 }
@@ -3140,7 +3082,7 @@ void LdpGenerator::source_for_staffobj_options(ImoStaffObj* pSO)
 //@ <staffObjOptions> = { <staffNum> | <printOptions> }
 
     StaffObjOptionsLdpGenerator gen(pSO, m_pExporter, is_space_needed());
-    m_source << gen.generate_source();
+    gen.generate_source();
 }
 
 //---------------------------------------------------------------------------------------
@@ -3149,7 +3091,7 @@ void LdpGenerator::source_for_print_options(ImoScoreObj* pSO)
 //@ <printOptions> = { [<visible>] [<location>] [<color>] }
 
     PrintOptionsLdpGenerator gen(pSO, m_pExporter, is_space_needed());
-    m_source << gen.generate_source();
+    gen.generate_source();
 }
 
 //---------------------------------------------------------------------------------------
@@ -3172,21 +3114,21 @@ void LdpGenerator::source_for_attachments(ImoContentObj* pSO)
 void LdpGenerator::source_for_base_staffobj(ImoObj* pImo)
 {
     StaffObjLdpGenerator gen(pImo, m_pExporter, is_space_needed());
-    m_source << gen.generate_source();
+    gen.generate_source();
 }
 
 //---------------------------------------------------------------------------------------
 void LdpGenerator::source_for_base_scoreobj(ImoObj* pImo)
 {
     ScoreObjLdpGenerator gen(pImo, m_pExporter, is_space_needed());
-    m_source << gen.generate_source();
+    gen.generate_source();
 }
 
 //---------------------------------------------------------------------------------------
 void LdpGenerator::source_for_base_contentobj(ImoObj* pImo)
 {
     ContentObjLdpGenerator gen(pImo, m_pExporter, is_space_needed());
-    m_source << gen.generate_source();
+    gen.generate_source();
 }
 
 //---------------------------------------------------------------------------------------
@@ -3194,7 +3136,7 @@ void LdpGenerator::source_for_base_imobj(ImoObj* pImo)
 {
     increment_indent();
     ImObjLdpGenerator gen(pImo, m_pExporter, is_space_needed());
-    m_source << gen.generate_source();
+    gen.generate_source();
     decrement_indent();
 }
 
@@ -3237,7 +3179,7 @@ void LdpGenerator::decrement_indent()
 }
 
 //---------------------------------------------------------------------------------------
-void LdpGenerator::add_duration(stringstream& source, int noteType, int dots)
+void LdpGenerator::add_duration(ostream& source, int noteType, int dots)
 {
     source << " " << LdpExporter::notetype_to_string(noteType, dots);
 }
@@ -3337,6 +3279,7 @@ LdpExporter::LdpExporter(LibraryScope* pLibraryScope)
     , m_nIndent(0)
     , m_fAddId(false)
     , m_fRemoveNewlines(false)
+    , m_pOutput(nullptr)
     , m_pCurrScore(nullptr)
     , m_fProcessingChord(false)
 {
@@ -3348,6 +3291,7 @@ LdpExporter::LdpExporter()
     , m_nIndent(0)
     , m_fAddId(false)
     , m_fRemoveNewlines(false)
+    , m_pOutput(nullptr)
     , m_pCurrScore(nullptr)
     , m_fProcessingChord(false)
 {
@@ -3361,10 +3305,22 @@ LdpExporter::~LdpExporter()
 //---------------------------------------------------------------------------------------
 string LdpExporter::get_source(ImoObj* pImo, ImoObj* pParent)
 {
+    stringstream source;
+    get_source(source, pImo, pParent);
+    return source.str();
+}
+
+//---------------------------------------------------------------------------------------
+void LdpExporter::get_source(ostream& out, ImoObj* pImo, ImoObj* pParent)
+{
+    //All generators write directly in the output stream. Nested invocations can
+    //use a different stream, so previous one is restored when finished
+    ostream* pPrevOutput = m_pOutput;
+    m_pOutput = &out;
     LdpGenerator* pGen = new_generator(pImo);
-    string source = pGen->generate_source(pParent);
+    pGen->generate_source(pParent);
     delete pGen;
-    return source;
+    m_pOutput = pPrevOutput;
 }
 
 //---------------------------------------------------------------------------------------
@@ -3377,6 +3333,7 @@ LdpGenerator* LdpExporter::new_generator(ImoObj* pImo)
         case k_imo_articulation_symbol:
                                     return LOMSE_NEW ArticulationSymbolLdpGenerator(pImo, this);
         case k_imo_barline:         return LOMSE_NEW BarlineLdpGenerator(pImo, this);
+        case k_imo_beam:            return LOMSE_NEW BeamLdpGenerator(pImo, this);
         case k_imo_clef:            return LOMSE_NEW ClefLdpGenerator(pImo, this);
         case k_imo_direction:       return LOMSE_NEW DirectionLdpGenerator(pImo, this);
         case k_imo_document:        return LOMSE_NEW LenmusdocLdpGenerator(pImo, this);
@@ -3399,6 +3356,7 @@ LdpGenerator* LdpExporter::new_generator(ImoObj* pImo)
         case k_imo_slur:            return LOMSE_NEW SlurLdpGenerator(pImo, this);
         case k_imo_time_signature:  return LOMSE_NEW TimeSignatureLdpGenerator(pImo, this);
         case k_imo_tie:             return LOMSE_NEW TieLdpGenerator(pImo, this);
+        case k_imo_tuplet:          return LOMSE_NEW TupletLdpGenerator(pImo, this);
         default:
             return new ErrorLdpGenerator(pImo, this);
     }
@@ -3511,25 +3469,34 @@ string LdpExporter::barline_type_to_ldp(int barlineType)
 //---------------------------------------------------------------------------------------
 string LdpExporter::color_to_ldp(Color color)
 {
-    stringstream source;
-    source << "#";
-    int r = color.r;
-    int g = color.g;
-    int b = color.b;
-    int a = color.a;
-    source << std::hex << setfill('0') << setw(2) << r;
-    source << std::hex << setfill('0') << setw(2) << g;
-    source << std::hex << setfill('0') << setw(2) << b;
-    source << std::hex << setfill('0') << setw(2) << a;
-    return source.str();
+    //formatted by hand: this is invoked for many objects and a stringstream is
+    //expensive to create
+    static const char* hexDigits = "0123456789abcdef";
+    char buffer[10];
+    buffer[0] = '#';
+    int components[4] = { color.r, color.g, color.b, color.a };
+    for (int i=0; i < 4; ++i)
+    {
+        buffer[2*i + 1] = hexDigits[(components[i] >> 4) & 0x0f];
+        buffer[2*i + 2] = hexDigits[components[i] & 0x0f];
+    }
+    buffer[9] = '\0';
+    return string(buffer);
 }
 
 //---------------------------------------------------------------------------------------
 string LdpExporter::float_to_string(float num)
 {
-    stringstream source;
-    source << num;
-    return source.str();
+    //same format than 'stringstream << num' but without creating a stream.
+    //LDP requires '.' as decimal point, whatever the C locale is
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%g", double(num));
+    for (char* p = buffer; *p; ++p)
+    {
+        if (*p == ',')
+            *p = '.';
+    }
+    return string(buffer);
 }
 
 //---------------------------------------------------------------------------------------
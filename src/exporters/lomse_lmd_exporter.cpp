@@ -51,7 +51,7 @@ class LmdGenerator
 {
 protected:
     LmdExporter* m_pExporter;
-    stringstream m_source;
+    ostream& m_source;          //the exporter output stream
     bool m_fTagOpen;
     stack<string> m_openTags;
 
@@ -59,7 +59,7 @@ public:
     LmdGenerator(LmdExporter* pExporter);
     virtual ~LmdGenerator() {}
 
-    virtual string generate_source() = 0;
+    virtual void generate_source() = 0;
 
 protected:
     void start_element(const string& name, ImoObj* pImo);
@@ -84,7 +84,7 @@ protected:
     void increment_indent();
     void decrement_indent();
 
-    void add_duration(stringstream& source, int noteType, int dots);
+    void add_duration(ostream& source, int noteType, int dots);
     void add_optional_style(ImoContentObj* pObj);
 
 };
@@ -111,12 +111,11 @@ public:
         //m_pObj = static_cast<ImoXXXXX*>(pImo);
     }
 
-    string generate_source()
+    void generate_source()
     {
         //start_element("xxxxx", m_pObj);
         close_start_tag();
         end_element();
-        return m_source.str();
     }
 };
 
@@ -133,14 +132,13 @@ public:
         m_pObj = static_cast<ImoBarline*>(pImo);
     }
 
-    string generate_source()
+    void generate_source()
     {
         start_element("barline", m_pObj);
         close_start_tag();
         add_barline_type();
         source_for_base_staffobj(m_pObj);
         end_element(k_in_same_line);
-        return m_source.str();
     }
 
 protected:
@@ -165,14 +163,13 @@ public:
         m_pObj = static_cast<ImoClef*>(pImo);
     }
 
-    string generate_source()
+    void generate_source()
     {
         start_element("clef", m_pObj);
         close_start_tag();
         add_type();
         source_for_base_staffobj(m_pObj);
         end_element();
-        return m_source.str();
     }
 
 protected:
@@ -197,7 +194,7 @@ public:
         m_pObj = static_cast<ImoContent*>(pImo);
     }
 
-    string generate_source()
+    void generate_source()
     {
         start_element("content", m_pObj);
         add_optional_style(m_pObj);
@@ -206,7 +203,6 @@ public:
         add_contained_objects();
 
         end_element();
-        return m_source.str();
     }
 
 protected:
@@ -235,7 +231,7 @@ public:
         m_pObj = static_cast<ImoControl*>(pImo);
     }
 
-    string generate_source()
+    void generate_source()
     {
         start_element("control", m_pObj);
         add_optional_style(m_pObj);
@@ -245,7 +241,6 @@ public:
         //add_contained_objects();
 
         end_element();
-        return m_source.str();
     }
 
 protected:
@@ -274,12 +269,11 @@ public:
         m_pObj = static_cast<ImoContentObj*>(pImo);
     }
 
-    string generate_source()
+    void generate_source()
     {
         add_user_location();
         add_attachments();
         source_for_base_imobj(m_pObj);
-        return m_source.str();
     }
 
 protected:
@@ -364,14 +358,13 @@ public:
         m_pObj = static_cast<ImoStyle*>(pImo);
     }
 
-    string generate_source()
+    void generate_source()
     {
         start_element("defineStyle", m_pObj);
         close_start_tag();
         add_name();
         add_properties();
         end_element();
-        return m_source.str();
     }
 
 protected:
@@ -661,7 +654,7 @@ public:
         m_pObj = static_cast<ImoDynamic*>(pImo);
     }
 
-    string generate_source()
+    void generate_source()
     {
         start_element("dynamic", m_pObj);
         add_optional_style(m_pObj);
@@ -670,7 +663,6 @@ public:
         add_contained_objects();
 
         end_element();
-        return m_source.str();
     }
 
 protected:
@@ -700,7 +692,7 @@ public:
     {
     }
 
-    string generate_source()
+    void generate_source()
     {
         start_element("TODO", m_pImo);
         close_start_tag();
@@ -708,7 +700,6 @@ public:
                  << ", Imo type=" << m_pImo->get_obj_type()
                  << ", id=" << m_pImo->get_id();
         end_element(k_in_same_line);
-        return m_source.str();
     }
 };
 
@@ -725,9 +716,8 @@ public:
         m_pObj = pImo;
     }
 
-    string generate_source()
+    void generate_source()
     {
-        return m_source.str();
     }
 };
 
@@ -744,7 +734,7 @@ public:
         m_pObj = static_cast<ImoInstrument*>(pImo);
     }
 
-    string generate_source()
+    void generate_source()
     {
         start_element("instrument", m_pObj);
         close_start_tag();
@@ -753,7 +743,6 @@ public:
         add_name_abbreviation();
         add_music_data();
         end_element();
-        return m_source.str();
     }
 
 protected:
@@ -808,14 +797,13 @@ public:
         m_pObj = static_cast<ImoKeySignature*>(pImo);
     }
 
-    string generate_source()
+    void generate_source()
     {
         start_element("key", m_pObj);
         close_start_tag();
         add_key_type();
 
         end_element(k_in_same_line);
-        return m_source.str();
     }
 
 protected:
@@ -873,7 +861,7 @@ public:
         m_pObj = static_cast<ImoDocument*>(pImo);
     }
 
-    string generate_source()
+    void generate_source()
     {
         m_source << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>";
         start_element("lenmusdoc", m_pObj);
@@ -890,7 +878,6 @@ public:
         add_content();
 
         end_element();
-        return m_source.str();
     }
 
 protected:
@@ -942,14 +929,13 @@ public:
         m_pObj = static_cast<ImoMusicData*>(pImo);
     }
 
-    string generate_source()
+    void generate_source()
     {
         start_element("musicData", m_pObj);
         close_start_tag();
         add_staffobjs();
         empty_line();
         end_element();
-        return m_source.str();
     }
 
 protected:
@@ -1079,7 +1065,7 @@ public:
         m_pObj = static_cast<ImoNote*>(pImo);
     }
 
-    string generate_source()
+    void generate_source()
     {
         start_element("note", m_pObj);
         close_start_tag();
@@ -1087,7 +1073,6 @@ public:
         add_duration(m_source, m_pObj->get_note_type(), m_pObj->get_dots());
         source_for_base_staffobj(m_pObj);
         end_element();
-        return m_source.str();
     }
 
 protected:
@@ -1144,7 +1129,7 @@ public:
         m_pObj = static_cast<ImoParagraph*>(pImo);
     }
 
-    string generate_source()
+    void generate_source()
     {
         start_element("para", m_pObj);
         add_optional_style(m_pObj);
@@ -1153,7 +1138,6 @@ public:
         add_inline_objects();
 
         end_element();
-        return m_source.str();
     }
 
 protected:
@@ -1185,14 +1169,13 @@ public:
         m_pObj = static_cast<ImoRest*>(pImo);
     }
 
-    string generate_source()
+    void generate_source()
     {
         start_element("rest", m_pObj);
         close_start_tag();
         add_duration(m_source, m_pObj->get_note_type(), m_pObj->get_dots());
         source_for_base_staffobj(m_pObj);
         end_element();
-        return m_source.str();
     }
 
 };
@@ -1210,19 +1193,23 @@ public:
         m_pObj = static_cast<ImoScore*>(pImo);
     }
 
-    string generate_source()
+    void generate_source()
     {
         int format = m_pExporter->get_score_format();
         switch(format)
         {
             case LmdExporter::k_format_ldp:
-                return generate_ldp();
+                generate_ldp();
+                break;
             case LmdExporter::k_format_lmd:
-                return generate_lmd();
+                generate_lmd();
+                break;
             case LmdExporter::k_format_musicxml:
-                return generate_musicxml();
+                generate_musicxml();
+                break;
             case LmdExporter::k_format_mnx:
-                return generate_mnx();
+                generate_mnx();
+                break;
             default:
             {
                 stringstream s;
@@ -1236,7 +1223,7 @@ public:
 
 protected:
 
-    string generate_ldp()
+    void generate_ldp()
     {
         start_element("ldpmusic", nullptr);
         close_start_tag();
@@ -1244,20 +1231,19 @@ protected:
         LdpExporter exporter;
         exporter.set_indent( m_pExporter->get_indent() );
         exporter.set_add_id( m_pExporter->get_add_id() );
-        m_source << exporter.get_source(m_pObj);
+        exporter.get_source(m_source, m_pObj);
 
         end_element();
-        return m_source.str();
     }
 
-    string generate_musicxml()
+    void generate_musicxml()
     {
 //        start_element("musicxml", m_pObj);
 //        close_start_tag();
 //
 //        MusicXmlExporter exporter;
 //        exporter.set_indent( m_pExporter->get_indent() );
-//        m_source << exporter.get_source(m_pObj);
+//        exporter.get_source(m_source, m_pObj);
 //
 //        end_element();
 
@@ -1265,10 +1251,9 @@ protected:
         start_element("TODO: MusicXml exporter", m_pObj);
         close_start_tag();
         end_element();
-        return m_source.str();
     }
 
-    string generate_lmd()
+    void generate_lmd()
     {
         start_element("score", m_pObj);
         close_start_tag();
@@ -1283,10 +1268,9 @@ protected:
         add_options();
         add_instruments_and_groups();
         end_element();
-        return m_source.str();
     }
 
-    string generate_mnx()
+    void generate_mnx()
     {
         start_element("mnx-music", nullptr);
         close_start_tag();
@@ -1294,10 +1278,9 @@ protected:
         MnxExporter exporter( m_pExporter->get_library_scope() );
         exporter.set_indent( m_pExporter->get_indent() );
         //exporter.set_add_id( m_pExporter->get_add_id() );
-        m_source << exporter.get_source(m_pObj);
+        exporter.get_source(m_source, m_pObj);
 
         end_element();
-        return m_source.str();
     }
 
     void add_version()
@@ -1441,12 +1424,11 @@ public:
         m_pObj = static_cast<ImoScoreObj*>(pImo);
     }
 
-    string generate_source()
+    void generate_source()
     {
         add_visible();
         add_color();
         source_for_base_contentobj(m_pObj);
-        return m_source.str();
     }
 
 protected:
@@ -1479,7 +1461,7 @@ public:
         m_pObj = static_cast<ImoHeading*>(pImo);
     }
 
-    string generate_source()
+    void generate_source()
     {
         start_element("section", m_pObj);
         add_level();
@@ -1487,7 +1469,6 @@ public:
         close_start_tag();
         add_inline_objects();
         end_element();
-        return m_source.str();
     }
 
 protected:
@@ -1524,13 +1505,12 @@ public:
         m_pObj = static_cast<ImoDirection*>(pImo);
     }
 
-    string generate_source()
+    void generate_source()
     {
         start_element("spacer", m_pObj);
         close_start_tag();
         //TODO: details
         end_element(k_in_same_line);
-        return m_source.str();
     }
 };
 
@@ -1547,11 +1527,10 @@ public:
         m_pObj = static_cast<ImoStaffObj*>(pImo);
     }
 
-    string generate_source()
+    void generate_source()
     {
         add_staff_num();
         source_for_base_scoreobj(m_pObj);
-        return m_source.str();
     }
 
 protected:
@@ -1586,7 +1565,7 @@ public:
         m_pObj = static_cast<ImoStyles*>(pImo);
     }
 
-    string generate_source()
+    void generate_source()
     {
         if (there_is_any_non_default_style())
         {
@@ -1595,9 +1574,7 @@ public:
             add_styles();
             end_element();
             empty_line();
-            return m_source.str();
         }
-        return "";
     }
 
 protected:
@@ -1638,6 +1615,7 @@ protected:
 //=======================================================================================
 LmdGenerator::LmdGenerator(LmdExporter* pExporter)
     : m_pExporter(pExporter)
+    , m_source( pExporter->get_output_stream() )
     , m_fTagOpen(false)
 {
 }
@@ -1706,13 +1684,11 @@ void LmdGenerator::end_comment()
 //---------------------------------------------------------------------------------------
 void LmdGenerator::empty_line()
 {
-    m_source.clear();
     new_line();
 }
 //---------------------------------------------------------------------------------------
 void LmdGenerator::new_line_and_indent_spaces(bool fStartLine)
 {
-    m_source.clear();
     if (!m_pExporter->get_remove_newlines())
     {
         if (fStartLine)
@@ -1736,28 +1712,28 @@ void LmdGenerator::new_line()
 //---------------------------------------------------------------------------------------
 void LmdGenerator::add_source_for(ImoObj* pImo)
 {
-    m_source << m_pExporter->get_source(pImo);
+    m_pExporter->get_source(m_source, pImo);
 }
 
 //---------------------------------------------------------------------------------------
 void LmdGenerator::source_for_base_staffobj(ImoObj* pImo)
 {
     StaffObjLmdGenerator gen(pImo, m_pExporter);
-    m_source << gen.generate_source();
+    gen.generate_source();
 }
 
 //---------------------------------------------------------------------------------------
 void LmdGenerator::source_for_base_scoreobj(ImoObj* pImo)
 {
     ScoreObjLmdGenerator gen(pImo, m_pExporter);
-    m_source << gen.generate_source();
+    gen.generate_source();
 }
 
 //---------------------------------------------------------------------------------------
 void LmdGenerator::source_for_base_contentobj(ImoObj* pImo)
 {
     ContentObjLmdGenerator gen(pImo, m_pExporter);
-    m_source << gen.generate_source();
+    gen.generate_source();
 }
 
 //---------------------------------------------------------------------------------------
@@ -1765,14 +1741,14 @@ void LmdGenerator::source_for_base_imobj(ImoObj* pImo)
 {
     increment_indent();
     ImObjLmdGenerator gen(pImo, m_pExporter);
-    m_source << gen.generate_source();
+    gen.generate_source();
     decrement_indent();
 }
 
 //---------------------------------------------------------------------------------------
 void LmdGenerator::source_for_auxobj(ImoObj* pImo)
 {
-    m_source <<  m_pExporter->get_source(pImo);
+    m_pExporter->get_source(m_source, pImo);
 }
 
 //---------------------------------------------------------------------------------------
@@ -1835,7 +1811,7 @@ void LmdGenerator::decrement_indent()
 }
 
 //---------------------------------------------------------------------------------------
-void LmdGenerator::add_duration(stringstream& source, int noteType, int dots)
+void LmdGenerator::add_duration(ostream& source, int noteType, int dots)
 {
     start_element("type", nullptr);
     close_start_tag();
@@ -1873,6 +1849,7 @@ LmdExporter::LmdExporter(LibraryScope& libScope)
     , m_fAddId(false)
     , m_scoreFormat(k_format_lmd)
     , m_fRemoveNewlines(false)
+    , m_pOutput(nullptr)
 {
     m_lomseVersion = libScope.get_version_string();
     m_exportTime = to_simple_string(chrono::system_clock::now());
@@ -1895,10 +1872,22 @@ string LmdExporter::get_version_and_time_string()
 //---------------------------------------------------------------------------------------
 string LmdExporter::get_source(ImoObj* pImo)
 {
+    stringstream source;
+    get_source(source, pImo);
+    return source.str();
+}
+
+//---------------------------------------------------------------------------------------
+void LmdExporter::get_source(ostream& out, ImoObj* pImo)
+{
+    //All generators write directly in the output stream. Nested invocations can
+    //use a different stream, so previous one is restored when finished
+    ostream* pPrevOutput = m_pOutput;
+    m_pOutput = &out;
     LmdGenerator* pGen = new_generator(pImo);
-    string source = pGen->generate_source();
+    pGen->generate_source();
     delete pGen;
-    return source;
+    m_pOutput = pPrevOutput;
 }
 
 //---------------------------------------------------------------------------------------
@@ -1988,17 +1977,19 @@ string LmdExporter::barline_type_to_ldp(int barType)
 //---------------------------------------------------------------------------------------
 string LmdExporter::color_to_ldp(Color color)
 {
-    stringstream source;
-    source << "#";
-    int r = color.r;
-    int g = color.g;
-    int b = color.b;
-    int a = color.a;
-    source << std::hex << setfill('0') << setw(2) << r;
-    source << std::hex << setfill('0') << setw(2) << g;
-    source << std::hex << setfill('0') << setw(2) << b;
-    source << std::hex << setfill('0') << setw(2) << a;
-    return source.str();
+    //formatted by hand: this is invoked for many objects and a stringstream is
+    //expensive to create
+    static const char* hexDigits = "0123456789abcdef";
+    char buffer[10];
+    buffer[0] = '#';
+    int components[4] = { color.r, color.g, color.b, color.a };
+    for (int i=0; i < 4; ++i)
+    {
+        buffer[2*i + 1] = hexDigits[(components[i] >> 4) & 0x0f];
+        buffer[2*i + 2] = hexDigits[components[i] & 0x0f];
+    }
+    buffer[9] = '\0';
+    return string(buffer);
 }
 
 //---------------------------------------------------------------------------------------
@@ -50,13 +50,13 @@ class MnxGenerator
 {
 protected:
     MnxExporter* m_pExporter;
-    stringstream m_source;
+    ostream& m_source;          //the exporter output stream
 
 public:
     MnxGenerator(MnxExporter* pExporter);
     virtual ~MnxGenerator() {}
 
-    virtual string generate_source() = 0;
+    virtual void generate_source() = 0;
 
 protected:
     void start_element(const string& name, ImoObj* pImo);
@@ -81,7 +81,7 @@ protected:
     void increment_indent();
     void decrement_indent();
 
-    void add_duration(stringstream& source, int noteType, int dots);
+    void add_duration(ostream& source, int noteType, int dots);
     void add_optional_style(ImoContentObj* pObj);
 
 };
@@ -110,12 +110,11 @@ public:
         //m_pObj = static_cast<ImoXXXXX*>(pImo);
     }
 
-    string generate_source()
+    void generate_source()
     {
         //start_element("xxxxx", m_pObj);
         close_start_tag();
         end_element();
-        return m_source.str();
     }
 };
 
@@ -132,14 +131,13 @@ public:
         m_pObj = static_cast<ImoBarline*>(pImo);
     }
 
-    string generate_source()
+    void generate_source()
     {
         start_element("barline", m_pObj);
         close_start_tag();
         add_barline_type();
         source_for_base_staffobj(m_pObj);
         end_element(k_in_same_line);
-        return m_source.str();
     }
 
 protected:
@@ -164,7 +162,7 @@ public:
         m_pObj = static_cast<ImoClef*>(pImo);
     }
 
-    string generate_source()
+    void generate_source()
     {
         if (m_pExporter->current_open_tag() != "directions")
         {
@@ -175,7 +173,6 @@ public:
         add_line_sign();
         //source_for_base_staffobj(m_pObj);
         end_element(k_in_same_line, k_add_close_tag);
-        return m_source.str();
     }
 
 protected:
@@ -207,12 +204,11 @@ public:
         m_pObj = static_cast<ImoContentObj*>(pImo);
     }
 
-    string generate_source()
+    void generate_source()
     {
         add_user_location();
         add_attachments();
         source_for_base_imobj(m_pObj);
-        return m_source.str();
     }
 
 protected:
@@ -297,14 +293,13 @@ public:
         m_pObj = static_cast<ImoStyle*>(pImo);
     }
 
-    string generate_source()
+    void generate_source()
     {
         start_element("defineStyle", m_pObj);
         close_start_tag();
         add_name();
         add_properties();
         end_element();
-        return m_source.str();
     }
 
 protected:
@@ -595,7 +590,7 @@ public:
     {
     }
 
-    string generate_source()
+    void generate_source()
     {
         start_element("TODO", m_pImo);
         close_start_tag();
@@ -603,7 +598,6 @@ public:
                  << ", Imo type=" << m_pImo->get_obj_type()
                  << ", id=" << m_pImo->get_id();
         end_element(k_in_same_line);
-        return m_source.str();
     }
 };
 
@@ -620,9 +614,8 @@ public:
         m_pObj = pImo;
     }
 
-    string generate_source()
+    void generate_source()
     {
-        return m_source.str();
     }
 };
 
@@ -639,7 +632,7 @@ public:
         m_pObj = static_cast<ImoInstrument*>(pImo);
     }
 
-    string generate_source()
+    void generate_source()
     {
         start_element("part", m_pObj);
         close_start_tag();
@@ -649,7 +642,6 @@ public:
         add_music_data();
         end_element();
         empty_line();
-        return m_source.str();
     }
 
 protected:
@@ -704,14 +696,13 @@ public:
         m_pObj = static_cast<ImoKeySignature*>(pImo);
     }
 
-    string generate_source()
+    void generate_source()
     {
         start_element("key", m_pObj);
         close_start_tag();
         add_key_type();
 
         end_element(k_in_same_line);
-        return m_source.str();
     }
 
 protected:
@@ -769,7 +760,7 @@ public:
         m_pObj = static_cast<ImoDocument*>(pImo);
     }
 
-    string generate_source()
+    void generate_source()
     {
         m_source << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>";
         add_comment();
@@ -783,7 +774,6 @@ public:
         add_content();
 
         end_element();    //mnx
-        return m_source.str();
     }
 
 protected:
@@ -841,11 +831,10 @@ public:
         m_pObj = static_cast<ImoMusicData*>(pImo);
     }
 
-    string generate_source()
+    void generate_source()
     {
         add_staffobjs();
         empty_line();
-        return m_source.str();
     }
 
 protected:
@@ -990,7 +979,7 @@ public:
         m_pObj = static_cast<ImoNote*>(pImo);
     }
 
-    string generate_source()
+    void generate_source()
     {
         if (m_pExporter->current_open_tag() == "directions")
             end_element();
@@ -1024,7 +1013,6 @@ public:
             m_pExporter->set_processing_chord(false);
         }
 
-        return m_source.str();
     }
 
 protected:
@@ -1083,7 +1071,7 @@ public:
         m_pObj = static_cast<ImoRest*>(pImo);
     }
 
-    string generate_source()
+    void generate_source()
     {
         if (m_pExporter->current_open_tag() == "directions")
             end_element();
@@ -1105,7 +1093,6 @@ public:
         //source_for_base_staffobj(m_pObj);
         end_element(k_in_same_line, k_add_close_tag);
         end_element();  //event
-        return m_source.str();
     }
 
 };
@@ -1123,7 +1110,7 @@ public:
         m_pObj = static_cast<ImoScore*>(pImo);
     }
 
-    string generate_source()
+    void generate_source()
     {
         start_element("score", m_pObj);
         close_start_tag();
@@ -1137,7 +1124,6 @@ public:
         add_instruments_and_groups();
         end_element();  //cwmnx
         end_element();  //score
-        return m_source.str();
     }
 
 protected:
@@ -1273,12 +1259,11 @@ public:
         m_pObj = static_cast<ImoScoreObj*>(pImo);
     }
 
-    string generate_source()
+    void generate_source()
     {
         add_visible();
         add_color();
         source_for_base_contentobj(m_pObj);
-        return m_source.str();
     }
 
 protected:
@@ -1311,13 +1296,12 @@ public:
         m_pObj = static_cast<ImoDirection*>(pImo);
     }
 
-    string generate_source()
+    void generate_source()
     {
         start_element("spacer", m_pObj);
         close_start_tag();
         //TODO: details
         end_element(k_in_same_line);
-        return m_source.str();
     }
 };
 
@@ -1334,11 +1318,10 @@ public:
         m_pObj = static_cast<ImoStaffObj*>(pImo);
     }
 
-    string generate_source()
+    void generate_source()
     {
         add_staff_num();
         source_for_base_scoreobj(m_pObj);
-        return m_source.str();
     }
 
 protected:
@@ -1373,7 +1356,7 @@ public:
         m_pObj = static_cast<ImoStyles*>(pImo);
     }
 
-    string generate_source()
+    void generate_source()
     {
         if (there_is_any_non_default_style())
         {
@@ -1382,9 +1365,7 @@ public:
             add_styles();
             end_element();
             empty_line();
-            return m_source.str();
         }
-        return "";
     }
 
 protected:
@@ -1425,6 +1406,7 @@ protected:
 //=======================================================================================
 MnxGenerator::MnxGenerator(MnxExporter* pExporter)
     : m_pExporter(pExporter)
+    , m_source( pExporter->get_output_stream() )
 {
 }
 
@@ -1505,13 +1487,11 @@ void MnxGenerator::end_comment()
 //---------------------------------------------------------------------------------------
 void MnxGenerator::empty_line()
 {
-    m_source.clear();
     new_line();
 }
 //---------------------------------------------------------------------------------------
 void MnxGenerator::new_line_and_indent_spaces(bool fStartLine)
 {
-    m_source.clear();
     if (!m_pExporter->get_remove_newlines())
     {
         if (fStartLine)
@@ -1535,28 +1515,28 @@ void MnxGenerator::new_line()
 //---------------------------------------------------------------------------------------
 void MnxGenerator::add_source_for(ImoObj* pImo)
 {
-    m_source << m_pExporter->get_source(pImo);
+    m_pExporter->get_source(m_source, pImo);
 }
 
 //---------------------------------------------------------------------------------------
 void MnxGenerator::source_for_base_staffobj(ImoObj* pImo)
 {
     StaffObjMnxGenerator gen(pImo, m_pExporter);
-    m_source << gen.generate_source();
+    gen.generate_source();
 }
 
 //---------------------------------------------------------------------------------------
 void MnxGenerator::source_for_base_scoreobj(ImoObj* pImo)
 {
     ScoreObjMnxGenerator gen(pImo, m_pExporter);
-    m_source << gen.generate_source();
+    gen.generate_source();
 }
 
 //---------------------------------------------------------------------------------------
 void MnxGenerator::source_for_base_contentobj(ImoObj* pImo)
 {
     ContentObjMnxGenerator gen(pImo, m_pExporter);
-    m_source << gen.generate_source();
+    gen.generate_source();
 }
 
 //---------------------------------------------------------------------------------------
@@ -1564,14 +1544,14 @@ void MnxGenerator::source_for_base_imobj(ImoObj* pImo)
 {
     increment_indent();
     ImObjMnxGenerator gen(pImo, m_pExporter);
-    m_source << gen.generate_source();
+    gen.generate_source();
     decrement_indent();
 }
 
 //---------------------------------------------------------------------------------------
 void MnxGenerator::source_for_auxobj(ImoObj* pImo)
 {
-    m_source <<  m_pExporter->get_source(pImo);
+    m_pExporter->get_source(m_source, pImo);
 }
 
 //---------------------------------------------------------------------------------------
@@ -1634,7 +1614,7 @@ void MnxGenerator::decrement_indent()
 }
 
 //---------------------------------------------------------------------------------------
-void MnxGenerator::add_duration(stringstream& source, int noteType, int dots)
+void MnxGenerator::add_duration(ostream& source, int noteType, int dots)
 {
     start_attrib("value");
     switch(noteType)
@@ -1670,6 +1650,7 @@ MnxExporter::MnxExporter(LibraryScope& libScope)
     , m_nIndent(0)
     , m_fAddId(false)
     , m_fRemoveNewlines(false)
+    , m_pOutput(nullptr)
     , m_fProcessingChord(false)
 {
     m_lomseVersion = libScope.get_version_string();
@@ -1693,10 +1674,22 @@ string MnxExporter::get_version_and_time_string()
 //---------------------------------------------------------------------------------------
 string MnxExporter::get_source(ImoObj* pImo)
 {
+    stringstream source;
+    get_source(source, pImo);
+    return source.str();
+}
+
+//---------------------------------------------------------------------------------------
+void MnxExporter::get_source(ostream& out, ImoObj* pImo)
+{
+    //All generators write directly in the output stream. Nested invocations can
+    //use a different stream, so previous one is restored when finished
+    ostream* pPrevOutput = m_pOutput;
+    m_pOutput = &out;
     MnxGenerator* pGen = new_generator(pImo);
-    string source = pGen->generate_source();
+    pGen->generate_source();
     delete pGen;
-    return source;
+    m_pOutput = pPrevOutput;
 }
 
 //---------------------------------------------------------------------------------------
@@ -1782,17 +1775,19 @@ string MnxExporter::barline_type_to_mnx(int barType)
 //---------------------------------------------------------------------------------------
 string MnxExporter::color_to_mnx(Color color)
 {
-    stringstream source;
-    source << "#";
-    int r = color.r;
-    int g = color.g;
-    int b = color.b;
-    int a = color.a;
-    source << std::hex << setfill('0') << setw(2) << r;
-    source << std::hex << setfill('0') << setw(2) << g;
-    source << std::hex << setfill('0') << setw(2) << b;
-    source << std::hex << setfill('0') << setw(2) << a;
-    return source.str();
+    //formatted by hand: this is invoked for many objects and a stringstream is
+    //expensive to create
+    static const char* hexDigits = "0123456789abcdef";
+    char buffer[10];
+    buffer[0] = '#';
+    int components[4] = { color.r, color.g, color.b, color.a };
+    for (int i=0; i < 4; ++i)
+    {
+        buffer[2*i + 1] = hexDigits[(components[i] >> 4) & 0x0f];
+        buffer[2*i + 2] = hexDigits[components[i] & 0x0f];
+    }
+    buffer[9] = '\0';
+    return string(buffer);
 }
 
 //---------------------------------------------------------------------------------------
@@ -370,6 +370,25 @@ long ZipInputStream::read(unsigned char* pDestBuffer, long nBytesToRead)
     m_pNextChar += bytesRead;
     pDestBuffer += bytesRead;
 
+    //for big reads, once the internal buffer is drained, decompress directly into
+    //the destination instead of bouncing the data through the internal buffer
+    long pending = nBytesToRead - bytesRead;
+    if (m_remainingBytes == 0 && !m_fIsLastBuffer && pending >= k_buffersize)
+    {
+        int bytes = unzReadCurrentFile(m_uzFile, pDestBuffer, unsigned(pending));
+        if (bytes > 0)
+        {
+            bytesRead += bytes;
+            pDestBuffer += bytes;
+        }
+        if (bytes < pending)
+        {
+            m_fIsLastBuffer = true;
+            m_curEntry.fEOF = true;
+            return bytesRead;
+        }
+    }
+
     if (m_remainingBytes == 0)
     {
         if (m_fIsLastBuffer)
@@ -54,7 +54,6 @@ PartsEngraver::PartsEngraver(LibraryScope& libraryScope, ScoreMeter* pScoreMeter
     : Engraver(libraryScope, pScoreMeter)
     , m_pGroups(pGroups)
     , m_pScore(pScore)
-    , m_pFontStorage( libraryScope.font_storage() )
     , m_pScoreLyt(pScoreLyt)
     , m_uFirstSystemIndent(0.0f)
     , m_uOtherSystemIndent(0.0f)
@@ -355,7 +354,6 @@ GroupEngraver::GroupEngraver(LibraryScope& libraryScope, ScoreMeter* pScoreMeter
     , m_pGroup(pGroup)
     , m_pScore(pScore)
     , m_pParts(pParts)
-    , m_pFontStorage( libraryScope.font_storage() )
     , m_stavesTop(0.0f)
     , m_stavesBottom(0.0f)
     , m_uBracketGap(0.0f)
@@ -551,7 +549,6 @@ InstrumentEngraver::InstrumentEngraver(LibraryScope& libraryScope,
     : Engraver(libraryScope, pScoreMeter)
     , m_pInstr(pInstr)
     , m_pScore(pScore)
-    , m_pFontStorage( libraryScope.font_storage() )
     , m_uBracketGap(0.0f)
     , m_stavesTop(0.0f)
     , m_stavesBottom(0.0f)
@@ -47,7 +47,6 @@ TextEngraver::TextEngraver(LibraryScope& libraryScope, ScoreMeter* pScoreMeter,
     : Engraver(libraryScope, pScoreMeter)
     , m_text(text)
     , m_pStyle(pStyle)
-    , m_pFontStorage( libraryScope.font_storage() )
     , m_language(language)
 {
 }
@@ -115,7 +114,6 @@ TextBoxEngraver::TextBoxEngraver(LibraryScope& libraryScope, ScoreMeter* pScoreM
     : Engraver(libraryScope, pScoreMeter)
     , m_text(text)
     , m_pStyle(pStyle)
-    , m_pFontStorage( libraryScope.font_storage() )
     , m_language(language)
 {
 }
@@ -185,7 +183,6 @@ MeasureNumberEngraver::MeasureNumberEngraver(LibraryScope& libraryScope,
                                              ScoreMeter* pScoreMeter, const string& text)
     : Engraver(libraryScope, pScoreMeter)
     , m_text(text)
-    , m_pFontStorage( libraryScope.font_storage() )
 {
     m_pStyle = m_pMeter->get_style_info("Measure numbers");
 }
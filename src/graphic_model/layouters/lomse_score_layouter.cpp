@@ -73,6 +73,8 @@
 #include "lomse_volta_engraver.h"
 #include "lomse_coda_segno_engraver.h"
 
+#include <algorithm>
+
 namespace lomse
 {
 
@@ -592,16 +594,16 @@ LUnits ScoreLayouter::determine_system_top_margin()
 //---------------------------------------------------------------------------------------
 int ScoreLayouter::get_system_containing_column(int iCol)
 {
+    //m_breaks is ordered: the system is the last one starting at or before iCol.
+    //Invoked for each pending aux object when engraving each system, so a binary
+    //search is used
+
     if (iCol > 0)
     {
-
         int maxSystem = get_num_systems() - 1;
-        for (int iSys = 0; iSys < maxSystem; ++iSys)
-        {
-            if (iCol >= m_breaks[iSys] && iCol < m_breaks[iSys+1])
-                return iSys;
-        }
-        return maxSystem;
+        vector<int>::iterator it = upper_bound(m_breaks.begin(), m_breaks.end(), iCol);
+        int iSys = int(it - m_breaks.begin()) - 1;
+        return min(iSys, maxSystem);
     }
     else
         return 0;
@@ -89,6 +89,14 @@ SpAlgGourlay::SpAlgGourlay(LibraryScope& libraryScope,
     , m_dmin(0.0f)
     , m_log2dmin(0.0f)
     , m_Fopt(0.0f)
+    , m_fSpringsReady(false)
+    //
+    , m_iMergedFirst(-1)
+    , m_iMergedLast(-1)
+    , m_mergedSlope(0.0f)
+    , m_mergedFixed(0.0f)
+    , m_mergedMinWidth(0.0f)
+    , m_numMergedColumns(0L)
 {
 //    m_columns.reserve(pScoreLyt->get_num_columns());
     m_data.reserve(pScore->get_staffobjs_table()->num_entries());
@@ -301,6 +309,7 @@ void SpAlgGourlay::new_slice(ColStaffObjsEntry* pEntry, int entryType, int iColu
         pSlice->m_prev = m_pCurSlice;
     }
     m_slices.push_back(pSlice);
+    m_fSpringsReady = false;
 
     //update variables
     m_pCurSlice = pSlice;
@@ -374,9 +383,15 @@ void SpAlgGourlay::finish_column_measurements(int UNUSED(iCol))
 //---------------------------------------------------------------------------------------
 void SpAlgGourlay::do_spacing(int iCol, bool fTrace)
 {
-    determine_spacing_parameters();
-    compute_springs();
-    order_slices_in_columns();
+    //springs and slices order do not depend on the column being spaced. Compute them
+    //only once, when spacing the first column, instead of once per column
+    if (!m_fSpringsReady)
+    {
+        determine_spacing_parameters();
+        compute_springs();
+        order_slices_in_columns();
+        m_fSpringsReady = true;
+    }
 
     int numInstruments = m_pScoreMeter->num_instruments();
     m_columns[iCol]->collect_barlines_information(numInstruments);
@@ -389,8 +404,8 @@ void SpAlgGourlay::do_spacing(int iCol, bool fTrace)
         m_columns[iCol]->dump(dbgLogger);
     }
 
-    //apply optimum force to get an initial estimation for columns width
-    apply_force(m_Fopt);
+    //apply optimum force to get an initial estimation for column width
+    m_columns[iCol]->apply_force(m_Fopt);
 
     //determine column spacing function slope in the neighborhood of Fopt
     m_columns[iCol]->determine_approx_sff_for(m_Fopt);
@@ -752,27 +767,23 @@ float SpAlgGourlay::determine_penalty_for_line(int iSystem, int iFirstCol, int i
     //                       j                          j
     //    sff[cicj] = 1 / ( SUM ( 1/Cappn ) )  = 1 / ( SUM ( slope.n ) )
     //                      n=i                        n=i
-    float sum = 0.0f;
-    LUnits fixed = 0.0f;
-    LUnits minWidth = 0.0f;
-    for (int i = iFirstCol; i <= iLastCol; ++i)
-    {
-        sum += m_columns[i]->m_slope;
-        fixed += m_columns[i]->m_xFixed;
-        minWidth += m_columns[i]->get_minimum_width();
-    }
+    merge_columns(iFirstCol, iLastCol);
+    float sum = m_mergedSlope;
+    LUnits fixed = m_mergedFixed;
+    LUnits minWidth = m_mergedMinWidth;
     float c = 1.0f / sum;
 
     //if minimum width is greater than required width, it is impossible to achieve
-    //the requiered width. Return a too high penalty
+    //the requiered width. And adding more columns will not fix it. Return an
+    //infinite penalty, so that the lines breaker does not try more columns
     if (minWidth > lineWidth && iFirstCol != iLastCol)
     {
         if (fTrace)
         {
             dbgLogger << "Determine penalty: minimum width is greater than "
-                      << "required width. Penalty= 1000" << endl;
+                      << "required width. Penalty= infinite" << endl;
         }
-        return 1000.0f;
+        return LOMSE_INFINITE_PENALTY;
     }
 
     //determine force to apply to get desired extent
@@ -816,6 +827,35 @@ float SpAlgGourlay::determine_penalty_for_line(int iSystem, int iFirstCol, int i
     return R;
 }
 
+//---------------------------------------------------------------------------------------
+void SpAlgGourlay::merge_columns(int iFirstCol, int iLastCol)
+{
+    //The lines breaker tries lines [i, i], [i, i+1], [i, i+2], ... Therefore, the
+    //merged data for the previous line is reused and only the new columns are added.
+    //Merged data is always reset when starting a new sequence of lines, as columns
+    //could have been modified.
+    //AWARE: columns are added in the same order than when merging all columns, so
+    //that results are identical.
+
+    if (iFirstCol == iLastCol || iFirstCol != m_iMergedFirst || iLastCol < m_iMergedLast)
+    {
+        m_iMergedFirst = iFirstCol;
+        m_iMergedLast = iFirstCol - 1;
+        m_mergedSlope = 0.0f;
+        m_mergedFixed = 0.0f;
+        m_mergedMinWidth = 0.0f;
+    }
+
+    for (int i = m_iMergedLast + 1; i <= iLastCol; ++i)
+    {
+        m_mergedSlope += m_columns[i]->m_slope;
+        m_mergedFixed += m_columns[i]->m_xFixed;
+        m_mergedMinWidth += m_columns[i]->get_minimum_width();
+        ++m_numMergedColumns;
+    }
+    m_iMergedLast = iLastCol;
+}
+
 //---------------------------------------------------------------------------------------
 bool SpAlgGourlay::is_better_option(float prevPenalty, float newPenalty,
                                     float nextPenalty, int UNUSED(i), int UNUSED(j))
@@ -130,6 +130,7 @@ void GmoObj::shift_origin(const USize& shift)
 {
     m_origin.x += shift.width;
     m_origin.y += shift.height;
+    invalidate_owner_drawing_bounds();
 }
 
 //---------------------------------------------------------------------------------------
@@ -137,6 +138,18 @@ void GmoObj::shift_origin(LUnits x, LUnits y)
 {
     m_origin.x += x;
     m_origin.y += y;
+    invalidate_owner_drawing_bounds();
+}
+
+//---------------------------------------------------------------------------------------
+void GmoObj::invalidate_owner_drawing_bounds()
+{
+    //the area covered by the box containing this object could have changed
+
+    if (is_box())
+        static_cast<GmoBox*>(this)->invalidate_drawing_bounds();
+    else if (m_pParentBox)
+        m_pParentBox->invalidate_drawing_bounds();
 }
 
 //---------------------------------------------------------------------------------------
@@ -313,6 +326,8 @@ GmoBox::GmoBox(int objtype, ImoObj* pCreatorImo)
     , m_uBottomMargin(0.0f)
     , m_uLeftMargin(0.0f)
     , m_uRightMargin(0.0f)
+    , m_drawBounds(0.0f, 0.0f, 0.0f, 0.0f)
+    , m_fDrawBoundsValid(false)
 {
 }
 
@@ -346,6 +361,7 @@ void GmoBox::add_child_box(GmoBox* child)
 {
     m_childBoxes.push_back(child);
     child->set_owner_box(this);
+    invalidate_drawing_bounds();
 }
 
 //---------------------------------------------------------------------------------------
@@ -363,6 +379,7 @@ void GmoBox::add_shape(GmoShape* shape, int layer)
     shape->set_layer(layer);
     shape->set_owner_box(this);
     m_shapes.push_back(shape);
+    invalidate_drawing_bounds();
 }
 
 //---------------------------------------------------------------------------------------
@@ -435,6 +452,10 @@ void GmoBox::set_flag_value(bool value, unsigned int flag)
 //---------------------------------------------------------------------------------------
 void GmoBox::on_draw(Drawer* pDrawer, RenderOptions& opt)
 {
+    //nothing to draw if the box and its content are out of the viewport
+    if (opt.cull_flag && !get_drawing_bounds().intersects(opt.cull_rect))
+        return;
+
     draw_border(pDrawer, opt);
     draw_shapes(pDrawer, opt);
 
@@ -449,7 +470,66 @@ void GmoBox::draw_shapes(Drawer* pDrawer, RenderOptions& opt)
 {
     std::list<GmoShape*>::iterator itS;
     for (itS=m_shapes.begin(); itS != m_shapes.end(); ++itS)
-        (*itS)->on_draw(pDrawer, opt);
+    {
+        if (!opt.cull_flag || (*itS)->get_bounds().intersects(opt.cull_rect))
+            (*itS)->on_draw(pDrawer, opt);
+    }
+}
+
+//---------------------------------------------------------------------------------------
+URect GmoBox::get_drawing_bounds()
+{
+    //Returns the rectangle enclosing the box and all its shapes and child boxes.
+    //It is computed when needed and cached until a contained object is added or
+    //moved.
+
+    if (!m_fDrawBoundsValid)
+    {
+        LUnits xLeft = m_origin.x;
+        LUnits yTop = m_origin.y;
+        LUnits xRight = get_right();
+        LUnits yBottom = get_bottom();
+
+        std::list<GmoShape*>::iterator itS;
+        for (itS=m_shapes.begin(); itS != m_shapes.end(); ++itS)
+        {
+            URect r = (*itS)->get_bounds();
+            xLeft = min(xLeft, r.x);
+            yTop = min(yTop, r.y);
+            xRight = max(xRight, r.right());
+            yBottom = max(yBottom, r.bottom());
+        }
+
+        std::vector<GmoBox*>::iterator itB;
+        for (itB=m_childBoxes.begin(); itB != m_childBoxes.end(); ++itB)
+        {
+            URect r = (*itB)->get_drawing_bounds();
+            xLeft = min(xLeft, r.x);
+            yTop = min(yTop, r.y);
+            xRight = max(xRight, r.right());
+            yBottom = max(yBottom, r.bottom());
+        }
+
+        m_drawBounds = URect(xLeft, yTop, xRight - xLeft, yBottom - yTop);
+        m_fDrawBoundsValid = true;
+    }
+    return m_drawBounds;
+}
+
+//---------------------------------------------------------------------------------------
+void GmoBox::invalidate_drawing_bounds()
+{
+    //When a box is valid all its children are also valid. Therefore, propagation
+    //can stop at the first box already invalidated.
+
+    if (!m_fDrawBoundsValid)
+        return;
+
+    m_fDrawBoundsValid = false;
+    if (is_box_doc_page())
+        static_cast<GmoBoxDocPage*>(this)->invalidate_shapes_grid();
+    if (m_pParentBox)
+        m_pParentBox->invalidate_drawing_bounds();
 }
 
 //---------------------------------------------------------------------------------------
@@ -591,6 +671,7 @@ void GmoBox::shift_origin_and_content(const USize& shift)
 
     m_origin.x += shift.width;
     m_origin.y += shift.height;
+    invalidate_drawing_bounds();
 
     //shift contained boxes
     std::vector<GmoBox*>::iterator itB;
@@ -822,6 +903,7 @@ public:
 GmoBoxDocPage::GmoBoxDocPage(ImoObj* pCreatorImo)
     : GmoBox(GmoObj::k_box_doc_page, pCreatorImo)
     , m_numPage(1)
+    , m_fShapesGridValid(false)
 {
 }
 
@@ -849,22 +931,31 @@ void GmoBoxDocPage::draw_page_background(Drawer* pDrawer, RenderOptions& UNUSED(
 //---------------------------------------------------------------------------------------
 void GmoBoxDocPage::add_to_tables(GmoShape* pShape)
 {
-    int layer = pShape->get_layer();
-    std::list<GmoShape*>::iterator it;
-    for (it = m_allShapes.begin(); it != m_allShapes.end(); ++it)
-    {
-        if ((*it)->get_layer() > layer)
-            break;
-    }
+    int layer = max(0, pShape->get_layer());
+    if (layer >= int(m_layers.size()))
+        m_layers.resize(max(layer + 1, int(GmoShape::k_layer_max)));
+    m_layers[layer].push_back(pShape);
 
-    if (it == m_allShapes.end())
-        m_allShapes.push_back(pShape);
-    else
-        m_allShapes.insert(it, pShape);
+    invalidate_shapes_grid();
 
     store_in_map_imo_shape(pShape);
 }
 
+//---------------------------------------------------------------------------------------
+void GmoBoxDocPage::get_all_shapes(std::vector<GmoShape*>* pShapes)
+{
+    //shapes ordered by layer and creation order
+
+    size_t numShapes = 0;
+    std::vector< std::vector<GmoShape*> >::const_iterator it;
+    for (it = m_layers.begin(); it != m_layers.end(); ++it)
+        numShapes += it->size();
+
+    pShapes->reserve(pShapes->size() + numShapes);
+    for (it = m_layers.begin(); it != m_layers.end(); ++it)
+        pShapes->insert(pShapes->end(), it->begin(), it->end());
+}
+
 //---------------------------------------------------------------------------------------
 void GmoBoxDocPage::store_in_map_imo_shape(GmoShape* pShape)
 {
@@ -880,35 +971,47 @@ void GmoBoxDocPage::store_in_map_imo_shape(GmoShape* pShape)
 //---------------------------------------------------------------------------------------
 GmoShape* GmoBoxDocPage::get_first_shape_for_layer(int layer)
 {
-    std::list<GmoShape*>::reverse_iterator it;
-    for (it = m_allShapes.rbegin(); it != m_allShapes.rend(); ++it)
-    {
-        if ((*it)->get_layer() == layer)
-            return *it;
-    }
-    return nullptr;
+    //AWARE: returns the last shape added to the layer
+    if (layer < 0 || layer >= int(m_layers.size()) || m_layers[layer].empty())
+        return nullptr;
+    return m_layers[layer].back();
 }
 
 //---------------------------------------------------------------------------------------
 GmoShape* GmoBoxDocPage::find_shape_at(LUnits x, LUnits y)
 {
-    std::list<GmoShape*>::reverse_iterator it;
-    for (it = m_allShapes.rbegin(); it != m_allShapes.rend(); ++it)
+    return get_shapes_grid()->find_shape_at(x, y);
+}
+
+//---------------------------------------------------------------------------------------
+ShapesGrid* GmoBoxDocPage::get_shapes_grid()
+{
+    if (!m_fShapesGridValid)
     {
-        if ((*it)->hit_test(x, y))
-            return *it;
+        //AWARE: computing the drawing bounds ensures that moving any shape in this
+        //page will propagate the invalidation up to this page
+        get_drawing_bounds();
+
+        std::vector<GmoShape*> shapes;
+        get_all_shapes(&shapes);
+        m_shapesGrid.build(shapes);
+        m_fShapesGridValid = true;
     }
-    return nullptr;
+    return &m_shapesGrid;
 }
 
 //---------------------------------------------------------------------------------------
 GmoShape* GmoBoxDocPage::find_shape_for_object(ImoStaffObj* pSO)
 {
-    std::list<GmoShape*>::iterator it;
-    for (it = m_allShapes.begin(); it != m_allShapes.end(); ++it)
+    std::vector< std::vector<GmoShape*> >::const_iterator itL;
+    for (itL = m_layers.begin(); itL != m_layers.end(); ++itL)
     {
-        if ((*it)->was_created_by(pSO))
-            return *it;
+        std::vector<GmoShape*>::const_iterator it;
+        for (it = itL->begin(); it != itL->end(); ++it)
+        {
+            if ((*it)->was_created_by(pSO))
+                return *it;
+        }
     }
     return nullptr;
 }
@@ -932,20 +1035,15 @@ void GmoBoxDocPage::select_objects_in_rectangle(SelectionSet* selection,
                                                 const URect& selRect,
                                                 unsigned UNUSED(flags))
 {
-    bool fSomethingSelected = false;
-    std::list<GmoShape*>::reverse_iterator it;
-    for (it = m_allShapes.rbegin(); it != m_allShapes.rend(); ++it)
-    {
-        URect bbox = (*it)->get_bounds();
-        if (selRect.contains(bbox))
-        {
-            selection->add(*it);
-            fSomethingSelected = true;
-        }
-    }
+    std::vector<GmoShape*> shapes;
+    get_shapes_grid()->find_shapes_in_rectangle(selRect, &shapes);
+
+    std::vector<GmoShape*>::iterator it;
+    for (it = shapes.begin(); it != shapes.end(); ++it)
+        selection->add(*it);
 
     //if no objects in rectangle try to select clicked object
-    if (!fSomethingSelected)
+    if (shapes.empty())
     {
         GmoShape* pShape = find_shape_at(selRect.get_x(), selRect.get_y());
         if (pShape)
@@ -60,6 +60,7 @@ static long m_idCounter = 0L;
 //---------------------------------------------------------------------------------------
 GraphicModel::GraphicModel()
     : m_modified(true)
+    , m_numChanges(0L)
 {
     m_root = LOMSE_NEW GmoBoxDocument(this, nullptr);    //TODO: replace nullptr by ImoDocument
     m_modelId = ++m_idCounter;
@@ -159,9 +160,9 @@ void GraphicModel::store_in_map_imo_shape(ImoObj* pImo, GmoShape* pShape)
     ImoId id = pImo->get_id();
     ShapeId idx = pShape->get_shape_id();
     if (idx > 0)
-        m_imoToSecondaryShape[ make_pair(id, idx) ] = pShape;
+        m_imoToSecondaryShape.set(id, idx, pShape);
     else
-        m_imoToMainShape[id] = pShape;
+        m_imoToMainShape.set(id, pShape);
 }
 
 //---------------------------------------------------------------------------------------
@@ -172,18 +173,18 @@ void GraphicModel::add_to_map_imo_to_box(GmoBox* pBox)
     {
         ImoId id = pImo->get_id();
         //DBG ------------------------------------------------------------
-        map<ImoId, GmoBox*>::const_iterator it = m_imoToBox.find(id);
-        if (it != m_imoToBox.end())
+        GmoBox* pExisting = m_imoToBox.find(id);
+        if (pExisting)
         {
             LOMSE_LOG_ERROR(
                 "Duplicated Imo id %d. Existing Gmo: %s. Adding Gmo: %s",
-                id, (it->second)->get_name().c_str(), pBox->get_name().c_str() );
+                id, pExisting->get_name().c_str(), pBox->get_name().c_str() );
             //TO_INVESTIGATE: This is nor an error. An Imo can create two
             //boxes (currently DocPage and DocPageContent boxes). Maybe the
             //error is in the implications if this is accepted.
         }
         //END_DBG --------------------------------------------------------
-        m_imoToBox[id] = pBox;
+        m_imoToBox.set(id, pBox);
     }
 }
 
@@ -205,22 +206,15 @@ GmoShape* GraphicModel::get_shape_for_imo(ImoId id, ShapeId shapeId)
     if (shapeId == 0)
         return get_main_shape_for_imo(id);
     else
-    {
-        map< pair<ImoId, ShapeId>, GmoShape*>::const_iterator it
-            = m_imoToSecondaryShape.find( make_pair(id, shapeId) );
-        if (it != m_imoToSecondaryShape.end())
-            return it->second;
-        else
-            return nullptr;
-    }
+        return m_imoToSecondaryShape.find(id, shapeId);
 }
 
 //---------------------------------------------------------------------------------------
 GmoShape* GraphicModel::get_main_shape_for_imo(ImoId id)
 {
-    map<ImoId, GmoShape*>::const_iterator it = m_imoToMainShape.find(id);
-    if (it != m_imoToMainShape.end())
-        return it->second;
+    GmoShape* pShape = m_imoToMainShape.find(id);
+    if (pShape)
+        return pShape;
     else
     {
         LOMSE_LOG_DEBUG(Logger::k_score_player,
@@ -242,11 +236,7 @@ GmoObj* GraphicModel::get_box_for_control(GmoRef gref)
 //---------------------------------------------------------------------------------------
 GmoBox* GraphicModel::get_box_for_imo(ImoId id)
 {
-	map<ImoId, GmoBox*>::const_iterator it = m_imoToBox.find(id);
-	if (it != m_imoToBox.end())
-		return it->second;
-    else
-        return nullptr;
+    return m_imoToBox.find(id);
 }
 
 //---------------------------------------------------------------------------------------
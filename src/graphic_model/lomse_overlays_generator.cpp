@@ -34,6 +34,9 @@
 #include "lomse_logger.h"
 #include "lomse_visual_effect.h"
 
+#include <cmath>
+#include <cstring>
+
 
 namespace lomse
 {
@@ -50,6 +53,7 @@ OverlaysGenerator::OverlaysGenerator(GraphicView* view, LibraryScope& librarySco
     , m_pSaveBytes(nullptr)
     , m_damagedRect(0.0, 0.0, 0.0, 0.0)
     , m_prevDamagedRect(0.0, 0.0, 0.0, 0.0)
+    , m_overlaysArea(0, 0, 0, 0)
     , m_pHandlersOwner(nullptr)
 {
 }
@@ -84,8 +88,9 @@ void OverlaysGenerator::remove_visual_effect(VisualEffect* pEffect)
 //---------------------------------------------------------------------------------------
 void OverlaysGenerator::update_all_visual_effects(ScreenDrawer* pDrawer)
 {
+    //remove current overlays by restoring only the area they cover
     if (m_fBackgroundDirty)
-        m_pCanvasBuffer->copy_from(m_savedBuffer);
+        restore_overlays_area(pDrawer);
 
     m_damagedRect = URect(0.0, 0.0, 0.0, 0.0);
     int overlays = 0;
@@ -101,13 +106,71 @@ void OverlaysGenerator::update_all_visual_effects(ScreenDrawer* pDrawer)
     }
 
     if (overlays == 0)
+    {
         m_damagedRect = m_prevDamagedRect;
+        m_overlaysArea = VRect(0, 0, 0, 0);
+    }
     else
+    {
         expand_damaged_rectangle();
+        determine_overlays_area(pDrawer);
+    }
 
     m_fBackgroundDirty = (overlays > 0);
 }
 
+//---------------------------------------------------------------------------------------
+void OverlaysGenerator::determine_overlays_area(ScreenDrawer* pDrawer)
+{
+    //convert the area covered by overlays (m_damagedRect, already expanded for
+    //anti-aliasing) to pixels, clipped to canvas size
+
+    double left = m_damagedRect.left();
+    double top = m_damagedRect.top();
+    double right = m_damagedRect.right();
+    double bottom = m_damagedRect.bottom();
+    pDrawer->model_point_to_screen(&left, &top);
+    pDrawer->model_point_to_screen(&right, &bottom);
+
+    Pixels x1 = max(0, Pixels(floor(min(left, right))) - 1);
+    Pixels y1 = max(0, Pixels(floor(min(top, bottom))) - 1);
+    Pixels x2 = min(Pixels(ceil(max(left, right))) + 1, int(m_pCanvasBuffer->width()));
+    Pixels y2 = min(Pixels(ceil(max(top, bottom))) + 1, int(m_pCanvasBuffer->height()));
+
+    if (x2 <= x1 || y2 <= y1)
+        m_overlaysArea = VRect(0, 0, 0, 0);
+    else
+        m_overlaysArea = VRect(VPoint(x1, y1), VPoint(x2, y2));
+}
+
+//---------------------------------------------------------------------------------------
+void OverlaysGenerator::restore_overlays_area(ScreenDrawer* pDrawer)
+{
+    //copy from the clean copy only the pixels covered by the overlays drawn in
+    //previous update, instead of the whole rendering buffer
+
+    if (m_overlaysArea.width <= 0 || m_overlaysArea.height <= 0)
+        return;
+
+    //clean copy is no longer valid for current canvas. Restore all
+    if (m_savedBuffer.width() != m_pCanvasBuffer->width()
+        || m_savedBuffer.height() != m_pCanvasBuffer->height()
+        || m_savedBuffer.stride() != m_pCanvasBuffer->stride())
+    {
+        m_pCanvasBuffer->copy_from(m_savedBuffer);
+        return;
+    }
+
+    //AWARE: rows can be padded. Pixel size must be taken from the pixel format
+    unsigned bytesPerPixel = pDrawer->bytes_per_pixel();
+    size_t offset = size_t(m_overlaysArea.x) * bytesPerPixel;
+    size_t bytes = size_t(m_overlaysArea.width) * bytesPerPixel;
+    int yEnd = m_overlaysArea.y + m_overlaysArea.height;
+    for (int y = m_overlaysArea.y; y < yEnd; ++y)
+        memcpy(m_pCanvasBuffer->row_ptr(y) + offset, m_savedBuffer.row_ptr(y) + offset,
+               bytes);
+}
+
 //---------------------------------------------------------------------------------------
 void OverlaysGenerator::update_visual_effect(VisualEffect* pEffect,
                                              ScreenDrawer* pDrawer)
@@ -159,6 +222,7 @@ void OverlaysGenerator::save_rendering_buffer()
 
     m_savedBuffer.copy_from(*m_pCanvasBuffer);
     m_fBackgroundDirty = false;
+    m_overlaysArea = VRect(0, 0, 0, 0);
 }
 
 //---------------------------------------------------------------------------------------
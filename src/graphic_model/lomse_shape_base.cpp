@@ -244,6 +244,7 @@ void GmoCompositeShape::shift_origin(const USize& shift)
 {
     m_origin.x += shift.width;
     m_origin.y += shift.height;
+    invalidate_owner_drawing_bounds();
 
     //shift components
     std::list<GmoShape*>::iterator it;
@@ -46,7 +46,6 @@ GmoShapeNote::GmoShapeNote(ImoObj* pCreatorImo,
                            LibraryScope& libraryScope)
     : GmoCompositeShape(pCreatorImo, GmoObj::k_shape_note, 0, color)
     , VoiceRelatedShape()
-    , m_pFontStorage( libraryScope.font_storage() )
     , m_libraryScope(libraryScope)
     , m_pNoteheadShape(nullptr)
 	, m_pStemShape(nullptr)
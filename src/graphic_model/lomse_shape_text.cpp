@@ -48,7 +48,6 @@ GmoShapeText::GmoShapeText(ImoObj* pCreatorImo, ShapeId idx, const std::string&
     , m_text(text)
     , m_language(language)
     , m_pStyle(pStyle)
-    , m_pFontStorage( libraryScope.font_storage() )
     , m_libraryScope(libraryScope)
 {
     //bounds
@@ -128,7 +127,6 @@ GmoShapeWord::GmoShapeWord(ImoObj* pCreatorImo, ShapeId idx, const wstring& text
     , m_text(text)
     , m_language(language)
     , m_pStyle(pStyle)
-    , m_pFontStorage( libraryScope.font_storage() )
     , m_libraryScope(libraryScope)
     , m_halfLeading(halfLeading)
 {
@@ -288,7 +286,6 @@ GmoShapeTextBox::GmoShapeTextBox(ImoObj* pCreatorImo, ShapeId idx, const string&
     , m_text(text)
     , m_language(language)
     , m_pStyle(pStyle)
-    , m_pFontStorage( libraryScope.font_storage() )
     , m_libraryScope(libraryScope)
 {
 //    SetBorderStyle(nBorderStyle);
@@ -195,6 +195,7 @@ void GmoShapeSlurTie::on_handler_dragged(int iHandler, UPoint newPos)
     compute_vertices();
     compute_bounds();
     make_points_and_vertices_relative_to_origin();
+    invalidate_owner_drawing_bounds();
 }
 
 //---------------------------------------------------------------------------------------
@@ -45,7 +45,6 @@ GmoShapeGlyph::GmoShapeGlyph(ImoObj* pCreatorImo, int type, ShapeId idx,
                              unsigned int nGlyph, UPoint pos, Color color,
                              LibraryScope& libraryScope, double fontHeight)
     : GmoSimpleShape(pCreatorImo, type, idx, color)
-    , m_pFontStorage( libraryScope.font_storage() )
     , m_libraryScope(libraryScope)
 {
     m_glyph = m_libraryScope.get_glyphs_table()->glyph_code(nGlyph);
@@ -0,0 +1,181 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the Lomse library.
+// Lomse is copyrighted work (c) 2010-2016. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice, this
+//      list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright notice, this
+//      list of conditions and the following disclaimer in the documentation and/or
+//      other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+// TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+// BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+// ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+// For any comment, suggestion or feature request, please contact the manager of
+// the project at cecilios@users.sourceforge.net
+//---------------------------------------------------------------------------------------
+
+#include "lomse_shapes_grid.h"
+
+#include "lomse_gm_basic.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+namespace lomse
+{
+
+//=======================================================================================
+// ShapesGrid implementation
+//=======================================================================================
+ShapesGrid::ShapesGrid()
+    : m_area(0.0f, 0.0f, 0.0f, 0.0f)
+    , m_numCols(0)
+    , m_numRows(0)
+    , m_cellWidth(0.0f)
+    , m_cellHeight(0.0f)
+{
+}
+
+//---------------------------------------------------------------------------------------
+void ShapesGrid::clear()
+{
+    m_shapes.clear();
+    m_cells.clear();
+    m_numCols = 0;
+    m_numRows = 0;
+}
+
+//---------------------------------------------------------------------------------------
+void ShapesGrid::build(const std::vector<GmoShape*>& shapes)
+{
+    clear();
+    if (shapes.empty())
+        return;
+
+    m_shapes.assign(shapes.begin(), shapes.end());
+
+    //determine area covered by the shapes
+    LUnits xLeft = m_shapes[0]->get_left();
+    LUnits yTop = m_shapes[0]->get_top();
+    LUnits xRight = m_shapes[0]->get_right();
+    LUnits yBottom = m_shapes[0]->get_bottom();
+    std::vector<GmoShape*>::iterator it;
+    for (it = m_shapes.begin(); it != m_shapes.end(); ++it)
+    {
+        xLeft = min(xLeft, (*it)->get_left());
+        yTop = min(yTop, (*it)->get_top());
+        xRight = max(xRight, (*it)->get_right());
+        yBottom = max(yBottom, (*it)->get_bottom());
+    }
+    m_area = URect(xLeft, yTop, xRight - xLeft, yBottom - yTop);
+
+    //grid size: aprox. two shapes per cell, in square cells
+    const int maxCells = 64;
+    int numCells = max(1, int(m_shapes.size()) / 2);
+    LUnits ratio = (m_area.height > 0.0f && m_area.width > 0.0f
+                    ? m_area.width / m_area.height : 1.0f);
+    m_numCols = int( sqrt(double(numCells) * ratio) );
+    m_numRows = int( sqrt(double(numCells) / ratio) );
+    m_numCols = max(1, min(maxCells, m_numCols));
+    m_numRows = max(1, min(maxCells, m_numRows));
+    m_cellWidth = max(1.0f, m_area.width / LUnits(m_numCols));
+    m_cellHeight = max(1.0f, m_area.height / LUnits(m_numRows));
+
+    //distribute shapes
+    m_cells.resize(m_numCols * m_numRows);
+    for (int i=0; i < int(m_shapes.size()); ++i)
+    {
+        GmoShape* pShape = m_shapes[i];
+        int colMax = col_for(pShape->get_right());
+        int rowMax = row_for(pShape->get_bottom());
+        for (int row = row_for(pShape->get_top()); row <= rowMax; ++row)
+        {
+            for (int col = col_for(pShape->get_left()); col <= colMax; ++col)
+                m_cells[row * m_numCols + col].push_back(i);
+        }
+    }
+}
+
+//---------------------------------------------------------------------------------------
+int ShapesGrid::col_for(LUnits x)
+{
+    int col = int( floor((x - m_area.x) / m_cellWidth) );
+    return max(0, min(m_numCols - 1, col));
+}
+
+//---------------------------------------------------------------------------------------
+int ShapesGrid::row_for(LUnits y)
+{
+    int row = int( floor((y - m_area.y) / m_cellHeight) );
+    return max(0, min(m_numRows - 1, row));
+}
+
+//---------------------------------------------------------------------------------------
+GmoShape* ShapesGrid::find_shape_at(LUnits x, LUnits y)
+{
+    //returns the top most shape at point (x, y) or nullptr
+
+    if (m_cells.empty() || !m_area.contains(x, y))
+        return nullptr;
+
+    std::vector<int>& cell = m_cells[row_for(y) * m_numCols + col_for(x)];
+    std::vector<int>::reverse_iterator it;
+    for (it = cell.rbegin(); it != cell.rend(); ++it)
+    {
+        if (m_shapes[*it]->hit_test(x, y))
+            return m_shapes[*it];
+    }
+    return nullptr;
+}
+
+//---------------------------------------------------------------------------------------
+void ShapesGrid::find_shapes_in_rectangle(const URect& rect,
+                                          std::vector<GmoShape*>* pFound)
+{
+    //adds to pFound all shapes fully contained in rect, top most shapes first
+
+    if (m_cells.empty() || !m_area.intersects(rect))
+        return;
+
+    std::vector<int> found;
+    int colMax = col_for(rect.right());
+    int rowMax = row_for(rect.bottom());
+    for (int row = row_for(rect.y); row <= rowMax; ++row)
+    {
+        for (int col = col_for(rect.x); col <= colMax; ++col)
+        {
+            std::vector<int>& cell = m_cells[row * m_numCols + col];
+            std::vector<int>::iterator it;
+            for (it = cell.begin(); it != cell.end(); ++it)
+            {
+                if (rect.contains( m_shapes[*it]->get_bounds() ))
+                    found.push_back(*it);
+            }
+        }
+    }
+
+    //a shape spanning several cells is found several times
+    std::sort(found.begin(), found.end());
+    found.erase( std::unique(found.begin(), found.end()), found.end() );
+
+    std::vector<int>::reverse_iterator it;
+    for (it = found.rbegin(); it != found.rend(); ++it)
+        pFound->push_back( m_shapes[*it] );
+}
+
+
+}   //namespace lomse
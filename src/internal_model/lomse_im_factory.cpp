@@ -48,96 +48,97 @@ ImoObj* ImFactory::inject(Document* pDoc, const std::string& ldpSource)
 ImoObj* ImFactory::inject(int type, Document* pDoc, ImoId id)
 {
     ImoObj* pObj = nullptr;
+    ModelArena* pArena = pDoc->get_model_arena();
 
     if (!(type > k_imo_dto && type < k_imo_dto_last))
         id = pDoc->reserve_id(id);
 
     switch(type)
     {
-        case k_imo_anonymous_block:     pObj = LOMSE_NEW ImoAnonymousBlock();     break;
-        case k_imo_articulation_symbol: pObj = LOMSE_NEW ImoArticulationSymbol(); break;
-        case k_imo_articulation_line:   pObj = LOMSE_NEW ImoArticulationLine();   break;
-        case k_imo_attachments:         pObj = LOMSE_NEW ImoAttachments();        break;
-        case k_imo_barline:             pObj = LOMSE_NEW ImoBarline();            break;
-        case k_imo_beam:                pObj = LOMSE_NEW ImoBeam();               break;
-        case k_imo_beam_dto:            pObj = LOMSE_NEW ImoBeamDto();            break;
-        case k_imo_bezier_info:         pObj = LOMSE_NEW ImoBezierInfo();         break;
-        case k_imo_button:              pObj = LOMSE_NEW ImoButton();             break;
-        case k_imo_chord:               pObj = LOMSE_NEW ImoChord();              break;
-        case k_imo_clef:                pObj = LOMSE_NEW ImoClef();               break;
-        case k_imo_color_dto:           pObj = LOMSE_NEW ImoColorDto();           break;
-        case k_imo_content:             pObj = LOMSE_NEW ImoContent();            break;
-        case k_imo_cursor_info:         pObj = LOMSE_NEW ImoCursorInfo();         break;
-        case k_imo_direction:           pObj = LOMSE_NEW ImoDirection();          break;
-        case k_imo_document:            pObj = LOMSE_NEW ImoDocument();           break;
-        case k_imo_dynamic:             pObj = LOMSE_NEW ImoDynamic();            break;
-        case k_imo_dynamics_mark:       pObj = LOMSE_NEW ImoDynamicsMark();       break;
-        case k_imo_fermata:             pObj = LOMSE_NEW ImoFermata();            break;
-        case k_imo_font_style_dto:      pObj = LOMSE_NEW ImoFontStyleDto();       break;
-        case k_imo_go_back_fwd:         pObj = LOMSE_NEW ImoGoBackFwd();          break;
-        case k_imo_heading:             pObj = LOMSE_NEW ImoHeading();            break;
-        case k_imo_image:               pObj = LOMSE_NEW ImoImage();              break;
-        case k_imo_inline_wrapper:      pObj = LOMSE_NEW ImoInlineWrapper();      break;
-        case k_imo_instr_group:         pObj = LOMSE_NEW ImoInstrGroup();         break;
-        case k_imo_instrument:          pObj = LOMSE_NEW ImoInstrument();         break;
-        case k_imo_instruments:         pObj = LOMSE_NEW ImoInstruments();        break;
-        case k_imo_instrument_groups:   pObj = LOMSE_NEW ImoInstrGroups();        break;
-        case k_imo_key_signature:       pObj = LOMSE_NEW ImoKeySignature();       break;
-        case k_imo_line:                pObj = LOMSE_NEW ImoLine();               break;
-        case k_imo_line_style:          pObj = LOMSE_NEW ImoLineStyle();          break;
-        case k_imo_list:                pObj = LOMSE_NEW ImoList(pDoc);           break;
-        case k_imo_listitem:            pObj = LOMSE_NEW ImoListItem(pDoc);       break;
-        case k_imo_link:                pObj = LOMSE_NEW ImoLink();               break;
-        case k_imo_lyric:               pObj = LOMSE_NEW ImoLyric();              break;
-        case k_imo_lyrics_text_info:    pObj = LOMSE_NEW ImoLyricsTextInfo();     break;
-        case k_imo_metronome_mark:      pObj = LOMSE_NEW ImoMetronomeMark();      break;
-        case k_imo_midi_info:           pObj = LOMSE_NEW ImoMidiInfo();           break;
-        case k_imo_multicolumn:         pObj = LOMSE_NEW ImoMultiColumn(pDoc);    break;
-        case k_imo_music_data:          pObj = LOMSE_NEW ImoMusicData();          break;
-        case k_imo_note:                pObj = LOMSE_NEW ImoNote();               break;
-        case k_imo_option:              pObj = LOMSE_NEW ImoOptionInfo();         break;
-        case k_imo_options:             pObj = LOMSE_NEW ImoOptions();            break;
-        case k_imo_ornament:            pObj = LOMSE_NEW ImoOrnament();           break;
-        case k_imo_page_info:           pObj = LOMSE_NEW ImoPageInfo();           break;
-        case k_imo_para:                pObj = LOMSE_NEW ImoParagraph();          break;
-        case k_imo_param_info:          pObj = LOMSE_NEW ImoParamInfo();          break;
-        case k_imo_relations:           pObj = LOMSE_NEW ImoRelations();          break;
-        case k_imo_rest:                pObj = LOMSE_NEW ImoRest();               break;
-        case k_imo_score:               pObj = LOMSE_NEW ImoScore(pDoc);          break;
-        case k_imo_score_line:          pObj = LOMSE_NEW ImoScoreLine();          break;
-        case k_imo_score_player:        pObj = LOMSE_NEW ImoScorePlayer();        break;
-        case k_imo_score_text:          pObj = LOMSE_NEW ImoScoreText();          break;
-        case k_imo_score_title:         pObj = LOMSE_NEW ImoScoreTitle();         break;
-        case k_imo_slur:                pObj = LOMSE_NEW ImoSlur();               break;
-        case k_imo_slur_dto:            pObj = LOMSE_NEW ImoSlurDto();            break;
-        case k_imo_sound_change:        pObj = LOMSE_NEW ImoSoundChange();        break;
-        case k_imo_sound_info:          pObj = LOMSE_NEW ImoSoundInfo();          break;
-        case k_imo_sounds:              pObj = LOMSE_NEW ImoSounds();             break;
-        case k_imo_staff_info:          pObj = LOMSE_NEW ImoStaffInfo();          break;
-        case k_imo_style:               pObj = LOMSE_NEW ImoStyle();              break;
-        case k_imo_styles:              pObj = LOMSE_NEW ImoStyles(pDoc);         break;
-        case k_imo_symbol_repetition_mark:  pObj = LOMSE_NEW ImoSymbolRepetitionMark();   break;
-        case k_imo_system_break:        pObj = LOMSE_NEW ImoSystemBreak();        break;
-        case k_imo_system_info:         pObj = LOMSE_NEW ImoSystemInfo();         break;
-        case k_imo_table:               pObj = LOMSE_NEW ImoTable();              break;
-        case k_imo_table_cell:          pObj = LOMSE_NEW ImoTableCell(pDoc);      break;
-        case k_imo_table_body:          pObj = LOMSE_NEW ImoTableBody();          break;
-        case k_imo_table_head:          pObj = LOMSE_NEW ImoTableHead();          break;
-        case k_imo_table_row:           pObj = LOMSE_NEW ImoTableRow(pDoc);       break;
-        case k_imo_technical:           pObj = LOMSE_NEW ImoTechnical();          break;
-        case k_imo_textblock_info:      pObj = LOMSE_NEW ImoTextBlockInfo();      break;
-        case k_imo_text_box:            pObj = LOMSE_NEW ImoTextBox();            break;
-        case k_imo_text_info:           pObj = LOMSE_NEW ImoTextInfo();           break;
-        case k_imo_text_item:           pObj = LOMSE_NEW ImoTextItem();           break;
-        case k_imo_text_repetition_mark:   pObj = LOMSE_NEW ImoTextRepetitionMark();   break;
-        case k_imo_tie:                 pObj = LOMSE_NEW ImoTie();                break;
-        case k_imo_tie_dto:             pObj = LOMSE_NEW ImoTieDto();             break;
-        case k_imo_time_modification_dto:  pObj = LOMSE_NEW ImoTimeModificationDto();  break;
-        case k_imo_time_signature:      pObj = LOMSE_NEW ImoTimeSignature();      break;
-        case k_imo_tuplet:              pObj = LOMSE_NEW ImoTuplet();             break;
-        case k_imo_tuplet_dto:          pObj = LOMSE_NEW ImoTupletDto();          break;
-        case k_imo_volta_bracket:       pObj = LOMSE_NEW ImoVoltaBracket();       break;
-        case k_imo_volta_bracket_dto:   pObj = LOMSE_NEW ImoVoltaBracketDto();    break;
+        case k_imo_anonymous_block:     pObj = new (pArena) ImoAnonymousBlock();     break;
+        case k_imo_articulation_symbol: pObj = new (pArena) ImoArticulationSymbol(); break;
+        case k_imo_articulation_line:   pObj = new (pArena) ImoArticulationLine();   break;
+        case k_imo_attachments:         pObj = new (pArena) ImoAttachments();        break;
+        case k_imo_barline:             pObj = new (pArena) ImoBarline();            break;
+        case k_imo_beam:                pObj = new (pArena) ImoBeam();               break;
+        case k_imo_beam_dto:            pObj = new (pArena) ImoBeamDto();            break;
+        case k_imo_bezier_info:         pObj = new (pArena) ImoBezierInfo();         break;
+        case k_imo_button:              pObj = new (pArena) ImoButton();             break;
+        case k_imo_chord:               pObj = new (pArena) ImoChord();              break;
+        case k_imo_clef:                pObj = new (pArena) ImoClef();               break;
+        case k_imo_color_dto:           pObj = new (pArena) ImoColorDto();           break;
+        case k_imo_content:             pObj = new (pArena) ImoContent();            break;
+        case k_imo_cursor_info:         pObj = new (pArena) ImoCursorInfo();         break;
+        case k_imo_direction:           pObj = new (pArena) ImoDirection();          break;
+        case k_imo_document:            pObj = new (pArena) ImoDocument();           break;
+        case k_imo_dynamic:             pObj = new (pArena) ImoDynamic();            break;
+        case k_imo_dynamics_mark:       pObj = new (pArena) ImoDynamicsMark();       break;
+        case k_imo_fermata:             pObj = new (pArena) ImoFermata();            break;
+        case k_imo_font_style_dto:      pObj = new (pArena) ImoFontStyleDto();       break;
+        case k_imo_go_back_fwd:         pObj = new (pArena) ImoGoBackFwd();          break;
+        case k_imo_heading:             pObj = new (pArena) ImoHeading();            break;
+        case k_imo_image:               pObj = new (pArena) ImoImage();              break;
+        case k_imo_inline_wrapper:      pObj = new (pArena) ImoInlineWrapper();      break;
+        case k_imo_instr_group:         pObj = new (pArena) ImoInstrGroup();         break;
+        case k_imo_instrument:          pObj = new (pArena) ImoInstrument();         break;
+        case k_imo_instruments:         pObj = new (pArena) ImoInstruments();        break;
+        case k_imo_instrument_groups:   pObj = new (pArena) ImoInstrGroups();        break;
+        case k_imo_key_signature:       pObj = new (pArena) ImoKeySignature();       break;
+        case k_imo_line:                pObj = new (pArena) ImoLine();               break;
+        case k_imo_line_style:          pObj = new (pArena) ImoLineStyle();          break;
+        case k_imo_list:                pObj = new (pArena) ImoList(pDoc);           break;
+        case k_imo_listitem:            pObj = new (pArena) ImoListItem(pDoc);       break;
+        case k_imo_link:                pObj = new (pArena) ImoLink();               break;
+        case k_imo_lyric:               pObj = new (pArena) ImoLyric();              break;
+        case k_imo_lyrics_text_info:    pObj = new (pArena) ImoLyricsTextInfo();     break;
+        case k_imo_metronome_mark:      pObj = new (pArena) ImoMetronomeMark();      break;
+        case k_imo_midi_info:           pObj = new (pArena) ImoMidiInfo();           break;
+        case k_imo_multicolumn:         pObj = new (pArena) ImoMultiColumn(pDoc);    break;
+        case k_imo_music_data:          pObj = new (pArena) ImoMusicData();          break;
+        case k_imo_note:                pObj = new (pArena) ImoNote();               break;
+        case k_imo_option:              pObj = new (pArena) ImoOptionInfo();         break;
+        case k_imo_options:             pObj = new (pArena) ImoOptions();            break;
+        case k_imo_ornament:            pObj = new (pArena) ImoOrnament();           break;
+        case k_imo_page_info:           pObj = new (pArena) ImoPageInfo();           break;
+        case k_imo_para:                pObj = new (pArena) ImoParagraph();          break;
+        case k_imo_param_info:          pObj = new (pArena) ImoParamInfo();          break;
+        case k_imo_relations:           pObj = new (pArena) ImoRelations();          break;
+        case k_imo_rest:                pObj = new (pArena) ImoRest();               break;
+        case k_imo_score:               pObj = new (pArena) ImoScore(pDoc);          break;
+        case k_imo_score_line:          pObj = new (pArena) ImoScoreLine();          break;
+        case k_imo_score_player:        pObj = new (pArena) ImoScorePlayer();        break;
+        case k_imo_score_text:          pObj = new (pArena) ImoScoreText();          break;
+        case k_imo_score_title:         pObj = new (pArena) ImoScoreTitle();         break;
+        case k_imo_slur:                pObj = new (pArena) ImoSlur();               break;
+        case k_imo_slur_dto:            pObj = new (pArena) ImoSlurDto();            break;
+        case k_imo_sound_change:        pObj = new (pArena) ImoSoundChange();        break;
+        case k_imo_sound_info:          pObj = new (pArena) ImoSoundInfo();          break;
+        case k_imo_sounds:              pObj = new (pArena) ImoSounds();             break;
+        case k_imo_staff_info:          pObj = new (pArena) ImoStaffInfo();          break;
+        case k_imo_style:               pObj = new (pArena) ImoStyle();              break;
+        case k_imo_styles:              pObj = new (pArena) ImoStyles(pDoc);         break;
+        case k_imo_symbol_repetition_mark:  pObj = new (pArena) ImoSymbolRepetitionMark();   break;
+        case k_imo_system_break:        pObj = new (pArena) ImoSystemBreak();        break;
+        case k_imo_system_info:         pObj = new (pArena) ImoSystemInfo();         break;
+        case k_imo_table:               pObj = new (pArena) ImoTable();              break;
+        case k_imo_table_cell:          pObj = new (pArena) ImoTableCell(pDoc);      break;
+        case k_imo_table_body:          pObj = new (pArena) ImoTableBody();          break;
+        case k_imo_table_head:          pObj = new (pArena) ImoTableHead();          break;
+        case k_imo_table_row:           pObj = new (pArena) ImoTableRow(pDoc);       break;
+        case k_imo_technical:           pObj = new (pArena) ImoTechnical();          break;
+        case k_imo_textblock_info:      pObj = new (pArena) ImoTextBlockInfo();      break;
+        case k_imo_text_box:            pObj = new (pArena) ImoTextBox();            break;
+        case k_imo_text_info:           pObj = new (pArena) ImoTextInfo();           break;
+        case k_imo_text_item:           pObj = new (pArena) ImoTextItem();           break;
+        case k_imo_text_repetition_mark:   pObj = new (pArena) ImoTextRepetitionMark();   break;
+        case k_imo_tie:                 pObj = new (pArena) ImoTie();                break;
+        case k_imo_tie_dto:             pObj = new (pArena) ImoTieDto();             break;
+        case k_imo_time_modification_dto:  pObj = new (pArena) ImoTimeModificationDto();  break;
+        case k_imo_time_signature:      pObj = new (pArena) ImoTimeSignature();      break;
+        case k_imo_tuplet:              pObj = new (pArena) ImoTuplet();             break;
+        case k_imo_tuplet_dto:          pObj = new (pArena) ImoTupletDto();          break;
+        case k_imo_volta_bracket:       pObj = new (pArena) ImoVoltaBracket();       break;
+        case k_imo_volta_bracket_dto:   pObj = new (pArena) ImoVoltaBracketDto();    break;
         default:
         {
             LOMSE_LOG_ERROR("[ImFactory::inject] invalid type.");
@@ -145,11 +146,9 @@ ImoObj* ImFactory::inject(int type, Document* pDoc, ImoId id)
         }
     }
 
+    pObj->set_id(id);
     if (!pObj->is_dto())
-    {
-        pObj->set_id(id);
         pDoc->assign_id(pObj);
-    }
     pObj->set_owner_document(pDoc);
     pObj->initialize_object(pDoc);
     return pObj;
@@ -158,7 +157,7 @@ ImoObj* ImFactory::inject(int type, Document* pDoc, ImoId id)
 //---------------------------------------------------------------------------------------
 ImoBeamData* ImFactory::inject_beam_data(Document* pDoc, ImoBeamDto* pDto)
 {
-    ImoBeamData* pObj = LOMSE_NEW ImoBeamData(pDto);
+    ImoBeamData* pObj = new (pDoc->get_model_arena()) ImoBeamData(pDto);
     pDoc->assign_id(pObj);
     pObj->set_owner_document(pDoc);
     return pObj;
@@ -167,7 +166,7 @@ ImoBeamData* ImFactory::inject_beam_data(Document* pDoc, ImoBeamDto* pDto)
 //---------------------------------------------------------------------------------------
 ImoTieData* ImFactory::inject_tie_data(Document* pDoc, ImoTieDto* pDto)
 {
-    ImoTieData* pObj = LOMSE_NEW ImoTieData(pDto);
+    ImoTieData* pObj = new (pDoc->get_model_arena()) ImoTieData(pDto);
     pDoc->assign_id(pObj);
     pObj->set_owner_document(pDoc);
     return pObj;
@@ -176,7 +175,7 @@ ImoTieData* ImFactory::inject_tie_data(Document* pDoc, ImoTieDto* pDto)
 //---------------------------------------------------------------------------------------
 ImoSlurData* ImFactory::inject_slur_data(Document* pDoc, ImoSlurDto* pDto)
 {
-    ImoSlurData* pObj = LOMSE_NEW ImoSlurData(pDto);
+    ImoSlurData* pObj = new (pDoc->get_model_arena()) ImoSlurData(pDto);
     pDoc->assign_id(pObj);
     pObj->set_owner_document(pDoc);
     return pObj;
@@ -185,7 +184,7 @@ ImoSlurData* ImFactory::inject_slur_data(Document* pDoc, ImoSlurDto* pDto)
 //---------------------------------------------------------------------------------------
 ImoTuplet* ImFactory::inject_tuplet(Document* pDoc, ImoTupletDto* pDto)
 {
-    ImoTuplet* pObj = LOMSE_NEW ImoTuplet(pDto);
+    ImoTuplet* pObj = new (pDoc->get_model_arena()) ImoTuplet(pDto);
     pObj->set_id( pDto->get_id() );
     pDoc->assign_id(pObj);
     pObj->set_owner_document(pDoc);
@@ -195,7 +194,7 @@ ImoTuplet* ImFactory::inject_tuplet(Document* pDoc, ImoTupletDto* pDto)
 //---------------------------------------------------------------------------------------
 ImoTextBox* ImFactory::inject_text_box(Document* pDoc, ImoTextBlockInfo& dto, ImoId id)
 {
-    ImoTextBox* pObj = LOMSE_NEW ImoTextBox(dto);
+    ImoTextBox* pObj = new (pDoc->get_model_arena()) ImoTextBox(dto);
     pObj->set_id(id);
     pDoc->assign_id(pObj);
     pObj->set_owner_document(pDoc);
@@ -207,7 +206,8 @@ ImoNote* ImFactory::inject_note(Document* pDoc, int step, int octave,
                                 int noteType, EAccidentals accidentals,
                                 int dots, int staff, int voice, int stem)
 {
-    ImoNote* pObj = LOMSE_NEW ImoNote(step, octave, noteType, accidentals, dots,
+    ImoNote* pObj = new (pDoc->get_model_arena())
+                        ImoNote(step, octave, noteType, accidentals, dots,
                                 staff, voice, stem);
     pDoc->assign_id(pObj);
     pObj->set_owner_document(pDoc);
@@ -217,7 +217,7 @@ ImoNote* ImFactory::inject_note(Document* pDoc, int step, int octave,
 //---------------------------------------------------------------------------------------
 ImoMultiColumn* ImFactory::inject_multicolumn(Document* pDoc)
 {
-    ImoMultiColumn* pObj = LOMSE_NEW ImoMultiColumn(pDoc);
+    ImoMultiColumn* pObj = new (pDoc->get_model_arena()) ImoMultiColumn(pDoc);
     pDoc->assign_id(pObj);
     pObj->set_owner_document(pDoc);
     return pObj;
@@ -227,7 +227,7 @@ ImoMultiColumn* ImFactory::inject_multicolumn(Document* pDoc)
 ImoImage* ImFactory::inject_image(Document* pDoc, unsigned char* imgbuf, VSize bmpSize,
                                   EPixelFormat format, USize imgSize)
 {
-    ImoImage* pObj = LOMSE_NEW ImoImage(imgbuf, bmpSize, format, imgSize);
+    ImoImage* pObj = new (pDoc->get_model_arena()) ImoImage(imgbuf, bmpSize, format, imgSize);
     pDoc->assign_id(pObj);
     pObj->set_owner_document(pDoc);
     return pObj;
@@ -236,7 +236,7 @@ ImoImage* ImFactory::inject_image(Document* pDoc, unsigned char* imgbuf, VSize b
 //---------------------------------------------------------------------------------------
 ImoControl* ImFactory::inject_control(Document* pDoc, Control* ctrol)
 {
-    ImoControl* pObj = LOMSE_NEW ImoControl(ctrol);
+    ImoControl* pObj = new (pDoc->get_model_arena()) ImoControl(ctrol);
     pDoc->assign_id(pObj);
     pObj->set_owner_document(pDoc);
     return pObj;
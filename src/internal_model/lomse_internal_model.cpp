@@ -383,6 +383,23 @@ ImoObj::ImoObj(int objtype, ImoId id)
     , m_flags(k_dirty)
     , m_pAttribs(nullptr)
 {
+    if (allocated_in_arena(this))
+        m_flags |= k_in_arena;
+}
+
+//---------------------------------------------------------------------------------------
+ImoObj::ImoObj(const ImoObj& a)
+    : Visitable(a)
+    , TreeNode<ImoObj>(a)
+    , ArenaObject()
+    , m_pDoc(a.m_pDoc)
+    , m_id(a.m_id)
+    , m_objtype(a.m_objtype)
+    , m_flags(a.m_flags & ~k_in_arena)
+    , m_pAttribs(a.m_pAttribs)
+{
+    if (allocated_in_arena(this))
+        m_flags |= k_in_arena;
 }
 
 //---------------------------------------------------------------------------------------
@@ -399,6 +416,9 @@ ImoObj::~ImoObj()
 
     remove_id();
     delete_attributes();
+
+    //AWARE: must be the last action, as deleting children also uses it
+    release_in_arena( (m_flags & k_in_arena) ? get_model_arena() : nullptr );
 }
 
 //---------------------------------------------------------------------------------------
@@ -636,6 +656,15 @@ ImoDocument* ImoObj::get_document()
         return nullptr;
 }
 
+//---------------------------------------------------------------------------------------
+ModelArena* ImoObj::get_model_arena()
+{
+    if (m_pDoc)
+        return m_pDoc->get_model_arena();
+    else
+        return nullptr;
+}
+
 //---------------------------------------------------------------------------------------
 Observable* ImoObj::get_observable_parent()
 {
@@ -1922,6 +1951,8 @@ ImoContentObj::ImoContentObj(int objtype)
     : ImoObj(objtype)
     , Observable()
     , m_pStyle(nullptr)
+    , m_pNamedStyle(nullptr)
+    , m_namedStyleEpoch(0)
     , m_txUserLocation(0.0f)
     , m_tyUserLocation(0.0f)
     , m_txUserRefPoint(0.0f)
@@ -1935,6 +1966,8 @@ ImoContentObj::ImoContentObj(ImoId id, int objtype)
     : ImoObj(id, objtype)
     , Observable()
     , m_pStyle(nullptr)
+    , m_pNamedStyle(nullptr)
+    , m_namedStyleEpoch(0)
     , m_txUserLocation(0.0f)
     , m_tyUserLocation(0.0f)
     , m_txUserRefPoint(0.0f)
@@ -2029,14 +2062,15 @@ ImoStyle* ImoContentObj::get_style(bool fInherit)
 //---------------------------------------------------------------------------------------
 ImoStyle* ImoContentObj::get_inherited_style()
 {
+    if (m_pNamedStyle && m_namedStyleEpoch == ImoStyle::resolved_styles_epoch(m_pDoc))
+        return m_pNamedStyle;
+
     string name;
     switch(get_obj_type())
     {
         case k_imo_heading:
         {
-            stringstream style;
-            style << "Heading-" << static_cast<ImoHeading*>(this)->get_level();
-            name = style.str();
+            name = "Heading-" + std::to_string(static_cast<ImoHeading*>(this)->get_level());
             break;
         }
         case k_imo_para:
@@ -2058,7 +2092,11 @@ ImoStyle* ImoContentObj::get_inherited_style()
 
     ImoDocument* pDoc = this->get_document();
     if (pDoc)
-        return pDoc->find_style(name);
+    {
+        m_namedStyleEpoch = ImoStyle::resolved_styles_epoch(m_pDoc);
+        m_pNamedStyle = pDoc->find_style(name);
+        return m_pNamedStyle;
+    }
     else
         return nullptr;
 }
@@ -3751,6 +3789,13 @@ void ImoScore::end_of_changes()
     builder.structurize(this);
 }
 
+//---------------------------------------------------------------------------------------
+void ImoScore::end_of_changes(ImoInstrument* pInstr, ImoStaffObj* pFirstChanged)
+{
+    ModelBuilder builder;
+    builder.structurize(this, get_instr_number_for(pInstr), pFirstChanged);
+}
+
 
 
 //=======================================================================================
@@ -3925,6 +3970,103 @@ ImoMidiInfo* ImoSoundChange::get_midi_info(const string& soundId)
 //=======================================================================================
 // ImoStyle implementation
 //=======================================================================================
+
+//---------------------------------------------------------------------------------------
+ImoStyle::~ImoStyle()
+{
+    delete m_pResolved;
+}
+
+//---------------------------------------------------------------------------------------
+void ImoStyle::invalidate_resolved_styles(Document* pDoc)
+{
+    if (pDoc)
+        pDoc->invalidate_resolved_styles();
+}
+
+//---------------------------------------------------------------------------------------
+unsigned ImoStyle::resolved_styles_epoch(Document* pDoc)
+{
+    return pDoc ? pDoc->get_styles_epoch() : 0;
+}
+
+//---------------------------------------------------------------------------------------
+void ImoStyle::resolve_props()
+{
+    unsigned epoch = resolved_styles_epoch(m_pDoc);
+
+    if (m_pResolved == nullptr)
+        m_pResolved = LOMSE_NEW ResolvedProps;
+
+    ResolvedProps* pProps = m_pResolved;
+    std::fill(pProps->fFloat, pProps->fFloat + k_max_style_property, false);
+    std::fill(pProps->fLUnits, pProps->fLUnits + k_max_style_property, false);
+    std::fill(pProps->fString, pProps->fString + k_max_style_property, false);
+    std::fill(pProps->fInt, pProps->fInt + k_max_style_property, false);
+    std::fill(pProps->fColor, pProps->fColor + k_max_style_property, false);
+
+    //apply values from the root style down to this one, so that own values
+    //override inherited ones
+    vector<ImoStyle*> chain;
+    for (ImoStyle* pStyle = this; pStyle; pStyle = pStyle->m_pParent)
+        chain.push_back(pStyle);
+
+    for (vector<ImoStyle*>::reverse_iterator it = chain.rbegin(); it != chain.rend(); ++it)
+        (*it)->add_own_props(pProps);
+
+    m_resolvedEpoch = epoch;
+}
+
+//---------------------------------------------------------------------------------------
+void ImoStyle::add_own_props(ResolvedProps* pProps)
+{
+    for (map<int, float>::const_iterator it = m_floatProps.begin();
+         it != m_floatProps.end(); ++it)
+    {
+        if (it->first >= 0 && it->first < k_max_style_property)
+        {
+            pProps->fFloat[it->first] = true;
+            pProps->floats[it->first] = it->second;
+        }
+    }
+    for (map<int, LUnits>::const_iterator it = m_lunitsProps.begin();
+         it != m_lunitsProps.end(); ++it)
+    {
+        if (it->first >= 0 && it->first < k_max_style_property)
+        {
+            pProps->fLUnits[it->first] = true;
+            pProps->lunits[it->first] = it->second;
+        }
+    }
+    for (map<int, string>::const_iterator it = m_stringProps.begin();
+         it != m_stringProps.end(); ++it)
+    {
+        if (it->first >= 0 && it->first < k_max_style_property)
+        {
+            pProps->fString[it->first] = true;
+            pProps->strings[it->first] = &(it->second);
+        }
+    }
+    for (map<int, int>::const_iterator it = m_intProps.begin();
+         it != m_intProps.end(); ++it)
+    {
+        if (it->first >= 0 && it->first < k_max_style_property)
+        {
+            pProps->fInt[it->first] = true;
+            pProps->ints[it->first] = it->second;
+        }
+    }
+    for (map<int, Color>::const_iterator it = m_colorProps.begin();
+         it != m_colorProps.end(); ++it)
+    {
+        if (it->first >= 0 && it->first < k_max_style_property)
+        {
+            pProps->fColor[it->first] = true;
+            pProps->colors[it->first] = it->second;
+        }
+    }
+}
+
 bool ImoStyle::is_default_style_with_default_values()
 {
     //returns true if it is a default style and contains default values
@@ -4698,6 +4840,7 @@ void ImoStyles::add_style(ImoStyle* pStyle)
     ImoStyle* oldStyle = find_style(name);
     delete oldStyle;
     m_nameToStyle[name] = pStyle;
+    ImoStyle::invalidate_resolved_styles(m_pDoc);
 }
 
 //---------------------------------------------------------------------------------------
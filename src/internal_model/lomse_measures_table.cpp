@@ -33,6 +33,7 @@
 #include "lomse_staffobjs_table.h"
 
 
+#include <algorithm>
 #include <sstream>
 using namespace std;
 
@@ -49,6 +50,7 @@ ImMeasuresTableEntry::ImMeasuresTableEntry(ColStaffObjsEntry* pEntry)
     , m_bottomBeat(LOMSE_NO_DURATION)
     , m_impliedBeat(LOMSE_NO_DURATION)
     , m_pCsoEntry(pEntry)
+    , m_pKey(nullptr)
 {
     if (pEntry != nullptr)
         m_timepos = pEntry->time();
@@ -62,6 +64,7 @@ ImMeasuresTableEntry::ImMeasuresTableEntry()
     , m_bottomBeat(LOMSE_NO_DURATION)
     , m_impliedBeat(LOMSE_NO_DURATION)
     , m_pCsoEntry(nullptr)
+    , m_pKey(nullptr)
 {
 }
 
@@ -106,6 +109,32 @@ ImMeasuresTableEntry* ImMeasuresTable::add_entry(ColStaffObjsEntry* pCsoEntry)
     return pEntry;
 }
 
+//---------------------------------------------------------------------------------------
+void ImMeasuresTable::replace_entries(int iFirst, int numOld,
+                                      vector<ImMeasuresTableEntry*>& entries)
+{
+    //replaces numOld entries, starting at index iFirst, by the new entries
+
+    vector<ImMeasuresTableEntry*>::iterator itFirst = m_theTable.begin() + iFirst;
+    vector<ImMeasuresTableEntry*>::iterator it;
+    for (it = itFirst; it != itFirst + numOld; ++it)
+        delete *it;
+
+    int numNew = int(entries.size());
+    int iEnd = iFirst + numNew;
+    if (numNew == numOld)
+        std::copy(entries.begin(), entries.end(), itFirst);
+    else
+    {
+        itFirst = m_theTable.erase(itFirst, itFirst + numOld);
+        m_theTable.insert(itFirst, entries.begin(), entries.end());
+        iEnd = num_entries();
+    }
+
+    for (int i=iFirst; i < iEnd; ++i)
+        m_theTable[i]->set_index(i);
+}
+
 //---------------------------------------------------------------------------------------
 ImMeasuresTableEntry* ImMeasuresTable::get_measure(int iMeasure)
 {
@@ -176,5 +205,22 @@ ImMeasuresTableEntry* ImMeasuresTable::get_measure_at(TimeUnits timepos)
     return nullptr;
 }
 
+//---------------------------------------------------------------------------------------
+static bool starts_before(ImMeasuresTableEntry* pEntry, TimeUnits timepos)
+{
+    return is_lower_time(pEntry->get_timepos(), timepos);
+}
+
+//---------------------------------------------------------------------------------------
+ImMeasuresTableEntry* ImMeasuresTable::get_measure_before(TimeUnits timepos)
+{
+    //Binary search in table for the last measure starting before the requested
+    //timepos. Returns nullptr if none.
+
+    vector<ImMeasuresTableEntry*>::iterator it =
+        std::lower_bound(m_theTable.begin(), m_theTable.end(), timepos, starts_before);
+    return (it != m_theTable.begin() ? *(it - 1) : nullptr);
+}
+
 
 }  //namespace lomse
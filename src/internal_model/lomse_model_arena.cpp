@@ -0,0 +1,174 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the Lomse library.
+// Lomse is copyrighted work (c) 2010-2016. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice, this
+//      list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright notice, this
+//      list of conditions and the following disclaimer in the documentation and/or
+//      other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+// TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+// BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+// ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+// For any comment, suggestion or feature request, please contact the manager of
+// the project at cecilios@users.sourceforge.net
+//---------------------------------------------------------------------------------------
+
+#include "lomse_model_arena.h"
+
+#include "lomse_basic.h"
+
+#include <new>
+
+namespace lomse
+{
+
+//=======================================================================================
+// ModelArena implementation
+//=======================================================================================
+ModelArena::ModelArena()
+    : m_pNext(nullptr)
+    , m_available(0)
+    , m_inUse(0)
+    , m_fDiscarding(false)
+{
+}
+
+//---------------------------------------------------------------------------------------
+ModelArena::~ModelArena()
+{
+    std::vector<char*>::iterator it;
+    for (it = m_chunks.begin(); it != m_chunks.end(); ++it)
+        ::operator delete(*it);
+}
+
+//---------------------------------------------------------------------------------------
+void* ModelArena::allocate(size_t size)
+{
+    size = round_size(size);
+    m_inUse += size;
+
+    //reuse a released block of the same size
+    size_t i = size / k_align;
+    if (i < m_freeLists.size() && m_freeLists[i])
+    {
+        void* pBlock = m_freeLists[i];
+        m_freeLists[i] = *static_cast<void**>(pBlock);
+        return pBlock;
+    }
+
+    if (size > m_available)
+        new_chunk();
+
+    void* pBlock = m_pNext;
+    m_pNext += size;
+    m_available -= size;
+    return pBlock;
+}
+
+//---------------------------------------------------------------------------------------
+void ModelArena::release(void* pBlock, size_t size)
+{
+    size = round_size(size);
+    m_inUse -= size;
+    if (m_fDiscarding)
+        return;
+
+    size_t i = size / k_align;
+    if (i >= m_freeLists.size())
+        m_freeLists.resize(i + 1, nullptr);
+    *static_cast<void**>(pBlock) = m_freeLists[i];
+    m_freeLists[i] = pBlock;
+}
+
+//---------------------------------------------------------------------------------------
+void ModelArena::new_chunk()
+{
+    //AWARE: the remaining space in current chunk is wasted. It is less than
+    //k_max_block bytes
+    char* pChunk = static_cast<char*>( ::operator new(k_chunk_size) );
+    m_chunks.push_back(pChunk);
+    m_pNext = pChunk;
+    m_available = k_chunk_size;
+}
+
+
+//=======================================================================================
+// ArenaObject implementation
+//=======================================================================================
+thread_local void* ArenaObject::m_pLastArenaBlock = nullptr;
+thread_local ModelArena* ArenaObject::m_pReleaseArena = nullptr;
+
+//---------------------------------------------------------------------------------------
+void* ArenaObject::operator new(size_t size)
+{
+    return ::operator new(size);
+}
+
+//---------------------------------------------------------------------------------------
+void* ArenaObject::operator new(size_t size, ModelArena* pArena)
+{
+    if (pArena && pArena->accepts(size))
+    {
+        m_pLastArenaBlock = pArena->allocate(size);
+        return m_pLastArenaBlock;
+    }
+    return ::operator new(size);
+}
+
+//---------------------------------------------------------------------------------------
+void ArenaObject::operator delete(void* p, size_t size)
+{
+    ModelArena* pArena = m_pReleaseArena;
+    m_pReleaseArena = nullptr;
+
+    if (pArena)
+        pArena->release(p, size);
+    else
+        ::operator delete(p);
+}
+
+//---------------------------------------------------------------------------------------
+void ArenaObject::operator delete(void* p, ModelArena* UNUSED(pArena))
+{
+    //invoked only when the constructor throws. Blocks from an arena are not reused
+    //(size is unknown) and will be freed with the arena
+    ModelArena* pReleaseArena = m_pReleaseArena;
+    m_pReleaseArena = nullptr;
+    if (p == m_pLastArenaBlock)
+        m_pLastArenaBlock = nullptr;
+    else if (!pReleaseArena)
+        ::operator delete(p);
+}
+
+#if (LOMSE_COMPILER_MSVC == 1) && (LOMSE_DEBUG == 1)
+//---------------------------------------------------------------------------------------
+void* ArenaObject::operator new(size_t size, int UNUSED(blockType),
+                                const char* UNUSED(file), int UNUSED(line))
+{
+    return ::operator new(size);
+}
+
+//---------------------------------------------------------------------------------------
+void ArenaObject::operator delete(void* p, int UNUSED(blockType),
+                                  const char* UNUSED(file), int UNUSED(line))
+{
+    ::operator delete(p);
+}
+#endif
+
+
+}   //namespace lomse
@@ -38,6 +38,7 @@
 #include "lomse_logger.h"
 #include "lomse_im_factory.h"
 #include "lomse_measures_table.h"
+#include "lomse_injectors.h"
 
 #include <math.h>       //round
 
@@ -113,6 +114,40 @@ void ModelBuilder::structurize(ImoObj* pImo)
     }
 }
 
+//---------------------------------------------------------------------------------------
+void ModelBuilder::structurize(ImoScore* pScore, int iInstr, ImoStaffObj* pFirstChanged)
+{
+    ColStaffObjsBuilder builder;
+    ColStaffObjsChanges changes;
+    bool fUpdated = builder.update(pScore, iInstr, pFirstChanged, &changes);
+
+    Document* pDoc = pScore->get_the_document();
+    if (fUpdated && pDoc && pDoc->get_library_scope().verify_incremental_updates()
+        && !builder.verify(pScore))
+    {
+        LOMSE_LOG_ERROR("Incremental update failed. Table rebuilt.");
+        builder.build(pScore);
+        fUpdated = false;
+    }
+
+    MeasuresTableBuilder measures;
+    PitchAssigner tuner;
+    if (fUpdated)
+    {
+        measures.update(pScore, iInstr, changes);
+        tuner.assign_pitch(pScore, iInstr, changes);
+    }
+    else
+    {
+        measures.build(pScore);
+
+        MidiAssigner assigner;
+        assigner.assign_midi_data(pScore);
+
+        tuner.assign_pitch(pScore);
+    }
+}
+
 
 //=======================================================================================
 // PitchAssigner implementation
@@ -167,6 +202,98 @@ void PitchAssigner::assign_pitch(ImoScore* pScore)
     }
 }
 
+//---------------------------------------------------------------------------------------
+void PitchAssigner::assign_pitch(ImoScore* pScore, int iInstr,
+                                 ColStaffObjsChanges& changes)
+{
+    //Assigns pitch only to the notes of instrument iInstr in the entries replaced by
+    //an incremental update of the ColStaffObjs table: after barline entry pStart
+    //(nullptr: from first entry) up to entry pEnd (nullptr: up to last entry). As
+    //accidentals are not reset at barlines when there is no key, and the key in
+    //force could have changed, in these cases notes are processed up to next key
+    //signature.
+
+    ColStaffObjsEntry* pStart = changes.pStart;
+    ColStaffObjsEntry* pEnd = changes.pEnd;
+    ImoInstrument* pInstr = pScore->get_instrument(iInstr);
+    int numStaves = pInstr->get_num_staves();
+    m_context.assign(numStaves, {0,0,0,0,0,0,0});       //alterations, per staff
+
+    //determine the key in force at pStart: the key at start of its measure or a key
+    //signature in that measure
+    ImoKeySignature* pKey = nullptr;
+    ColStaffObjsEntry* pEntry = pScore->get_staffobjs_table()->front();
+    if (pStart)
+    {
+        ImMeasuresTable* pTable = pInstr->get_measures_table();
+        ImMeasuresTableEntry* pMeasure =
+            (pTable ? pTable->get_measure_before(pStart->time()) : nullptr);
+        if (pMeasure)
+        {
+            pKey = pMeasure->get_key();
+            pEntry = pMeasure->get_entry();
+        }
+        for (; pEntry != pStart; pEntry = pEntry->get_next())
+        {
+            if (pEntry->num_instrument() == iInstr
+                && pEntry->imo_object()->is_key_signature())
+            {
+                pKey = static_cast<ImoKeySignature*>( pEntry->imo_object() );
+            }
+        }
+
+        //pStart is a barline. Without key, context depends on all previous notes
+        if (pKey)
+        {
+            for (int iStaff=0; iStaff < numStaves; ++iStaff)
+                reset_accidentals(pKey, iStaff);
+            pEntry = pStart->get_next();
+        }
+        else
+            pEntry = pScore->get_staffobjs_table()->front();
+    }
+
+    bool fKeyFound = false;
+    bool fAfterEnd = false;
+    for (; pEntry; pEntry = pEntry->get_next())
+    {
+        if (pEntry->num_instrument() != iInstr)
+            continue;
+
+        //entries with equal time could be in a different order than in the music
+        //data. After pEnd there could be new entries
+        ImoStaffObj* pSO = pEntry->imo_object();
+        bool fNew = pEntry->order() >= changes.firstOrder
+                    && pEntry->order() <= changes.lastOrder;
+        if (fAfterEnd && !fNew
+            && ((pKey && !fKeyFound) || pSO->is_key_signature()))
+        {
+            break;
+        }
+
+        if (pSO->is_note())
+        {
+            ImoNote* pNote = static_cast<ImoNote*>(pSO);
+            compute_pitch(pNote, pEntry->staff());
+        }
+        else if (pSO->is_barline())
+        {
+            for (int iStaff=0; iStaff < numStaves; ++iStaff)
+                reset_accidentals(pKey, iStaff);
+        }
+        else if (pSO->is_key_signature())
+        {
+            fKeyFound = true;
+            pKey = static_cast<ImoKeySignature*>( pSO );
+            for (int iStaff=0; iStaff < numStaves; ++iStaff)
+                reset_accidentals(pKey, iStaff);
+        }
+
+        if (pEntry == pEnd)
+            fAfterEnd = true;
+    }
+}
+
 //---------------------------------------------------------------------------------------
 void PitchAssigner::compute_notated_accidentals(ImoNote* pNote, int context)
 {
@@ -571,6 +698,15 @@ MeasuresTableBuilder::~MeasuresTableBuilder()
 //---------------------------------------------------------------------------------------
 void MeasuresTableBuilder::build(ImoScore* pScore)
 {
+    build(pScore, -1);
+}
+
+//---------------------------------------------------------------------------------------
+void MeasuresTableBuilder::build(ImoScore* pScore, int onlyInstr)
+{
+    //builds the measures tables for instrument onlyInstr or, when -1, for all
+    //instruments
+
     ColStaffObjs* pCSO = pScore->get_staffobjs_table();
     if (pCSO->num_entries() == 0)
         return;
@@ -578,13 +714,18 @@ void MeasuresTableBuilder::build(ImoScore* pScore)
     int numInstrs = pScore->get_num_instruments();
     m_instruments.assign(numInstrs, nullptr);
     m_measures.assign(numInstrs, nullptr);
+    m_keys.assign(numInstrs, nullptr);
 
     ColStaffObjsIterator it = pCSO->begin();
     while (it != pCSO->end())
     {
         ColStaffObjsEntry* pCsoEntry = *it;
         int iInstr = pCsoEntry->num_instrument();
-        ImoStaffObj* pSO = pCsoEntry->imo_object();
+        if (onlyInstr != -1 && iInstr != onlyInstr)
+        {
+            ++it;
+            continue;
+        }
 
         //if first entry for the instrument create measures table and first measure
         if (m_instruments[iInstr] == nullptr)
@@ -597,24 +738,133 @@ void MeasuresTableBuilder::build(ImoScore* pScore)
         if (m_measures[iInstr] == nullptr)
             start_new_measure(iInstr, pCsoEntry);
 
-        //if Time Signature update beat duration
-        if (pSO->is_time_signature())
+        process_entry(iInstr, pCsoEntry->imo_object());
+
+        //advance to next entry
+        ++it;
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void MeasuresTableBuilder::update(ImoScore* pScore, int iInstr,
+                                  ColStaffObjsChanges& changes)
+{
+    //Updates the measures table for instrument iInstr after an incremental update
+    //of the ColStaffObjs table, in which the entries after barline entry pStart and
+    //up to entry pEnd (nullptr: up to last entry) were replaced. Only the measures
+    //after pStart and up to the one containing pEnd are created again. If key or
+    //time signature in force for next measures have changed, the table for the
+    //instrument is built again.
+
+    ColStaffObjsEntry* pStart = changes.pStart;
+    ColStaffObjsEntry* pEnd = changes.pEnd;
+    ImoInstrument* pInstr = pScore->get_instrument(iInstr);
+    ImMeasuresTable* pTable = pInstr->get_measures_table();
+    ImMeasuresTableEntry* pOld =
+        (pTable && pStart ? pTable->get_measure_before(pStart->time()) : nullptr);
+    if (!pOld)
+    {
+        build(pScore, iInstr);
+        return;
+    }
+
+    int numInstrs = pScore->get_num_instruments();
+    m_instruments.assign(numInstrs, nullptr);
+    m_measures.assign(numInstrs, nullptr);
+    m_keys.assign(numInstrs, nullptr);
+    m_instruments[iInstr] = pInstr;
+
+    //process again the measure containing pStart, and create new measures up to
+    //the measure containing pEnd
+    int iOld = pOld->get_table_index();
+    int iNext = pTable->num_entries();
+    TimeUnits impliedBeat = pOld->get_implied_beat_duration();
+    TimeUnits bottomBeat = pOld->get_bottom_ts_beat_duration();
+    m_measures[iInstr] = pOld;
+    m_keys[iInstr] = pOld->get_key();
+    vector<ImMeasuresTableEntry*> measures;
+    bool fAfterEnd = false;
+    ColStaffObjsEntry* pCsoEntry = pOld->get_entry();
+    for (; pCsoEntry; pCsoEntry = pCsoEntry->get_next())
+    {
+        if (pCsoEntry->num_instrument() != iInstr)
+            continue;
+
+        if (m_measures[iInstr] == nullptr)
         {
-            ImoTimeSignature* pTS = static_cast<ImoTimeSignature*>(pSO);
-            m_measures[iInstr]->set_implied_beat_duration( pTS->get_beat_duration() );
-            m_measures[iInstr]->set_bottom_ts_beat_duration( pTS->get_ref_note_duration() );
+            //Entries with equal time could be in a different order than in the
+            //music data. After pEnd there could be new entries
+            if (fAfterEnd && (pCsoEntry->order() < changes.firstOrder
+                              || pCsoEntry->order() > changes.lastOrder))
+            {
+                //this measure is not changed. Find it in the table
+                for (iNext = iOld + 1; iNext < pTable->num_entries(); ++iNext)
+                {
+                    if (pTable->get_measure(iNext)->get_entry() == pCsoEntry)
+                        break;
+                }
+                break;
+            }
+
+            m_measures[iInstr] = LOMSE_NEW ImMeasuresTableEntry(pCsoEntry);
+            init_measure(iInstr, measures.empty() ? pOld : measures.back());
+            measures.push_back(m_measures[iInstr]);
         }
 
-        //if not intermediate barline finish current measure
-        if (pSO->is_barline())
+        process_entry(iInstr, pCsoEntry->imo_object());
+
+        if (pCsoEntry == pEnd)
+            fAfterEnd = true;
+    }
+
+    //next measures are not changed if the key and time signature in force at their
+    //start is the same. If next measure not found, the table is wrong
+    bool fSameState = (pCsoEntry == nullptr || iNext < pTable->num_entries());
+    if (fSameState && iNext < pTable->num_entries())
+    {
+        ImMeasuresTableEntry* pNewLast = (measures.empty() ? pOld : measures.back());
+        if (iNext - 1 != iOld)
         {
-            ImoBarline* pBL = static_cast<ImoBarline*>(pSO);
-            if (!pBL->is_middle())
-                finish_current_measure(iInstr);
+            impliedBeat = pTable->get_measure(iNext - 1)->get_implied_beat_duration();
+            bottomBeat = pTable->get_measure(iNext - 1)->get_bottom_ts_beat_duration();
         }
+        fSameState = pTable->get_measure(iNext)->get_key() == m_keys[iInstr]
+            && pNewLast->get_implied_beat_duration() == impliedBeat
+            && pNewLast->get_bottom_ts_beat_duration() == bottomBeat;
+    }
 
-        //advance to next entry
-        ++it;
+    if (fSameState)
+        pTable->replace_entries(iOld + 1, iNext - iOld - 1, measures);
+    else
+    {
+        vector<ImMeasuresTableEntry*>::iterator it;
+        for (it = measures.begin(); it != measures.end(); ++it)
+            delete *it;
+        build(pScore, iInstr);
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void MeasuresTableBuilder::process_entry(int iInstr, ImoStaffObj* pSO)
+{
+    //if Time Signature update beat duration
+    if (pSO->is_time_signature())
+    {
+        ImoTimeSignature* pTS = static_cast<ImoTimeSignature*>(pSO);
+        m_measures[iInstr]->set_implied_beat_duration( pTS->get_beat_duration() );
+        m_measures[iInstr]->set_bottom_ts_beat_duration( pTS->get_ref_note_duration() );
+    }
+
+    //if Key Signature, it is in force for next measures
+    else if (pSO->is_key_signature())
+        m_keys[iInstr] = static_cast<ImoKeySignature*>(pSO);
+
+    //if not intermediate barline finish current measure
+    else if (pSO->is_barline())
+    {
+        ImoBarline* pBL = static_cast<ImoBarline*>(pSO);
+        if (!pBL->is_middle())
+            finish_current_measure(iInstr);
     }
 }
 
@@ -645,6 +895,13 @@ void MeasuresTableBuilder::start_new_measure(int iInstr, ColStaffObjsEntry* pCso
     ImMeasuresTable* pTable = pInstr->get_measures_table();
     ImMeasuresTableEntry* prevMeasure = pTable->back();
     m_measures[iInstr] = pTable->add_entry(pCsoEntry);
+    init_measure(iInstr, prevMeasure);
+}
+
+//---------------------------------------------------------------------------------------
+void MeasuresTableBuilder::init_measure(int iInstr, ImMeasuresTableEntry* prevMeasure)
+{
+    m_measures[iInstr]->set_key( m_keys[iInstr] );
 
     if (prevMeasure != nullptr)
     {
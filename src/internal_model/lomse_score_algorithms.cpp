@@ -147,8 +147,12 @@ ImoNoteRest* ScoreAlgorithms::find_noterest_at(ImoScore* pScore,
                                                int instr, int voice, TimeUnits time)
 {
     ColStaffObjs* pColStaffObjs = pScore->get_staffobjs_table();
-    ColStaffObjsIterator it;
-    for (it=pColStaffObjs->begin(); it != pColStaffObjs->end(); ++it)
+
+    //notes starting before time - max.duration can not include time. Start search
+    //there (1 TimeUnit before, to avoid rounding problems)
+    TimeUnits startTime = time - pColStaffObjs->max_note_duration() - 1.0;
+    ColStaffObjsIterator it = pColStaffObjs->find_first_at_or_after(startTime);
+    for (; it != pColStaffObjs->end(); ++it)
     {
         if (is_greater_time((*it)->time(), time))
             break;
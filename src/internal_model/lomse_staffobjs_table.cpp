@@ -35,9 +35,11 @@
 #include "lomse_ldp_exporter.h"
 #include "lomse_time.h"
 #include "lomse_im_factory.h"
+#include "lomse_logger.h"
 
 
 #include <sstream>
+#include <set>
 using namespace std;
 
 namespace lomse
@@ -78,6 +80,8 @@ ColStaffObjs::ColStaffObjs()
     , m_minNoteDuration(LOMSE_NO_NOTE_DURATION)
     , m_pFirst(nullptr)
     , m_pLast(nullptr)
+    , m_fIndexValid(false)
+    , m_maxNoteDuration(0.0)
 {
 }
 
@@ -90,13 +94,15 @@ ColStaffObjs::~ColStaffObjs()
 }
 
 //---------------------------------------------------------------------------------------
-void ColStaffObjs::add_entry(int measure, int instr, int voice, int staff,
-                             ImoStaffObj* pImo)
+ColStaffObjsEntry* ColStaffObjs::add_entry(int measure, int instr, int voice, int staff,
+                                           ImoStaffObj* pImo, int order)
 {
     ColStaffObjsEntry* pEntry =
-        LOMSE_NEW ColStaffObjsEntry(measure, instr, voice, staff, pImo);
+        LOMSE_NEW ColStaffObjsEntry(measure, instr, voice, staff, pImo, order);
     add_entry_to_list(pEntry);
+    m_entryForImo[pImo] = pEntry;
     ++m_numEntries;
+    return pEntry;
 }
 
 //---------------------------------------------------------------------------------------
@@ -118,6 +124,8 @@ string ColStaffObjs::dump(bool fWithIds)
 //---------------------------------------------------------------------------------------
 void ColStaffObjs::add_entry_to_list(ColStaffObjsEntry* pEntry)
 {
+    invalidate_index();
+
     if (!m_pFirst)
     {
         //first entry
@@ -221,9 +229,24 @@ void ColStaffObjs::delete_entry_for(ImoStaffObj* pSO)
         LOMSE_LOG_ERROR("[ColStaffObjs::delete_entry_for] entry not found!");
         throw runtime_error("[ColStaffObjs::delete_entry_for] entry not found!");
     }
+    unlink_entry(pEntry);
+}
+
+//---------------------------------------------------------------------------------------
+void ColStaffObjs::unlink_entry(ColStaffObjsEntry* pEntry)
+{
+    //removes the entry from the table and deletes it. The staffobj is not accessed,
+    //so this method can be used when the staffobj has been already deleted.
 
     ColStaffObjsEntry* pPrev = pEntry->get_prev();
     ColStaffObjsEntry* pNext = pEntry->get_next();
+
+    std::unordered_map<ImoStaffObj*, ColStaffObjsEntry*>::iterator it
+        = m_entryForImo.find(pEntry->imo_object());
+    if (it != m_entryForImo.end() && it->second == pEntry)
+        m_entryForImo.erase(it);
+
+    invalidate_index();
     delete pEntry;
     if (pPrev == nullptr)
     {
@@ -231,6 +254,8 @@ void ColStaffObjs::delete_entry_for(ImoStaffObj* pSO)
         m_pFirst = pNext;
         if (pNext)
             pNext->set_prev(nullptr);
+        else
+            m_pLast = nullptr;
     }
     else if (pNext == nullptr)
     {
@@ -247,16 +272,340 @@ void ColStaffObjs::delete_entry_for(ImoStaffObj* pSO)
     --m_numEntries;
 }
 
+//---------------------------------------------------------------------------------------
+void ColStaffObjs::insert_entries_after(ColStaffObjsEntry* pPrev,
+                                        std::vector<ColStaffObjsEntry*>& entries)
+{
+    //Inserts entries, ordered by time, after pPrev (nullptr: at start of table) and
+    //after all entries with lower or equal time. The order among entries with equal
+    //time is not determined here but by reorder_entries_from().
+
+    std::vector<ColStaffObjsEntry*>::iterator it;
+    for (it = entries.begin(); it != entries.end(); ++it)
+    {
+        ColStaffObjsEntry* pEntry = *it;
+        TimeUnits time = pEntry->time();
+        ColStaffObjsEntry* pNext = (pPrev ? pPrev->get_next() : m_pFirst);
+        while (pNext && !is_greater_time(pNext->time(), time))
+        {
+            pPrev = pNext;
+            pNext = pNext->get_next();
+        }
+
+        //insert between pPrev and pNext
+        pEntry->set_prev(pPrev);
+        pEntry->set_next(pNext);
+        if (pPrev)
+            pPrev->set_next(pEntry);
+        else
+            m_pFirst = pEntry;
+        if (pNext)
+            pNext->set_prev(pEntry);
+        else
+            m_pLast = pEntry;
+
+        m_entryForImo[pEntry->imo_object()] = pEntry;
+        ++m_numEntries;
+        pPrev = pEntry;
+    }
+    invalidate_index();
+}
+
+//---------------------------------------------------------------------------------------
+void ColStaffObjs::reorder_entries_from(ColStaffObjsEntry* pEntry, TimeUnits maxTime)
+{
+    //Order of entries with equal time only depends on the order in which they were
+    //added to the table. Therefore, each group of entries with equal time, from the
+    //group containing pEntry (nullptr: first entry) up to time maxTime, is ordered
+    //again as add_entry_to_list() would have done when building the table.
+
+    pEntry = (pEntry ? first_with_equal_time(pEntry) : m_pFirst);
+    std::vector<ColStaffObjsEntry*> group;
+    while (pEntry && !is_greater_time(pEntry->time(), maxTime))
+    {
+        TimeUnits time = pEntry->time();
+        group.clear();
+        while (pEntry && is_equal_time(pEntry->time(), time))
+        {
+            group.push_back(pEntry);
+            pEntry = pEntry->get_next();
+        }
+        if (group.size() > 1)
+            reorder_group(group);
+    }
+
+    //entries positions have changed
+    invalidate_index();
+}
+
+//---------------------------------------------------------------------------------------
+ColStaffObjsEntry* ColStaffObjs::first_with_equal_time(ColStaffObjsEntry* pEntry)
+{
+    while (pEntry->get_prev() && is_equal_time(pEntry->get_prev()->time(), pEntry->time()))
+        pEntry = pEntry->get_prev();
+    return pEntry;
+}
+
+//---------------------------------------------------------------------------------------
+static bool is_lower_creation_order(ColStaffObjsEntry* a, ColStaffObjsEntry* b)
+{
+    return a->num_instrument() < b->num_instrument()
+           || (a->num_instrument() == b->num_instrument() && a->order() < b->order());
+}
+
+//---------------------------------------------------------------------------------------
+void ColStaffObjs::reorder_group(std::vector<ColStaffObjsEntry*>& group)
+{
+    //group: consecutive entries in the table, all with equal time. They are sorted
+    //by instrument and creation order, and inserted as add_entry_to_list() does.
+
+    ColStaffObjsEntry* pPrev = group.front()->get_prev();
+    ColStaffObjsEntry* pNext = group.back()->get_next();
+
+    std::sort(group.begin(), group.end(), is_lower_creation_order);
+    std::vector<ColStaffObjsEntry*>::iterator itStart = group.begin();
+    std::vector<ColStaffObjsEntry*>::iterator itG;
+    for (itG = group.begin(); itG != group.end(); ++itG)
+    {
+        ColStaffObjsEntry* pEntry = *itG;
+        std::vector<ColStaffObjsEntry*>::iterator itPos = itG;
+        while (itPos != itStart && is_lower_entry(pEntry, *(itPos - 1)))
+            --itPos;
+        std::copy_backward(itPos, itG, itG + 1);
+        *itPos = pEntry;
+    }
+
+    //relink the group
+    ColStaffObjsEntry* pLast = pPrev;
+    for (itG = group.begin(); itG != group.end(); ++itG)
+    {
+        (*itG)->set_prev(pLast);
+        if (pLast)
+            pLast->set_next(*itG);
+        else
+            m_pFirst = *itG;
+        pLast = *itG;
+    }
+    pLast->set_next(pNext);
+    if (pNext)
+        pNext->set_prev(pLast);
+    else
+        m_pLast = pLast;
+}
+
 //---------------------------------------------------------------------------------------
 ColStaffObjsEntry* ColStaffObjs::find_entry_for(ImoStaffObj* pSO)
 {
-    ColStaffObjs::iterator it;
-    for (it=begin(); it != end(); ++it)
+    std::unordered_map<ImoStaffObj*, ColStaffObjsEntry*>::iterator it
+        = m_entryForImo.find(pSO);
+    return (it != m_entryForImo.end() ? it->second : nullptr);
+}
+
+//---------------------------------------------------------------------------------------
+ColStaffObjs::iterator ColStaffObjs::find_first(ImoStaffObj* pSO)
+{
+    //Key and time signatures have an entry in each staff of the instrument, all of
+    //them at the same time. m_entryForImo keeps the last one; look back for the
+    //first one.
+
+    ColStaffObjsEntry* pFound = find_entry_for(pSO);
+    if (pFound == nullptr)
+        return end();
+
+    ColStaffObjsEntry* pEntry = pFound->get_prev();
+    while (pEntry && is_equal_time(pEntry->time(), pFound->time()))
     {
-        if ((*it)->imo_object() == pSO)
-            return *it;
+        if (pEntry->imo_object() == pSO)
+            pFound = pEntry;
+        pEntry = pEntry->get_prev();
     }
-    return nullptr;
+    return iterator(pFound);
+}
+
+//---------------------------------------------------------------------------------------
+void ColStaffObjs::update_index()
+{
+    if (m_fIndexValid)
+        return;
+
+    m_entries.clear();
+    m_entries.reserve(m_numEntries);
+    m_barlines.clear();
+    m_timeSignatures.clear();
+    m_firstInStaff.clear();
+    m_maxNoteDuration = 0.0;
+    for (ColStaffObjsEntry* pEntry = m_pFirst; pEntry; pEntry = pEntry->get_next())
+    {
+        pEntry->set_index( int(m_entries.size()) );
+        m_entries.push_back(pEntry);
+
+        ImoStaffObj* pSO = pEntry->imo_object();
+        if (pSO->is_note_rest())
+            m_maxNoteDuration = max(m_maxNoteDuration, pEntry->duration());
+
+        int instr = pEntry->num_instrument();
+        if (instr < 0)
+            continue;
+        if (instr >= int(m_barlines.size()))
+        {
+            m_barlines.resize(instr + 1);
+            m_timeSignatures.resize(instr + 1);
+            m_firstInStaff.resize(instr + 1);
+        }
+
+        if (pSO->is_barline())
+            m_barlines[instr].push_back(pEntry);
+        else if (pSO->is_time_signature())
+            m_timeSignatures[instr].push_back(pEntry);
+
+        int staff = pEntry->staff();
+        if (staff >= 0)
+        {
+            std::vector<ColStaffObjsEntry*>& staves = m_firstInStaff[instr];
+            if (staff >= int(staves.size()))
+                staves.resize(staff + 1, nullptr);
+            if (staves[staff] == nullptr)
+                staves[staff] = pEntry;
+        }
+    }
+    m_fIndexValid = true;
+}
+
+//---------------------------------------------------------------------------------------
+ColStaffObjs::iterator ColStaffObjs::find_barline_for_measure(int instr, int measure)
+{
+    //Binary search. Returns an iterator pointing to the first barline in instrument
+    //instr whose measure number is measure, or end() if none. Measure numbers
+    //never decrease along the table for the barlines of one instrument.
+
+    update_index();
+    if (instr < 0 || instr >= int(m_barlines.size()))
+        return end();
+
+    std::vector<ColStaffObjsEntry*>& barlines = m_barlines[instr];
+    int first = 0;
+    int last = int(barlines.size());
+    while (first < last)
+    {
+        int middle = first + (last - first) / 2;
+        if (barlines[middle]->measure() < measure)
+            first = middle + 1;
+        else
+            last = middle;
+    }
+
+    if (first < int(barlines.size()) && barlines[first]->measure() == measure)
+        return iterator(barlines[first]);
+    return end();
+}
+
+//---------------------------------------------------------------------------------------
+ColStaffObjs::iterator ColStaffObjs::find_first_in_staff(int instr, int staff)
+{
+    //Returns an iterator pointing to the first entry in instrument instr that is
+    //placed on staff or that is a barline (barlines are in all staves), or end()
+    //if none.
+
+    update_index();
+    if (instr < 0 || instr >= int(m_firstInStaff.size()))
+        return end();
+
+    ColStaffObjsEntry* pFirst = nullptr;
+    std::vector<ColStaffObjsEntry*>& staves = m_firstInStaff[instr];
+    if (staff >= 0 && staff < int(staves.size()))
+        pFirst = staves[staff];
+
+    std::vector<ColStaffObjsEntry*>& barlines = m_barlines[instr];
+    if (!barlines.empty()
+        && (pFirst == nullptr || barlines.front()->index() < pFirst->index()))
+    {
+        pFirst = barlines.front();
+    }
+
+    return (pFirst ? iterator(pFirst) : end());
+}
+
+//---------------------------------------------------------------------------------------
+ColStaffObjsEntry* ColStaffObjs::find_barline_before(int instr,
+                                                     ColStaffObjsEntry* pEntry)
+{
+    update_index();
+    if (instr < 0 || instr >= int(m_barlines.size()))
+        return nullptr;
+    return find_last_before(m_barlines[instr], pEntry);
+}
+
+//---------------------------------------------------------------------------------------
+ColStaffObjsEntry* ColStaffObjs::find_time_signature_before(int instr,
+                                                            ColStaffObjsEntry* pEntry)
+{
+    update_index();
+    if (instr < 0 || instr >= int(m_timeSignatures.size()))
+        return nullptr;
+    return find_last_before(m_timeSignatures[instr], pEntry);
+}
+
+//---------------------------------------------------------------------------------------
+ColStaffObjsEntry* ColStaffObjs::find_last_before(std::vector<ColStaffObjsEntry*>& entries,
+                                                  ColStaffObjsEntry* pEntry)
+{
+    //Binary search. Returns the last entry in entries (that must be in table order)
+    //placed before pEntry in the table, or nullptr if none.
+    //AWARE: the index must be valid
+
+    if (pEntry == nullptr)
+        return (entries.empty() ? nullptr : entries.back());
+
+    int pos = pEntry->index();
+    int first = 0;
+    int last = int(entries.size());
+    while (first < last)
+    {
+        int middle = first + (last - first) / 2;
+        if (entries[middle]->index() < pos)
+            first = middle + 1;
+        else
+            last = middle;
+    }
+    return (first > 0 ? entries[first - 1] : nullptr);
+}
+
+//---------------------------------------------------------------------------------------
+ColStaffObjsEntry* ColStaffObjs::get_entry(int i)
+{
+    update_index();
+    return (i >= 0 && i < int(m_entries.size()) ? m_entries[i] : nullptr);
+}
+
+//---------------------------------------------------------------------------------------
+int ColStaffObjs::get_index_of(ColStaffObjsEntry* pEntry)
+{
+    update_index();
+    return pEntry->index();
+}
+
+//---------------------------------------------------------------------------------------
+TimeUnits ColStaffObjs::max_note_duration()
+{
+    update_index();
+    return m_maxNoteDuration;
+}
+
+//---------------------------------------------------------------------------------------
+ColStaffObjs::iterator ColStaffObjs::find_first_at_or_after(TimeUnits time)
+{
+    //Binary search. Returns an iterator pointing to the first entry whose time is
+    //equal or greater than time, or end() if none.
+
+    update_index();
+    std::vector<ColStaffObjsEntry*>::iterator it =
+        std::lower_bound(m_entries.begin(), m_entries.end(), time,
+                         [](ColStaffObjsEntry* pEntry, TimeUnits t)
+                         {
+                             return is_lower_time(pEntry->time(), t);
+                         });
+
+    return (it != m_entries.end() ? iterator(*it) : end());
 }
 
 //---------------------------------------------------------------------------------------
@@ -302,6 +651,254 @@ ColStaffObjs* ColStaffObjsBuilder::build(ImoScore* pScore)
     return pColStaffObjs;
 }
 
+//---------------------------------------------------------------------------------------
+bool ColStaffObjsBuilder::update(ImoScore* pScore, int iInstr, ImoStaffObj* pFirstChanged,
+                                 ColStaffObjsChanges* pChanges)
+{
+    ColStaffObjs* pColStaffObjs = pScore->get_staffobjs_table();
+    int numInstrs = pScore->get_num_instruments();
+    if (pColStaffObjs && iInstr >= 0 && iInstr < numInstrs
+        && int(pColStaffObjs->m_instrData.size()) == numInstrs
+        && update_entries(pScore, pColStaffObjs, iInstr, pFirstChanged, pChanges))
+    {
+        return true;
+    }
+
+    build(pScore);
+    return false;
+}
+
+//---------------------------------------------------------------------------------------
+bool ColStaffObjsBuilder::update_entries(ImoScore* pScore, ColStaffObjs* pColStaffObjs,
+                                         int iInstr, ImoStaffObj* pFirstChanged,
+                                         ColStaffObjsChanges* pChanges)
+{
+    //determine the new entries. If the lines used by the instrument change, lines
+    //for next instruments also change
+    ColStaffObjsReplay replay;
+    ColStaffObjsBuilderEngine* builder = create_builder_engine(pScore);
+    ColStaffObjs::InstrumentData& data = pColStaffObjs->m_instrData[iInstr];
+    if (!builder->replay_entries(pColStaffObjs, iInstr, pFirstChanged, &replay)
+        || (replay.pLast == nullptr && replay.lastLine != data.lastLine))
+    {
+        delete builder;
+        return false;
+    }
+
+    remove_replaced_entries(pColStaffObjs, iInstr, replay);
+    shift_next_entries(pColStaffObjs, replay);
+    ColStaffObjsEntry* pEnd = add_new_entries(pColStaffObjs, iInstr, replay);
+    update_line_requests(pColStaffObjs, iInstr, replay);
+
+    data.minNoteDuration = (data.noteDurations.empty() ? LOMSE_NO_NOTE_DURATION
+                                                       : data.noteDurations.begin()->first);
+    builder->update_table_info();
+    delete builder;
+
+    if (pChanges)
+    {
+        pChanges->pStart = replay.pStart;
+        pChanges->pEnd = pEnd;
+        pChanges->firstOrder = replay.startOrder;
+        pChanges->lastOrder = replay.startOrder + int(replay.entries.size()) - 1;
+    }
+    return true;
+}
+
+//---------------------------------------------------------------------------------------
+void ColStaffObjsBuilder::remove_replaced_entries(ColStaffObjs* pColStaffObjs,
+                                                  int iInstr, ColStaffObjsReplay& replay)
+{
+    //Replaced entries are after the barline from which entries were determined again,
+    //and their time is not greater than the old time of the last replayed staffobj.
+    //The staffobj for a replaced entry could have been deleted or its time already
+    //changed, so it is not accessed.
+
+    ColStaffObjs::InstrumentData& data = pColStaffObjs->m_instrData[iInstr];
+    ColStaffObjsEntry* pEntry = (replay.pStart ? replay.pStart->get_next()
+                                               : pColStaffObjs->front());
+    while (pEntry)
+    {
+        ColStaffObjsEntry* pNext = pEntry->get_next();
+        if (pEntry->num_instrument() == iInstr && pEntry->order() >= replay.startOrder
+            && (replay.pLast == nullptr || pEntry->order() <= replay.lastOrder))
+        {
+            if (pEntry->note_duration() > 0.0)
+            {
+                std::map<TimeUnits, int>::iterator it =
+                    data.noteDurations.find(pEntry->note_duration());
+                if (it != data.noteDurations.end() && --(it->second) == 0)
+                    data.noteDurations.erase(it);
+            }
+            pColStaffObjs->unlink_entry(pEntry);
+        }
+        else if (replay.pLast && is_greater_time(pEntry->time(), replay.lastTime))
+            break;
+
+        pEntry = pNext;
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void ColStaffObjsBuilder::shift_next_entries(ColStaffObjs* pColStaffObjs,
+                                             ColStaffObjsReplay& replay)
+{
+    //entries after the replayed ones are not changed but, when measures or entries
+    //have been added or removed, their measure number and creation order. As order
+    //of barlines in a group of entries with equal time depends on measure numbers,
+    //the groups containing shifted entries are ordered again
+
+    if (replay.pLast == nullptr || (replay.measureShift == 0 && replay.orderShift == 0))
+        return;
+
+    std::set<ColStaffObjsEntry*> groups;
+    ImoObj* pImo = replay.pLast->get_next_sibling();
+    for (; pImo; pImo = pImo->get_next_sibling())
+    {
+        ImoStaffObj* pSO = static_cast<ImoStaffObj*>(pImo);
+        ColStaffObjsEntry* pLastEntry = pColStaffObjs->find_entry_for(pSO);
+        if (!pLastEntry)
+            continue;
+
+        //key and time signatures have an entry in each staff
+        ColStaffObjsEntry* pEntry = pLastEntry;
+        if (pSO->is_key_signature() || pSO->is_time_signature())
+            pEntry = *(pColStaffObjs->find_first(pSO));
+
+        for (; pEntry; pEntry = pEntry->get_next())
+        {
+            if (pEntry->imo_object() == pSO)
+            {
+                pEntry->set_measure(pEntry->measure() + replay.measureShift);
+                pEntry->set_order(pEntry->order() + replay.orderShift);
+                if (replay.measureShift != 0
+                    && is_greater_time(pEntry->time(), replay.lastTime))
+                {
+                    groups.insert( pColStaffObjs->first_with_equal_time(pEntry) );
+                }
+            }
+            if (pEntry == pLastEntry)
+                break;
+        }
+    }
+
+    //groups up to lastTime will be ordered when adding the new entries
+    std::set<ColStaffObjsEntry*>::iterator it;
+    for (it = groups.begin(); it != groups.end(); ++it)
+        pColStaffObjs->reorder_entries_from(*it, (*it)->time());
+}
+
+//---------------------------------------------------------------------------------------
+static bool is_lower_entry_time(ColStaffObjsEntry* a, ColStaffObjsEntry* b)
+{
+    return is_lower_time(a->time(), b->time());
+}
+
+//---------------------------------------------------------------------------------------
+ColStaffObjsEntry* ColStaffObjsBuilder::add_new_entries(ColStaffObjs* pColStaffObjs,
+                                                        int iInstr,
+                                                        ColStaffObjsReplay& replay)
+{
+    //Adds the replayed entries and orders again the entries in the modified part of
+    //the table. Returns the entry for the last replayed staffobj, or nullptr if all
+    //entries from the start barline have been replayed.
+
+    ColStaffObjs::InstrumentData& data = pColStaffObjs->m_instrData[iInstr];
+    std::vector<ColStaffObjsEntry*> entries;
+    entries.reserve(replay.entries.size());
+    std::vector<ColStaffObjsEntry>::iterator it;
+    for (it = replay.entries.begin(); it != replay.entries.end(); ++it)
+    {
+        entries.push_back( LOMSE_NEW ColStaffObjsEntry(*it) );
+        if (it->note_duration() > 0.0)
+            ++data.noteDurations[it->note_duration()];
+    }
+    std::stable_sort(entries.begin(), entries.end(), is_lower_entry_time);
+    pColStaffObjs->insert_entries_after(replay.pStart, entries);
+
+    if (replay.pLast)
+    {
+        pColStaffObjs->reorder_entries_from(replay.pStart, replay.lastTime);
+        return pColStaffObjs->find_entry_for(replay.pLast);
+    }
+
+    pColStaffObjs->reorder_entries_from(replay.pStart, LOMSE_NO_TIME);
+    return nullptr;
+}
+
+//---------------------------------------------------------------------------------------
+void ColStaffObjsBuilder::update_line_requests(ColStaffObjs* pColStaffObjs, int iInstr,
+                                               ColStaffObjsReplay& replay)
+{
+    ColStaffObjs::InstrumentData& data = pColStaffObjs->m_instrData[iInstr];
+    std::vector<StaffVoiceLine> requests;
+    std::vector<StaffVoiceLine>::iterator it;
+    for (it = data.lineRequests.begin(); it != data.lineRequests.end(); ++it)
+    {
+        if (it->order < replay.startOrder)
+            requests.push_back(*it);
+    }
+    requests.insert(requests.end(), replay.lineRequests.begin(),
+                    replay.lineRequests.end());
+    if (replay.pLast)
+    {
+        for (it = data.lineRequests.begin(); it != data.lineRequests.end(); ++it)
+        {
+            if (it->order > replay.lastOrder)
+                requests.push_back( StaffVoiceLine(it->order + replay.orderShift,
+                                                   it->voice, it->staff) );
+        }
+    }
+    else
+        data.lastLine = replay.lastLine;
+
+    data.lineRequests.swap(requests);
+}
+
+//---------------------------------------------------------------------------------------
+bool ColStaffObjsBuilder::verify(ImoScore* pScore)
+{
+    ColStaffObjs* pColStaffObjs = pScore->get_staffobjs_table();
+    ColStaffObjsBuilderEngine* builder = create_builder_engine(pScore);
+    ColStaffObjs* pExpected = builder->do_build();
+    delete builder;
+
+    bool fOk = pColStaffObjs != nullptr
+               && pColStaffObjs->num_entries() == pExpected->num_entries()
+               && pColStaffObjs->num_lines() == pExpected->num_lines()
+               && is_equal_time(pColStaffObjs->min_note_duration(),
+                                pExpected->min_note_duration())
+               && is_equal_time(pColStaffObjs->anacrusis_missing_time(),
+                                pExpected->anacrusis_missing_time());
+
+    if (fOk)
+    {
+        ColStaffObjsEntry* pEntry = pColStaffObjs->front();
+        ColStaffObjsEntry* pOther = pExpected->front();
+        for (; fOk && pEntry && pOther;
+             pEntry = pEntry->get_next(), pOther = pOther->get_next())
+        {
+            fOk = pEntry->imo_object() == pOther->imo_object()
+                  && pEntry->num_instrument() == pOther->num_instrument()
+                  && pEntry->staff() == pOther->staff()
+                  && pEntry->line() == pOther->line()
+                  && pEntry->measure() == pOther->measure()
+                  && pEntry->order() == pOther->order();
+        }
+    }
+
+    if (!fOk)
+    {
+        LOMSE_LOG_ERROR("ColStaffObjs table differs from full build. Table:\n%s\n"
+                        "Expected:\n%s",
+                        (pColStaffObjs ? pColStaffObjs->dump().c_str() : "null"),
+                        pExpected->dump().c_str());
+    }
+
+    delete pExpected;
+    return fOk;
+}
+
 //---------------------------------------------------------------------------------------
 ColStaffObjsBuilderEngine* ColStaffObjsBuilder::create_builder_engine(ImoScore* pScore)
 {
@@ -331,12 +928,74 @@ void ColStaffObjsBuilderEngine::create_table()
     int totalInstruments = m_pImScore->get_num_instruments();
     for (int instr = 0; instr < totalInstruments; instr++)
     {
+        int firstLine = get_line_for(0, 0);
+        TimeUnits minNote = m_minNoteDuration;
+        m_minNoteDuration = LOMSE_NO_NOTE_DURATION;
+        m_order = 0;
+        m_lineRequests.clear();
+        m_noteDurations.clear();
+
         create_entries(instr);
+
+        m_pColStaffObjs->m_instrData.push_back(
+            ColStaffObjs::InstrumentData(firstLine, m_lines.get_number_of_lines(),
+                                         m_minNoteDuration) );
+        m_pColStaffObjs->m_instrData.back().lineRequests.swap(m_lineRequests);
+        m_pColStaffObjs->m_instrData.back().noteDurations.swap(m_noteDurations);
+        m_minNoteDuration = min(minNote, m_minNoteDuration);
         prepare_for_next_instrument();
     }
     collect_anacrusis_info();
 }
 
+//---------------------------------------------------------------------------------------
+bool ColStaffObjsBuilderEngine::replay_entries(ColStaffObjs* UNUSED(pColStaffObjs),
+                                               int UNUSED(iInstr),
+                                               ImoStaffObj* UNUSED(pFirstChanged),
+                                               ColStaffObjsReplay* UNUSED(pReplay))
+{
+    //Determining the entries for only part of an instrument is not supported by
+    //default. The table must be built again.
+    return false;
+}
+
+//---------------------------------------------------------------------------------------
+void ColStaffObjsBuilderEngine::update_table_info()
+{
+    //after replacing the entries for one instrument (see replay_entries()), table
+    //information must also be updated
+
+    TimeUnits minNote = LOMSE_NO_NOTE_DURATION;
+    for (const ColStaffObjs::InstrumentData& data : m_pColStaffObjs->m_instrData)
+        minNote = min(minNote, data.minNoteDuration);
+    m_pColStaffObjs->set_min_note(minNote);
+
+    m_pColStaffObjs->set_anacrusis_missing_time(0.0);
+    collect_anacrusis_info();
+}
+
+//---------------------------------------------------------------------------------------
+void ColStaffObjsBuilderEngine::add_entry(int measure, int nInstr, int nLine, int nStaff,
+                                          ImoStaffObj* pSO)
+{
+    if (m_pCollected)
+    {
+        m_pCollected->push_back(
+            ColStaffObjsEntry(measure, nInstr, nLine, nStaff, pSO, m_order) );
+        m_pCollected->back().set_note_duration(m_noteDuration);
+    }
+    else
+    {
+        ColStaffObjsEntry* pEntry =
+            m_pColStaffObjs->add_entry(measure, nInstr, nLine, nStaff, pSO, m_order);
+        pEntry->set_note_duration(m_noteDuration);
+        if (m_noteDuration > 0.0)
+            ++m_noteDurations[m_noteDuration];
+    }
+    m_noteDuration = 0.0;
+    ++m_order;
+}
+
 //---------------------------------------------------------------------------------------
 void ColStaffObjsBuilderEngine::collect_anacrusis_info()
 {
@@ -383,6 +1042,8 @@ void ColStaffObjsBuilderEngine::collect_anacrusis_info()
 //---------------------------------------------------------------------------------------
 int ColStaffObjsBuilderEngine::get_line_for(int nVoice, int nStaff)
 {
+    if (!m_lines.is_assigned(nVoice, nStaff))
+        m_lineRequests.push_back( StaffVoiceLine(m_order, nVoice, nStaff) );
     return m_lines.get_line_assigned_to(nVoice, nStaff);
 }
 
@@ -403,7 +1064,7 @@ void ColStaffObjsBuilderEngine::add_entries_for_key_or_time_signature(ImoObj* pI
     for (int nStaff=0; nStaff < numStaves; nStaff++)
     {
         int nLine = get_line_for(0, nStaff);
-        m_pColStaffObjs->add_entry(m_nCurMeasure, nInstr, nLine, nStaff, pSO);
+        add_entry(m_nCurMeasure, nInstr, nLine, nStaff, pSO);
     }
 }
 
@@ -473,7 +1134,7 @@ void ColStaffObjsBuilderEngine1x::add_entry_for_staffobj(ImoObj* pImo, int nInst
         m_minNoteDuration = min(m_minNoteDuration, pNR->get_duration());
     }
     int nLine = get_line_for(nVoice, nStaff);
-    m_pColStaffObjs->add_entry(m_nCurMeasure, nInstr, nLine, nStaff, pSO);
+    add_entry(m_nCurMeasure, nInstr, nLine, nStaff, pSO);
 }
 
 //---------------------------------------------------------------------------------------
@@ -576,19 +1237,180 @@ void ColStaffObjsBuilderEngine2x::create_entries(int nInstr)
     reset_counters();
     ImoObj::children_iterator it;
     for(it = pMusicData->begin(); it != pMusicData->end(); ++it)
+        add_entries_for(*it, nInstr);
+}
+
+//---------------------------------------------------------------------------------------
+void ColStaffObjsBuilderEngine2x::add_entries_for(ImoObj* pImo, int nInstr)
+{
+    if (pImo->is_key_signature() || pImo->is_time_signature())
+    {
+        add_entries_for_key_or_time_signature(pImo, nInstr);
+    }
+    else
+    {
+        ImoStaffObj* pSO = static_cast<ImoStaffObj*>(pImo);
+        add_entry_for_staffobj(pSO, nInstr);
+        if (pSO->is_barline())
+            update_measure();
+    }
+}
+
+//---------------------------------------------------------------------------------------
+bool ColStaffObjsBuilderEngine2x::replay_entries(ColStaffObjs* pColStaffObjs, int iInstr,
+                                                 ImoStaffObj* pFirstChanged,
+                                                 ColStaffObjsReplay* pReplay)
+{
+    //Determines again the entries for instrument iInstr, but only from the barline
+    //before pFirstChanged up to a barline at which the algorithm is in the same state
+    //than when the table was built (same time, and lines requested for the same
+    //voices and staves). As next staffobjs are not changed, their entries would not
+    //change. When pFirstChanged is nullptr, all entries for the instrument are
+    //determined again. Entries are saved in pReplay instead of adding them to the
+    //table.
+
+    ImoInstrument* pInstr = m_pImScore->get_instrument(iInstr);
+    ImoMusicData* pMusicData = pInstr->get_musicdata();
+    if (!pMusicData)
+        return false;
+
+    m_pColStaffObjs = pColStaffObjs;
+    ColStaffObjs::InstrumentData& data = pColStaffObjs->m_instrData[iInstr];
+    reset_counters();
+    m_lines.new_instrument_at_line(data.firstLine);
+    m_order = 0;
+    m_lineRequests.clear();
+
+    //find the barline before the first changed staffobj and restart from it
+    ImoObj* pImo = (pFirstChanged ? pFirstChanged->get_prev_sibling() : nullptr);
+    while (pImo && !pImo->is_barline())
+        pImo = pImo->get_prev_sibling();
+    if (pImo)
+    {
+        pReplay->pStart = pColStaffObjs->find_entry_for(static_cast<ImoStaffObj*>(pImo));
+        if (!pReplay->pStart)
+            return false;
+        restart_after(pReplay->pStart, pImo, data);
+        pImo = pImo->get_next_sibling();
+    }
+    else
+        pImo = pMusicData->get_first_child();
+    pReplay->startOrder = m_order;
+
+    //info about last barline at which the state is the same
+    bool fSameState = false;
+    ImoStaffObj* pBarline = nullptr;
+    int barlineOrder = 0;
+    TimeUnits barlineTime = 0.0;
+    size_t numEntries = 0;
+    size_t numRequests = 0;
+
+    m_pCollected = &(pReplay->entries);
+    for (; pImo; pImo = pImo->get_next_sibling())
     {
-        if ((*it)->is_key_signature() || (*it)->is_time_signature())
+        ImoStaffObj* pSO = static_cast<ImoStaffObj*>(pImo);
+        ColStaffObjsEntry* pOld = (pFirstChanged ? pColStaffObjs->find_entry_for(pSO)
+                                                 : nullptr);
+        TimeUnits oldTime = pSO->get_time();
+
+        add_entries_for(pSO, iInstr);
+
+        //check if the entry has not changed
+        ColStaffObjsEntry& entry = pReplay->entries.back();
+        if (!pOld || !is_equal_time(oldTime, entry.time()) || pOld->line() != entry.line())
+            fSameState = false;
+        else if (pSO->is_barline())
         {
-            add_entries_for_key_or_time_signature(*it, nInstr);
+            fSameState = same_line_requests(data, pReplay->startOrder, pOld->order());
+            pBarline = pSO;
+            barlineOrder = pOld->order();
+            barlineTime = oldTime;
+            numEntries = pReplay->entries.size();
+            numRequests = m_lineRequests.size();
+            pReplay->measureShift = entry.measure() - pOld->measure();
+            pReplay->orderShift = entry.order() - pOld->order();
+        }
+        else if (fSameState
+                 && entry.measure() - pOld->measure() == pReplay->measureShift
+                 && entry.order() - pOld->order() == pReplay->orderShift)
+        {
+            //After the barline, the current voice is not known until reaching a
+            //note/rest. If entries are the same up to it, next entries will not
+            //change. Entries after the barline are kept.
+            if (pSO->is_note_rest())
+            {
+                pReplay->pLast = pBarline;
+                pReplay->lastOrder = barlineOrder;
+                pReplay->lastTime = barlineTime;
+                pReplay->entries.erase(pReplay->entries.begin() + numEntries,
+                                       pReplay->entries.end());
+                m_lineRequests.erase(m_lineRequests.begin() + numRequests,
+                                     m_lineRequests.end());
+                break;
+            }
         }
         else
+            fSameState = false;
+    }
+    m_pCollected = nullptr;
+
+    pReplay->lineRequests.swap(m_lineRequests);
+    pReplay->lastLine = m_lines.get_number_of_lines();
+    return true;
+}
+
+//---------------------------------------------------------------------------------------
+void ColStaffObjsBuilderEngine2x::restart_after(ColStaffObjsEntry* pBarline, ImoObj* pImo,
+                                                ColStaffObjs::InstrumentData& data)
+{
+    //sets the algorithm state as it was after processing barline pImo, whose entry
+    //is pBarline
+
+    m_order = pBarline->order() + 1;
+    std::vector<StaffVoiceLine>::iterator it;
+    for (it = data.lineRequests.begin(); it != data.lineRequests.end(); ++it)
+    {
+        if (it->order >= m_order)
+            break;
+        m_lines.get_line_assigned_to(it->voice, it->staff);
+    }
+
+    m_nCurMeasure = pBarline->measure() + 1;
+    m_rMaxSegmentTime = pBarline->time();
+    m_rStartSegmentTime = m_rMaxSegmentTime;
+    m_rCurTime.assign(k_max_voices, m_rMaxSegmentTime);
+
+    //current voice is the voice of the last note/rest
+    ImoObj* pPrev = pImo->get_prev_sibling();
+    while (pPrev && !pPrev->is_note_rest())
+        pPrev = pPrev->get_prev_sibling();
+    if (pPrev)
+        m_curVoice = static_cast<ImoNoteRest*>(pPrev)->get_voice();
+}
+
+//---------------------------------------------------------------------------------------
+bool ColStaffObjsBuilderEngine2x::same_line_requests(ColStaffObjs::InstrumentData& data,
+                                                     int startOrder, int lastOrder)
+{
+    //returns true if the lines requested since the restart point are the same than
+    //when building the table, from startOrder up to old creation order lastOrder
+
+    std::vector<StaffVoiceLine>::iterator itNew = m_lineRequests.begin();
+    std::vector<StaffVoiceLine>::iterator it;
+    for (it = data.lineRequests.begin(); it != data.lineRequests.end(); ++it)
+    {
+        if (it->order < startOrder)
+            continue;
+        if (it->order > lastOrder)
+            break;
+        if (itNew == m_lineRequests.end() || itNew->voice != it->voice
+            || itNew->staff != it->staff)
         {
-            ImoStaffObj* pSO = static_cast<ImoStaffObj*>(*it);
-            add_entry_for_staffobj(pSO, nInstr);
-            if (pSO->is_barline())
-                update_measure();
+            return false;
         }
+        ++itNew;
     }
+    return itNew == m_lineRequests.end();
 }
 
 //---------------------------------------------------------------------------------------
@@ -610,7 +1432,7 @@ void ColStaffObjsBuilderEngine2x::add_entry_for_staffobj(ImoObj* pImo, int nInst
         nVoice = m_curVoice;
 
     int nLine = get_line_for(nVoice, nStaff);
-    m_pColStaffObjs->add_entry(m_nCurMeasure, nInstr, nLine, nStaff, pSO);
+    add_entry(m_nCurMeasure, nInstr, nLine, nStaff, pSO);
 }
 
 //---------------------------------------------------------------------------------------
@@ -644,7 +1466,10 @@ void ColStaffObjsBuilderEngine2x::determine_timepos(ImoStaffObj* pSO)
         m_rCurTime[voice] += duration;
 
         if (duration > 0.0)
+        {
             m_minNoteDuration = min(m_minNoteDuration, duration);
+            m_noteDuration = duration;
+        }
     }
     else if (pSO->is_barline())
     {
@@ -700,6 +1525,13 @@ int StaffVoiceLineTable::get_line_assigned_to(int nVoice, int nStaff)
         return assign_line_to(nVoice, nStaff);
 }
 
+//---------------------------------------------------------------------------------------
+bool StaffVoiceLineTable::is_assigned(int nVoice, int nStaff)
+{
+    return m_lineForStaffVoice.find( form_key(nVoice, nStaff) )
+           != m_lineForStaffVoice.end();
+}
+
 //---------------------------------------------------------------------------------------
 int StaffVoiceLineTable::assign_line_to(int nVoice, int nStaff)
 {
@@ -732,6 +1564,14 @@ int StaffVoiceLineTable::assign_line_to(int nVoice, int nStaff)
     return line;
 }
 
+//---------------------------------------------------------------------------------------
+void StaffVoiceLineTable::new_instrument_at_line(int line)
+{
+    //prepare table for an instrument whose first line is line
+    m_lastAssignedLine = line - 1;
+    new_instrument();
+}
+
 //---------------------------------------------------------------------------------------
 void StaffVoiceLineTable::new_instrument()
 {
@@ -61,7 +61,6 @@ LomseDoorway::LomseDoorway()
     , m_pObj_notify(nullptr)
     , m_pObj_request(nullptr)
 {
-    clear_forensic_log();
 }
 
 //---------------------------------------------------------------------------------------
@@ -70,14 +69,6 @@ LomseDoorway::~LomseDoorway()
     delete m_pLibraryScope;
 }
 
-//---------------------------------------------------------------------------------------
-void LomseDoorway::clear_forensic_log()
-{
-    ofstream logger;
-    logger.open("forensic_log.txt");
-    logger.close();
-}
-
 //---------------------------------------------------------------------------------------
 Presenter* LomseDoorway::new_document(int viewType)
 {
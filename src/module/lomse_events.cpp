@@ -432,4 +432,63 @@ EventControlPointMoved::EventControlPointMoved(EEventType type, WpInteractor wpI
 }
 
 
+//=======================================================================================
+// EventVisualTracking implementation
+//=======================================================================================
+bool EventVisualTracking::coalesce(EventVisualTracking* pNext)
+{
+    //Merges the sub-events of pNext into this event, removing redundant sub-events.
+    //It is used by EventsDispatcher when this event has not yet been delivered.
+    //Returns false if both events are not for the same score and interactor.
+
+    if (m_nID != pNext->m_nID
+        || m_wpInteractor.owner_before(pNext->m_wpInteractor)
+        || pNext->m_wpInteractor.owner_before(m_wpInteractor))
+    {
+        return false;
+    }
+
+    std::list< pair<int, ImoId> >::iterator itNew;
+    for (itNew = pNext->m_items.begin(); itNew != pNext->m_items.end(); ++itNew)
+    {
+        int type = (*itNew).first;
+        if (type == k_end_of_visual_tracking)
+        {
+            //all visual effects are going to be removed
+            m_items.clear();
+        }
+        else if (type == k_move_tempo_line)
+        {
+            //only the last tempo line position is relevant
+            std::list< pair<int, ImoId> >::iterator it = m_items.begin();
+            while (it != m_items.end())
+            {
+                if ((*it).first == k_move_tempo_line)
+                    it = m_items.erase(it);
+                else
+                    ++it;
+            }
+            m_timepos = pNext->m_timepos;
+        }
+        else if (type == k_highlight_off)
+        {
+            //a pending highlight on for the same object is just cancelled
+            std::list< pair<int, ImoId> >::iterator it;
+            for (it = m_items.begin(); it != m_items.end(); ++it)
+            {
+                if ((*it).first == k_highlight_on && (*it).second == (*itNew).second)
+                    break;
+            }
+            if (it != m_items.end())
+            {
+                m_items.erase(it);
+                continue;
+            }
+        }
+        m_items.push_back(*itNew);
+    }
+    return true;
+}
+
+
 }   //namespace lomse
@@ -29,17 +29,18 @@
 
 #include "lomse_events_dispatcher.h"
 
+#include "lomse_doorway.h"
+#include "lomse_logger.h"
+
 namespace lomse
 {
 
-//TODO: For now, direct invocation without enqueuing the event in the thread.
-#define LOMSE_DIRECT_INVOCATION     1       //1=do not use events thread
-
 //=======================================================================================
 // EventsDispatcher implementation
 //=======================================================================================
-EventsDispatcher::EventsDispatcher()
-    : m_pThread(nullptr)
+EventsDispatcher::EventsDispatcher(LomseDoorway* pDoorway)
+    : m_pDoorway(pDoorway)
+    , m_pThread(nullptr)
     , m_fStopLoop(false)
 {
 }
@@ -47,54 +48,109 @@ EventsDispatcher::EventsDispatcher()
 //---------------------------------------------------------------------------------------
 EventsDispatcher::~EventsDispatcher()
 {
+    stop_events_loop();
 }
 
 //---------------------------------------------------------------------------------------
 void EventsDispatcher::start_events_loop()
 {
     //Create the thread. It starts inmediately to execute the events loop (method
-    //run_events_loop())
+    //run_events_loop()). From now on, events are enqueued and delivered by that
+    //thread.
 
-    //AWARE: this method is only intended to be invoked by Lomse, when the library is
-    //initialized. This method only returns when the stop_events_loop() method
-    //is invoked.
+    if (m_pThread)
+        return;
 
-#if (LOMSE_DIRECT_INVOCATION == 0)
-    delete m_pThread;
+    m_fStopLoop = false;
     m_pThread = LOMSE_NEW EventsThread(&EventsDispatcher::thread_main, this);
-#endif
 }
 
 //---------------------------------------------------------------------------------------
 void EventsDispatcher::stop_events_loop()
 {
-    //stops the events dispatch loop
+    //stops the events dispatch loop and waits for the thread to finish. From now on,
+    //events are delivered synchronously. Events pending in the queue are discarded.
+
+    if (!m_pThread)
+        return;
+
+    {
+        QueueLock lock(m_mutex);
+        m_fStopLoop = true;
+    }
+    m_queueFlag.notify_one();
 
-    //AWARE: this method is only intended to be run by Lomse, when the
-    //Lomse LibraryScope object is destroyed.
+    m_pThread->join();
+    delete m_pThread;
+    m_pThread = nullptr;
 
-    m_fStopLoop = true;
+    QueueLock lock(m_mutex);
+    m_events.clear();
 }
 
 //---------------------------------------------------------------------------------------
 void EventsDispatcher::thread_main()
 {
-#if (LOMSE_DIRECT_INVOCATION == 0)
     run_events_loop();
-#endif
 }
 
 //---------------------------------------------------------------------------------------
 void EventsDispatcher::post_event(Observer* pObserver, SpEventInfo pEvent)
 {
-#if (LOMSE_DIRECT_INVOCATION == 1)
-    pObserver->notify(pEvent);
-#else
+    if (m_pThread)
+        enqueue(pEvent, pObserver);
+    else
+        pObserver->notify(pEvent);
+}
+
+//---------------------------------------------------------------------------------------
+void EventsDispatcher::post_event(SpEventInfo pEvent)
+{
+    //event for the user application
+
+    if (m_pThread)
+        enqueue(pEvent, nullptr);
+    else
+        deliver(pEvent, nullptr);
+}
+
+//---------------------------------------------------------------------------------------
+void EventsDispatcher::enqueue(SpEventInfo pEvent, Observer* pObserver)
+{
     {
         QueueLock lock(m_mutex);
-        m_events.push( make_pair(pEvent, pObserver));
+        if (coalesce_with_last(pEvent, pObserver))
+            return;
+        m_events.push_back( QueuedEvent(pEvent, pObserver) );
     }
-#endif
+    m_queueFlag.notify_one();
+}
+
+//---------------------------------------------------------------------------------------
+bool EventsDispatcher::coalesce_with_last(SpEventInfo pEvent, Observer* pObserver)
+{
+    //AWARE: must be invoked with the queue locked.
+    //Only the last pending event is considered, so that events order is preserved.
+
+    if (m_events.empty() || !pEvent->is_tracking_event())
+        return false;
+
+    QueuedEvent& last = m_events.back();
+    if (last.pObserver != pObserver || !last.pEvent->is_tracking_event())
+        return false;
+
+    SpEventVisualTracking pLast( static_pointer_cast<EventVisualTracking>(last.pEvent) );
+    SpEventVisualTracking pNew( static_pointer_cast<EventVisualTracking>(pEvent) );
+    return pLast->coalesce(pNew.get());
+}
+
+//---------------------------------------------------------------------------------------
+void EventsDispatcher::deliver(SpEventInfo pEvent, Observer* pObserver)
+{
+    if (pObserver)
+        pObserver->notify(pEvent);
+    else if (m_pDoorway)
+        m_pDoorway->post_event(pEvent);
 }
 
 //---------------------------------------------------------------------------------------
@@ -103,31 +159,36 @@ void EventsDispatcher::post_event(Observer* pObserver, SpEventInfo pEvent)
 
 void EventsDispatcher::run_events_loop()
 {
-    std::chrono::milliseconds waitTime(5);   //5ms
+    deque<QueuedEvent> batch;
 
-    while (!stop_event_received())
+    while (true)
     {
-        if (pending_events())
-            dispatch_next_event();
-        else
-            std::this_thread::sleep_for(waitTime);
+        {
+            QueueLock lock(m_mutex);
+            m_queueFlag.wait(lock, [this]{ return m_fStopLoop || !m_events.empty(); });
+            if (m_fStopLoop)
+                return;
+
+            //take all pending events. New events can be enqueued while these
+            //are delivered
+            batch.swap(m_events);
+        }
+
+        dispatch_pending_events(batch);
     }
 }
 
 //---------------------------------------------------------------------------------------
-void EventsDispatcher::dispatch_next_event()
+void EventsDispatcher::dispatch_pending_events(deque<QueuedEvent>& batch)
 {
-    pair<SpEventInfo, Observer*> event;
+    LOMSE_LOG_DEBUG(Logger::k_events, "Dispatching %d events", int(batch.size()));
 
+    while (!batch.empty())
     {
-        QueueLock lock(m_mutex);
-        event = m_events.front();
-        m_events.pop();
+        QueuedEvent& event = batch.front();
+        deliver(event.pEvent, event.pObserver);
+        batch.pop_front();
     }
-
-    SpEventInfo pEvent = event.first;
-    Observer* pObserver = event.second;
-    pObserver->notify(pEvent);
 }
 
 
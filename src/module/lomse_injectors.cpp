@@ -56,16 +56,81 @@
 #include "lomse_id_assigner.h"
 #include "lomse_document_cursor.h"
 #include "lomse_command.h"
+#include "lomse_command_journal.h"
 #include "lomse_caret_positioner.h"
 #include "lomse_glyphs.h"
 #include "lomse_engraving_options.h"
+#include "lomse_model_arena.h"
 
 #include <sstream>
+#include <atomic>
+#include <vector>
 using namespace std;
 
 namespace lomse
 {
 
+//---------------------------------------------------------------------------------------
+// ThreadFontStorages: the FontStorage objects of a thread, one for each LibraryScope
+// used in the thread. They are deleted when the thread ends.
+class ThreadFontStorages
+{
+protected:
+    std::vector< std::pair<unsigned long, FontStorage*> > m_storages; //scope id, storage
+
+public:
+    ThreadFontStorages() {}
+    ~ThreadFontStorages();
+
+    FontStorage* get_storage(LibraryScope* pScope, unsigned long scopeId);
+    void delete_storage(unsigned long scopeId);
+};
+
+static thread_local ThreadFontStorages m_threadFontStorages;
+static thread_local bool m_fThreadFontsDeleted = false;
+static std::atomic<unsigned long> m_nextScopeId(1);
+
+//---------------------------------------------------------------------------------------
+ThreadFontStorages::~ThreadFontStorages()
+{
+    std::vector< std::pair<unsigned long, FontStorage*> >::iterator it;
+    for (it = m_storages.begin(); it != m_storages.end(); ++it)
+        delete it->second;
+    m_storages.clear();
+    m_fThreadFontsDeleted = true;
+}
+
+//---------------------------------------------------------------------------------------
+FontStorage* ThreadFontStorages::get_storage(LibraryScope* pScope, unsigned long scopeId)
+{
+    //there is normally only one LibraryScope. A linear search is enough
+    std::vector< std::pair<unsigned long, FontStorage*> >::iterator it;
+    for (it = m_storages.begin(); it != m_storages.end(); ++it)
+    {
+        if (it->first == scopeId)
+            return it->second;
+    }
+
+    FontStorage* pStorage = LOMSE_NEW FontStorage(pScope);
+    m_storages.push_back( std::make_pair(scopeId, pStorage) );
+    return pStorage;
+}
+
+//---------------------------------------------------------------------------------------
+void ThreadFontStorages::delete_storage(unsigned long scopeId)
+{
+    std::vector< std::pair<unsigned long, FontStorage*> >::iterator it;
+    for (it = m_storages.begin(); it != m_storages.end(); ++it)
+    {
+        if (it->first == scopeId)
+        {
+            delete it->second;
+            m_storages.erase(it);
+            return;
+        }
+    }
+}
+
 
 //=======================================================================================
 // LibraryScope implementation
@@ -75,9 +140,11 @@ LibraryScope::LibraryScope(ostream& reporter, LomseDoorway* pDoorway)
     , m_pDoorway(pDoorway)
     , m_pNullDoorway(nullptr)
     , m_pLdpFactory(nullptr)       //lazzy instantiation. Singleton scope.
-    , m_pFontStorage(nullptr)      //lazzy instantiation. Singleton scope.
+    , m_scopeId(m_nextScopeId++)
+    , m_pGlyphMetrics( LOMSE_NEW GlyphMetricsStore() )
     , m_pGlobalMetronome(nullptr)
     , m_pDispatcher(nullptr)
+    , m_pJournal(nullptr)
     , m_sMusicFontFile("Bravura.otf")
     , m_sMusicFontName("Bravura")
     , m_sMusicFontPath(LOMSE_FONTS_PATH)
@@ -85,6 +152,10 @@ LibraryScope::LibraryScope(ostream& reporter, LomseDoorway* pDoorway)
     , m_pMusicGlyphs(nullptr)      //lazzy instantiation. Singleton scope.
     , m_fReplaceLocalMetronome(false)
     , m_importOptions()
+    , m_fAsyncEvents(false)
+    , m_fModelArena(false)
+    , m_fIncrementalLayout(true)
+    , m_renderingThreads(1)
     , m_fJustifySystems(true)
     , m_fDumpColumnTables(false)
     , m_fDrawAnchorObjects(false)
@@ -92,6 +163,7 @@ LibraryScope::LibraryScope(ostream& reporter, LomseDoorway* pDoorway)
     , m_fShowShapeBounds(false)
     , m_fUnitTests(false)
     , m_traceLinesBreaker(k_trace_breaks_off)
+    , m_fVerifyUpdates(false)
     , m_fUseDbgValues(false)
     , m_spacingOptForce(1.0f)
     , m_spacingAlpha(0.666666667f)
@@ -111,7 +183,11 @@ LibraryScope::LibraryScope(ostream& reporter, LomseDoorway* pDoorway)
 LibraryScope::~LibraryScope()
 {
     delete m_pLdpFactory;
-    delete m_pFontStorage;
+    //AWARE: FontStorage objects created in other threads are not deleted here, but
+    //when those threads end. They are no longer used, as scope ids are not reused
+    if (!m_fThreadFontsDeleted)
+        m_threadFontStorages.delete_storage(m_scopeId);
+    delete m_pGlyphMetrics;
     delete m_pNullDoorway;
     delete m_pMusicGlyphs;
     if (m_pDispatcher)
@@ -119,6 +195,7 @@ LibraryScope::~LibraryScope()
         m_pDispatcher->stop_events_loop();
         delete m_pDispatcher;
     }
+    delete m_pJournal;
 }
 
 //---------------------------------------------------------------------------------------
@@ -132,9 +209,12 @@ LdpFactory* LibraryScope::ldp_factory()
 //---------------------------------------------------------------------------------------
 FontStorage* LibraryScope::font_storage()
 {
-    if (!m_pFontStorage)
-        m_pFontStorage = LOMSE_NEW FontStorage(this);
-    return m_pFontStorage;
+    //FontStorage is not thread safe. Each thread has its own FontStorage, and it
+    //is deleted when the thread ends. Therefore, do not save the returned pointer:
+    //ask for it when needed. Glyph metrics are shared by all of them, to avoid
+    //measuring the same glyphs again.
+
+    return m_threadFontStorages.get_storage(this, m_scopeId);
 }
 
 //---------------------------------------------------------------------------------------
@@ -177,12 +257,40 @@ EventsDispatcher* LibraryScope::get_events_dispatcher()
 {
     if (!m_pDispatcher)
     {
-        m_pDispatcher = LOMSE_NEW EventsDispatcher();
-        m_pDispatcher->start_events_loop();
+        m_pDispatcher = LOMSE_NEW EventsDispatcher(m_pDoorway);
+        if (m_fAsyncEvents)
+            m_pDispatcher->start_events_loop();
     }
     return m_pDispatcher;
 }
 
+//---------------------------------------------------------------------------------------
+void LibraryScope::set_async_events_dispatch(bool value)
+{
+    m_fAsyncEvents = value;
+    if (m_pDispatcher)
+    {
+        if (value)
+            m_pDispatcher->start_events_loop();
+        else
+            m_pDispatcher->stop_events_loop();
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void LibraryScope::enable_command_journal(const string& filename, size_t maxRecords)
+{
+    delete m_pJournal;
+    m_pJournal = LOMSE_NEW CommandJournal(filename, maxRecords);
+}
+
+//---------------------------------------------------------------------------------------
+void LibraryScope::disable_command_journal()
+{
+    delete m_pJournal;
+    m_pJournal = nullptr;
+}
+
 //---------------------------------------------------------------------------------------
 double LibraryScope::get_screen_ppi() const
 {
@@ -466,6 +574,7 @@ DocCommandExecuter* Injector::inject_DocCommandExecuter(Document* pDoc)
 //=======================================================================================
 DocumentScope::DocumentScope(ostream& reporter)
     : m_reporter(reporter)
+    , m_pArena(nullptr)
 {
     m_idAssigner = LOMSE_NEW IdAssigner();
 }
@@ -474,6 +583,14 @@ DocumentScope::DocumentScope(ostream& reporter)
 DocumentScope::~DocumentScope()
 {
     delete m_idAssigner;
+    delete m_pArena;
+}
+
+//---------------------------------------------------------------------------------------
+void DocumentScope::create_model_arena()
+{
+    if (!m_pArena)
+        m_pArena = LOMSE_NEW ModelArena();
 }
 
 
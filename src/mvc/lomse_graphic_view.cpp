@@ -31,6 +31,8 @@
 #include "lomse_graphic_view.h"
 
 #include <cstdio>       //for sprintf
+#include <cmath>
+#include <cstring>
 #include "lomse_graphical_model.h"
 #include "lomse_gm_basic.h"
 #include "lomse_screen_drawer.h"
@@ -42,6 +44,7 @@
 #include "lomse_visual_effect.h"
 #include "lomse_tempo_line.h"
 #include "lomse_overlays_generator.h"
+#include "lomse_tiles_cache.h"
 #include "lomse_handler.h"
 #include "lomse_box_slice.h"
 #include "lomse_box_slice_instr.h"
@@ -104,6 +107,8 @@ GraphicView::GraphicView(LibraryScope& libraryScope, ScreenDrawer* pDrawer)
     , m_options()
     , m_pRenderBuf(nullptr)
     , m_pOverlaysGenerator(nullptr)
+    , m_pTilesCache(nullptr)
+    , m_pTilesDrawer(nullptr)
     , m_expand(0.0)
     , m_gamma(1.0)
     , m_rotation(0.0)   //degrees: -180.0 to 180.0
@@ -161,6 +166,8 @@ GraphicView::~GraphicView()
 {
     delete m_pDrawer;
     delete m_pOverlaysGenerator;
+    delete m_pTilesCache;
+    delete m_pTilesDrawer;
 
     //AWARE: ownership of all VisualEffects (m_pCaret, m_pDragImg, m_pHighlighted,
     //       m_pTimeGrid & m_pTempoLine) is transferred to OverlaysGenerator.
@@ -768,8 +775,151 @@ void GraphicView::draw_graphic_model()
     m_pDrawer->set_viewport(m_vxOrg, m_vyOrg);
     m_pDrawer->set_transform(m_transform);
 
-    generate_paths();
-    m_pDrawer->render();
+    if (m_pTilesCache && is_valid_viewport())
+        draw_graphic_model_from_tiles();
+    else
+    {
+        generate_paths();
+        m_pDrawer->render();
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void GraphicView::enable_tiles_cache(bool value, size_t maxMemory)
+{
+    delete m_pTilesCache;
+    m_pTilesCache = (value ? LOMSE_NEW TilesCache(maxMemory) : nullptr);
+}
+
+//---------------------------------------------------------------------------------------
+void GraphicView::invalidate_tiles_cache()
+{
+    if (m_pTilesCache)
+        m_pTilesCache->clear();
+}
+
+//---------------------------------------------------------------------------------------
+void GraphicView::draw_graphic_model_from_tiles()
+{
+    //The document, at current scale, is split into square tiles. Tiles intersecting
+    //the viewport are taken from the cache, or rasterized if not cached, and copied
+    //into the rendering buffer. Positions are in document pixels, that is, the
+    //pixels position when the viewport origin is (0,0).
+
+    collect_page_bounds();
+
+    GraphicModel* pGModel = get_graphic_model();
+    unsigned bytesPerPixel = m_pDrawer->bytes_per_pixel();
+
+    TilesContext context;
+    context.modelId = pGModel->get_model_id();
+    context.modelChanges = pGModel->get_num_changes();
+    context.scale = m_transform.scale();
+    context.bytesPerPixel = bytesPerPixel;
+    context.background = m_options.background_color;
+    context.flags = (m_options.read_only_mode ? 1 : 0)
+                    | (m_options.draw_anchor_objects ? 2 : 0)
+                    | (m_options.draw_anchor_lines ? 4 : 0)
+                    | (m_options.draw_shape_bounds ? 8 : 0);
+    m_pTilesCache->set_context(context);
+
+    Pixels size = m_pTilesCache->get_tile_size();
+    int col1 = int( floor(double(m_vxOrg) / double(size)) );
+    int col2 = int( floor(double(m_vxOrg + m_viewportSize.width - 1) / double(size)) );
+    int row1 = int( floor(double(m_vyOrg) / double(size)) );
+    int row2 = int( floor(double(m_vyOrg + m_viewportSize.height - 1) / double(size)) );
+
+    for (int row = row1; row <= row2; ++row)
+    {
+        for (int col = col1; col <= col2; ++col)
+        {
+            RenderingBuffer* pTile = m_pTilesCache->get_tile(col, row);
+            if (!pTile)
+            {
+                pTile = m_pTilesCache->add_tile(col, row, bytesPerPixel);
+                rasterize_tile(pTile, col * size, row * size);
+            }
+            copy_tile_to_canvas(pTile, col * size, row * size);
+        }
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void GraphicView::rasterize_tile(RenderingBuffer* pTile, Pixels x, Pixels y)
+{
+    //x, y: tile position, in document pixels
+
+    if (!m_pTilesDrawer)
+        m_pTilesDrawer = Injector::inject_ScreenDrawer(m_libraryScope);
+
+    //same transform than for the view, but moving viewport origin to tile origin
+    TransAffine transform = m_transform;
+    transform.tx = double(-x);
+    transform.ty = double(-y);
+    m_pTilesDrawer->reset(*pTile, m_options.background_color);
+    m_pTilesDrawer->set_viewport(x, y);
+    m_pTilesDrawer->set_transform(transform);
+
+    //tile rectangle, in model units, enlarged as the viewport culling rectangle
+    Pixels size = m_pTilesCache->get_tile_size();
+    double xLeft = -2.0;
+    double yTop = -2.0;
+    double xRight = double(size + 3);
+    double yBottom = double(size + 3);
+    m_pTilesDrawer->screen_point_to_model(&xLeft, &yTop);
+    m_pTilesDrawer->screen_point_to_model(&xRight, &yBottom);
+    normalize_rectangle(&xLeft, &yTop, &xRight, &yBottom);
+
+    const LUnits margin = 100.0f;     //1 mm
+    URect tile(LUnits(xLeft) - margin, LUnits(yTop) - margin,
+               LUnits(xRight - xLeft) + 2.0f * margin,
+               LUnits(yBottom - yTop) + 2.0f * margin);
+
+    //draw the pages intersecting the tile
+    GraphicModel* pGModel = get_graphic_model();
+    m_options.cull_flag = true;
+    int iPage = 0;
+    list<URect>::iterator it;
+    for (it = m_pageBounds.begin(); it != m_pageBounds.end(); ++it, ++iPage)
+    {
+        URect bounds = *it;
+        bounds.x -= margin;
+        bounds.y -= margin;
+        bounds.width += 2.0f * margin;
+        bounds.height += 2.0f * margin;
+        if (!bounds.intersects(tile))
+            continue;
+
+        UPoint origin = (*it).get_top_left();
+        m_options.cull_rect = URect(tile.x - origin.x, tile.y - origin.y,
+                                    tile.width, tile.height);
+        pGModel->draw_page(iPage, origin, m_pTilesDrawer, m_options);
+    }
+    m_options.cull_flag = false;
+}
+
+//---------------------------------------------------------------------------------------
+void GraphicView::copy_tile_to_canvas(RenderingBuffer* pTile, Pixels x, Pixels y)
+{
+    //x, y: tile position, in document pixels
+
+    Pixels size = m_pTilesCache->get_tile_size();
+    Pixels x1 = max(x, m_vxOrg);
+    Pixels y1 = max(y, m_vyOrg);
+    Pixels x2 = min(x + size, m_vxOrg + m_viewportSize.width);
+    Pixels y2 = min(y + size, m_vyOrg + m_viewportSize.height);
+    if (x2 <= x1 || y2 <= y1)
+        return;
+
+    unsigned bytesPerPixel = m_pDrawer->bytes_per_pixel();
+    size_t bytes = size_t(x2 - x1) * bytesPerPixel;
+    size_t srcOffset = size_t(x1 - x) * bytesPerPixel;
+    size_t dstOffset = size_t(x1 - m_vxOrg) * bytesPerPixel;
+    for (Pixels yDoc = y1; yDoc < y2; ++yDoc)
+    {
+        memcpy(m_pRenderBuf->row_ptr(yDoc - m_vyOrg) + dstOffset,
+               pTile->row_ptr(yDoc - y) + srcOffset, bytes);
+    }
 }
 
 //---------------------------------------------------------------------------------------
@@ -1415,24 +1565,28 @@ void GraphicView::set_rendering_option(int option, bool value)
             m_options.draw_voices_coloured = value;
             break;
     }
+    invalidate_tiles_cache();
 }
 
 //---------------------------------------------------------------------------------------
 void GraphicView::reset_boxes_to_draw()
 {
     m_options.reset_boxes_to_draw();
+    invalidate_tiles_cache();
 }
 
 //---------------------------------------------------------------------------------------
 void GraphicView::set_box_to_draw(int boxType)
 {
     m_options.draw_box_for(boxType);
+    invalidate_tiles_cache();
 }
 
 //---------------------------------------------------------------------------------------
 void GraphicView::highlight_voice(int voice)
 {
     m_options.highlighted_voice = voice;
+    invalidate_tiles_cache();
 }
 
 //---------------------------------------------------------------------------------------
@@ -1493,16 +1647,43 @@ void GraphicView::delete_rectangles(list<PageRectangle*>& rectangles)
 void GraphicView::draw_visible_pages(int minPage, int maxPage)
 {
     GraphicModel* pGModel = get_graphic_model();
+    URect viewport = get_viewport_culling_rectangle();
 
     list<URect>::iterator it = m_pageBounds.begin();
     for (int i=0; i < minPage; i++)
         ++it;
 
+    //only boxes and shapes intersecting the viewport will be drawn
+    m_options.cull_flag = true;
     for (int i=minPage; i <= maxPage; i++, ++it)
     {
         UPoint origin = (*it).get_top_left();
+        m_options.cull_rect = URect(viewport.x - origin.x, viewport.y - origin.y,
+                                    viewport.width, viewport.height);
         pGModel->draw_page(i, origin, m_pDrawer, m_options);
     }
+    m_options.cull_flag = false;
+}
+
+//---------------------------------------------------------------------------------------
+URect GraphicView::get_viewport_culling_rectangle()
+{
+    //Returns the viewport rectangle, in model units. It is enlarged a couple of
+    //pixels, for antialiasing, and 1 mm, for lines thickness not included in
+    //shapes bounds
+
+    double xLeft = -2.0;
+    double yTop = -2.0;
+    double xRight = double(m_viewportSize.width + 2);
+    double yBottom = double(m_viewportSize.height + 2);
+    m_pDrawer->screen_point_to_model(&xLeft, &yTop);
+    m_pDrawer->screen_point_to_model(&xRight, &yBottom);
+    normalize_rectangle(&xLeft, &yTop, &xRight, &yBottom);
+
+    const LUnits margin = 100.0f;     //1 mm
+    return URect(LUnits(xLeft) - margin, LUnits(yTop) - margin,
+                 LUnits(xRight - xLeft) + 2.0f * margin,
+                 LUnits(yBottom - yTop) + 2.0f * margin);
 }
 
 //---------------------------------------------------------------------------------------
@@ -1438,6 +1438,15 @@ void Interactor::set_view_background(Color color)
         pGView->set_background(color);
 }
 
+//---------------------------------------------------------------------------------------
+void Interactor::enable_tiles_cache(bool value, size_t maxMemory)
+{
+    m_fViewParamsChanged = true;
+    GraphicView* pGView = dynamic_cast<GraphicView*>(m_pView);
+    if (pGView)
+        pGView->enable_tiles_cache(value, maxMemory);
+}
+
 //---------------------------------------------------------------------------------------
 void Interactor::set_box_to_draw(int boxType)
 {
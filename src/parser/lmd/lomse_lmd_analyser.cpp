@@ -5759,6 +5759,41 @@ void LmdElementAnalyser::add_to_model(ImoObj* pImo)
 
 
 
+//---------------------------------------------------------------------------------------
+// Element names to tag values. Sorted by name, for binary search
+static const XmlTagName k_lmd_tags[] =
+{
+    { "clef",         k_tag_clef },
+    { "color",        k_tag_color },
+    { "content",      k_tag_content },
+    { "defineStyle",  k_tag_defineStyle },
+    { "dynamic",      k_tag_dynamic },
+    { "group",        k_tag_group },
+    { "image",        k_tag_image },
+    { "instrument",   k_tag_instrument },
+    { "itemizedlist", k_tag_itemizedlist },
+    { "ldpmusic",     k_tag_ldpmusic },
+    { "lenmusdoc",    k_tag_lenmusdoc },
+    { "link",         k_tag_link },
+    { "listitem",     k_tag_listitem },
+    { "musicData",    k_tag_musicData },
+    { "orderedlist",  k_tag_orderedlist },
+    { "para",         k_tag_para },
+    { "param",        k_tag_param },
+    { "parts",        k_tag_parts },
+    { "score",        k_tag_score },
+    { "scorePlayer",  k_tag_scorePlayer },
+    { "section",      k_tag_section },
+    { "styles",       k_tag_styles },
+    { "table",        k_tag_table },
+    { "tableBody",    k_tag_tableBody },
+    { "tableCell",    k_tag_tableCell },
+    { "tableColumn",  k_tag_tableColumn },
+    { "tableHead",    k_tag_tableHead },
+    { "tableRow",     k_tag_tableRow },
+    { "txt",          k_tag_txt },
+};
+
 //=======================================================================================
 // LmdAnalyser implementation
 //=======================================================================================
@@ -5789,42 +5824,12 @@ LmdAnalyser::LmdAnalyser(ostream& reporter, LibraryScope& libraryScope, Document
     , m_nShowTupletNumber(k_yesno_default)
     , m_pLastNote(nullptr)
 {
-    m_NameToTag["clef"] = k_tag_clef;
-    m_NameToTag["content"] = k_tag_content;
-    m_NameToTag["color"] = k_tag_color;
-    m_NameToTag["defineStyle"] = k_tag_defineStyle;
-    m_NameToTag["dynamic"] = k_tag_dynamic;
-    m_NameToTag["group"] = k_tag_group;
-    m_NameToTag["image"] = k_tag_image;
-    m_NameToTag["instrument"] = k_tag_instrument;
-    m_NameToTag["itemizedlist"] = k_tag_itemizedlist;
-    m_NameToTag["ldpmusic"] = k_tag_ldpmusic;
-    m_NameToTag["lenmusdoc"] = k_tag_lenmusdoc;
-    m_NameToTag["link"] = k_tag_link;
-    m_NameToTag["listitem"] = k_tag_listitem;
-    m_NameToTag["musicData"] = k_tag_musicData;
-    m_NameToTag["orderedlist"] = k_tag_orderedlist;
-    m_NameToTag["para"] = k_tag_para;
-    m_NameToTag["param"] = k_tag_param;
-    m_NameToTag["parts"] = k_tag_parts;
-    m_NameToTag["score"] = k_tag_score;
-    m_NameToTag["scorePlayer"] = k_tag_scorePlayer;
-    m_NameToTag["section"] = k_tag_section;
-    m_NameToTag["styles"] = k_tag_styles;
-    m_NameToTag["table"] = k_tag_table;
-    m_NameToTag["tableCell"] = k_tag_tableCell;
-    m_NameToTag["tableColumn"] = k_tag_tableColumn;
-    m_NameToTag["tableBody"] = k_tag_tableBody;
-    m_NameToTag["tableHead"] = k_tag_tableHead;
-    m_NameToTag["tableRow"] = k_tag_tableRow;
-    m_NameToTag["txt"] = k_tag_txt;
 }
 
 //---------------------------------------------------------------------------------------
 LmdAnalyser::~LmdAnalyser()
 {
     delete_relation_builders();
-    m_NameToTag.clear();
 }
 
 //---------------------------------------------------------------------------------------
@@ -5869,13 +5874,97 @@ int LmdAnalyser::get_line_number(XmlNode* node)
     return m_pParser->get_line_number(node);
 }
 
+//---------------------------------------------------------------------------------------
+// Helper for creating element analysers in the stack
+template <class T, class... Args>
+static ImoObj* analyse_with(XmlNode* pNode, Args&&... args)
+{
+    T analyser(std::forward<Args>(args)...);
+    return analyser.analyse_node(pNode);
+}
+
 //---------------------------------------------------------------------------------------
 ImoObj* LmdAnalyser::analyse_node(XmlNode* pNode, ImoObj* pAnchor)
 {
-    LmdElementAnalyser* a = new_analyser( pNode->name(), pAnchor );
-    ImoObj* pImo = a->analyse_node(pNode);
-    delete a;
-    return pImo;
+    switch ( name_to_tag(pNode->name_c_str()) )
+    {
+//        case k_tag_abbrev:          return analyse_with<InstrNameLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+//        case k_tag_anchorLine:      return analyse_with<AnchorLineLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+//        case k_tag_barline:         return analyse_with<BarlineLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+//        case k_tag_beam:            return analyse_with<BeamLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+//        case k_tag_bezier:          return analyse_with<BezierLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+//        case k_tag_border:          return analyse_with<BorderLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+//        case k_tag_chord:           return analyse_with<ChordLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_tag_clef:            return analyse_with<ClefLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_tag_content:         return analyse_with<ContentLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+////        case k_tag_creationMode:    return analyse_with<ContentLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_tag_color:           return analyse_with<ColorLmdAnalyser>(pNode, this, m_reporter, m_libraryScope);
+//        case k_tag_cursor:          return analyse_with<CursorLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_tag_defineStyle:     return analyse_with<DefineStyleLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+//        case k_tag_endPoint:        return analyse_with<PointLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_tag_dynamic:         return analyse_with<DynamicLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+//        case k_tag_fermata:         return analyse_with<FermataLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+//        case k_tag_figuredBass:     return analyse_with<FiguredBassLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+//        case k_tag_font:            return analyse_with<FontLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+//        case k_tag_goBack:          return analyse_with<GoBackFwdLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+//        case k_tag_goFwd:           return analyse_with<GoBackFwdLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_tag_group:           return analyse_with<GroupLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_tag_image:           return analyse_with<ImageLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_tag_itemizedlist:    return analyse_with<ListLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+//        case k_tag_infoMIDI:        return analyse_with<InfoMidiLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_tag_instrument:      return analyse_with<InstrumentLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+//        case k_tag_key_signature:   return analyse_with<KeySignatureLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_tag_ldpmusic:        return analyse_with<LdpmusicLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_tag_lenmusdoc:       return analyse_with<LenmusdocLmdAnalyser>(pNode, this, m_reporter, m_libraryScope);
+//        case k_tag_line:            return analyse_with<LineLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_tag_link:            return analyse_with<LinkLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_tag_listitem:        return analyse_with<ListItemLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+//        case k_tag_metronome:       return analyse_with<MetronomeLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_tag_musicData:       return analyse_with<MusicDataLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+//        case k_tag_na:              return analyse_with<NoteRestLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+//        case k_tag_newSystem:       return analyse_with<ControlLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+//        case k_tag_note:            return analyse_with<NoteRestLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+//        case k_tag_opt:             return analyse_with<OptLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_tag_orderedlist:     return analyse_with<ListLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+//        case k_tag_pageLayout:      return analyse_with<PageLayoutLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+//        case k_tag_pageMargins:     return analyse_with<PageMarginsLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+//        case k_tag_pageSize:        return analyse_with<PageSizeLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_tag_para:            return analyse_with<ParagraphLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_tag_param:           return analyse_with<ParamLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_tag_parts:           return analyse_with<PartsLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+//        case k_tag_rest:            return analyse_with<NoteRestLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+//        case k_tag_settings:        return analyse_with<SettingsLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_tag_score:           return analyse_with<ScoreLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_tag_scorePlayer:     return analyse_with<ScorePlayerLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_tag_section:         return analyse_with<SectionLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+//        case k_tag_size:            return analyse_with<SizeLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+//        case k_tag_slur:            return analyse_with<SlurLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+//        case k_tag_spacer:          return analyse_with<SpacerLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+//        case k_tag_staff:           return analyse_with<StaffLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+////        case k_tag_symbol:          return analyse_with<XxxxxxxLmdAnalyser>(pNode, this, m_reporter, m_libraryScope);
+////        case k_tag_symbolSize:      return analyse_with<XxxxxxxLmdAnalyser>(pNode, this, m_reporter, m_libraryScope);
+//        case k_tag_startPoint:      return analyse_with<PointLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_tag_styles:          return analyse_with<StylesLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+//        case k_tag_systemLayout:    return analyse_with<SystemLayoutLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+//        case k_tag_systemMargins:   return analyse_with<SystemMarginsLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_tag_table:           return analyse_with<TableLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_tag_tableCell:       return analyse_with<TableCellLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_tag_tableColumn:     return analyse_with<TableColumnLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_tag_tableBody:       return analyse_with<TableBodyLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_tag_tableHead:       return analyse_with<TableHeadLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_tag_tableRow:        return analyse_with<TableRowLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_tag_txt:             return analyse_with<TextItemLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+//        case k_tag_text:            return analyse_with<TextStringLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+//        case k_tag_textbox:         return analyse_with<TextBoxLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+//        case k_tag_time_signature:  return analyse_with<TimeSignatureLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+//        case k_tag_tie:             return analyse_with<TieLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+//        case k_tag_title:           return analyse_with<TitleLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+//        case k_tag_tuplet:          return analyse_with<TupletLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+////        case k_tag_undoData:        return analyse_with<XxxxxxxLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+
+        default:
+            return analyse_with<NullLmdAnalyser>(pNode, this, m_reporter, m_libraryScope, pNode->name());
+    }
 }
 
 //---------------------------------------------------------------------------------------
@@ -6184,99 +6273,9 @@ EAccidentals LmdAnalyser::to_accidentals(const std::string& accidentals)
 }
 
 //---------------------------------------------------------------------------------------
-LmdElementAnalyser* LmdAnalyser::new_analyser(const string& name, ImoObj* pAnchor)
-{
-    //Factory method to create analysers
-
-    switch ( name_to_tag(name) )
-    {
-//        case k_tag_abbrev:          return LOMSE_NEW InstrNameLmdAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_tag_anchorLine:      return LOMSE_NEW AnchorLineLmdAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_tag_barline:         return LOMSE_NEW BarlineLmdAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_tag_beam:            return LOMSE_NEW BeamLmdAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_tag_bezier:          return LOMSE_NEW BezierLmdAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_tag_border:          return LOMSE_NEW BorderLmdAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_tag_chord:           return LOMSE_NEW ChordLmdAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_tag_clef:            return LOMSE_NEW ClefLmdAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_tag_content:         return LOMSE_NEW ContentLmdAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-////        case k_tag_creationMode:    return LOMSE_NEW ContentLmdAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_tag_color:           return LOMSE_NEW ColorLmdAnalyser(this, m_reporter, m_libraryScope);
-//        case k_tag_cursor:          return LOMSE_NEW CursorLmdAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_tag_defineStyle:     return LOMSE_NEW DefineStyleLmdAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_tag_endPoint:        return LOMSE_NEW PointLmdAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_tag_dynamic:         return LOMSE_NEW DynamicLmdAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_tag_fermata:         return LOMSE_NEW FermataLmdAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_tag_figuredBass:     return LOMSE_NEW FiguredBassLmdAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_tag_font:            return LOMSE_NEW FontLmdAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_tag_goBack:          return LOMSE_NEW GoBackFwdLmdAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_tag_goFwd:           return LOMSE_NEW GoBackFwdLmdAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_tag_group:           return LOMSE_NEW GroupLmdAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_tag_image:           return LOMSE_NEW ImageLmdAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_tag_itemizedlist:    return LOMSE_NEW ListLmdAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_tag_infoMIDI:        return LOMSE_NEW InfoMidiLmdAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_tag_instrument:      return LOMSE_NEW InstrumentLmdAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_tag_key_signature:   return LOMSE_NEW KeySignatureLmdAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_tag_ldpmusic:        return LOMSE_NEW LdpmusicLmdAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_tag_lenmusdoc:       return LOMSE_NEW LenmusdocLmdAnalyser(this, m_reporter, m_libraryScope);
-//        case k_tag_line:            return LOMSE_NEW LineLmdAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_tag_link:            return LOMSE_NEW LinkLmdAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_tag_listitem:        return LOMSE_NEW ListItemLmdAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_tag_metronome:       return LOMSE_NEW MetronomeLmdAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_tag_musicData:       return LOMSE_NEW MusicDataLmdAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_tag_na:              return LOMSE_NEW NoteRestLmdAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_tag_newSystem:       return LOMSE_NEW ControlLmdAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_tag_note:            return LOMSE_NEW NoteRestLmdAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_tag_opt:             return LOMSE_NEW OptLmdAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_tag_orderedlist:     return LOMSE_NEW ListLmdAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_tag_pageLayout:      return LOMSE_NEW PageLayoutLmdAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_tag_pageMargins:     return LOMSE_NEW PageMarginsLmdAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_tag_pageSize:        return LOMSE_NEW PageSizeLmdAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_tag_para:            return LOMSE_NEW ParagraphLmdAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_tag_param:           return LOMSE_NEW ParamLmdAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_tag_parts:           return LOMSE_NEW PartsLmdAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_tag_rest:            return LOMSE_NEW NoteRestLmdAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_tag_settings:        return LOMSE_NEW SettingsLmdAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_tag_score:           return LOMSE_NEW ScoreLmdAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_tag_scorePlayer:     return LOMSE_NEW ScorePlayerLmdAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_tag_section:         return LOMSE_NEW SectionLmdAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_tag_size:            return LOMSE_NEW SizeLmdAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_tag_slur:            return LOMSE_NEW SlurLmdAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_tag_spacer:          return LOMSE_NEW SpacerLmdAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_tag_staff:           return LOMSE_NEW StaffLmdAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-////        case k_tag_symbol:          return LOMSE_NEW XxxxxxxLmdAnalyser(this, m_reporter, m_libraryScope);
-////        case k_tag_symbolSize:      return LOMSE_NEW XxxxxxxLmdAnalyser(this, m_reporter, m_libraryScope);
-//        case k_tag_startPoint:      return LOMSE_NEW PointLmdAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_tag_styles:          return LOMSE_NEW StylesLmdAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_tag_systemLayout:    return LOMSE_NEW SystemLayoutLmdAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_tag_systemMargins:   return LOMSE_NEW SystemMarginsLmdAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_tag_table:           return LOMSE_NEW TableLmdAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_tag_tableCell:       return LOMSE_NEW TableCellLmdAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_tag_tableColumn:     return LOMSE_NEW TableColumnLmdAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_tag_tableBody:       return LOMSE_NEW TableBodyLmdAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_tag_tableHead:       return LOMSE_NEW TableHeadLmdAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_tag_tableRow:        return LOMSE_NEW TableRowLmdAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_tag_txt:             return LOMSE_NEW TextItemLmdAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_tag_text:            return LOMSE_NEW TextStringLmdAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_tag_textbox:         return LOMSE_NEW TextBoxLmdAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_tag_time_signature:  return LOMSE_NEW TimeSignatureLmdAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_tag_tie:             return LOMSE_NEW TieLmdAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_tag_title:           return LOMSE_NEW TitleLmdAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_tag_tuplet:          return LOMSE_NEW TupletLmdAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-////        case k_tag_undoData:        return LOMSE_NEW XxxxxxxLmdAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-
-        default:
-            return LOMSE_NEW NullLmdAnalyser(this, m_reporter, m_libraryScope, name);
-    }
-}
-
-//---------------------------------------------------------------------------------------
-int LmdAnalyser::name_to_tag(const string& name) const
+int LmdAnalyser::name_to_tag(const char* name) const
 {
-	map<string, int>::const_iterator it = m_NameToTag.find(name);
-	if (it != m_NameToTag.end())
-		return it->second;
-    else
-        return k_tag_undefined;
+    return find_xml_tag(k_lmd_tags, name, k_tag_undefined);
 }
 
 
@@ -40,52 +40,96 @@ using namespace std;
 namespace lomse
 {
 
+//=======================================================================================
+// LdpReader implementation
+//=======================================================================================
+void LdpReader::set_buffer(const std::string& text)
+{
+    m_pStart = text.data();
+    m_pEnd = m_pStart + text.size();
+    m_pNext = m_pStart;
+    m_fPastEnd = false;
+}
+
+
+
 //=======================================================================================
 // LdpFileReader implementation
 //=======================================================================================
 LdpFileReader::LdpFileReader(const std::string& filelocator)
     : LdpReader()
-    , m_file( FileSystem::open_input_stream(filelocator) )
     , m_locator(filelocator)
+    , m_fReady(false)
+    , m_pLineCount(nullptr)
     , m_numLine(1)
-    , m_repeating_last_char(false)
 {
+    load_file();
 }
+
 //---------------------------------------------------------------------------------------
-LdpFileReader::~LdpFileReader()
+void LdpFileReader::load_file()
 {
-    delete m_file;
+    InputStream* file = FileSystem::open_input_stream(m_locator);
+    m_fReady = file->is_open();
+
+    const long k_chunk = 65536L;
+    while (m_fReady && !file->eof())
+    {
+        size_t size = m_text.size();
+        m_text.resize(size + k_chunk);
+        long bytes = file->read(reinterpret_cast<unsigned char*>(&m_text[size]), k_chunk);
+        m_text.resize(size + size_t(bytes > 0 ? bytes : 0));
+        if (bytes < k_chunk)
+            break;
+    }
+    delete file;
+
+    set_buffer(m_text);
+    m_pLineCount = m_pStart;
 }
 
 //---------------------------------------------------------------------------------------
 char LdpFileReader::get_next_char()
 {
-    char ch = m_file->get_char();
-    if (!m_repeating_last_char && ch == 0x0a)
-        m_numLine++;
-    m_repeating_last_char = false;
-    return ch;
+    return next_buffered_char();
 }
 
 //---------------------------------------------------------------------------------------
 void LdpFileReader::repeat_last_char()
 {
-    m_repeating_last_char = true;
-    m_file->unget();
+    repeat_buffered_char();
 }
 
 //---------------------------------------------------------------------------------------
 bool LdpFileReader::is_ready()
 {
-    return m_file->is_open();
+    return m_fReady;
 }
 
 //---------------------------------------------------------------------------------------
 bool LdpFileReader::end_of_data()
 {
-    return m_file->eof();
+    return buffer_exhausted();
 }
 
+//---------------------------------------------------------------------------------------
+int LdpFileReader::get_line_number()
+{
+    //line feeds are counted from the last requested position, so that the cost
+    //is proportional to the text scanned since then
+
+    for (; m_pLineCount < m_pNext; ++m_pLineCount)
+    {
+        if (*m_pLineCount == '\x0a')
+            ++m_numLine;
+    }
+    for (; m_pLineCount > m_pNext; --m_pLineCount)
+    {
+        if (*(m_pLineCount - 1) == '\x0a')
+            --m_numLine;
+    }
+    return m_numLine;
+}
 
 
 
@@ -95,20 +139,21 @@ bool LdpFileReader::end_of_data()
 
 LdpTextReader::LdpTextReader(const std::string& sourceText)
     : LdpReader()
-    , m_stream(sourceText)
+    , m_text(sourceText)
 {
+    set_buffer(m_text);
 }
 
 //---------------------------------------------------------------------------------------
 char LdpTextReader::get_next_char()
 {
-    return m_stream.get();
+    return next_buffered_char();
 }
 
 //---------------------------------------------------------------------------------------
 void LdpTextReader::repeat_last_char()
 {
-    m_stream.unget();
+    repeat_buffered_char();
 }
 
 //---------------------------------------------------------------------------------------
@@ -120,7 +165,7 @@ bool LdpTextReader::is_ready()
 //---------------------------------------------------------------------------------------
 bool LdpTextReader::end_of_data()
 {
-    return m_stream.peek() == EOF;
+    return buffer_exhausted();
 }
 
 
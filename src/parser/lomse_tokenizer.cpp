@@ -89,6 +89,7 @@ LdpTokenizer::LdpTokenizer(LdpReader& reader, ostream& reporter)
     , m_expectingValuePart(false)
     , m_expectingNamePart(false)
     , m_pTokenNamePart(nullptr)
+    , m_fBuffered(reader.is_buffered())
 {
 }
 
@@ -108,7 +109,7 @@ void LdpTokenizer::skip_utf_bom()
         curChar = get_next_char();  // 0xbf
     }
     else
-        m_reader.repeat_last_char();
+        repeat_last_char();
 }
 
 //---------------------------------------------------------------------------------------
@@ -158,7 +159,7 @@ LdpToken* LdpTokenizer::read_token()
     // loop until a token is found
     while(true)
     {
-        if (m_reader.end_of_data())
+        if (end_of_data())
         {
             m_pToken = LOMSE_NEW LdpToken(tkEndOfFile, "", m_reader.get_line_number());
             return m_pToken;
@@ -202,7 +203,7 @@ LdpToken* LdpTokenizer::parse_new_token()
     };
 
     EAutomataState state = k_Start;
-    stringstream tokendata;
+    string tokendata;
     char curChar = 0;
     int numLine = 0;
 
@@ -266,7 +267,7 @@ LdpToken* LdpTokenizer::parse_new_token()
                 break;
 
             case k_ETQ01:
-                tokendata << curChar;
+                tokendata += curChar;
                 curChar = get_next_char();
                 if (is_letter(curChar) || is_number(curChar) ||
                     curChar == chUnderscore || curChar == chDot ||
@@ -281,12 +282,12 @@ LdpToken* LdpTokenizer::parse_new_token()
                     // compact notation [ name:value --> (name value) ]
                     // 'name' part is parsed and we've found the ':' sign
                     m_expectingNamePart = true;
-                    m_pTokenNamePart = LOMSE_NEW LdpToken(tkLabel, tokendata.str(), numLine);
+                    m_pTokenNamePart = LOMSE_NEW LdpToken(tkLabel, tokendata, numLine);
                     return LOMSE_NEW LdpToken(tkStartOfElement, chOpenParenthesis, numLine);
                 }
                 else {
-                    m_reader.repeat_last_char();
-                    return LOMSE_NEW LdpToken(tkLabel, tokendata.str(), numLine);
+                    repeat_last_char();
+                    return LOMSE_NEW LdpToken(tkLabel, tokendata, numLine);
                 }
                 break;
 
@@ -312,7 +313,7 @@ LdpToken* LdpTokenizer::parse_new_token()
             case k_STR00:
                 curChar = get_next_char();
                 if (curChar == chQuotes) {
-                    return LOMSE_NEW LdpToken(tkString, tokendata.str(), numLine);
+                    return LOMSE_NEW LdpToken(tkString, tokendata, numLine);
                 } else {
                     if (curChar == nEOF) {
                         state = k_Error;
@@ -323,10 +324,10 @@ LdpToken* LdpTokenizer::parse_new_token()
                 break;
 
             case k_STR01:
-                tokendata << curChar;
+                tokendata += curChar;
                 curChar = get_next_char();
                 if (curChar == chQuotes) {
-                    return LOMSE_NEW LdpToken(tkString, tokendata.str(), numLine);
+                    return LOMSE_NEW LdpToken(tkString, tokendata, numLine);
                 } else {
                     if (curChar == nEOF) {
                         state = k_Error;
@@ -346,7 +347,7 @@ LdpToken* LdpTokenizer::parse_new_token()
                 break;
 
             case k_STR02:
-                tokendata << curChar;
+                tokendata += curChar;
                 curChar = get_next_char();
                 if (curChar == chApostrophe) {
                     state = k_STR03;
@@ -358,14 +359,14 @@ LdpToken* LdpTokenizer::parse_new_token()
             case k_STR03:
                 curChar = get_next_char();
                 if (curChar == chApostrophe) {
-                    return LOMSE_NEW LdpToken(tkString, tokendata.str(), numLine);
+                    return LOMSE_NEW LdpToken(tkString, tokendata, numLine);
                 } else {
                     state = k_STR02;
                 }
                 break;
 
             case k_CMT01:
-                tokendata << curChar;
+                tokendata += curChar;
                 curChar = get_next_char();
                 if (curChar == chSlash)
                     state = k_CMT02;
@@ -376,16 +377,16 @@ LdpToken* LdpTokenizer::parse_new_token()
                 break;
 
             case k_CMT02:
-                tokendata << curChar;
+                tokendata += curChar;
                 curChar = get_next_char();
                 if (curChar == chLF || curChar == nEOF) {
-                    return LOMSE_NEW LdpToken(tkComment, tokendata.str(), numLine);
+                    return LOMSE_NEW LdpToken(tkComment, tokendata, numLine);
                 }
                 //else continue in this state
                 break;
 
             case k_CMT03:
-                tokendata << curChar;
+                tokendata += curChar;
                 curChar = get_next_char();
                 if (curChar == chAsterisk || curChar == nEOF) {
                     state = k_CMT04;
@@ -394,18 +395,18 @@ LdpToken* LdpTokenizer::parse_new_token()
                 break;
 
             case k_CMT04:
-                tokendata << curChar;
+                tokendata += curChar;
                 curChar = get_next_char();
                 if (curChar == chSlash || curChar == nEOF) {
-                    tokendata << curChar;
-                    return LOMSE_NEW LdpToken(tkComment, tokendata.str(), numLine);
+                    tokendata += curChar;
+                    return LOMSE_NEW LdpToken(tkComment, tokendata, numLine);
                 }
                 else
                     state = k_CMT03;
                 break;
 
             case k_NUM01:
-                tokendata << curChar;
+                tokendata += curChar;
                 curChar = get_next_char();
                 if (is_number(curChar)) {
                     state = k_NUM01;
@@ -414,19 +415,19 @@ LdpToken* LdpTokenizer::parse_new_token()
                 } else if (is_letter(curChar) || curChar == chUnderscore) {
                     state = k_ETQ01;
                 } else {
-                    m_reader.repeat_last_char();
-                    return LOMSE_NEW LdpToken(tkIntegerNumber, tokendata.str(), numLine);
+                    repeat_last_char();
+                    return LOMSE_NEW LdpToken(tkIntegerNumber, tokendata, numLine);
                 }
                 break;
 
             case k_NUM02:
-                tokendata << curChar;
+                tokendata += curChar;
                 curChar = get_next_char();
                 if (is_number(curChar)) {
                     state = k_NUM02;
                 } else {
-                    m_reader.repeat_last_char();
-                    return LOMSE_NEW LdpToken(tkRealNumber, tokendata.str(), numLine);
+                    repeat_last_char();
+                    return LOMSE_NEW LdpToken(tkRealNumber, tokendata, numLine);
                 }
                 break;
 
@@ -435,21 +436,21 @@ LdpToken* LdpTokenizer::parse_new_token()
                 if (curChar == chSpace || curChar == chTab) {
                     state = k_SPC01;
                 } else {
-                    m_reader.repeat_last_char();
+                    repeat_last_char();
                     return LOMSE_NEW LdpToken(tkSpaces, chSpace, numLine);
                 }
                 break;
 
             case k_S01:
-                tokendata << curChar;
+                tokendata += curChar;
                 curChar = get_next_char();
                 if (curChar == chSpace || curChar == chTab) {
-                    return LOMSE_NEW LdpToken(tkLabel, tokendata.str(), numLine);
+                    return LOMSE_NEW LdpToken(tkLabel, tokendata, numLine);
                 }
                 else if (curChar == chCloseParenthesis)
                 {
-                    m_reader.repeat_last_char();
-                    return LOMSE_NEW LdpToken(tkLabel, tokendata.str(), numLine);
+                    repeat_last_char();
+                    return LOMSE_NEW LdpToken(tkLabel, tokendata, numLine);
                 }
                 else if (is_number(curChar)) {
                     state = k_NUM01;
@@ -487,25 +488,38 @@ LdpToken* LdpTokenizer::parse_new_token()
 //---------------------------------------------------------------------------------------
 char LdpTokenizer::get_next_char()
 {
-    char ch = m_reader.get_next_char();
+    char ch = (m_fBuffered ? m_reader.next_buffered_char() : m_reader.get_next_char());
     if (ch == chTab || ch == chCR)
         return ' ';
     else
         return ch;
 }
 
+//---------------------------------------------------------------------------------------
+void LdpTokenizer::repeat_last_char()
+{
+    if (m_fBuffered)
+        m_reader.repeat_buffered_char();
+    else
+        m_reader.repeat_last_char();
+}
+
+//---------------------------------------------------------------------------------------
+bool LdpTokenizer::end_of_data()
+{
+    return (m_fBuffered ? m_reader.buffer_exhausted() : m_reader.end_of_data());
+}
+
 //---------------------------------------------------------------------------------------
 bool LdpTokenizer::is_letter(char ch)
 {
-    static const std::string letters("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz");
-    return (letters.find(ch) != string::npos);
+    return (ch >= 'A' && ch <= 'Z') || (ch >= 'a' && ch <= 'z');
 }
 
 //---------------------------------------------------------------------------------------
 bool LdpTokenizer::is_number(char ch)
 {
-    static const std::string numbers("0123456789");
-    return (numbers.find(ch) != string::npos);
+    return (ch >= '0' && ch <= '9');
 }
 
 //---------------------------------------------------------------------------------------
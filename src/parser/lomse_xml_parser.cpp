@@ -29,9 +29,12 @@
 
 #include "lomse_xml_parser.h"
 
+#include "lomse_file_system.h"
+
 #include <iostream>
 #include <ostream>
 #include <sstream>
+#include <stdexcept>
 #include <vector>
 using namespace std;
 
@@ -150,6 +153,28 @@ void XmlParser::parse_cstring(char* sourceText)
     parse_char_string(sourceText);
 }
 
+//---------------------------------------------------------------------------------------
+void XmlParser::parse_stream(InputStream* pStream, long size)
+{
+    //Reads 'size' bytes from the stream directly into a buffer allocated with the
+    //pugixml allocator and parses it in place. pugixml takes ownership of the
+    //buffer, so the source text is never duplicated.
+
+    if (size < 0)
+        size = 0;
+    char* buffer = static_cast<char*>(
+                        pugi::get_memory_allocation_function()(size_t(size) + 1) );
+    if (buffer == nullptr)
+        throw std::runtime_error("[XmlParser::parse_stream] error allocating memory");
+
+    long bytes = 0;
+    if (size > 0 && pStream->is_open() && !pStream->eof())
+        bytes = pStream->read(reinterpret_cast<unsigned char*>(buffer), size);
+    buffer[bytes] = 0;
+
+    parse_buffer_inplace(buffer, size_t(bytes));
+}
+
 //---------------------------------------------------------------------------------------
 void XmlParser::parse_file(const std::string& filename, bool UNUSED(fErrorMsg))
 {
@@ -189,6 +214,27 @@ void XmlParser::parse_char_string(char* str)
     find_root();
 }
 
+//---------------------------------------------------------------------------------------
+void XmlParser::parse_buffer_inplace(char* buffer, size_t size)
+{
+    //buffer must have been allocated with pugixml allocation function. Ownership
+    //is transferred to pugixml
+
+    m_fOffsetDataReady = false;
+    m_filename.clear();
+    pugi::xml_parse_result result = m_doc.load_buffer_inplace_own(buffer, size,
+                                                            (pugi::parse_default |
+                                                             pugi::parse_declaration)
+                                                     );
+
+    if (!result)
+    {
+        m_errorMsg = string(result.description());
+        m_errorOffset = result.offset;
+    }
+    find_root();
+}
+
 //---------------------------------------------------------------------------------------
 void XmlParser::find_root()
 {
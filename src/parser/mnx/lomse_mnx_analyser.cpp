@@ -711,10 +711,7 @@ bool MnxElementAnalyser::analyse_optional(const string& name, ImoObj* pAnchor)
 //---------------------------------------------------------------------------------------
 bool MnxElementAnalyser::analyse_content(const string& tag, ImoObj* pAnchor)
 {
-    MnxElementAnalyser* a = m_pAnalyser->new_analyser(tag, pAnchor);
-    bool ret = a->analyse_node(&m_analysedNode);
-    delete a;
-    return ret;
+    return m_pAnalyser->analyse_node_as(tag.c_str(), &m_analysedNode, pAnchor);
 }
 
 //---------------------------------------------------------------------------------------
@@ -3392,6 +3389,84 @@ public:
 
 
 
+//---------------------------------------------------------------------------------------
+// Element names to tag values. Sorted by name, for binary search
+static const XmlTagName k_mnx_tags[] =
+{
+//    { "accordion-registration", k_mnx_tag_accordion_registration },
+//    { "articulations",          k_mnx_tag_articulations },
+//    { "backup",                 k_mnx_tag_backup },
+//    { "barline",                k_mnx_tag_barline },
+    { "beamed",                 k_mnx_tag_beamed },
+//    { "bracket",                k_mnx_tag_bracket },
+    { "clef",                   k_mnx_tag_clef },
+//    { "coda",                   k_mnx_tag_coda },
+    { "cwmnx",                  k_mnx_tag_cwmnx },
+//    { "damp",                   k_mnx_tag_damp },
+//    { "damp-all",               k_mnx_tag_damp_all },
+//    { "dashes",                 k_mnx_tag_dashes },
+//    { "direction",              k_mnx_tag_direction },
+//    { "direction-type",         k_mnx_tag_direction_type },
+    { "directions",             k_mnx_tag_directions },
+    { "dynamics",               k_mnx_tag_dynamics },
+//    { "ending",                 k_mnx_tag_ending },
+    { "event",                  k_mnx_tag_event },
+    { "expression",             k_mnx_tag_expression },
+//    { "eyeglasses",             k_mnx_tag_eyeglasses },
+//    { "fermata",                k_mnx_tag_fermata },
+//    { "forward",                k_mnx_tag_forward },
+    { "global",                 k_mnx_tag_global },
+//    { "harp-pedals",            k_mnx_tag_harp_pedals },
+    { "head",                   k_mnx_tag_head },
+//    { "image",                  k_mnx_tag_image },
+    { "instrument-sound",       k_mnx_tag_instrument_sound },
+    { "key",                    k_mnx_tag_key },
+//    { "lyric",                  k_mnx_tag_lyric },
+    { "measure",                k_mnx_tag_measure },
+//    { "metronome",              k_mnx_tag_metronome },
+//    { "midi-device",            k_mnx_tag_midi_device },
+//    { "midi-instrument",        k_mnx_tag_midi_instrument },
+    { "mnx",                    k_mnx_tag_mnx },
+//    { "notations",              k_mnx_tag_notations },
+    { "note",                   k_mnx_tag_note },
+//    { "octave-shift",           k_mnx_tag_octave_shift },
+//    { "ornaments",              k_mnx_tag_ornaments },
+    { "part",                   k_mnx_tag_part },
+//    { "part-group",             k_mnx_tag_part_group },
+//    { "part-list",              k_mnx_tag_part_list },
+    { "part-name",              k_mnx_tag_part_name },
+//    { "pedal",                  k_mnx_tag_pedal },
+//    { "percussion",             k_mnx_tag_percussion },
+//    { "pitch",                  k_mnx_tag_pitch },
+//    { "principal-voice",        k_mnx_tag_principal_voice },
+//    { "print",                  k_mnx_tag_print },
+//    { "rehearsal",              k_mnx_tag_rehearsal },
+    { "rest",                   k_mnx_tag_rest },
+//    { "scordatura",             k_mnx_tag_scordatura },
+    { "score",                  k_mnx_tag_score },
+//    { "score-instrument",       k_mnx_tag_score_instrument },
+//    { "score-part",             k_mnx_tag_score_part },
+//    { "score-partwise",         k_mnx_tag_score_partwise },
+//    { "segno",                  k_mnx_tag_segno },
+    { "sequence",               k_mnx_tag_sequence },
+    { "sequence_content",       k_mnx_tag_sequence_content },
+//    { "slur",                   k_mnx_tag_slur },
+//    { "sound",                  k_mnx_tag_sound },
+    { "staff",                  k_mnx_tag_staff },
+//    { "string-mute",            k_mnx_tag_string_mute },
+//    { "technical",              k_mnx_tag_technical },
+//    { "text",                   k_mnx_tag_text },
+//    { "tied",                   k_mnx_tag_tied },
+    { "time",                   k_mnx_tag_time },
+//    { "time-modification",      k_mnx_tag_time_modification },
+    { "tuplet",                 k_mnx_tag_tuplet },
+//    { "tuplet-actual",          k_mnx_tag_tuplet_actual },
+//    { "tuplet-normal",          k_mnx_tag_tuplet_normal },
+//    { "virtual-instrument",     k_mnx_tag_virtual_instr },
+    { "wedge",                  k_mnx_tag_wedge },
+//    { "words",                  k_mnx_tag_words },
+};
+
 //=======================================================================================
 // MnxAnalyser implementation
 //=======================================================================================
@@ -3432,86 +3507,12 @@ MnxAnalyser::MnxAnalyser(ostream& reporter, LibraryScope& libraryScope, Document
     , m_curVoice(0)
     , m_beamLevel(0)
 {
-    //populate the name to enum conversion map
-//    m_NameToEnum["accordion-registration"] = k_mnx_tag_accordion_registration;
-//    m_NameToEnum["articulations"] = k_mnx_tag_articulations;
-//    m_NameToEnum["backup"] = k_mnx_tag_backup;
-//    m_NameToEnum["barline"] = k_mnx_tag_barline;
-    m_NameToEnum["beamed"] = k_mnx_tag_beamed;
-//    m_NameToEnum["bracket"] = k_mnx_tag_bracket;
-    m_NameToEnum["clef"] = k_mnx_tag_clef;
-    m_NameToEnum["cwmnx"] = k_mnx_tag_cwmnx;
-//    m_NameToEnum["coda"] = k_mnx_tag_coda;
-//    m_NameToEnum["damp"] = k_mnx_tag_damp;
-//    m_NameToEnum["damp-all"] = k_mnx_tag_damp_all;
-//    m_NameToEnum["dashes"] = k_mnx_tag_dashes;
-//    m_NameToEnum["direction"] = k_mnx_tag_direction;
-    m_NameToEnum["directions"] = k_mnx_tag_directions;
-//    m_NameToEnum["direction-type"] = k_mnx_tag_direction_type;
-    m_NameToEnum["dynamics"] = k_mnx_tag_dynamics;
-//    m_NameToEnum["ending"] = k_mnx_tag_ending;
-    m_NameToEnum["event"] = k_mnx_tag_event;
-    m_NameToEnum["expression"] = k_mnx_tag_expression;
-//    m_NameToEnum["eyeglasses"] = k_mnx_tag_eyeglasses;
-//    m_NameToEnum["fermata"] = k_mnx_tag_fermata;
-//    m_NameToEnum["forward"] = k_mnx_tag_forward;
-    m_NameToEnum["global"] = k_mnx_tag_global;
-//    m_NameToEnum["harp-pedals"] = k_mnx_tag_harp_pedals;
-    m_NameToEnum["head"] = k_mnx_tag_head;
-//    m_NameToEnum["image"] = k_mnx_tag_image;
-    m_NameToEnum["instrument-sound"] = k_mnx_tag_instrument_sound;
-    m_NameToEnum["key"] = k_mnx_tag_key;
-//    m_NameToEnum["lyric"] = k_mnx_tag_lyric;
-    m_NameToEnum["measure"] = k_mnx_tag_measure;
-//    m_NameToEnum["metronome"] = k_mnx_tag_metronome;
-//    m_NameToEnum["midi-device"] = k_mnx_tag_midi_device;
-//    m_NameToEnum["midi-instrument"] = k_mnx_tag_midi_instrument;
-    m_NameToEnum["mnx"] = k_mnx_tag_mnx;
-//    m_NameToEnum["notations"] = k_mnx_tag_notations;
-    m_NameToEnum["note"] = k_mnx_tag_note;
-//    m_NameToEnum["octave-shift"] = k_mnx_tag_octave_shift;
-//    m_NameToEnum["ornaments"] = k_mnx_tag_ornaments;
-    m_NameToEnum["part"] = k_mnx_tag_part;
-//    m_NameToEnum["part-group"] = k_mnx_tag_part_group;
-//    m_NameToEnum["part-list"] = k_mnx_tag_part_list;
-    m_NameToEnum["part-name"] = k_mnx_tag_part_name;
-//    m_NameToEnum["pedal"] = k_mnx_tag_pedal;
-//    m_NameToEnum["percussion"] = k_mnx_tag_percussion;
-//    m_NameToEnum["pitch"] = k_mnx_tag_pitch;
-//    m_NameToEnum["principal-voice"] = k_mnx_tag_principal_voice;
-//    m_NameToEnum["print"] = k_mnx_tag_print;
-//    m_NameToEnum["rehearsal"] = k_mnx_tag_rehearsal;
-    m_NameToEnum["rest"] = k_mnx_tag_rest;
-//    m_NameToEnum["scordatura"] = k_mnx_tag_scordatura;
-    m_NameToEnum["score"] = k_mnx_tag_score;
-//    m_NameToEnum["score-instrument"] = k_mnx_tag_score_instrument;
-//    m_NameToEnum["score-part"] = k_mnx_tag_score_part;
-//    m_NameToEnum["score-partwise"] = k_mnx_tag_score_partwise;
-//    m_NameToEnum["segno"] = k_mnx_tag_segno;
-    m_NameToEnum["sequence"] = k_mnx_tag_sequence;
-    m_NameToEnum["sequence_content"] = k_mnx_tag_sequence_content;
-//    m_NameToEnum["slur"] = k_mnx_tag_slur;
-//    m_NameToEnum["sound"] = k_mnx_tag_sound;
-    m_NameToEnum["staff"] = k_mnx_tag_staff;
-//    m_NameToEnum["string-mute"] = k_mnx_tag_string_mute;
-//    m_NameToEnum["technical"] = k_mnx_tag_technical;
-//    m_NameToEnum["text"] = k_mnx_tag_text;
-//    m_NameToEnum["tied"] = k_mnx_tag_tied;
-    m_NameToEnum["time"] = k_mnx_tag_time;
-//    m_NameToEnum["time-modification"] = k_mnx_tag_time_modification;
-    m_NameToEnum["tuplet"] = k_mnx_tag_tuplet;
-//    m_NameToEnum["tuplet-actual"] = k_mnx_tag_tuplet_actual;
-//    m_NameToEnum["tuplet-normal"] = k_mnx_tag_tuplet_normal;
-//    m_NameToEnum["virtual-instrument"] = k_mnx_tag_virtual_instr;
-    m_NameToEnum["wedge"] = k_mnx_tag_wedge;
-//    m_NameToEnum["words"] = k_mnx_tag_words;
 }
 
 //---------------------------------------------------------------------------------------
 MnxAnalyser::~MnxAnalyser()
 {
     delete_relation_builders();
-    m_NameToEnum.clear();
     m_lyrics.clear();
     m_lyricIndex.clear();
 }
@@ -3553,15 +3554,57 @@ ImoObj* MnxAnalyser::analyse_tree(XmlNode* tree, const string& locator)
     return analyse_tree_and_get_object(tree);
 }
 
+//---------------------------------------------------------------------------------------
+// Helper for creating element analysers in the stack
+template <class T, class... Args>
+static bool analyse_with(XmlNode* pNode, Args&&... args)
+{
+    T analyser(std::forward<Args>(args)...);
+    return analyser.analyse_node(pNode);
+}
+
 //---------------------------------------------------------------------------------------
 bool MnxAnalyser::analyse_node(XmlNode* pNode, ImoObj* pAnchor)
 {
     //m_reporter << "DBG. Analysing node: " << pNode->name() << endl;
-    MnxElementAnalyser* a = new_analyser( pNode->name(), pAnchor );
     m_pResult = nullptr;
-    bool res = a->analyse_node(pNode);
-    delete a;
-    return res;
+    return analyse_node_as(pNode->name_c_str(), pNode, pAnchor);
+}
+
+//---------------------------------------------------------------------------------------
+bool MnxAnalyser::analyse_node_as(const char* name, XmlNode* pNode, ImoObj* pAnchor)
+{
+    //analyse the node with the analyser for element 'name'
+
+    switch ( name_to_enum(name) )
+    {
+        case k_mnx_tag_beamed:              return analyse_with<BeamedMnxAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mnx_tag_clef:                return analyse_with<ClefMnxAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mnx_tag_cwmnx:               return analyse_with<CwmnxMnxAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mnx_tag_directions:          return analyse_with<DirectionsMnxAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mnx_tag_dynamics:            return analyse_with<DynamicsMnxAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mnx_tag_event:               return analyse_with<EventMnxAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mnx_tag_expression:          return analyse_with<ExpressionMnxAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mnx_tag_global:              return analyse_with<GlobalMnxAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mnx_tag_head:                return analyse_with<HeadMnxAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mnx_tag_instrument_sound:    return analyse_with<InstrumentSoundMnxAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mnx_tag_key:                 return analyse_with<KeyMnxAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mnx_tag_measure:             return analyse_with<MeasureMnxAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mnx_tag_mnx:                 return analyse_with<MnxMnxAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mnx_tag_note:                return analyse_with<NoteMnxAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mnx_tag_part:                return analyse_with<PartMnxAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mnx_tag_part_name:           return analyse_with<PartNameMnxAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mnx_tag_rest:                return analyse_with<RestMnxAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mnx_tag_score:               return analyse_with<ScoreMnxAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mnx_tag_sequence:            return analyse_with<SequenceMnxAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mnx_tag_sequence_content:    return analyse_with<SequenceContentMnxAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mnx_tag_staff:               return analyse_with<StaffMnxAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mnx_tag_time:                return analyse_with<TimeMnxAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mnx_tag_tuplet:              return analyse_with<TupletMnxAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mnx_tag_wedge:               return analyse_with<WedgeMnxAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        default:
+            return analyse_with<NullMnxAnalyser>(pNode, this, m_reporter, m_libraryScope, name);
+    }
 }
 
 //---------------------------------------------------------------------------------------
@@ -3840,49 +3883,9 @@ bool MnxAnalyser::to_integer(const string& text, int* pResult)
 }
 
 //---------------------------------------------------------------------------------------
-MnxElementAnalyser* MnxAnalyser::new_analyser(const string& name, ImoObj* pAnchor)
+int MnxAnalyser::name_to_enum(const char* name) const
 {
-    //Factory method to create analysers
-
-    switch ( name_to_enum(name) )
-    {
-        case k_mnx_tag_beamed:              return LOMSE_NEW BeamedMnxAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mnx_tag_clef:                return LOMSE_NEW ClefMnxAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mnx_tag_cwmnx:               return LOMSE_NEW CwmnxMnxAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mnx_tag_directions:          return LOMSE_NEW DirectionsMnxAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mnx_tag_dynamics:            return LOMSE_NEW DynamicsMnxAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mnx_tag_event:               return LOMSE_NEW EventMnxAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mnx_tag_expression:          return LOMSE_NEW ExpressionMnxAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mnx_tag_global:              return LOMSE_NEW GlobalMnxAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mnx_tag_head:                return LOMSE_NEW HeadMnxAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mnx_tag_instrument_sound:    return LOMSE_NEW InstrumentSoundMnxAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mnx_tag_key:                 return LOMSE_NEW KeyMnxAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mnx_tag_measure:             return LOMSE_NEW MeasureMnxAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mnx_tag_mnx:                 return LOMSE_NEW MnxMnxAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mnx_tag_note:                return LOMSE_NEW NoteMnxAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mnx_tag_part:                return LOMSE_NEW PartMnxAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mnx_tag_part_name:           return LOMSE_NEW PartNameMnxAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mnx_tag_rest:                return LOMSE_NEW RestMnxAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mnx_tag_score:               return LOMSE_NEW ScoreMnxAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mnx_tag_sequence:            return LOMSE_NEW SequenceMnxAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mnx_tag_sequence_content:    return LOMSE_NEW SequenceContentMnxAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mnx_tag_staff:               return LOMSE_NEW StaffMnxAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mnx_tag_time:                return LOMSE_NEW TimeMnxAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mnx_tag_tuplet:              return LOMSE_NEW TupletMnxAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mnx_tag_wedge:               return LOMSE_NEW WedgeMnxAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        default:
-            return LOMSE_NEW NullMnxAnalyser(this, m_reporter, m_libraryScope, name);
-    }
-}
-
-//---------------------------------------------------------------------------------------
-int MnxAnalyser::name_to_enum(const string& name) const
-{
-	map<string, int>::const_iterator it = m_NameToEnum.find(name);
-	if (it != m_NameToEnum.end())
-		return it->second;
-    else
-        return k_mnx_tag_undefined;
+    return find_xml_tag(k_mnx_tags, name, k_mnx_tag_undefined);
 }
 
 //---------------------------------------------------------------------------------------
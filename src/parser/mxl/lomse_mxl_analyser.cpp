@@ -6940,6 +6940,72 @@ int mxl_type_of_repetion_mark(const string& value)
 }
 
 
+//---------------------------------------------------------------------------------------
+// Element names to tag values. Sorted by name, for binary search
+static const XmlTagName k_mxl_tags[] =
+{
+    { "accordion-registration", k_mxl_tag_accordion_registration },
+    { "articulations",          k_mxl_tag_articulations },
+    { "attributes",             k_mxl_tag_attributes },
+    { "backup",                 k_mxl_tag_backup },
+    { "barline",                k_mxl_tag_barline },
+    { "bracket",                k_mxl_tag_bracket },
+    { "clef",                   k_mxl_tag_clef },
+    { "coda",                   k_mxl_tag_coda },
+    { "damp",                   k_mxl_tag_damp },
+    { "damp-all",               k_mxl_tag_damp_all },
+    { "dashes",                 k_mxl_tag_dashes },
+    { "direction",              k_mxl_tag_direction },
+    { "direction-type",         k_mxl_tag_direction_type },
+    { "dynamics",               k_mxl_tag_dynamics },
+    { "ending",                 k_mxl_tag_ending },
+    { "eyeglasses",             k_mxl_tag_eyeglasses },
+    { "fermata",                k_mxl_tag_fermata },
+    { "forward",                k_mxl_tag_forward },
+    { "harp-pedals",            k_mxl_tag_harp_pedals },
+    { "image",                  k_mxl_tag_image },
+    { "key",                    k_mxl_tag_key },
+    { "lyric",                  k_mxl_tag_lyric },
+    { "measure",                k_mxl_tag_measure },
+    { "metronome",              k_mxl_tag_metronome },
+    { "midi-device",            k_mxl_tag_midi_device },
+    { "midi-instrument",        k_mxl_tag_midi_instrument },
+    { "notations",              k_mxl_tag_notations },
+    { "note",                   k_mxl_tag_note },
+    { "octave-shift",           k_mxl_tag_octave_shift },
+    { "ornaments",              k_mxl_tag_ornaments },
+    { "part",                   k_mxl_tag_part },
+    { "part-group",             k_mxl_tag_part_group },
+    { "part-list",              k_mxl_tag_part_list },
+    { "part-name",              k_mxl_tag_part_name },
+    { "pedal",                  k_mxl_tag_pedal },
+    { "percussion",             k_mxl_tag_percussion },
+    { "pitch",                  k_mxl_tag_pitch },
+    { "principal-voice",        k_mxl_tag_principal_voice },
+    { "print",                  k_mxl_tag_print },
+    { "rehearsal",              k_mxl_tag_rehearsal },
+    { "rest",                   k_mxl_tag_rest },
+    { "scordatura",             k_mxl_tag_scordatura },
+    { "score-instrument",       k_mxl_tag_score_instrument },
+    { "score-part",             k_mxl_tag_score_part },
+    { "score-partwise",         k_mxl_tag_score_partwise },
+    { "segno",                  k_mxl_tag_segno },
+    { "slur",                   k_mxl_tag_slur },
+    { "sound",                  k_mxl_tag_sound },
+    { "string-mute",            k_mxl_tag_string_mute },
+    { "technical",              k_mxl_tag_technical },
+    { "text",                   k_mxl_tag_text },
+    { "tied",                   k_mxl_tag_tied },
+    { "time",                   k_mxl_tag_time },
+    { "time-modification",      k_mxl_tag_time_modification },
+    { "tuplet",                 k_mxl_tag_tuplet },
+    { "tuplet-actual",          k_mxl_tag_tuplet_actual },
+    { "tuplet-normal",          k_mxl_tag_tuplet_normal },
+    { "virtual-instrument",     k_mxl_tag_virtual_instr },
+    { "wedge",                  k_mxl_tag_wedge },
+    { "words",                  k_mxl_tag_words },
+};
+
 //=======================================================================================
 // MxlAnalyser implementation
 //=======================================================================================
@@ -6977,74 +7043,12 @@ MxlAnalyser::MxlAnalyser(ostream& reporter, LibraryScope& libraryScope, Document
     , m_measuresCounter(0)
     , m_curVoice(0)
 {
-    //populate the name to enum conversion map
-    m_NameToEnum["accordion-registration"] = k_mxl_tag_accordion_registration;
-    m_NameToEnum["articulations"] = k_mxl_tag_articulations;
-    m_NameToEnum["attributes"] = k_mxl_tag_attributes;
-    m_NameToEnum["backup"] = k_mxl_tag_backup;
-    m_NameToEnum["barline"] = k_mxl_tag_barline;
-    m_NameToEnum["bracket"] = k_mxl_tag_bracket;
-    m_NameToEnum["clef"] = k_mxl_tag_clef;
-    m_NameToEnum["coda"] = k_mxl_tag_coda;
-    m_NameToEnum["damp"] = k_mxl_tag_damp;
-    m_NameToEnum["damp-all"] = k_mxl_tag_damp_all;
-    m_NameToEnum["dashes"] = k_mxl_tag_dashes;
-    m_NameToEnum["direction"] = k_mxl_tag_direction;
-    m_NameToEnum["direction-type"] = k_mxl_tag_direction_type;
-    m_NameToEnum["dynamics"] = k_mxl_tag_dynamics;
-    m_NameToEnum["ending"] = k_mxl_tag_ending;
-    m_NameToEnum["eyeglasses"] = k_mxl_tag_eyeglasses;
-    m_NameToEnum["fermata"] = k_mxl_tag_fermata;
-    m_NameToEnum["forward"] = k_mxl_tag_forward;
-    m_NameToEnum["harp-pedals"] = k_mxl_tag_harp_pedals;
-    m_NameToEnum["image"] = k_mxl_tag_image;
-    m_NameToEnum["key"] = k_mxl_tag_key;
-    m_NameToEnum["lyric"] = k_mxl_tag_lyric;
-    m_NameToEnum["measure"] = k_mxl_tag_measure;
-    m_NameToEnum["metronome"] = k_mxl_tag_metronome;
-    m_NameToEnum["midi-device"] = k_mxl_tag_midi_device;
-    m_NameToEnum["midi-instrument"] = k_mxl_tag_midi_instrument;
-    m_NameToEnum["notations"] = k_mxl_tag_notations;
-    m_NameToEnum["note"] = k_mxl_tag_note;
-    m_NameToEnum["octave-shift"] = k_mxl_tag_octave_shift;
-    m_NameToEnum["ornaments"] = k_mxl_tag_ornaments;
-    m_NameToEnum["part"] = k_mxl_tag_part;
-    m_NameToEnum["part-group"] = k_mxl_tag_part_group;
-    m_NameToEnum["part-list"] = k_mxl_tag_part_list;
-    m_NameToEnum["part-name"] = k_mxl_tag_part_name;
-    m_NameToEnum["pedal"] = k_mxl_tag_pedal;
-    m_NameToEnum["percussion"] = k_mxl_tag_percussion;
-    m_NameToEnum["pitch"] = k_mxl_tag_pitch;
-    m_NameToEnum["principal-voice"] = k_mxl_tag_principal_voice;
-    m_NameToEnum["print"] = k_mxl_tag_print;
-    m_NameToEnum["rehearsal"] = k_mxl_tag_rehearsal;
-    m_NameToEnum["rest"] = k_mxl_tag_rest;
-    m_NameToEnum["scordatura"] = k_mxl_tag_scordatura;
-    m_NameToEnum["score-instrument"] = k_mxl_tag_score_instrument;
-    m_NameToEnum["score-part"] = k_mxl_tag_score_part;
-    m_NameToEnum["score-partwise"] = k_mxl_tag_score_partwise;
-    m_NameToEnum["segno"] = k_mxl_tag_segno;
-    m_NameToEnum["slur"] = k_mxl_tag_slur;
-    m_NameToEnum["sound"] = k_mxl_tag_sound;
-    m_NameToEnum["string-mute"] = k_mxl_tag_string_mute;
-    m_NameToEnum["technical"] = k_mxl_tag_technical;
-    m_NameToEnum["text"] = k_mxl_tag_text;
-    m_NameToEnum["tied"] = k_mxl_tag_tied;
-    m_NameToEnum["time"] = k_mxl_tag_time;
-    m_NameToEnum["time-modification"] = k_mxl_tag_time_modification;
-    m_NameToEnum["tuplet"] = k_mxl_tag_tuplet;
-    m_NameToEnum["tuplet-actual"] = k_mxl_tag_tuplet_actual;
-    m_NameToEnum["tuplet-normal"] = k_mxl_tag_tuplet_normal;
-    m_NameToEnum["virtual-instrument"] = k_mxl_tag_virtual_instr;
-    m_NameToEnum["wedge"] = k_mxl_tag_wedge;
-    m_NameToEnum["words"] = k_mxl_tag_words;
 }
 
 //---------------------------------------------------------------------------------------
 MxlAnalyser::~MxlAnalyser()
 {
     delete_relation_builders();
-    m_NameToEnum.clear();
     m_lyrics.clear();
     m_lyricIndex.clear();
 }
@@ -7082,14 +7086,84 @@ ImoObj* MxlAnalyser::analyse_tree(XmlNode* tree, const string& locator)
     return analyse_tree_and_get_object(tree);
 }
 
+//---------------------------------------------------------------------------------------
+// Element analysers are short lived: create them in the stack. A separate function
+// keeps in the stack only the analysers of the elements being analysed.
+template <class T, class... Args>
+static ImoObj* analyse_with(XmlNode* pNode, Args&&... args)
+{
+    T analyser(std::forward<Args>(args)...);
+    return analyser.analyse_node(pNode);
+}
+
 //---------------------------------------------------------------------------------------
 ImoObj* MxlAnalyser::analyse_node(XmlNode* pNode, ImoObj* pAnchor)
 {
     //m_reporter << "DBG. Analysing node: " << pNode->name() << endl;
-    MxlElementAnalyser* a = new_analyser( pNode->name(), pAnchor );
-    ImoObj* pImo = a->analyse_node(pNode);
-    delete a;
-    return pImo;
+    switch ( name_to_enum(pNode->name_c_str()) )
+    {
+//        case k_mxl_tag_accordion_registration: return analyse_with<AccordionRegistrationMxlAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_articulations:        return analyse_with<ArticulationsMxlAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_attributes:           return analyse_with<AtribbutesMxlAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_backup:               return analyse_with<FwdBackMxlAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_barline:              return analyse_with<BarlineMxlAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+//        case k_mxl_tag_bracket:              return analyse_with<BracketMxlAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_clef:                 return analyse_with<ClefMxlAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_coda:                 return analyse_with<CodaMxlAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+//        case k_mxl_tag_damp:                 return analyse_with<DampMxlAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+//        case k_mxl_tag_damp_all:             return analyse_with<DampAllMxlAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+//        case k_mxl_tag_dashes:               return analyse_with<DashesMxlAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_direction:            return analyse_with<DirectionMxlAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_direction_type:       return analyse_with<DirectionTypeMxlAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_dynamics:             return analyse_with<DynamicsMxlAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_ending:               return analyse_with<EndingMxlAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+//        case k_mxl_tag_eyeglasses:           return analyse_with<EyeglassesMxlAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_fermata:              return analyse_with<FermataMxlAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_forward:              return analyse_with<FwdBackMxlAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+//        case k_mxl_tag_harp_pedals:          return analyse_with<HarpPedalsMxlAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+//        case k_mxl_tag_image:                return analyse_with<ImageMxlAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_key:                  return analyse_with<KeyMxlAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_lyric:                return analyse_with<LyricMxlAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_measure:              return analyse_with<MeasureMxlAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_metronome:            return analyse_with<MetronomeMxlAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_midi_device:          return analyse_with<MidiDeviceMxlAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_midi_instrument:      return analyse_with<MidiInstrumentMxlAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_notations:            return analyse_with<NotationsMxlAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_note:                 return analyse_with<NoteRestMxlAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+//        case k_mxl_tag_octave_shift:         return analyse_with<OctaveShiftMxlAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_ornaments:            return analyse_with<OrnamentsMxlAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_part:                 return analyse_with<PartMxlAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_part_group:           return analyse_with<PartGroupMxlAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_part_list:            return analyse_with<PartListMxlAnalyser>(pNode, this, m_reporter, m_libraryScope);
+        case k_mxl_tag_part_name:            return analyse_with<PartNameMxlAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+//        case k_mxl_tag_pedal:                return analyse_with<PedalMxlAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+//        case k_mxl_tag_percussion:           return analyse_with<PercussionMxlAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_pitch:                return analyse_with<PitchMxlAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+//        case k_mxl_tag_principal_voice:      return analyse_with<PrincipalVoiceMxlAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_print:                return analyse_with<PrintMxlAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+//        case k_mxl_tag_rehearsal:            return analyse_with<RehearsalMxlAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+//        case k_mxl_tag_scordatura:           return analyse_with<ScordaturaMxlAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_score_instrument:     return analyse_with<ScoreInstrumentMxlAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_score_part:           return analyse_with<ScorePartMxlAnalyser>(pNode, this, m_reporter, m_libraryScope);
+        case k_mxl_tag_score_partwise:       return analyse_with<ScorePartwiseMxlAnalyser>(pNode, this, m_reporter, m_libraryScope);
+        case k_mxl_tag_segno:                return analyse_with<SegnoMxlAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_slur:                 return analyse_with<SlurMxlAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_sound:                return analyse_with<SoundMxlAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+//        case k_mxl_tag_string_mute:          return analyse_with<StringMmuteMxlAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_technical:            return analyse_with<TecnicalMxlAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_text:                 return analyse_with<TextMxlAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_tied:                 return analyse_with<TiedMxlAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_time:                 return analyse_with<TimeMxlAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_time_modification:    return analyse_with<TimeModificationXmlAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_tuplet:               return analyse_with<TupletMxlAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_tuplet_actual:        return analyse_with<TupletNumbersMxlAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_tuplet_normal:        return analyse_with<TupletNumbersMxlAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_virtual_instr:        return analyse_with<VirtualInstrumentMxlAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+//        case k_mxl_tag_wedge:                return analyse_with<WedgeMxlAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_words:                return analyse_with<WordsMxlAnalyser>(pNode, this, m_reporter, m_libraryScope, pAnchor);
+        default:
+            return analyse_with<NullMxlAnalyser>(pNode, this, m_reporter, m_libraryScope, pNode->name());
+    }
 }
 
 //---------------------------------------------------------------------------------------
@@ -7407,84 +7481,9 @@ bool MxlAnalyser::to_integer(const string& text, int* pResult)
 }
 
 //---------------------------------------------------------------------------------------
-MxlElementAnalyser* MxlAnalyser::new_analyser(const string& name, ImoObj* pAnchor)
-{
-    //Factory method to create analysers
-
-    switch ( name_to_enum(name) )
-    {
-//        case k_mxl_tag_accordion_registration: return LOMSE_NEW AccordionRegistrationMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_articulations:        return LOMSE_NEW ArticulationsMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_attributes:           return LOMSE_NEW AtribbutesMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_backup:               return LOMSE_NEW FwdBackMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_barline:              return LOMSE_NEW BarlineMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_mxl_tag_bracket:              return LOMSE_NEW BracketMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_clef:                 return LOMSE_NEW ClefMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_coda:                 return LOMSE_NEW CodaMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_mxl_tag_damp:                 return LOMSE_NEW DampMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_mxl_tag_damp_all:             return LOMSE_NEW DampAllMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_mxl_tag_dashes:               return LOMSE_NEW DashesMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_direction:            return LOMSE_NEW DirectionMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_direction_type:       return LOMSE_NEW DirectionTypeMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_dynamics:             return LOMSE_NEW DynamicsMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_ending:               return LOMSE_NEW EndingMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_mxl_tag_eyeglasses:           return LOMSE_NEW EyeglassesMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_fermata:              return LOMSE_NEW FermataMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_forward:              return LOMSE_NEW FwdBackMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_mxl_tag_harp_pedals:          return LOMSE_NEW HarpPedalsMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_mxl_tag_image:                return LOMSE_NEW ImageMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_key:                  return LOMSE_NEW KeyMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_lyric:                return LOMSE_NEW LyricMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_measure:              return LOMSE_NEW MeasureMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_metronome:            return LOMSE_NEW MetronomeMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_midi_device:          return LOMSE_NEW MidiDeviceMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_midi_instrument:      return LOMSE_NEW MidiInstrumentMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_notations:            return LOMSE_NEW NotationsMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_note:                 return LOMSE_NEW NoteRestMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_mxl_tag_octave_shift:         return LOMSE_NEW OctaveShiftMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_ornaments:            return LOMSE_NEW OrnamentsMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_part:                 return LOMSE_NEW PartMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_part_group:           return LOMSE_NEW PartGroupMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_part_list:            return LOMSE_NEW PartListMxlAnalyser(this, m_reporter, m_libraryScope);
-        case k_mxl_tag_part_name:            return LOMSE_NEW PartNameMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_mxl_tag_pedal:                return LOMSE_NEW PedalMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_mxl_tag_percussion:           return LOMSE_NEW PercussionMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_pitch:                return LOMSE_NEW PitchMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_mxl_tag_principal_voice:      return LOMSE_NEW PrincipalVoiceMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_print:                return LOMSE_NEW PrintMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_mxl_tag_rehearsal:            return LOMSE_NEW RehearsalMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_mxl_tag_scordatura:           return LOMSE_NEW ScordaturaMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_score_instrument:     return LOMSE_NEW ScoreInstrumentMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_score_part:           return LOMSE_NEW ScorePartMxlAnalyser(this, m_reporter, m_libraryScope);
-        case k_mxl_tag_score_partwise:       return LOMSE_NEW ScorePartwiseMxlAnalyser(this, m_reporter, m_libraryScope);
-        case k_mxl_tag_segno:                return LOMSE_NEW SegnoMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_slur:                 return LOMSE_NEW SlurMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_sound:                return LOMSE_NEW SoundMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_mxl_tag_string_mute:          return LOMSE_NEW StringMmuteMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_technical:            return LOMSE_NEW TecnicalMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_text:                 return LOMSE_NEW TextMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_tied:                 return LOMSE_NEW TiedMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_time:                 return LOMSE_NEW TimeMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_time_modification:    return LOMSE_NEW TimeModificationXmlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_tuplet:               return LOMSE_NEW TupletMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_tuplet_actual:        return LOMSE_NEW TupletNumbersMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_tuplet_normal:        return LOMSE_NEW TupletNumbersMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_virtual_instr:        return LOMSE_NEW VirtualInstrumentMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_mxl_tag_wedge:                return LOMSE_NEW WedgeMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_words:                return LOMSE_NEW WordsMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        default:
-            return LOMSE_NEW NullMxlAnalyser(this, m_reporter, m_libraryScope, name);
-    }
-}
-
-//---------------------------------------------------------------------------------------
-int MxlAnalyser::name_to_enum(const string& name) const
+int MxlAnalyser::name_to_enum(const char* name) const
 {
-	map<string, int>::const_iterator it = m_NameToEnum.find(name);
-	if (it != m_NameToEnum.end())
-		return it->second;
-    else
-        return k_mxl_tag_undefined;
+    return find_xml_tag(k_mxl_tags, name, k_mxl_tag_undefined);
 }
 
 
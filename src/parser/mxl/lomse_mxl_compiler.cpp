@@ -90,11 +90,9 @@ ImoDocument* MxlCompiler::compile_file(const std::string& filename)
         InputStream* pFile = FileSystem::open_input_stream(m_fileLocator);
         ZipInputStream* zip  = static_cast<ZipInputStream*>(pFile);
 
-        unsigned char* buffer = zip->get_as_string();
-        m_pXmlParser->parse_cstring( (char *)buffer );
+        m_pXmlParser->parse_stream(zip, zip->get_size());
 
         delete pFile;
-        delete[] buffer;
 #else
 		throw runtime_error("Could not open compressed file: Lomse was compiled without compression support");
 #endif
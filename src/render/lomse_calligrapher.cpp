@@ -55,8 +55,8 @@ extern LUnits pt_to_LUnits(float pt);
 //---------------------------------------------------------------------------------------
 // Calligrapher implementation
 //---------------------------------------------------------------------------------------
-Calligrapher::Calligrapher(FontStorage* fonts, Renderer* renderer)
-    : m_pFonts(fonts)
+Calligrapher::Calligrapher(LibraryScope& libraryScope, Renderer* renderer)
+    : m_libraryScope(libraryScope)
     , m_pRenderer(renderer)
 {
 }
@@ -84,7 +84,8 @@ int Calligrapher::draw_text(double x, double y, const wstring& str, Color color,
 {
     //returns the number of chars drawn
 
-    if (!m_pFonts->is_font_valid())
+    FontStorage* pFonts = m_libraryScope.font_storage();
+    if (!pFonts->is_font_valid())
         return 0;
 
     set_scale(scale);
@@ -94,15 +95,15 @@ int Calligrapher::draw_text(double x, double y, const wstring& str, Color color,
     wstring::const_iterator it;
     for (it = str.begin(); it != str.end(); ++it)
     {
-        const lomse::glyph_cache* glyph = m_pFonts->get_glyph_cache(*it);
+        const lomse::glyph_cache* glyph = pFonts->get_glyph_cache(*it);
         if(glyph)
         {
-            m_pFonts->add_kerning(&x, &y);
-            m_pFonts->init_adaptors(glyph, x, y);
+            pFonts->add_kerning(&x, &y);
+            pFonts->init_adaptors(glyph, x, y);
 
             //render the glyph using method agg::glyph_ren_agg_gray8
-            m_pRenderer->render(m_pFonts->get_gray8_adaptor(),
-                                m_pFonts->get_gray8_scanline(),
+            m_pRenderer->render(pFonts->get_gray8_adaptor(),
+                                pFonts->get_gray8_scanline(),
                                 color);
 
             // increment pen position
@@ -126,18 +127,19 @@ void Calligrapher::draw_glyph(double x, double y, unsigned int ch, Color color)
 {
     //ch is the glyph (utf-32)
 
-   if (!m_pFonts->is_font_valid())
+    FontStorage* pFonts = m_libraryScope.font_storage();
+   if (!pFonts->is_font_valid())
         return;
 
-    const lomse::glyph_cache* glyph = m_pFonts->get_glyph_cache(ch);
+    const lomse::glyph_cache* glyph = pFonts->get_glyph_cache(ch);
     if(glyph)
     {
-        m_pFonts->add_kerning(&x, &y);
-        m_pFonts->init_adaptors(glyph, x, y);
+        pFonts->add_kerning(&x, &y);
+        pFonts->init_adaptors(glyph, x, y);
 
         //render the glyph using method agg::glyph_ren_agg_gray8
-        m_pRenderer->render(m_pFonts->get_gray8_adaptor(),
-                            m_pFonts->get_gray8_scanline(),
+        m_pRenderer->render(pFonts->get_gray8_adaptor(),
+                            pFonts->get_gray8_scanline(),
                             color);
     }
 }
@@ -145,12 +147,13 @@ void Calligrapher::draw_glyph(double x, double y, unsigned int ch, Color color)
 //---------------------------------------------------------------------------------------
 void Calligrapher::set_scale(double scale)
 {
-   if (!m_pFonts->is_font_valid())
+    FontStorage* pFonts = m_libraryScope.font_storage();
+   if (!pFonts->is_font_valid())
         return;
 
     agg::trans_affine mtx;
     mtx *= agg::trans_affine_scaling(scale);
-    m_pFonts->set_transform(mtx);
+    pFonts->set_transform(mtx);
 }
 
 
@@ -158,7 +161,7 @@ void Calligrapher::set_scale(double scale)
 // TextMeter implementation
 //---------------------------------------------------------------------------------------
 TextMeter::TextMeter(LibraryScope& libraryScope)
-    : m_pFonts( libraryScope.font_storage() )
+    : m_libraryScope(libraryScope)
     , m_scale( libraryScope.get_screen_ppi() / 2540.0 )
 {
 }
@@ -182,19 +185,20 @@ LUnits TextMeter::measure_width(const std::string& str)
 //---------------------------------------------------------------------------------------
 LUnits TextMeter::measure_width(const wstring& str)
 {
-   if (!m_pFonts->is_font_valid())
+    FontStorage* pFonts = m_libraryScope.font_storage();
+   if (!pFonts->is_font_valid())
         return 0.0f;
 
     set_transform();
 
     //loop to measure glyphs
     LUnits width = 0.0f;
+    GlyphMetrics metrics;
     wstring::const_iterator it;
     for (it = str.begin(); it != str.end(); ++it)
     {
-        const lomse::glyph_cache* glyph = m_pFonts->get_glyph_cache(*it);
-        if(glyph)
-            width += static_cast<LUnits>( glyph->advance_x );
+        if (pFonts->get_glyph_metrics(*it, &metrics))
+            width += static_cast<LUnits>( metrics.advance_x );
     }
     return width;
 }
@@ -202,7 +206,8 @@ LUnits TextMeter::measure_width(const wstring& str)
 //---------------------------------------------------------------------------------------
 void TextMeter::measure_glyphs(wstring* glyphs, std::vector<LUnits>& glyphWidths)
 {
-    if (!m_pFonts->is_font_valid())
+    FontStorage* pFonts = m_libraryScope.font_storage();
+    if (!pFonts->is_font_valid())
     {
         string msg("[TextMeter::measure_glyphs] Not valid font");
         LOMSE_LOG_ERROR(msg);
@@ -212,12 +217,12 @@ void TextMeter::measure_glyphs(wstring* glyphs, std::vector<LUnits>& glyphWidths
     set_transform();
 
     //loop to measure glyphs
+    GlyphMetrics metrics;
     wstring::iterator it;
     for (it = glyphs->begin(); it != glyphs->end(); ++it)
     {
-        const lomse::glyph_cache* glyph = m_pFonts->get_glyph_cache(*it);
-        if(glyph)
-            glyphWidths.push_back( static_cast<LUnits>( glyph->advance_x ) );
+        if (pFonts->get_glyph_metrics(*it, &metrics))
+            glyphWidths.push_back( static_cast<LUnits>( metrics.advance_x ) );
         else
             glyphWidths.push_back( 0.0f );
     }
@@ -226,55 +231,59 @@ void TextMeter::measure_glyphs(wstring* glyphs, std::vector<LUnits>& glyphWidths
 //---------------------------------------------------------------------------------------
 LUnits TextMeter::get_ascender()
 {
-    if (!m_pFonts->is_font_valid())
+    FontStorage* pFonts = m_libraryScope.font_storage();
+    if (!pFonts->is_font_valid())
         return 0.0f;
     else
-        return pt_to_LUnits( float(m_pFonts->get_ascender()) );
+        return pt_to_LUnits( float(pFonts->get_ascender()) );
 }
 
 //---------------------------------------------------------------------------------------
 LUnits TextMeter::get_descender()
 {
-    if (!m_pFonts->is_font_valid())
+    FontStorage* pFonts = m_libraryScope.font_storage();
+    if (!pFonts->is_font_valid())
         return 0.0f;
     else
-        return pt_to_LUnits( float(m_pFonts->get_descender()) );
+        return pt_to_LUnits( float(pFonts->get_descender()) );
 }
 
 //---------------------------------------------------------------------------------------
 LUnits TextMeter::get_font_height()
 {
-    if (!m_pFonts->is_font_valid())
+    FontStorage* pFonts = m_libraryScope.font_storage();
+    if (!pFonts->is_font_valid())
         return 0.0f;
     else
-        return pt_to_LUnits( float(m_pFonts->get_font_height_in_points()) );
+        return pt_to_LUnits( float(pFonts->get_font_height_in_points()) );
 }
 
 //---------------------------------------------------------------------------------------
 void TextMeter::set_transform()
 {
+    FontStorage* pFonts = m_libraryScope.font_storage();
     agg::trans_affine mtx;
     mtx *= agg::trans_affine_scaling(1.0 / m_scale);
-    m_pFonts->set_transform(mtx);
+    pFonts->set_transform(mtx);
 }
 
 //---------------------------------------------------------------------------------------
 URect TextMeter::bounding_rectangle(unsigned int ch)
 {
+    FontStorage* pFonts = m_libraryScope.font_storage();
     URect rect;
-    if (!m_pFonts->is_font_valid())
+    if (!pFonts->is_font_valid())
         return rect;
 
     //set_transform();
     agg::trans_affine mtx;
     mtx *= agg::trans_affine_scaling(1.0 / m_scale);
-    m_pFonts->set_transform(mtx);
+    pFonts->set_transform(mtx);
 
-    const lomse::glyph_cache* glyph = m_pFonts->get_glyph_cache(ch);
-    if(glyph)
+    GlyphMetrics metrics;
+    if (pFonts->get_glyph_metrics(ch, &metrics))
     {
-        //m_pFonts->init_adaptors(glyph, x, y);
-        agg::rect_i bbox = glyph->bounds;
+        agg::rect_i bbox = metrics.bounds;
 
         //bbox is a rectangle with integer values (type agg::rect_i)
         //(x1,y1) is left-top corner and (x2,y2) is right-bottom corner.
@@ -292,7 +301,8 @@ bool TextMeter::select_font(const std::string& language,
                             const std::string& fontName, double height,
                             bool fBold, bool fItalic)
 {
-    return m_pFonts->select_font(language, fontFile, fontName, height, fBold, fItalic);
+    FontStorage* pFonts = m_libraryScope.font_storage();
+    return pFonts->select_font(language, fontFile, fontName, height, fBold, fItalic);
 }
 
 //---------------------------------------------------------------------------------------
@@ -301,8 +311,9 @@ bool TextMeter::select_raster_font(const std::string& language,
                                    const std::string& fontName, double height,
                                    bool fBold, bool fItalic)
 {
-    return m_pFonts->select_raster_font(language, fontFile, fontName,
-                                         height, fBold, fItalic);
+    FontStorage* pFonts = m_libraryScope.font_storage();
+    return pFonts->select_raster_font(language, fontFile, fontName,
+                                       height, fBold, fItalic);
 }
 
 //---------------------------------------------------------------------------------------
@@ -311,8 +322,9 @@ bool TextMeter::select_vector_font(const std::string& language,
                                    const std::string& fontName, double height,
                                    bool fBold, bool fItalic)
 {
-    return m_pFonts->select_vector_font(language, fontFile, fontName,
-                                         height, fBold, fItalic);
+    FontStorage* pFonts = m_libraryScope.font_storage();
+    return pFonts->select_vector_font(language, fontFile, fontName,
+                                       height, fBold, fItalic);
 }
 
 
@@ -54,6 +54,12 @@ FontStorage::FontStorage(LibraryScope* pLibScope)
     : m_fontEngine(1000)        //1000 = number of faces in cache
     , m_fontCacheManager(m_fontEngine)
     , m_pLibScope(pLibScope)
+    , m_pMetricsStore(pLibScope->glyph_metrics_store())
+    , m_pMetrics(nullptr)
+    , m_pLocalMetrics(nullptr)
+    , m_metricsStamp(-1)
+    , m_fontFile()
+    , m_transform()
     , m_fontHeight(14.0)
     , m_fontWidth(14.0)
     , m_fHinting(false)
@@ -94,7 +100,17 @@ FontStorage::~FontStorage()
 bool FontStorage::set_font(const std::string& fontFullName, double height,
                            EFontCacheType type)
 {
+    //re-selecting the current font is frequent when measuring texts. Avoid the cost
+    //of rebuilding the font signature
+    if (m_fValidFont && fontFullName == m_fontFile
+        && height == m_fontHeight && height == m_fontWidth)
+    {
+        m_fontCacheType = type;
+        return false;
+    }
+
     m_fValidFont = false;
+    m_fontFile.clear();
     lomse::glyph_rendering gren = lomse::glyph_ren_agg_gray8;
     if(! m_fontEngine.select_font(fontFullName, 0, gren))
         return !m_fValidFont;    //error
@@ -110,10 +126,50 @@ bool FontStorage::set_font(const std::string& fontFullName, double height,
     //////mtx *= agg::trans_affine_translation(1, 0);
     ////m_fontEngine.transform(mtx);
 
+    m_fontFile = fontFullName;
     m_fValidFont = true;
     return !m_fValidFont;
 }
 
+//---------------------------------------------------------------------------------------
+bool FontStorage::get_glyph_metrics(unsigned int nChar, GlyphMetrics* pMetrics)
+{
+    //Returns false if the glyph is not available in current font
+
+    if (m_metricsStamp != m_fontEngine.change_stamp())
+    {
+        m_pMetrics = m_pMetricsStore->get_table(m_fontEngine.font_signature());
+        m_pLocalMetrics = &m_localMetrics[m_pMetrics];
+        m_metricsStamp = m_fontEngine.change_stamp();
+    }
+
+    //glyphs already used in this thread are found without locking
+    std::unordered_map<unsigned int, GlyphMetrics>::const_iterator it
+        = m_pLocalMetrics->find(nChar);
+    if (it != m_pLocalMetrics->end())
+    {
+        *pMetrics = it->second;
+        return true;
+    }
+
+    if (m_pMetrics->find(nChar, pMetrics))
+    {
+        (*m_pLocalMetrics)[nChar] = *pMetrics;
+        return true;
+    }
+
+    const lomse::glyph_cache* glyph = m_fontCacheManager.glyph(nChar);
+    if (!glyph)
+        return false;
+
+    pMetrics->advance_x = glyph->advance_x;
+    pMetrics->advance_y = glyph->advance_y;
+    pMetrics->bounds = glyph->bounds;
+    m_pMetrics->add(nChar, *pMetrics);
+    (*m_pLocalMetrics)[nChar] = *pMetrics;
+    return true;
+}
+
 //---------------------------------------------------------------------------------------
 void FontStorage::set_font_size(double rPoints)
 {
@@ -172,6 +228,55 @@ bool FontStorage::select_vector_font(const std::string& language,
 
 
 
+//=======================================================================================
+// GlyphMetricsTable implementation
+//=======================================================================================
+bool GlyphMetricsTable::find(unsigned int nChar, GlyphMetrics* pMetrics)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::unordered_map<unsigned int, GlyphMetrics>::const_iterator it
+        = m_glyphs.find(nChar);
+    if (it == m_glyphs.end())
+        return false;
+
+    *pMetrics = it->second;
+    return true;
+}
+
+//---------------------------------------------------------------------------------------
+void GlyphMetricsTable::add(unsigned int nChar, const GlyphMetrics& metrics)
+{
+    //if another thread added it first, the values are the same. Keep the existing ones
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_glyphs.insert( std::make_pair(nChar, metrics) );
+}
+
+
+//=======================================================================================
+// GlyphMetricsStore implementation
+//=======================================================================================
+GlyphMetricsStore::~GlyphMetricsStore()
+{
+    std::map<std::string, GlyphMetricsTable*>::iterator it;
+    for (it = m_tables.begin(); it != m_tables.end(); ++it)
+        delete it->second;
+}
+
+//---------------------------------------------------------------------------------------
+GlyphMetricsTable* GlyphMetricsStore::get_table(const char* fontSignature)
+{
+    std::string signature(fontSignature ? fontSignature : "");
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::map<std::string, GlyphMetricsTable*>::iterator it = m_tables.find(signature);
+    if (it != m_tables.end())
+        return it->second;
+
+    GlyphMetricsTable* pTable = LOMSE_NEW GlyphMetricsTable();
+    m_tables[signature] = pTable;
+    return pTable;
+}
+
 
 //=======================================================================================
 // FontSelector implementation
@@ -153,6 +153,7 @@ Renderer::Renderer(double ppi, AttrStorage& attr_storage, PathStorage& path)
     , m_uyShift(0.0)
     , m_vxOrg(0.0)
     , m_vyOrg(0.0)
+    , m_numThreads(1)
 
     , m_transform()
     , m_mtx()
@@ -218,5 +219,25 @@ void Renderer::reset()
     m_attr_storage.remove_all();
 }
 
+//---------------------------------------------------------------------------------------
+int Renderer::determine_number_of_bands(int height)
+{
+    //Bands smaller than this are not worth a thread
+    const int k_min_band_height = 64;     //pixels
+
+    int numThreads = m_numThreads;
+    if (numThreads == 0)
+        numThreads = int(std::thread::hardware_concurrency());
+
+    return min(numThreads, height / k_min_band_height);
+}
+
+
+//---------------------------------------------------------------------------------------
+// BandClipper
+//---------------------------------------------------------------------------------------
+thread_local int BandClipper::m_bandY1 = 0;
+thread_local int BandClipper::m_bandY2 = 0;
+
 
 }  //namespace lomse
@@ -508,7 +508,6 @@ template<class Source> struct LineCapsConverter
 Drawer::Drawer(LibraryScope& libraryScope)
     : m_libraryScope(libraryScope)
 {
-    m_pFonts = libraryScope.font_storage();
 }
 
 //---------------------------------------------------------------------------------------
@@ -526,9 +525,10 @@ ScreenDrawer::ScreenDrawer(LibraryScope& libraryScope)
     : Drawer(libraryScope)
     , m_pRenderer( RendererFactory::create_renderer(libraryScope, m_attr_storage, m_path) )
     , m_pTextMeter(nullptr)
-    , m_pCalligrapher( LOMSE_NEW Calligrapher(m_pFonts, m_pRenderer) )
+    , m_pCalligrapher( LOMSE_NEW Calligrapher(libraryScope, m_pRenderer) )
     , m_numPaths(0)
 {
+    m_pRenderer->set_rendering_threads( libraryScope.get_rendering_threads() );
 }
 
 //---------------------------------------------------------------------------------------
@@ -561,8 +561,10 @@ void ScreenDrawer::delete_paths()
 //---------------------------------------------------------------------------------------
 void ScreenDrawer::begin_path()
 {
+    //each path starts with default attributes. Otherwise, the result would depend
+    //on the previous drawn shape, that might have been culled
     unsigned idx = m_path.start_new_path();
-    m_attr_storage.add( m_numPaths==0 ? PathAttributes(idx) : PathAttributes(cur_attr(), idx) );
+    m_attr_storage.add( PathAttributes(idx) );
     m_numPaths++;
 }
 
@@ -817,7 +819,8 @@ bool ScreenDrawer::select_font(const std::string& language,
                                const std::string& fontName, double height,
                                bool fBold, bool fItalic)
 {
-    return m_pFonts->select_font(language, fontFile, fontName, height, fBold, fItalic);
+    FontStorage* pFonts = m_libraryScope.font_storage();
+    return pFonts->select_font(language, fontFile, fontName, height, fBold, fItalic);
 }
 
 //---------------------------------------------------------------------------------------
@@ -826,8 +829,9 @@ bool ScreenDrawer::select_raster_font(const std::string& language,
                                       const std::string& fontName, double height,
                                       bool fBold, bool fItalic)
 {
-    return m_pFonts->select_raster_font(language, fontFile, fontName,
-                                         height, fBold, fItalic);
+    FontStorage* pFonts = m_libraryScope.font_storage();
+    return pFonts->select_raster_font(language, fontFile, fontName,
+                                       height, fBold, fItalic);
 }
 
 //---------------------------------------------------------------------------------------
@@ -836,8 +840,9 @@ bool ScreenDrawer::select_vector_font(const std::string& language,
                                       const std::string& fontName, double height,
                                       bool fBold, bool fItalic)
 {
-    return m_pFonts->select_vector_font(language, fontFile, fontName,
-                                         height, fBold, fItalic);
+    FontStorage* pFonts = m_libraryScope.font_storage();
+    return pFonts->select_vector_font(language, fontFile, fontName,
+                                       height, fBold, fItalic);
 }
 
 //---------------------------------------------------------------------------------------
@@ -998,6 +1003,12 @@ Pixels ScreenDrawer::LUnits_to_Pixels(double value)
     return Pixels( value * mtx.scale() );
 }
 
+//---------------------------------------------------------------------------------------
+unsigned ScreenDrawer::bytes_per_pixel()
+{
+    return m_pRenderer->bytes_per_pixel();
+}
+
 //---------------------------------------------------------------------------------------
 void ScreenDrawer::reset(RenderingBuffer& buf, Color bgcolor)
 {
@@ -0,0 +1,132 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the Lomse library.
+// Lomse is copyrighted work (c) 2010-2016. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice, this
+//      list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright notice, this
+//      list of conditions and the following disclaimer in the documentation and/or
+//      other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+// TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+// BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+// ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+// For any comment, suggestion or feature request, please contact the manager of
+// the project at cecilios@users.sourceforge.net
+//---------------------------------------------------------------------------------------
+
+#include "lomse_tiles_cache.h"
+
+namespace lomse
+{
+
+//=======================================================================================
+// TilesCache implementation
+//=======================================================================================
+TilesCache::TilesCache(size_t maxBytes, int tileSize)
+    : m_tileSize(tileSize)
+    , m_maxBytes(maxBytes)
+    , m_usedBytes(0)
+{
+}
+
+//---------------------------------------------------------------------------------------
+TilesCache::~TilesCache()
+{
+    clear();
+}
+
+//---------------------------------------------------------------------------------------
+void TilesCache::clear()
+{
+    list<Tile*>::iterator it;
+    for (it = m_tiles.begin(); it != m_tiles.end(); ++it)
+        delete *it;
+    m_tiles.clear();
+    m_index.clear();
+    m_usedBytes = 0;
+}
+
+//---------------------------------------------------------------------------------------
+void TilesCache::set_context(const TilesContext& context)
+{
+    if (context != m_context)
+    {
+        clear();
+        m_context = context;
+    }
+}
+
+//---------------------------------------------------------------------------------------
+RenderingBuffer* TilesCache::get_tile(int col, int row)
+{
+    map<pair<int, int>, list<Tile*>::iterator>::iterator it =
+        m_index.find( make_pair(col, row) );
+    if (it == m_index.end())
+        return nullptr;
+
+    //move it to front, as most recently used
+    m_tiles.splice(m_tiles.begin(), m_tiles, it->second);
+    return &(m_tiles.front()->rbuf);
+}
+
+//---------------------------------------------------------------------------------------
+RenderingBuffer* TilesCache::add_tile(int col, int row, unsigned bytesPerPixel)
+{
+    //Returns a new tile, not yet rasterized. Any previous tile (col, row) is replaced.
+    //AWARE: the returned tile could be discarded when adding another tile.
+
+    map<pair<int, int>, list<Tile*>::iterator>::iterator it =
+        m_index.find( make_pair(col, row) );
+    if (it != m_index.end())
+    {
+        Tile* pOld = *(it->second);
+        m_usedBytes -= pOld->bytes.size();
+        m_tiles.erase(it->second);
+        m_index.erase(it);
+        delete pOld;
+    }
+
+    //AWARE: the renderer does not paint the last row and column of the buffer. Thus,
+    //the buffer for the tile has an additional row and column, not used.
+    unsigned size = unsigned(m_tileSize + 1);
+    size_t bytes = size_t(size) * size_t(size) * bytesPerPixel;
+    while (!m_tiles.empty() && m_usedBytes + bytes > m_maxBytes)
+        discard_least_recently_used();
+
+    Tile* pTile = LOMSE_NEW Tile();
+    pTile->col = col;
+    pTile->row = row;
+    pTile->bytes.resize(bytes);
+    pTile->rbuf.attach(&pTile->bytes[0], size, size, int(size * bytesPerPixel));
+
+    m_tiles.push_front(pTile);
+    m_index[make_pair(col, row)] = m_tiles.begin();
+    m_usedBytes += bytes;
+    return &(pTile->rbuf);
+}
+
+//---------------------------------------------------------------------------------------
+void TilesCache::discard_least_recently_used()
+{
+    Tile* pTile = m_tiles.back();
+    m_index.erase( make_pair(pTile->col, pTile->row) );
+    m_usedBytes -= pTile->bytes.size();
+    m_tiles.pop_back();
+    delete pTile;
+}
+
+
+}  //namespace lomse
@@ -49,7 +49,8 @@ namespace lomse
 //
 //    There are two tables to maintain:
 //    - m_events (std::vector<SoundEvent*>):
-//        Contains the MIDI events.
+//        Contains the MIDI events. The events are not individually allocated: they
+//        are stored, by value, in m_storage and m_events is just an index over it.
 //    - m_measures (std::vector<int>):
 //        Contains the index over m_events for the first event of each measure.
 //
@@ -85,10 +86,29 @@ SoundEventsTable::~SoundEventsTable()
 //---------------------------------------------------------------------------------------
 void SoundEventsTable::delete_events_table()
 {
-    std::vector<SoundEvent*>::iterator it;
-    for (it = m_events.begin(); it != m_events.end(); ++it)
-        delete *it;
     m_events.clear();
+    m_storage.clear();
+}
+
+//---------------------------------------------------------------------------------------
+void SoundEventsTable::reserve_events_space()
+{
+    //Each note generates four events (sound on/off, visual on/off) and each rest two.
+    //Other staffobjs generate, at most, one. Add one prog_instr event per instrument
+    //and the final end_of_score event.
+    ColStaffObjs* pColStaffObjs = m_pScore->get_staffobjs_table();
+    int numEntries = (pColStaffObjs ? pColStaffObjs->num_entries() : 0);
+    size_t space = size_t(4 * numEntries + m_pScore->get_num_instruments() + 1);
+    m_storage.reserve(space);
+    m_events.reserve(space);
+}
+
+//---------------------------------------------------------------------------------------
+void SoundEventsTable::rebuild_events_index()
+{
+    m_events.resize(m_storage.size());
+    for (size_t i=0; i < m_storage.size(); ++i)
+        m_events[i] = &m_storage[i];
 }
 
 //---------------------------------------------------------------------------------------
@@ -108,6 +128,7 @@ void SoundEventsTable::program_sounds_for_instruments()
 {
 	int numInstruments = m_pScore->get_num_instruments();
     m_channels.resize(numInstruments);
+    reserve_events_space();
 
     for (int iInstr = 0; iInstr < numInstruments; iInstr++)
     {
@@ -340,17 +361,30 @@ void SoundEventsTable::store_event(TimeUnits rTime, int eventType, int channel,
                                    MidiPitch pitch, int volume, int step,
                                    ImoStaffObj* pSO, int measure)
 {
-    SoundEvent* pEvent = LOMSE_NEW SoundEvent(rTime, eventType, channel, pitch,
-                                              volume, step, pSO, measure);
-    m_events.push_back(pEvent);
+    SoundEvent* pOldStorage = m_storage.data();
+    m_storage.push_back( SoundEvent(rTime, eventType, channel, pitch,
+                                    volume, step, pSO, measure) );
+
+    //if storage was reallocated the index is no longer valid
+    if (m_storage.data() != pOldStorage)
+        rebuild_events_index();
+    else
+        m_events.push_back(&m_storage.back());
+
     m_numMeasures = max(m_numMeasures, measure);
 }
 
 //---------------------------------------------------------------------------------------
 void SoundEventsTable::store_jump_event(TimeUnits rTime, JumpEntry* pJump, int measure)
 {
-    SoundEvent* pEvent = LOMSE_NEW SoundEvent(rTime, SoundEvent::k_jump, pJump, measure);
-    m_events.push_back(pEvent);
+    SoundEvent* pOldStorage = m_storage.data();
+    m_storage.push_back( SoundEvent(rTime, SoundEvent::k_jump, pJump, measure) );
+
+    if (m_storage.data() != pOldStorage)
+        rebuild_events_index();
+    else
+        m_events.push_back(&m_storage.back());
+
     m_numMeasures = max(m_numMeasures, measure);
 }
 
@@ -477,39 +511,25 @@ void SoundEventsTable::create_measures_table()
 //---------------------------------------------------------------------------------------
 void SoundEventsTable::sort_by_time()
 {
-    // Sort events by time, measure and event type. Uses the bubble sort algorithm
-
-    int j, k;
-    bool fChanges;
-    int nNumElements = int(m_events.size());
-    SoundEvent* pEvAux;
-
-    for (int i = 0; i < nNumElements; i++)
-    {
-        fChanges = false;
-        j = nNumElements - 1;
+    // Sort events by time, measure and event type. The sort is stable, so events
+    // with the same key keep their creation order. The end of score event is
+    // always the last one, although it is marked as belonging to measure 0.
 
-        while ( j != i )
+    std::stable_sort(m_storage.begin(), m_storage.end(),
+        [](const SoundEvent& a, const SoundEvent& b)
         {
-            k = j - 1;
-            if ((m_events[j]->DeltaTime < m_events[k]->DeltaTime) ||
-                ((m_events[j]->DeltaTime == m_events[k]->DeltaTime) &&
-                 ((m_events[j]->Measure < m_events[k]->Measure) ||
-                  (m_events[j]->EventType < m_events[k]->EventType))))
-            {
-                //interchange elements
-                pEvAux = m_events[j];
-                m_events[j] = m_events[k];
-                m_events[k] = pEvAux;
-                fChanges = true;
-            }
-            j = k;
-        }
-
-        //If there were no changes in this loop step it implies that the table is ordered;
-        //in this case exit loop to save time
-        if (!fChanges) break;
-    }
+            if (a.DeltaTime != b.DeltaTime)
+                return a.DeltaTime < b.DeltaTime;
+            bool fEndA = (a.EventType == SoundEvent::k_end_of_score);
+            bool fEndB = (b.EventType == SoundEvent::k_end_of_score);
+            if (fEndA != fEndB)
+                return fEndB;
+            if (a.Measure != b.Measure)
+                return a.Measure < b.Measure;
+            return a.EventType < b.EventType;
+        });
+
+    rebuild_events_index();
 }
 
 //---------------------------------------------------------------------------------------
@@ -34,13 +34,14 @@
 #include "lomse_internal_model.h"
 #include "lomse_injectors.h"
 #include "lomse_events.h"
+#include "lomse_events_dispatcher.h"
 #include "lomse_interactor.h"
 #include "lomse_player_gui.h"
 #include "lomse_metronome.h"
 #include "lomse_logger.h"
 
 #include <algorithm>    //max(), min()
-#include <ctime>        //clock()
+#include <cmath>        //sqrt()
 
 
 namespace lomse
@@ -347,7 +348,7 @@ void ScorePlayer::do_play(int nEvStart, int nEvEnd, bool fVisualTracking,
     //-----------------------------------------------------------------------------------
 
     //declaration of some time related variables.
-    long nEvTime;           //time (millisecs) for next event, metronome or from table
+    double nEvTime;         //time (millisecs) for next event, metronome or from table
     long nMtrEvDeltaTime;   //time (Time Units) for next metronome click
 
     // get metronome interval duration, in milliseconds
@@ -381,7 +382,7 @@ void ScorePlayer::do_play(int nEvStart, int nEvEnd, bool fVisualTracking,
     m_nCurNumPulses = 4;                    //assume 4/4 time signature
     m_nPrevNumPulses = m_nCurNumPulses;
 
-    m_conversionFactor = float(m_nCurMtrIntval) / float(m_nMtrPulseDuration);
+    m_conversionFactor = double(m_nCurMtrIntval) / double(m_nMtrPulseDuration);
 //    LOMSE_LOG_DEBUG(Logger::k_score_player,
 //                    "initial settings: nCurMeasureDuration=%ld, nCurMtrIntval=%ld"
 //                    "conversionFactor=%f",
@@ -439,7 +440,7 @@ void ScorePlayer::do_play(int nEvStart, int nEvEnd, bool fVisualTracking,
     //Define and initialize time counter (real time, in millisecs). If playback
     //starts not at the beginning but in another measure, advance time counter to that
     //measure
-    long curTime = 0L;
+    double curTime = 0.0;
 	if (nEvStart > 1)
 		curTime = time_units_to_milliseconds( events[nEvStart]->DeltaTime );
 
@@ -525,18 +526,22 @@ void ScorePlayer::do_play(int nEvStart, int nEvEnd, bool fVisualTracking,
         if (numPulses < 2)
             numPulses += m_nCurNumPulses;
 
-        //generate the pulses
+        //generate the pulses. Count off clicks are scheduled backwards from
+        //curTime, so that the final click takes place exactly at curTime
+        double clickTime = curTime - double((numPulses - 1) * m_nCurMtrIntval);
+        m_scheduler.start(clickTime);
         for (int j=numPulses; j > 1; --j)
         {
             //generate click
+            m_scheduler.wait_until(clickTime);
             m_pMidi->note_on(m_MtrChannel, m_MtrTone2, 127);
-            std::chrono::milliseconds waitTime(m_nCurMtrIntval/2L);
-            std::this_thread::sleep_for(waitTime);
+            m_scheduler.wait_until(clickTime + double(m_nCurMtrIntval) / 2.0);
             m_pMidi->note_off(m_MtrChannel, m_MtrTone2, 127);
-            std::this_thread::sleep_for(waitTime);
+            clickTime += double(m_nCurMtrIntval);
         }
 
         //generate final metronome click before real events
+        m_scheduler.wait_until(curTime);
         m_pMidi->note_on(m_MtrChannel, m_MtrTone1, 127);
 
         fSendMtrOff = true;
@@ -546,6 +551,8 @@ void ScorePlayer::do_play(int nEvStart, int nEvEnd, bool fVisualTracking,
 //        LOMSE_LOG_DEBUG(Logger::k_score_player,
 //                        "end of count-off: nMtrEvDeltaTime=%ld", nMtrEvDeltaTime);
     }
+    else
+        m_scheduler.start(curTime);
 
     //loop to process events
     do
@@ -564,31 +571,20 @@ void ScorePlayer::do_play(int nEvStart, int nEvEnd, bool fVisualTracking,
             if (curTime < nEvTime)
             {
                 //flush pending events
-                long elapsed = 0L;
                 if (fVisualTracking && pEvent->get_num_items() > 0)
                 {
-                    clock_t t1=clock();
-                    if (m_fPostEvents)
-                        m_libScope.post_event(pEvent);
-                    else if (pInteractor)
-                        pInteractor->handle_event(pEvent);
+                    send_event(pEvent, pInteractor);
                     pEvent = SpEventVisualTracking(
                                 LOMSE_NEW EventVisualTracking(wpInteractor,
                                                               m_pScore->get_id()) );
-                    clock_t t2=clock();
-                    elapsed = long( ((t2-t1)*1000.0)/double(CLOCKS_PER_SEC));
                 }
 
-                //wait for current time
-                long waitT = nEvTime - curTime - elapsed;
-                if (waitT > 0L)
-                {
-                    std::chrono::milliseconds waitTime(waitT);
-                    std::this_thread::sleep_for(waitTime);
-                }
+                //wait for current time. Deadline is absolute, so the time spent
+                //in flushing events is automatically discounted
+                m_scheduler.wait_until(nEvTime);
                 curTime = nEvTime;
-//                LOMSE_LOG_DEBUG(Logger::k_score_player, "flush pending events: waitT=%ld, new curTime=%ld",
-//                                waitT, curTime);
+//                LOMSE_LOG_DEBUG(Logger::k_score_player, "flush pending events: new curTime=%f",
+//                                curTime);
             }
 
             if (fSendMtrOff)
@@ -645,30 +641,18 @@ void ScorePlayer::do_play(int nEvStart, int nEvEnd, bool fVisualTracking,
             if (nEvTime > curTime)
             {
                 //flush accumulated events for curTime
-                long elapsed = 0L;
                 if (fVisualTracking && pEvent->get_num_items() > 0)
                 {
 //                    LOMSE_LOG_DEBUG(Logger::k_events | Logger::k_score_player,
 //                                    "Flush pending events");
-                    clock_t t1=clock();
-                    if (m_fPostEvents)
-                        m_libScope.post_event(pEvent);
-                    else if (pInteractor)
-                        pInteractor->handle_event(pEvent);
+                    send_event(pEvent, pInteractor);
                     pEvent = SpEventVisualTracking(
                                 LOMSE_NEW EventVisualTracking(wpInteractor,
                                                               m_pScore->get_id()) );
-                    clock_t t2=clock();
-                    elapsed = long( ((t2-t1)*1000.0)/double(CLOCKS_PER_SEC));
                 }
 
                 //wait until new time arrives
-                long waitT = nEvTime - curTime - elapsed;
-                if (waitT > 0L)
-                {
-                    std::chrono::milliseconds waitTime(waitT);
-                    std::this_thread::sleep_for(waitTime);
-                }
+                m_scheduler.wait_until(nEvTime);
             }
 
             //if it is a jump event, execute the jump if applicable
@@ -682,7 +666,9 @@ void ScorePlayer::do_play(int nEvStart, int nEvEnd, bool fVisualTracking,
                         || pJump->get_times_valid() > pJump->get_executed())
                     {
                         i = pJump->get_event();
+                        double jumpTime = max(curTime, nEvTime);
                         nEvTime = time_units_to_milliseconds( events[i]->DeltaTime );
+                        m_scheduler.rebase(jumpTime, nEvTime);
                         curTime = nEvTime;
                         nMtrEvDeltaTime = events[i]->DeltaTime;
                         if (pJump->get_times_valid() > pJump->get_executed())
@@ -837,14 +823,19 @@ void ScorePlayer::do_play(int nEvStart, int nEvEnd, bool fVisualTracking,
             LOMSE_LOG_DEBUG(Logger::k_score_player, "Going to finish 1");
             break;
         }
-        while(m_fPaused)
+        if (m_fPaused)
         {
-            std::this_thread::sleep_for( std::chrono::milliseconds(200) );
-            if (m_fShouldStop)
+            m_scheduler.suspend();
+            while(m_fPaused)
             {
-                LOMSE_LOG_DEBUG(Logger::k_score_player, "Going to finish 2");
-                break;
+                std::this_thread::sleep_for( std::chrono::milliseconds(200) );
+                if (m_fShouldStop)
+                {
+                    LOMSE_LOG_DEBUG(Logger::k_score_player, "Going to finish 2");
+                    break;
+                }
             }
+            m_scheduler.resume();
         }
 
         //update metronome information, just in case metronome was updated
@@ -854,11 +845,14 @@ void ScorePlayer::do_play(int nEvStart, int nEvEnd, bool fVisualTracking,
             if (m_prevGuiBpm != curGuiBpm)
             {
                 long newMtrClickIntval = 60000L / curGuiBpm;
-                float factor = float(newMtrClickIntval) / float(m_nCurMtrIntval);
+                double factor = double(newMtrClickIntval) / double(m_nCurMtrIntval);
                 m_conversionFactor *= factor;
-                m_nPrevMtrIntval = long( float(m_nPrevMtrIntval) * factor);
+                m_nPrevMtrIntval = long( double(m_nPrevMtrIntval) * factor);
                 m_nCurMtrIntval = newMtrClickIntval;
-                curTime = time_units_to_milliseconds( events[i-1]->DeltaTime );
+                //all score times are scaled. Keep current position at current
+                //wall time
+                m_scheduler.rebase(curTime, curTime * factor);
+                curTime *= factor;
                 m_prevGuiBpm = curGuiBpm;
             }
         }
@@ -870,6 +864,16 @@ void ScorePlayer::do_play(int nEvStart, int nEvEnd, bool fVisualTracking,
     // 690 without sending last event. It is not important as next event will remove all
     // highlight but should be studied and decided. Can be sent here.
 
+    #if (LOMSE_ENABLE_DEBUG_LOGS == 1)
+    {
+        PlaybackTimingStats stats = m_scheduler.get_stats();
+        LOMSE_LOG_DEBUG(Logger::k_score_player,
+                        "Timing: events=%ld, late=%ld, mean=%.1f us, max=%.1f us, jitter=%.1f us",
+                        stats.numEvents, stats.numLateEvents, stats.meanLateness,
+                        stats.maxLateness, stats.jitter);
+    }
+    #endif
+
     //ensure that all visual highlight is removed
     if (fVisualTracking && !m_fQuit)
     {
@@ -879,10 +883,7 @@ void ScorePlayer::do_play(int nEvStart, int nEvEnd, bool fVisualTracking,
         pEvent->add_item(EventVisualTracking::k_end_of_visual_tracking, k_no_imoid);
         //LOMSE_LOG_DEBUG(Logger::k_events | Logger::k_score_player,
         //                "Flush pending events");
-        if (m_fPostEvents)
-            m_libScope.post_event(pEvent);
-        else if (pInteractor)
-            pInteractor->handle_event(pEvent);
+        send_event(pEvent, pInteractor);
     }
     LOMSE_LOG_DEBUG(Logger::k_score_player, "<< Exit");
 }
@@ -908,10 +909,7 @@ void ScorePlayer::end_of_playback_housekeeping(bool fVisualTracking,
         SpEventVisualTracking pEvent(
             LOMSE_NEW EventVisualTracking(wpInteractor, m_pScore->get_id()) );
         pEvent->add_item(EventVisualTracking::k_end_of_visual_tracking, k_no_imoid);
-        if (m_fPostEvents)
-            m_libScope.post_event(pEvent);
-        else if (pInteractor)
-            pInteractor->handle_event(pEvent);
+        send_event(pEvent, pInteractor);
     }
 
     //ensure that all sounds are off
@@ -951,14 +949,23 @@ void ScorePlayer::end_of_playback_housekeeping(bool fVisualTracking,
         SpEventEndOfPlayback event(
             LOMSE_NEW EventEndOfPlayback(k_end_of_playback_event, wpInteractor,
                                          m_pScore, m_pPlayerGui) );
-        if (m_fPostEvents)
-            m_libScope.post_event(event);
-        else if (pInteractor)
-            pInteractor->handle_event(event);
+        send_event(event, pInteractor);
     }
     LOMSE_LOG_DEBUG(Logger::k_score_player, "<< Exit");
 }
 
+//---------------------------------------------------------------------------------------
+void ScorePlayer::send_event(SpEventInfo pEvent, Interactor* pInteractor)
+{
+    //When posting, events go through the events dispatcher. If it is running its
+    //own thread, the playback thread is not blocked by the application handler.
+
+    if (m_fPostEvents)
+        m_libScope.get_events_dispatcher()->post_event(pEvent);
+    else if (pInteractor)
+        pInteractor->handle_event(pEvent);
+}
+
 //---------------------------------------------------------------------------------------
 void ScorePlayer::set_new_beat_information(SoundEvent* pEvent)
 {
@@ -1003,5 +1010,111 @@ void ScorePlayer::set_new_beat_information(SoundEvent* pEvent)
 }
 
 
+//=======================================================================================
+// PlaybackScheduler implementation
+//=======================================================================================
+PlaybackScheduler::PlaybackScheduler()
+    : m_origin( Clock::now() )
+    , m_suspendTime( m_origin )
+    , m_numEvents(0L)
+    , m_numLateEvents(0L)
+    , m_sumLateness(0.0)
+    , m_sumSquaredLateness(0.0)
+    , m_maxLateness(0.0)
+{
+}
+
+//---------------------------------------------------------------------------------------
+void PlaybackScheduler::start(double scoreTime)
+{
+    //score time 'scoreTime' corresponds to current wall time
+    m_origin = Clock::now() - std::chrono::duration_cast<Clock::duration>(
+                    std::chrono::duration<double, std::milli>(scoreTime) );
+    reset_stats();
+}
+
+//---------------------------------------------------------------------------------------
+PlaybackScheduler::Clock::time_point PlaybackScheduler::deadline_for(double scoreTime)
+{
+    return m_origin + std::chrono::duration_cast<Clock::duration>(
+                            std::chrono::duration<double, std::milli>(scoreTime) );
+}
+
+//---------------------------------------------------------------------------------------
+void PlaybackScheduler::wait_until(double scoreTime)
+{
+    Clock::time_point deadline = deadline_for(scoreTime);
+    if (Clock::now() < deadline)
+        std::this_thread::sleep_until(deadline);
+
+    std::chrono::duration<double, std::micro> lateness = Clock::now() - deadline;
+    add_lateness(lateness.count());
+}
+
+//---------------------------------------------------------------------------------------
+void PlaybackScheduler::rebase(double oldScoreTime, double newScoreTime)
+{
+    //the wall time that was assigned to oldScoreTime is now assigned to newScoreTime.
+    //Used for jumps and tempo changes
+    m_origin += std::chrono::duration_cast<Clock::duration>(
+                    std::chrono::duration<double, std::milli>(oldScoreTime - newScoreTime) );
+}
+
+//---------------------------------------------------------------------------------------
+void PlaybackScheduler::suspend()
+{
+    m_suspendTime = Clock::now();
+}
+
+//---------------------------------------------------------------------------------------
+void PlaybackScheduler::resume()
+{
+    //shift all deadlines by the time elapsed while paused
+    m_origin += Clock::now() - m_suspendTime;
+}
+
+//---------------------------------------------------------------------------------------
+void PlaybackScheduler::add_lateness(double microseconds)
+{
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    ++m_numEvents;
+    if (microseconds > 1000.0)
+        ++m_numLateEvents;
+    m_sumLateness += microseconds;
+    m_sumSquaredLateness += microseconds * microseconds;
+    m_maxLateness = max(m_maxLateness, microseconds);
+}
+
+//---------------------------------------------------------------------------------------
+void PlaybackScheduler::reset_stats()
+{
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    m_numEvents = 0L;
+    m_numLateEvents = 0L;
+    m_sumLateness = 0.0;
+    m_sumSquaredLateness = 0.0;
+    m_maxLateness = 0.0;
+}
+
+//---------------------------------------------------------------------------------------
+PlaybackTimingStats PlaybackScheduler::get_stats()
+{
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    PlaybackTimingStats stats;
+    stats.numEvents = m_numEvents;
+    stats.numLateEvents = m_numLateEvents;
+    stats.maxLateness = m_maxLateness;
+    if (m_numEvents > 0)
+    {
+        double n = double(m_numEvents);
+        stats.meanLateness = m_sumLateness / n;
+        double variance = m_sumSquaredLateness / n
+                          - stats.meanLateness * stats.meanLateness;
+        stats.jitter = (variance > 0.0 ? sqrt(variance) : 0.0);
+    }
+    return stats;
+}
+
+
 }   //namespace lomse
 
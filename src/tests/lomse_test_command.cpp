@@ -29,12 +29,16 @@
 
 #include <UnitTest++.h>
 #include <sstream>
+#include <fstream>
+#include <cstdio>
+#include <cstdlib>
 #include "lomse_build_options.h"
 
 //classes related to these tests
 #include "lomse_injectors.h"
 #include "lomse_document.h"
 #include "lomse_command.h"
+#include "lomse_command_journal.h"
 #include "lomse_document_cursor.h"
 #include "lomse_im_note.h"
 #include "lomse_im_attributes.h"
@@ -5181,3 +5185,134 @@ SUITE(DocCommandTest)
     }
 
 }
+
+
+//=======================================================================================
+// CommandJournal tests
+//=======================================================================================
+
+SUITE(CommandJournalTest)
+{
+
+    string temp_file_path(const string& name)
+    {
+        //path for a file in the system temporary directory
+        const char* vars[] = { "TMPDIR", "TEMP", "TMP" };
+        for (int i=0; i < 3; ++i)
+        {
+            const char* dir = std::getenv(vars[i]);
+            if (dir && *dir)
+                return string(dir) + "/" + name;
+        }
+        return "/tmp/" + name;
+    }
+
+    TEST_FIXTURE(DocCommandTestFixture, command_journal_001)
+    {
+        //001. journal is disabled by default
+        CHECK( m_libraryScope.get_command_journal() == nullptr );
+
+        Document doc(m_libraryScope);
+        doc.from_string("(score (vers 2.0)(instrument (musicData (clef G)(n c4 q))))");
+        DocCursor cursor(&doc);
+        cursor.enter_element();
+        DocCommandExecuter executer(&doc);
+        MySelectionSet sel(&doc);
+        executer.execute(&cursor, LOMSE_NEW CmdDeleteStaffObj(), &sel);
+        executer.undo(&cursor, &sel);
+
+        CHECK( m_libraryScope.get_command_journal() == nullptr );
+    }
+
+    TEST_FIXTURE(DocCommandTestFixture, command_journal_002)
+    {
+        //002. records for execution and undo. Kept in memory
+        m_libraryScope.enable_command_journal("");
+        CommandJournal* pJournal = m_libraryScope.get_command_journal();
+        CHECK( pJournal != nullptr );
+
+        Document doc(m_libraryScope);
+        doc.from_string("(score (vers 2.0)(instrument (musicData (clef G)(n c4 q))))");
+        DocCursor cursor(&doc);
+        cursor.enter_element();
+        DocCommandExecuter executer(&doc);
+        MySelectionSet sel(&doc);
+        executer.execute(&cursor, LOMSE_NEW CmdDeleteStaffObj(), &sel);
+        executer.undo(&cursor, &sel);
+
+        vector<string> records = pJournal->get_records();
+        CHECK( records.size() == 2 );
+        CHECK( records.size() == 2 && records[0].find("Before executing command") != string::npos );
+        CHECK( records.size() == 2 && records[1].find("Before Undo") != string::npos );
+
+        m_libraryScope.disable_command_journal();
+        CHECK( m_libraryScope.get_command_journal() == nullptr );
+    }
+
+    TEST_FIXTURE(DocCommandTestFixture, command_journal_003)
+    {
+        //003. ring buffer retention. File contains only the retained records
+        string filename = temp_file_path("lomse-command-journal-003.txt");
+        m_libraryScope.enable_command_journal(filename, 2);
+        CommandJournal* pJournal = m_libraryScope.get_command_journal();
+
+        pJournal->add_record("record 1\n");
+        pJournal->add_record("record 2\n");
+        pJournal->add_record("record 3\n");
+        pJournal->flush();
+
+        vector<string> records = pJournal->get_records();
+        CHECK( records.size() == 2 );
+        CHECK( records.size() == 2 && records[0] == "record 2\n" );
+
+        ifstream file(filename);
+        stringstream content;
+        content << file.rdbuf();
+        file.close();
+        CHECK( content.str() == "record 2\nrecord 3\n" );
+
+        m_libraryScope.disable_command_journal();
+        std::remove( filename.c_str() );
+    }
+
+    TEST_FIXTURE(DocCommandTestFixture, command_journal_004)
+    {
+        //004. without retention limit records are only appended to the file
+        string filename = temp_file_path("lomse-command-journal-004.txt");
+        m_libraryScope.enable_command_journal(filename);
+        CommandJournal* pJournal = m_libraryScope.get_command_journal();
+        CHECK( pJournal->get_max_records() == 0 );
+
+        pJournal->add_record("record 1\n");
+        pJournal->add_record("record 2\n");
+        pJournal->add_record("record 3\n");
+        pJournal->flush();
+
+        CHECK( pJournal->get_records().size() == 0 );
+
+        ifstream file(filename);
+        stringstream content;
+        content << file.rdbuf();
+        file.close();
+        CHECK( content.str() == "record 1\nrecord 2\nrecord 3\n" );
+
+        m_libraryScope.disable_command_journal();
+        std::remove( filename.c_str() );
+    }
+
+    TEST_FIXTURE(DocCommandTestFixture, command_journal_005)
+    {
+        //005. journal only in memory is always limited
+        m_libraryScope.enable_command_journal("");
+        CommandJournal* pJournal = m_libraryScope.get_command_journal();
+        CHECK( pJournal->get_max_records() == CommandJournal::k_default_max_records );
+
+        for (int i=0; i < CommandJournal::k_default_max_records + 10; ++i)
+            pJournal->add_record("record\n");
+
+        CHECK( pJournal->get_records().size() == CommandJournal::k_default_max_records );
+
+        m_libraryScope.disable_command_journal();
+    }
+
+}
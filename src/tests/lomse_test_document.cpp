@@ -42,6 +42,9 @@
 #include "lomse_events.h"
 #include "lomse_document_iterator.h"
 #include "lomse_im_factory.h"
+#include "lomse_staffobjs_table.h"
+#include "lomse_model_arena.h"
+#include "lomse_im_attributes.h"
 
 #include <exception>
 using namespace UnitTest;
@@ -526,5 +529,127 @@ SUITE(DocumentTest)
         CHECK( pImo->is_note() );
     }
 
+    TEST_FIXTURE(DocumentTestFixture, checkpoints_212)
+    {
+        //212. music data checkpoint. Content restored preserving ids
+        create_document_1();
+        ImoScore* pScore = static_cast<ImoScore*>( m_pDoc->get_pointer_to_imo(94L) );
+        ImoInstrument* pInstr = pScore->get_instrument(0);
+        ImoMusicData* pMD = pInstr->get_musicdata();
+        ImoId idMD = pMD->get_id();
+        string original = m_pDoc->to_string(true);
+
+        string data = m_pDoc->get_checkpoint_data_for(idMD);
+        CHECK( data.compare(0, 10, "(musicData") == 0 );
+        CHECK( data.find("<ldpmusic>") == string::npos );
+
+        stringstream errormsg;
+        pInstr->insert_staff_objects_at(nullptr, "(n e4 q)(n f4 q)", errormsg);
+        pScore->end_of_changes();
+        CHECK( pScore->get_staffobjs_table()->num_entries() == 7 );
+
+        CHECK( m_pDoc->replace_object_from_checkpoint_data(idMD, data) == 0 );
+
+        CHECK( m_pDoc->get_pointer_to_imo(idMD) == pMD );
+        CHECK( pMD->get_num_children() == 5 );
+        CHECK( m_pDoc->to_string(true) == original );
+        CHECK( pScore->get_staffobjs_table()->num_entries() == 5 );
+        ImoObj* pImo = m_pDoc->get_pointer_to_imo(124L);
+        CHECK( pImo && pImo->is_note() );
+    }
+
 };
 
+
+//=======================================================================================
+// ModelArena tests
+//=======================================================================================
+class ModelArenaTestFixture
+{
+public:
+
+    ModelArenaTestFixture()     //SetUp fixture
+        : m_libraryScope(cout)
+    {
+    }
+
+    ~ModelArenaTestFixture()    //TearDown fixture
+    {
+    }
+
+    LibraryScope m_libraryScope;
+
+};
+
+//---------------------------------------------------------------------------------------
+SUITE(ModelArenaTest)
+{
+
+    TEST_FIXTURE(ModelArenaTestFixture, arena_reuses_released_blocks)
+    {
+        ModelArena arena;
+        void* pBlock = arena.allocate(40);
+        void* pOther = arena.allocate(100);
+        arena.release(pBlock, 40);
+
+        CHECK( arena.allocate(100) != pBlock );
+        CHECK( arena.allocate(40) == pBlock );
+        CHECK( arena.num_chunks() == 1 );
+        CHECK( pOther != pBlock );
+    }
+
+    TEST_FIXTURE(ModelArenaTestFixture, arena_not_used_by_default)
+    {
+        Document doc(m_libraryScope);
+        doc.from_string("(score (vers 2.0)(instrument (musicData (clef G)(n c4 q))))");
+
+        CHECK( doc.get_model_arena() == nullptr );
+    }
+
+    TEST_FIXTURE(ModelArenaTestFixture, document_model_in_arena)
+    {
+        m_libraryScope.set_use_model_arena(true);
+        Document doc(m_libraryScope);
+        doc.from_string("(score (vers 2.0)(instrument (musicData (clef G)(n c4 q))))");
+
+        ModelArena* pArena = doc.get_model_arena();
+        CHECK( pArena != nullptr );
+        CHECK( pArena->num_chunks() == 1 );
+        size_t used = pArena->bytes_in_use();
+        CHECK( used > 0 );
+
+        ImoObj* pImo = ImFactory::inject(k_imo_note, &doc);
+        pImo->set_int_attribute(k_attr_octave, 5);
+        size_t noteSize = (sizeof(ImoNote) + ModelArena::k_align - 1)
+                          & ~size_t(ModelArena::k_align - 1);
+        CHECK( pArena->bytes_in_use() == used + noteSize );     //no header
+
+        delete pImo;
+        CHECK( pArena->bytes_in_use() == used );
+
+        ImoObj* pOther = ImFactory::inject(k_imo_note, &doc);
+        CHECK( pOther == pImo );    //block reused
+        delete pOther;
+    }
+
+    TEST_FIXTURE(ModelArenaTestFixture, heap_objects_in_arena_document)
+    {
+        Document heapDoc(m_libraryScope);
+        m_libraryScope.set_use_model_arena(true);
+        Document doc(m_libraryScope);
+        doc.from_string("(score (vers 2.0)(instrument (musicData (clef G)(n c4 q))))");
+        ModelArena* pArena = doc.get_model_arena();
+        size_t used = pArena->bytes_in_use();
+
+        ImoObj* pImo = ImFactory::inject(k_imo_staff_info, &doc);
+        ImoStaffInfo* pCopy = LOMSE_NEW ImoStaffInfo(*static_cast<ImoStaffInfo*>(pImo));
+        ImoObj* pHeap = ImFactory::inject(k_imo_note, &heapDoc);
+        delete pImo;
+        CHECK( pArena->bytes_in_use() == used );
+
+        delete pCopy;
+        delete pHeap;
+        CHECK( pArena->bytes_in_use() == used );
+    }
+
+}
@@ -38,6 +38,13 @@
 #include "lomse_events.h"
 #include "lomse_hyperlink_ctrl.h"
 #include "lomse_button_ctrl.h"
+#include "lomse_events_dispatcher.h"
+#include "lomse_time.h"
+#include "lomse_doorway.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
 
 using namespace UnitTest;
 using namespace std;
@@ -248,3 +255,140 @@ SUITE(DocumentEventsTest)
 
 };
 
+
+
+//---------------------------------------------------------------------------------------
+class MyTrackingReceiver
+{
+public:
+    std::atomic<int> m_numEvents;
+    std::atomic<int> m_numItems;
+
+    MyTrackingReceiver() : m_numEvents(0), m_numItems(0) {}
+
+    static void wrapper_for_events(void* pThis, SpEventInfo pEvent)
+    {
+        static_cast<MyTrackingReceiver*>(pThis)->on_event(pEvent);
+    }
+
+    void on_event(SpEventInfo pEvent)
+    {
+        if (pEvent->is_tracking_event())
+        {
+            SpEventVisualTracking pEv(
+                    static_pointer_cast<EventVisualTracking>(pEvent) );
+            m_numItems += pEv->get_num_items();
+        }
+        ++m_numEvents;
+    }
+};
+
+//---------------------------------------------------------------------------------------
+class EventsDispatcherTestFixture
+{
+public:
+    LomseDoorway m_doorway;
+    MyTrackingReceiver m_receiver;
+
+    EventsDispatcherTestFixture()     //SetUp fixture
+    {
+        m_doorway.init_library(k_pix_format_rgba32, 96, false);
+        m_doorway.set_notify_callback(&m_receiver,
+                                      MyTrackingReceiver::wrapper_for_events);
+    }
+
+    ~EventsDispatcherTestFixture()    //TearDown fixture
+    {
+    }
+};
+
+SUITE(EventsDispatcherTest)
+{
+
+    TEST_FIXTURE(EventsDispatcherTestFixture, coalesce_same_score)
+    {
+        SpEventVisualTracking pEv1( new EventVisualTracking(WpInteractor(), 10L) );
+        pEv1->add_item(EventVisualTracking::k_highlight_on, 20L);
+        SpEventVisualTracking pEv2( new EventVisualTracking(WpInteractor(), 10L) );
+        pEv2->add_item(EventVisualTracking::k_highlight_off, 20L);
+        pEv2->add_item(EventVisualTracking::k_highlight_on, 21L);
+
+        CHECK( pEv1->coalesce(pEv2.get()) == true );
+        CHECK( pEv1->get_num_items() == 1 );
+        CHECK( pEv1->get_items().front().second == 21L );
+    }
+
+    TEST_FIXTURE(EventsDispatcherTestFixture, coalesce_keeps_last_tempo_line)
+    {
+        SpEventVisualTracking pEv1( new EventVisualTracking(WpInteractor(), 10L) );
+        pEv1->add_move_tempo_line_event(64.0);
+        SpEventVisualTracking pEv2( new EventVisualTracking(WpInteractor(), 10L) );
+        pEv2->add_move_tempo_line_event(128.0);
+
+        CHECK( pEv1->coalesce(pEv2.get()) == true );
+        CHECK( pEv1->get_num_items() == 1 );
+        CHECK( is_equal_time(pEv1->get_timepos(), 128.0) );
+    }
+
+    TEST_FIXTURE(EventsDispatcherTestFixture, coalesce_other_score_fails)
+    {
+        SpEventVisualTracking pEv1( new EventVisualTracking(WpInteractor(), 10L) );
+        pEv1->add_item(EventVisualTracking::k_highlight_on, 20L);
+        SpEventVisualTracking pEv2( new EventVisualTracking(WpInteractor(), 11L) );
+        pEv2->add_item(EventVisualTracking::k_highlight_off, 20L);
+
+        CHECK( pEv1->coalesce(pEv2.get()) == false );
+        CHECK( pEv1->get_num_items() == 1 );
+    }
+
+    TEST_FIXTURE(EventsDispatcherTestFixture, sync_delivery_when_no_thread)
+    {
+        EventsDispatcher dispatcher(&m_doorway);
+        SpEventVisualTracking pEv( new EventVisualTracking(WpInteractor(), 10L) );
+        pEv->add_item(EventVisualTracking::k_highlight_on, 20L);
+
+        dispatcher.post_event(pEv);
+
+        CHECK( dispatcher.is_events_loop_running() == false );
+        CHECK( m_receiver.m_numEvents == 1 );
+    }
+
+    TEST_FIXTURE(EventsDispatcherTestFixture, async_delivery_from_thread)
+    {
+        EventsDispatcher dispatcher(&m_doorway);
+        dispatcher.start_events_loop();
+        CHECK( dispatcher.is_events_loop_running() == true );
+
+        for (int i=0; i < 10; ++i)
+        {
+            SpEventVisualTracking pEv( new EventVisualTracking(WpInteractor(), 10L) );
+            pEv->add_item(EventVisualTracking::k_highlight_on, 20L + i);
+            dispatcher.post_event(pEv);
+        }
+
+        //events can be coalesced but no sub-event is lost
+        for (int i=0; i < 200 && m_receiver.m_numItems < 10; ++i)
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        CHECK( m_receiver.m_numItems == 10 );
+        CHECK( m_receiver.m_numEvents >= 1 );
+        CHECK( m_receiver.m_numEvents <= 10 );
+
+        dispatcher.stop_events_loop();
+        CHECK( dispatcher.is_events_loop_running() == false );
+    }
+
+    TEST_FIXTURE(EventsDispatcherTestFixture, library_scope_option)
+    {
+        LibraryScope libraryScope(cout, &m_doorway);
+        CHECK( libraryScope.async_events_dispatch() == false );
+        EventsDispatcher* pDispatcher = libraryScope.get_events_dispatcher();
+        CHECK( pDispatcher->is_events_loop_running() == false );
+
+        libraryScope.set_async_events_dispatch(true);
+        CHECK( pDispatcher->is_events_loop_running() == true );
+
+        libraryScope.set_async_events_dispatch(false);
+        CHECK( pDispatcher->is_events_loop_running() == false );
+    }
+
+};
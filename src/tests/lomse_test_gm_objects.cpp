@@ -42,20 +42,28 @@
 #include "lomse_shape_staff.h"
 #include "lomse_im_factory.h"
 #include "lomse_document.h"
+#include "lomse_shapes.h"
+#include "lomse_drawer.h"
 
 using namespace UnitTest;
 using namespace std;
 using namespace lomse;
 
 //---------------------------------------------------------------------------------------
-// for accessing protected members
-class MyGmoBoxDocPage : public GmoBoxDocPage
+// a shape that counts the times it is drawn
+class MyCountingShape : public GmoShapeInvisible
 {
 public:
-    MyGmoBoxDocPage(ImoObj* pCreatorImo) : GmoBoxDocPage(pCreatorImo) {}
-    ~MyGmoBoxDocPage() {}
+    int m_numDraws;
 
-    inline std::list<GmoShape*>& get_all_shapes() { return m_allShapes; }
+    MyCountingShape(UPoint pos, USize size)
+        : GmoShapeInvisible(nullptr, 0, pos, size)
+        , m_numDraws(0)
+    {
+    }
+    ~MyCountingShape() {}
+
+    void on_draw(Drawer* UNUSED(pDrawer), RenderOptions& UNUSED(opt)) { ++m_numDraws; }
 };
 
 
@@ -218,7 +226,7 @@ SUITE(GmoTest)
     TEST_FIXTURE(GmoTestFixture, BoxSystem_ShapesOrderedByLayer)
     {
         Document doc(m_libraryScope);
-        MyGmoBoxDocPage page(nullptr);
+        GmoBoxDocPage page(nullptr);
         GmoBoxDocPageContent* pDPC = LOMSE_NEW GmoBoxDocPageContent(nullptr);
         page.add_child_box(pDPC);
         GmoBoxScorePage* pScorePage = LOMSE_NEW GmoBoxScorePage(nullptr);
@@ -242,8 +250,9 @@ SUITE(GmoTest)
         pScorePage->add_system(pBox, 0);
         pBox->add_shapes_to_tables();
 
-        std::list<GmoShape*>& shapes = page.get_all_shapes();
-        std::list<GmoShape*>::iterator it = shapes.begin();
+        std::vector<GmoShape*> shapes;
+        page.get_all_shapes(&shapes);
+        std::vector<GmoShape*>::iterator it = shapes.begin();
 
         //cout << (*it)->get_layer() << endl;
         CHECK( (*it) == pShape4 );
@@ -308,6 +317,182 @@ SUITE(GmoTest)
         CHECK( pDP->get_graphic_model() == &gm );
     }
 
-};
+    TEST_FIXTURE(GmoTestFixture, Box_DrawingBoundsIncludeOverflowingShapes)
+    {
+        GmoBoxSystem box(nullptr);
+        box.set_origin(1000.0f, 1000.0f);
+        box.set_width(5000.0f);
+        box.set_height(2000.0f);
+        MyCountingShape* pShape = LOMSE_NEW MyCountingShape(UPoint(2000.0f, 500.0f),
+                                                            USize(300.0f, 300.0f));
+        box.add_shape(pShape, 0);
+
+        URect r = box.get_drawing_bounds();
+        CHECK( r.x == 1000.0f );
+        CHECK( r.y == 500.0f );
+        CHECK( r.right() == 6000.0f );
+        CHECK( r.bottom() == 3000.0f );
+    }
+
+    TEST_FIXTURE(GmoTestFixture, Box_DrawingBoundsUpdatedWhenShapeMoved)
+    {
+        GmoBoxSystem* pSystem = LOMSE_NEW GmoBoxSystem(nullptr);
+        GmoBoxScorePage page(nullptr);
+        page.add_child_box(pSystem);
+        pSystem->set_width(5000.0f);
+        pSystem->set_height(2000.0f);
+        MyCountingShape* pShape = LOMSE_NEW MyCountingShape(UPoint(0.0f, 0.0f),
+                                                            USize(300.0f, 300.0f));
+        pSystem->add_shape(pShape, 0);
+        CHECK( page.get_drawing_bounds().bottom() == 2000.0f );
+
+        pShape->set_origin(100.0f, 4000.0f);
+
+        CHECK( pSystem->get_drawing_bounds().bottom() == 4300.0f );
+        CHECK( page.get_drawing_bounds().bottom() == 4300.0f );
+    }
+
+    TEST_FIXTURE(GmoTestFixture, Box_ShapesOutOfCullRectNotDrawn)
+    {
+        GmoBoxSystem box(nullptr);
+        box.set_width(10000.0f);
+        box.set_height(10000.0f);
+        MyCountingShape* pShape1 = LOMSE_NEW MyCountingShape(UPoint(1000.0f, 1000.0f),
+                                                             USize(300.0f, 300.0f));
+        box.add_shape(pShape1, 0);
+        MyCountingShape* pShape2 = LOMSE_NEW MyCountingShape(UPoint(8000.0f, 8000.0f),
+                                                             USize(300.0f, 300.0f));
+        box.add_shape(pShape2, 0);
+
+        RenderOptions opt;
+        box.on_draw(nullptr, opt);
+        CHECK( pShape1->m_numDraws == 1 );
+        CHECK( pShape2->m_numDraws == 1 );
+
+        opt.cull_flag = true;
+        opt.cull_rect = URect(0.0f, 0.0f, 5000.0f, 5000.0f);
+        box.on_draw(nullptr, opt);
+        CHECK( pShape1->m_numDraws == 2 );
+        CHECK( pShape2->m_numDraws == 1 );
+    }
+
+    TEST_FIXTURE(GmoTestFixture, Box_BoxesOutOfCullRectNotDrawn)
+    {
+        GmoBoxScorePage page(nullptr);
+        page.set_width(10000.0f);
+        page.set_height(10000.0f);
+        GmoBoxSystem* pSystem1 = LOMSE_NEW GmoBoxSystem(nullptr);
+        page.add_child_box(pSystem1);
+        pSystem1->set_width(10000.0f);
+        pSystem1->set_height(2000.0f);
+        MyCountingShape* pShape1 = LOMSE_NEW MyCountingShape(UPoint(1000.0f, 1000.0f),
+                                                             USize(300.0f, 300.0f));
+        pSystem1->add_shape(pShape1, 0);
+        GmoBoxSystem* pSystem2 = LOMSE_NEW GmoBoxSystem(nullptr);
+        page.add_child_box(pSystem2);
+        pSystem2->set_origin(0.0f, 6000.0f);
+        pSystem2->set_width(10000.0f);
+        pSystem2->set_height(2000.0f);
+        MyCountingShape* pShape2 = LOMSE_NEW MyCountingShape(UPoint(1000.0f, 7000.0f),
+                                                             USize(300.0f, 300.0f));
+        pSystem2->add_shape(pShape2, 0);
+        //a slur overflowing system 2 and visible in the viewport
+        MyCountingShape* pShape3 = LOMSE_NEW MyCountingShape(UPoint(1000.0f, 4000.0f),
+                                                             USize(300.0f, 2500.0f));
+        pSystem2->add_shape(pShape3, 0);
+
+        RenderOptions opt;
+        opt.cull_flag = true;
+        opt.cull_rect = URect(0.0f, 0.0f, 10000.0f, 5000.0f);
+        page.on_draw(nullptr, opt);
+
+        CHECK( pShape1->m_numDraws == 1 );
+        CHECK( pShape2->m_numDraws == 0 );
+        CHECK( pShape3->m_numDraws == 1 );
+    }
+
+    TEST_FIXTURE(GmoTestFixture, Rectangle_Intersects)
+    {
+        URect r(1000.0f, 1000.0f, 500.0f, 500.0f);
+        CHECK( r.intersects( URect(1200.0f, 1200.0f, 1000.0f, 1000.0f) ) == true );
+        CHECK( r.intersects( URect(1600.0f, 1200.0f, 1000.0f, 1000.0f) ) == false );
+        CHECK( r.intersects( URect(0.0f, 1200.0f, 3000.0f, 0.0f) ) == true );
+        CHECK( r.intersects( URect(0.0f, 0.0f, 900.0f, 900.0f) ) == false );
+    }
 
+    // GmoBoxDocPage spatial index ------------------------------------------------------
 
+    TEST_FIXTURE(GmoTestFixture, Page_FindShapeAtReturnsTopMost)
+    {
+        GmoBoxDocPage page(nullptr);
+        GmoBoxSystem* pBox = LOMSE_NEW GmoBoxSystem(nullptr);
+        page.add_child_box(pBox);
+        for (int i=0; i < 100; ++i)
+        {
+            LUnits x = LUnits(i % 10) * 1000.0f;
+            LUnits y = LUnits(i / 10) * 1000.0f;
+            MyCountingShape* pShape = LOMSE_NEW MyCountingShape(UPoint(x, y),
+                                                                USize(500.0f, 500.0f));
+            pBox->add_shape(pShape, GmoShape::k_layer_notes);
+        }
+        MyCountingShape* pTop = LOMSE_NEW MyCountingShape(UPoint(5100.0f, 5100.0f),
+                                                          USize(200.0f, 200.0f));
+        pBox->add_shape(pTop, GmoShape::k_layer_top);
+        MyCountingShape* pBottom = LOMSE_NEW MyCountingShape(UPoint(5200.0f, 5200.0f),
+                                                             USize(200.0f, 200.0f));
+        pBox->add_shape(pBottom, GmoShape::k_layer_background);
+        pBox->add_shapes_to_tables();
+
+        CHECK( page.find_shape_at(5250.0f, 5250.0f) == pTop );
+        CHECK( page.find_shape_at(5350.0f, 5350.0f) == pBox->get_shape(55) );
+        CHECK( page.find_shape_at(3100.0f, 2100.0f) == pBox->get_shape(23) );
+        CHECK( page.find_shape_at(3700.0f, 2100.0f) == nullptr );
+        CHECK( page.find_shape_at(-100.0f, 2100.0f) == nullptr );
+        CHECK( page.get_shapes_grid()->get_num_shapes() == 102 );
+    }
+
+    TEST_FIXTURE(GmoTestFixture, Page_ShapesGridUpdatedWhenShapeMoved)
+    {
+        GmoBoxDocPage page(nullptr);
+        GmoBoxSystem* pBox = LOMSE_NEW GmoBoxSystem(nullptr);
+        page.add_child_box(pBox);
+        MyCountingShape* pShape1 = LOMSE_NEW MyCountingShape(UPoint(0.0f, 0.0f),
+                                                             USize(500.0f, 500.0f));
+        pBox->add_shape(pShape1, GmoShape::k_layer_notes);
+        MyCountingShape* pShape2 = LOMSE_NEW MyCountingShape(UPoint(5000.0f, 5000.0f),
+                                                             USize(500.0f, 500.0f));
+        pBox->add_shape(pShape2, GmoShape::k_layer_notes);
+        pBox->add_shapes_to_tables();
+        CHECK( page.find_shape_at(100.0f, 100.0f) == pShape1 );
+
+        pShape1->set_origin(8000.0f, 8000.0f);
+
+        CHECK( page.find_shape_at(100.0f, 100.0f) == nullptr );
+        CHECK( page.find_shape_at(8100.0f, 8100.0f) == pShape1 );
+    }
+
+    TEST_FIXTURE(GmoTestFixture, ShapesGrid_ShapesInRectangle)
+    {
+        GmoBoxSystem box(nullptr);
+        for (int i=0; i < 100; ++i)
+        {
+            LUnits x = LUnits(i % 10) * 1000.0f;
+            LUnits y = LUnits(i / 10) * 1000.0f;
+            box.add_shape( LOMSE_NEW MyCountingShape(UPoint(x, y), USize(1500.0f, 500.0f)),
+                           GmoShape::k_layer_notes );
+        }
+        std::vector<GmoShape*> shapes;
+        for (int i=0; i < 100; ++i)
+            shapes.push_back( box.get_shape(i) );
+        ShapesGrid grid;
+        grid.build(shapes);
+
+        std::vector<GmoShape*> found;
+        grid.find_shapes_in_rectangle(URect(900.0f, 900.0f, 2700.0f, 1700.0f), &found);
+
+        CHECK( found.size() == 4 );
+        CHECK( found.size() == 4 && found[0] == box.get_shape(22) );
+        CHECK( found.size() == 4 && found[3] == box.get_shape(11) );
+    }
+
+};
@@ -1115,6 +1115,64 @@ SUITE(GraphicModelTest)
         delete pIntor;
     }
 
+
+    //@ IdMap ----------------------------------------------------------------------------
+
+    TEST_FIXTURE(GraphicModelTestFixture, id_map_01)
+    {
+        //@01. paged, negative and big ids. Entries in id order
+        int values[4];
+        IdMap<int> idMap;
+        idMap.set(3L, &values[0]);
+        idMap.set(k_no_imoid, &values[1]);
+        idMap.set(900000000L, &values[2]);
+        idMap.set(1000L, &values[3]);
+
+        CHECK( idMap.size() == 4 );
+        CHECK( idMap.find(3L) == &values[0] );
+        CHECK( idMap.find(k_no_imoid) == &values[1] );
+        CHECK( idMap.find(900000000L) == &values[2] );
+        CHECK( idMap.find(1000L) == &values[3] );
+        CHECK( idMap.find(4L) == nullptr );
+        CHECK( idMap.find(5000L) == nullptr );
+
+        vector< pair<ImoId, int*> > entries;
+        idMap.get_entries(entries);
+        CHECK( entries.size() == 4 );
+        CHECK( entries[0].first == k_no_imoid );
+        CHECK( entries[1].first == 3L );
+        CHECK( entries[2].first == 1000L );
+        CHECK( entries[3].first == 900000000L );
+
+        idMap.erase(3L);
+        idMap.erase(900000000L);
+        CHECK( idMap.size() == 2 );
+        CHECK( idMap.find(3L) == nullptr );
+        CHECK( idMap.find(900000000L) == nullptr );
+    }
+
+    TEST_FIXTURE(GraphicModelTestFixture, id_map_02)
+    {
+        //@02. ImoShapeIdMap grows and finds all entries
+        int values[1000];
+        ImoShapeIdMap<int> idMap;
+        for (int i=0; i < 1000; ++i)
+            idMap.set(ImoId(i / 10), ShapeId(i % 10 + 1), &values[i]);
+
+        CHECK( idMap.size() == 1000 );
+        bool fOk = true;
+        for (int i=0; i < 1000; ++i)
+            fOk &= (idMap.find(ImoId(i / 10), ShapeId(i % 10 + 1)) == &values[i]);
+        CHECK( fOk );
+        CHECK( idMap.find(5L, 11) == nullptr );
+        CHECK( idMap.find(100L, 1) == nullptr );
+        CHECK( idMap.find(5L, 0) == nullptr );
+
+        idMap.set(5L, 3, &values[0]);
+        CHECK( idMap.size() == 1000 );
+        CHECK( idMap.find(5L, 3) == &values[0] );
+    }
+
 };
 
 
@@ -1191,6 +1191,66 @@ SUITE(InternalModelTest)
         CHECK( pStyle->font_size() == 21.0f );
     }
 
+    TEST_FIXTURE(InternalModelTestFixture, Style_inherits_parent_changes)
+    {
+        //@ Style_inherits_parent_changes. Resolved values are rebuilt
+        Document doc(m_libraryScope);
+        doc.create_empty();
+        ImoDocument* pDoc = doc.get_im_root();
+        ImoStyle* pStyle = pDoc->create_private_style();
+        CHECK( pStyle->font_size() == 12.0f );
+        CHECK( pStyle->font_name() == "Liberation serif" );
+
+        ImoStyle* pDefault = pDoc->get_default_style();
+        pDefault->font_size(15.0f);
+        pDefault->font_name("Callamet");
+
+        CHECK( pStyle->font_size() == 15.0f );
+        CHECK( pStyle->font_name() == "Callamet" );
+    }
+
+    TEST_FIXTURE(InternalModelTestFixture, Object_named_style_replaced)
+    {
+        //@ Object_named_style_replaced. Cached named style is invalidated
+        Document doc(m_libraryScope);
+        doc.from_string("(lenmusdoc (vers 0.0)(content "
+            "(para (txt \"hello\")) ))" );
+        ImoDocument* pDoc = doc.get_im_root();
+        ImoContent* pContent = pDoc->get_content();
+        ImoContentObj* pImo = static_cast<ImoContentObj*>( *(pContent->begin()) );
+        CHECK( pImo->get_style()->get_name() == "Paragraph" );
+        CHECK( pImo->get_style()->font_size() == 12.0f );
+
+        ImoStyle* pStyle = static_cast<ImoStyle*>(ImFactory::inject(k_imo_style, &doc));
+        pStyle->set_name("Paragraph");
+        pStyle->set_parent_style(pDoc->get_default_style());
+        pStyle->font_size(30.0f);
+        pDoc->add_style(pStyle);
+
+        CHECK( pImo->get_style() == pStyle );
+        CHECK( pImo->get_style()->font_size() == 30.0f );
+    }
+
+    TEST_FIXTURE(InternalModelTestFixture, Styles_epoch_per_document)
+    {
+        //@ Styles_epoch_per_document. Changes in other documents do not
+        //@ invalidate cached values
+        Document doc1(m_libraryScope);
+        doc1.create_empty();
+        Document doc2(m_libraryScope);
+        doc2.create_empty();
+        ImoStyle* pStyle2 = doc2.get_im_root()->get_default_style();
+        CHECK( pStyle2->font_size() == 12.0f );
+        unsigned epoch1 = doc1.get_styles_epoch();
+        unsigned epoch2 = doc2.get_styles_epoch();
+
+        doc1.get_im_root()->get_default_style()->font_size(15.0f);
+
+        CHECK( doc1.get_styles_epoch() != epoch1 );
+        CHECK( doc2.get_styles_epoch() == epoch2 );
+        CHECK( pStyle2->font_size() == 12.0f );
+    }
+
 
     //@ ImoArticulationSymbol ------------------------------------------------------------
 
@@ -1422,4 +1422,40 @@ SUITE(LdpExporterTest)
         CHECK( source == expected );
     }
 
+
+    //@ output stream -------------------------------------------------------------------
+
+    TEST_FIXTURE(LdpExporterTestFixture, output_stream_01)
+    {
+        //@01 Source is appended to the caller stream. Same result than get_source()
+        Document doc(m_libraryScope);
+        doc.from_string("(score (vers 2.0)(instrument (musicData "
+            "(clef G)(n g5 s g+ t3/2)(n f5 s)(n g5 s g- t-)(barline)"
+            ")))" );
+        ImoScore* pScore = static_cast<ImoScore*>( doc.get_im_root()->get_content_item(0) );
+        ImoMusicData* pMD = pScore->get_instrument(0)->get_musicdata();
+
+        LdpExporter exporter(&m_libraryScope);
+        exporter.set_current_score(pScore);
+        exporter.set_remove_newlines(true);
+        stringstream out;
+        out << "prefix";
+        exporter.get_source(out, pMD);
+        string source = exporter.get_source(pMD);
+
+        //cout << test_name() << endl << "\"" << out.str() << "\"" << endl;
+        CHECK( out.str() == "prefix" + source );
+        CHECK( source.find(" + 3 2)") != string::npos );
+        CHECK( source.find("(beam ") != string::npos );
+    }
+
+    TEST_FIXTURE(LdpExporterTestFixture, output_stream_02)
+    {
+        //@02 Numbers formatting
+        CHECK( LdpExporter::color_to_ldp(Color(255, 0, 16, 128)) == "#ff001080" );
+        CHECK( LdpExporter::float_to_string(2.5f) == "2.5" );
+        CHECK( LdpExporter::float_to_string(-30.0f) == "-30" );
+        CHECK( LdpExporter::float_to_string(0.125f) == "0.125" );
+    }
+
 };
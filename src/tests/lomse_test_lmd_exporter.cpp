@@ -449,6 +449,28 @@ SUITE(LmdExporterTest)
         CHECK( source == expected );
     }
 
+    TEST_FIXTURE(LmdExporterTestFixture, lenmusdoc_output_stream)
+    {
+        //source is appended to the caller stream, including the LDP source for
+        //the scores
+        Document doc(m_libraryScope);
+        doc.from_string("<lenmusdoc vers='2.3'><content><ldpmusic>"
+            "(score (vers 2.0)(instrument (musicData (clef G)(n c4 q))))"
+            "</ldpmusic></content></lenmusdoc>", Document::k_format_lmd);
+        ImoDocument* pImoDoc = doc.get_im_root();
+
+        MyLmdExporter exporter(m_libraryScope, "0.12.5", "2012/12/21 13:10:27");
+        exporter.set_score_format(LmdExporter::k_format_ldp);
+        stringstream out;
+        out << "prefix";
+        exporter.get_source(out, pImoDoc);
+        string source = exporter.get_source(pImoDoc);
+//        cout << out.str() << endl;
+        CHECK( out.str() == "prefix" + source );
+        CHECK( source.find("<ldpmusic>") != string::npos );
+        CHECK( source.find("(n c4 q") != string::npos );
+    }
+
     TEST_FIXTURE(LmdExporterTestFixture, lenmusdoc_with_styles)
     {
         Document doc(m_libraryScope);
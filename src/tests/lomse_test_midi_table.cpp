@@ -444,6 +444,45 @@ SUITE(MidiTableTest)
         CHECK( (*it)->DeltaTime == 64.0f );
     }
 
+    TEST_FIXTURE(MidiTableTestFixture, EventsSorted_large_score)
+    {
+        //@201. Events of a large score are sorted by time, measure and type, and the
+        //      events index is valid after storage grows
+
+        stringstream src;
+        src << "(score (vers 2.0)(instrument (musicData (clef G)(time 4 4)";
+        for (int i=0; i < 500; ++i)
+            src << "(chord (n c4 q)(n e4 q)(n g4 q))(n d4 q)(r q)(n e4 q)(barline)";
+        src << ")))";
+
+        Document doc(m_libraryScope);
+        doc.from_string(src.str());
+        ImoScore* pScore = static_cast<ImoScore*>( doc.get_im_root()->get_content_item(0) );
+        MySoundEventsTable table(pScore);
+        table.create_table();
+
+        std::vector<SoundEvent*>& events = table.get_events();
+        //prog_instr, rhythm change, 12 events per measure and end_of_score
+        CHECK( table.num_events() == 1 + 1 + 500 * 12 + 1 );
+        CHECK( table.get_num_measures() == 500 );
+        bool fSorted = true;
+        for (int i=1; i < table.num_events() - 1; ++i)
+        {
+            SoundEvent* pPrev = events[i-1];
+            SoundEvent* pEv = events[i];
+            if (pPrev->DeltaTime > pEv->DeltaTime
+                || (pPrev->DeltaTime == pEv->DeltaTime && pPrev->Measure > pEv->Measure)
+                || (pPrev->DeltaTime == pEv->DeltaTime && pPrev->Measure == pEv->Measure
+                    && pPrev->EventType > pEv->EventType) )
+            {
+                fSorted = false;
+            }
+        }
+        CHECK( fSorted );
+        CHECK( events.back()->EventType == SoundEvent::k_end_of_score );
+        CHECK( events[table.get_first_event_for_measure(500)]->Measure == 500 );
+    }
+
 
     //@ Measures table ------------------------------------------------------------------
 
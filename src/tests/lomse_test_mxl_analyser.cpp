@@ -222,6 +222,25 @@ SUITE(MxlAnalyserTest)
 
     //@ score_partwise ------------------------------------------------------------------------
 
+    TEST_FIXTURE(MxlAnalyserTestFixture, MxlAnalyser_name_to_enum)
+    {
+        //@00 tags table is sorted and complete
+        stringstream errormsg;
+        Document doc(m_libraryScope);
+        XmlParser parser;
+        MxlAnalyser a(errormsg, m_libraryScope, &doc, &parser);
+
+        int undefined = a.name_to_enum("unknown-tag");
+        CHECK( a.name_to_enum("notes") == undefined );
+        CHECK( a.name_to_enum("accordion-registration") != undefined );
+        CHECK( a.name_to_enum("note") != undefined );
+        CHECK( a.name_to_enum("part") != undefined );
+        CHECK( a.name_to_enum("part-list") != undefined );
+        CHECK( a.name_to_enum("part") != a.name_to_enum("part-list") );
+        CHECK( a.name_to_enum("score-partwise") != undefined );
+        CHECK( a.name_to_enum("words") != undefined );
+    }
+
     TEST_FIXTURE(MxlAnalyserTestFixture, MxlAnalyser_part_group_)
     {
         //@01 missing mandatory <part-list>. Returns empty document
@@ -102,6 +102,17 @@ SUITE(LdpTextReaderTest)
         CHECK( reader.end_of_data() );
     }
 
+    TEST_FIXTURE(LdpTextReaderTestFixture, TextReaderCanUnreadEOF)
+    {
+        LdpTextReader reader("ab");
+        CHECK( reader.get_next_char() == 'a' );
+        CHECK( reader.get_next_char() == 'b' );
+        CHECK( reader.get_next_char() == EOF );
+        reader.repeat_last_char();
+        CHECK( reader.get_next_char() == EOF );
+        CHECK( reader.end_of_data() );
+    }
+
     TEST_FIXTURE(LdpTextReaderTestFixture, TextReaderKnowsItsLocator)
     {
         LdpTextReader reader("abc");
@@ -185,6 +196,24 @@ SUITE(LdpFileReaderTest)
         CHECK( reader.end_of_data() );
     }
 
+    TEST_FIXTURE(LdpFileReaderTestFixture, FileReaderCountsLines)
+    {
+        LdpFileReader reader(m_scores_path + "00011-empty-fill-page.lms");
+        CHECK( reader.get_line_number() == 1 );
+        while (reader.get_next_char() != 'v');
+        CHECK( reader.get_line_number() == 2 );
+        while (reader.get_next_char() != '.');
+        CHECK( reader.get_line_number() == 2 );
+        while (reader.get_next_char() != 'F');
+        CHECK( reader.get_line_number() == 5 );
+        reader.repeat_last_char();
+        CHECK( reader.get_line_number() == 5 );
+        while (reader.get_next_char() != 0x0a);
+        CHECK( reader.get_line_number() == 6 );
+        reader.repeat_last_char();
+        CHECK( reader.get_line_number() == 5 );
+    }
+
     TEST_FIXTURE(LdpFileReaderTestFixture, FileReaderKnowsItsLocator)
     {
         string loc = m_scores_path + "00011-empty-fill-page.lms";
@@ -103,6 +103,36 @@ SUITE(ScoreAlgorithmsTest)
         CHECK( pNote->get_fpitch() == FPitch("e4") );
     }
 
+    TEST_FIXTURE(ScoreAlgorithmsTestFixture, find_noterest_2)
+    {
+        //note starts before requested timepos. Long note in other instrument
+        Document doc(m_libraryScope);
+        doc.from_string("(score (vers 2.0)"
+            "(instrument (musicData (clef F4)(n c3 w v1)(barline)))"
+            "(instrument (musicData (clef G)(n e4 h v1)(n f4 q v1)(n g4 q v1)(barline)"
+            "(n a4 h v1)(n b4 h v1)(barline)"
+            ")))");
+        ImoScore* pScore =
+            static_cast<ImoScore*>( doc.get_im_root()->get_content_item(0) );
+
+        ImoNote* pNote = static_cast<ImoNote*>(
+                            ScoreAlgorithms::find_noterest_at(pScore, 1, 1, 140.0) );
+        CHECK( pNote != nullptr );
+        CHECK( pNote && pNote->get_fpitch() == FPitch("f4") );
+
+        pNote = static_cast<ImoNote*>(
+                            ScoreAlgorithms::find_noterest_at(pScore, 0, 1, 200.0) );
+        CHECK( pNote != nullptr );
+        CHECK( pNote && pNote->get_fpitch() == FPitch("c3") );
+
+        pNote = static_cast<ImoNote*>(
+                            ScoreAlgorithms::find_noterest_at(pScore, 1, 1, 400.0) );
+        CHECK( pNote != nullptr );
+        CHECK( pNote && pNote->get_fpitch() == FPitch("b4") );
+
+        CHECK( ScoreAlgorithms::find_noterest_at(pScore, 0, 1, 400.0) == nullptr );
+    }
+
     TEST_FIXTURE(ScoreAlgorithmsTestFixture, find_and_classify_021)
     {
         //@021. requested interval starts and ends at same time than existing note
@@ -101,6 +101,9 @@ public:
     GmoBoxSystem* my_get_current_system_box() { return m_pCurBoxSystem; }
     ShapesCreator* my_shapes_creator() { return m_pShapesCreator; }
     void my_engrave_system() { engrave_system(); }
+    int my_get_system_containing_column(int iCol) {
+        return get_system_containing_column(iCol);
+    }
 
     void my_delete_all() { delete_not_used_objects(); }
 };
@@ -894,4 +897,34 @@ SUITE(ScoreLayouterTest)
         scoreLyt.my_delete_all();
     }
 
+    TEST_FIXTURE(ScoreLayouterTestFixture, ScoreLayouter_130)
+    {
+        //@130. System containing a column, from line breaks
+
+        Document doc(m_libraryScope);
+        doc.from_string("(score (vers 2.0) "
+            "(instrument (musicData (clef G)(n c4 q) )))" );
+        GraphicModel gmodel;
+        ImoScore* pImoScore = static_cast<ImoScore*>( doc.get_im_root()->get_content_item(0) );
+        MyScoreLayouter scoreLyt(pImoScore, &gmodel, m_libraryScope);
+        scoreLyt.prepare_to_start_layout();
+        std::vector<int>& breaks = scoreLyt.my_get_line_breaks();
+        breaks.clear();
+        breaks.push_back(0);
+        breaks.push_back(3);
+        breaks.push_back(5);
+        breaks.push_back(9);
+
+        CHECK( scoreLyt.my_get_system_containing_column(0) == 0 );
+        CHECK( scoreLyt.my_get_system_containing_column(2) == 0 );
+        CHECK( scoreLyt.my_get_system_containing_column(3) == 1 );
+        CHECK( scoreLyt.my_get_system_containing_column(4) == 1 );
+        CHECK( scoreLyt.my_get_system_containing_column(5) == 2 );
+        CHECK( scoreLyt.my_get_system_containing_column(8) == 2 );
+        CHECK( scoreLyt.my_get_system_containing_column(9) == 3 );
+        CHECK( scoreLyt.my_get_system_containing_column(20) == 3 );
+
+        scoreLyt.my_delete_all();
+    }
+
 };
@@ -485,4 +485,59 @@ SUITE(ScorePlayerTest)
         CHECK( handler.my_last_event_type() == k_end_of_playback_event );
     }
 
+    TEST_FIXTURE(ScorePlayerTestFixture, Scheduler_AbsoluteDeadlines)
+    {
+        //waits are computed from the start time, not from the previous wait
+        PlaybackScheduler scheduler;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        scheduler.start(0.0);
+        for (int i=1; i <= 10; ++i)
+            scheduler.wait_until(double(i) * 2.5);
+        std::chrono::duration<double, std::milli> elapsed =
+            std::chrono::steady_clock::now() - start;
+
+        CHECK( elapsed.count() >= 25.0 );
+        PlaybackTimingStats stats = scheduler.get_stats();
+        CHECK( stats.numEvents == 10 );
+        CHECK( stats.meanLateness >= 0.0 );
+        CHECK( stats.maxLateness >= stats.meanLateness );
+    }
+
+    TEST_FIXTURE(ScorePlayerTestFixture, Scheduler_Rebase)
+    {
+        //after rebasing, a past score time becomes the current one
+        PlaybackScheduler scheduler;
+        scheduler.start(1000.0);
+        scheduler.rebase(1000.0, 10.0);
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        scheduler.wait_until(15.0);
+        std::chrono::duration<double, std::milli> elapsed =
+            std::chrono::steady_clock::now() - start;
+
+        CHECK( elapsed.count() >= 4.0 );
+        CHECK( elapsed.count() < 500.0 );
+    }
+
+    TEST_FIXTURE(ScorePlayerTestFixture, DoPlay_TimingStatsCollected)
+    {
+        LomseDoorway* pLomse = m_libraryScope.platform_interface();
+        pLomse->set_notify_callback(nullptr, MyScorePlayer::my_callback);
+        SpDocument spDoc( new Document(m_libraryScope) );
+        spDoc->from_string("(lenmusdoc (vers 0.0) (content (score (vers 2.0) "
+            "(instrument (musicData (clef G)(n c4 s)(n d4 s) )) )))" );
+        ImoScore* pScore = static_cast<ImoScore*>( spDoc->get_im_root()->get_content_item(0) );
+        MyMidiServer midi;
+        MyScorePlayer player(m_libraryScope, &midi);
+        PlayerNoGui playGui;
+        player.load_score(pScore, &playGui);
+        int nEvMax = player.my_get_table()->num_events() - 1;
+        player.my_do_play(0, nEvMax, k_play_normal_instrument, k_no_visual_tracking,
+                          k_no_countoff, 240L, nullptr);
+        player.my_wait_for_termination();
+
+        PlaybackTimingStats stats = player.get_timing_stats();
+        CHECK( stats.numEvents > 0 );
+        CHECK( stats.maxLateness >= 0.0 );
+    }
+
 }
@@ -44,6 +44,7 @@
 #include "lomse_graphical_model.h"
 #include "lomse_gm_basic.h"
 #include "lomse_spacing_algorithm_gourlay.h"
+#include "lomse_document_layouter.h"
 
 using namespace UnitTest;
 using namespace std;
@@ -165,6 +166,26 @@ public:
         }
     }
 
+    long merged_columns_for_measures(int numMeasures)
+    {
+        //layout a score with numMeasures and return the number of columns merged
+        //by the lines breaker for computing lines penalties
+
+        stringstream ss;
+        ss << "(score (vers 2.1)(instrument (musicData (clef G)(time 4 4)";
+        for (int i=0; i < numMeasures; ++i)
+            ss << "(n c4 q)(n e4 q)(n g4 q)(n c5 q)(barline)";
+        ss << ")))";
+
+        Document doc(m_libraryScope);
+        doc.from_string(ss.str());
+        DocLayouter layouter(&doc, m_libraryScope);
+        layouter.layout_document();
+        ScoreLayouter* pScoreLyt = layouter.get_score_layouter();
+        SpAlgGourlay* pAlg = static_cast<SpAlgGourlay*>(pScoreLyt->get_spacing_algorithm());
+        return pAlg->get_num_merged_columns();
+    }
+
 
 };
 
@@ -440,4 +461,20 @@ SUITE(SpAlgGourlayTest)
         scoreLyt.my_delete_all();
     }
 
+    TEST_FIXTURE(SpAlgGourlayTestFixture, SpAlgGourlay_06)
+    {
+        //@ 06. Lines breaker cost. Only columns that fit in a line are tried and
+        //@     merged data for a line is reused for next line. Thus, the number of
+        //@     merged columns grows linearly with the number of columns.
+
+        long merged50 = merged_columns_for_measures(50);
+        long merged200 = merged_columns_for_measures(200);
+
+        CHECK( merged50 > 0 );
+        CHECK( merged200 < 6 * merged50 );
+
+//        cout << test_name() << ": merged columns for 50 measures= " << merged50
+//             << ", for 200 measures= " << merged200 << endl;
+    }
+
 };
@@ -42,6 +42,10 @@
 #include "lomse_score_iterator.h"
 #include "lomse_model_builder.h"
 #include "lomse_time.h"
+#include "lomse_measures_table.h"
+#include "lomse_im_algorithms.h"
+
+#include <set>
 
 using namespace UnitTest;
 using namespace std;
@@ -1363,6 +1367,290 @@ SUITE(ColStaffObjsBuilderTest)
         if (pRoot && !pRoot->is_document()) delete pRoot;
     }
 
+    TEST_FIXTURE(ColStaffObjsBuilderTestFixture, ColStaffObjsIndexedAccess)
+    {
+        Document doc(m_libraryScope);
+        doc.from_string("(score (vers 2.0)(instrument (musicData "
+            "(clef G)(n c4 q)(n d4 e)(n e4 e)(barline)(n f4 h)(n g4 h)(barline)"
+            ")))");
+        ImoScore* pScore =
+            static_cast<ImoScore*>( doc.get_im_root()->get_content_item(0) );
+        ColStaffObjs* pTable = pScore->get_staffobjs_table();
+
+        CHECK( pTable->num_entries() == 8 );
+        ColStaffObjsIterator it = pTable->begin();
+        for (int i=0; it != pTable->end(); ++it, ++i)
+        {
+            CHECK( pTable->get_entry(i) == *it );
+            CHECK( pTable->get_index_of(*it) == i );
+            CHECK( *(pTable->find((*it)->imo_object())) == *it );
+        }
+        CHECK( pTable->get_entry(8) == nullptr );
+        CHECK( is_equal_time(pTable->max_note_duration(), 128.0) );
+
+        it = pTable->find_first_at_or_after(100.0);
+        CHECK( (*it)->imo_object()->is_barline() );
+        CHECK( is_equal_time((*it)->time(), 128.0) );
+        it = pTable->find_first_at_or_after(200.0);
+        CHECK( (*it)->imo_object()->is_note() );
+        CHECK( is_equal_time((*it)->time(), 256.0) );
+        CHECK( pTable->find_first_at_or_after(600.0) == pTable->end() );
+    }
+
+    TEST_FIXTURE(ColStaffObjsBuilderTestFixture, ColStaffObjsIndexUpdatedAfterDelete)
+    {
+        Document doc(m_libraryScope);
+        doc.from_string("(score (vers 2.0)(instrument (musicData "
+            "(clef G)(n c4 q)(n d4 e)(n e4 e)(barline)"
+            ")))");
+        ImoScore* pScore =
+            static_cast<ImoScore*>( doc.get_im_root()->get_content_item(0) );
+        ColStaffObjs* pTable = pScore->get_staffobjs_table();
+        ImoStaffObj* pSO = pTable->get_entry(1)->imo_object();
+
+        pTable->delete_entry_for(pSO);
+
+        CHECK( pTable->num_entries() == 4 );
+        CHECK( pTable->find(pSO) == pTable->end() );
+        CHECK( pTable->get_entry(1)->imo_object()->is_note() );
+        CHECK( pTable->get_index_of(pTable->back()) == 3 );
+        CHECK( pTable->get_entry(4) == nullptr );
+    }
+
+    TEST_FIXTURE(ColStaffObjsBuilderTestFixture, ColStaffObjsIndexByInstrument)
+    {
+        Document doc(m_libraryScope);
+        doc.from_string("(score (vers 2.0)"
+            "(instrument (staves 2)(musicData (clef G p1)(clef F4 p2)(time 2 4)"
+            "(n c4 q p1)(n e4 q)(barline)(n f4 h)(barline)(time 3 8)(n g4 q.)(barline)))"
+            "(instrument (musicData (clef G)(n c4 h)(barline)(n c4 h)(barline)))"
+            ")");
+        ImoScore* pScore =
+            static_cast<ImoScore*>( doc.get_im_root()->get_content_item(0) );
+        ColStaffObjs* pTable = pScore->get_staffobjs_table();
+
+        ColStaffObjsIterator it = pTable->find_barline_for_measure(0, 1);
+        CHECK( it != pTable->end() );
+        CHECK( (*it)->imo_object()->is_barline() );
+        CHECK( (*it)->num_instrument() == 0 );
+        CHECK( is_equal_time((*it)->time(), 256.0) );
+        CHECK( pTable->find_barline_for_measure(1, 2) == pTable->end() );
+        CHECK( pTable->find_barline_for_measure(2, 0) == pTable->end() );
+
+        ColStaffObjsEntry* pEntry = pTable->find_time_signature_before(0, *it);
+        CHECK( pEntry && is_equal_time(pEntry->time(), 0.0) );
+        pEntry = pTable->find_time_signature_before(0, nullptr);
+        CHECK( pEntry && is_equal_time(pEntry->time(), 256.0) );
+        CHECK( pTable->find_time_signature_before(1, nullptr) == nullptr );
+        ColStaffObjsIterator itTS = pTable->find_first(pEntry->imo_object());
+        CHECK( (*itTS)->staff() == 0 );
+        CHECK( *(pTable->find(pEntry->imo_object())) == pEntry );
+        pEntry = pTable->find_barline_before(0, *it);
+        CHECK( pEntry && is_equal_time(pEntry->time(), 128.0) );
+        CHECK( pTable->find_barline_before(0, pEntry) == nullptr );
+
+        it = pTable->find_first_in_staff(0, 1);
+        CHECK( (*it)->imo_object()->is_clef() );
+        CHECK( (*it)->staff() == 1 );
+        it = pTable->find_first_in_staff(1, 0);
+        CHECK( (*it)->imo_object()->is_clef() );
+        CHECK( (*it)->num_instrument() == 1 );
+    }
+
+    TEST_FIXTURE(ColStaffObjsBuilderTestFixture, ColStaffObjsUpdateAfterInsertion)
+    {
+        Document doc(m_libraryScope);
+        doc.from_string("(score (vers 2.0)"
+            "(instrument (musicData (clef G)(n c4 q)(n d4 q)(barline)"
+                "(n e4 q)(n f4 q)(barline)))"
+            "(instrument (musicData (clef F4)(n c3 h)(barline)"
+                "(n e3 q)(n f3 q)(barline)))"
+            ")");
+        ImoScore* pScore =
+            static_cast<ImoScore*>( doc.get_im_root()->get_content_item(0) );
+        ColStaffObjs* pTable = pScore->get_staffobjs_table();
+        ImoInstrument* pInstr = pScore->get_instrument(0);
+        ImoStaffObj* pAt =
+            static_cast<ImoStaffObj*>( pInstr->get_musicdata()->get_child(4) );  //(n e4 q)
+        CHECK( pAt->is_note() );
+
+        stringstream errormsg;
+        pInstr->insert_staff_objects_at(pAt, "(n g4 e)(n a4 e)", errormsg);
+        pScore->end_of_changes(pInstr);
+
+//        cout << test_name() << endl;
+//        cout << pTable->dump();
+        ColStaffObjsBuilder builder;
+        CHECK( pScore->get_staffobjs_table() == pTable );
+        CHECK( pTable->num_entries() == 15 );
+        CHECK( builder.verify(pScore) == true );
+        CHECK( is_equal_time(pTable->back()->time(), 320.0) );
+    }
+
+    TEST_FIXTURE(ColStaffObjsBuilderTestFixture, ColStaffObjsUpdateAfterDeletion)
+    {
+        Document doc(m_libraryScope);
+        doc.from_string("(score (vers 2.0)"
+            "(instrument (musicData (clef G)(n c4 q)(n d4 q)(barline)"
+                "(n e4 q)(n f4 q)(barline)))"
+            "(instrument (musicData (clef F4)(n c3 q)(n d3 q)(barline)"
+                "(n e3 q)(n f3 q)(barline)))"
+            ")");
+        ImoScore* pScore =
+            static_cast<ImoScore*>( doc.get_im_root()->get_content_item(0) );
+        ColStaffObjs* pTable = pScore->get_staffobjs_table();
+        ImoInstrument* pInstr = pScore->get_instrument(1);
+        ImoStaffObj* pSO = pTable->get_entry(3)->imo_object();    //(n c3 q)
+        CHECK( pSO->is_note() );
+
+        //staffobj deleted without removing its entry
+        pInstr->get_musicdata()->remove_child(pSO);
+        delete pSO;
+        ColStaffObjsBuilder builder;
+        CHECK( builder.update(pScore, 1) == true );
+
+//        cout << test_name() << endl;
+//        cout << pTable->dump();
+        CHECK( pTable->num_entries() == 13 );
+        CHECK( builder.verify(pScore) == true );
+        CHECK( pTable->find_first_at_or_after(192.0) != pTable->end() );
+    }
+
+    TEST_FIXTURE(ColStaffObjsBuilderTestFixture, ColStaffObjsUpdateRebuildsWhenLinesChange)
+    {
+        Document doc(m_libraryScope);
+        doc.from_string("(score (vers 2.0)"
+            "(instrument (musicData (clef G)(n c4 q)(n d4 q)(barline)))"
+            "(instrument (musicData (clef F4)(n c3 h)(barline)))"
+            ")");
+        ImoScore* pScore =
+            static_cast<ImoScore*>( doc.get_im_root()->get_content_item(0) );
+        ImoInstrument* pInstr = pScore->get_instrument(0);
+        ImoStaffObj* pAt =
+            static_cast<ImoStaffObj*>( pInstr->get_musicdata()->get_child(3) );
+        CHECK( pAt->is_barline() );
+
+        //a second voice requires a new line. Next instrument lines change
+        stringstream errormsg;
+        pInstr->insert_staff_objects_at(pAt, "(n e4 h v2)", errormsg);
+        ColStaffObjsBuilder builder;
+        CHECK( builder.update(pScore, 0) == false );
+        CHECK( builder.verify(pScore) == true );
+        CHECK( pScore->get_staffobjs_table()->num_lines() == 3 );
+    }
+
+    TEST_FIXTURE(ColStaffObjsBuilderTestFixture, ColStaffObjsUpdateOnlyChangedMeasures)
+    {
+        Document doc(m_libraryScope);
+        doc.from_string("(score (vers 2.0)"
+            "(instrument (musicData (clef G)(n c4 q)(n d4 q)(barline)"
+                "(n e4 q)(n f4 q)(barline)(n g4 q)(n a4 q)(barline)"
+                "(n b4 q)(n c5 q)(barline)))"
+            "(instrument (musicData (clef F4)(n c3 h)(barline)"
+                "(n e3 h)(barline)(n g3 h)(barline)(n b3 h)(barline)))"
+            ")");
+        ImoScore* pScore =
+            static_cast<ImoScore*>( doc.get_im_root()->get_content_item(0) );
+        ColStaffObjs* pTable = pScore->get_staffobjs_table();
+        ImoInstrument* pInstr = pScore->get_instrument(0);
+        ImMeasuresTable* pMeasures = pInstr->get_measures_table();
+        CHECK( pMeasures->num_entries() == 4 );
+
+        std::vector< pair<ImoStaffObj*, ColStaffObjsEntry*> > oldEntries;
+        for (ColStaffObjsEntry* pEntry = pTable->front(); pEntry; pEntry = pEntry->get_next())
+            oldEntries.push_back( make_pair(pEntry->imo_object(), pEntry) );
+        std::vector<ImMeasuresTableEntry*> oldMeasures;
+        for (int i=0; i < pMeasures->num_entries(); ++i)
+            oldMeasures.push_back( pMeasures->get_measure(i) );
+        ImoMusicData* pMD = pInstr->get_musicdata();
+        ImoStaffObj* pAt = static_cast<ImoStaffObj*>( pMD->get_child(5) );  //(n f4 q)
+        ImoStaffObj* pNext = static_cast<ImoStaffObj*>( pMD->get_child(10) );    //(n b4 q)
+        int nextOrder = (*pTable->find(pNext))->order();
+
+        //entries are replaced from first barline up to next barline
+        std::set<ImoObj*> replaced;
+        for (int i=4; i <= 6; ++i)
+            replaced.insert( pMD->get_child(i) );   //(n e4 q) to (barline)
+
+        ImoTreeAlgoritms::insert_staffobjs(pInstr, pAt, "(clef F4)");
+
+//        cout << test_name() << endl;
+//        cout << pTable->dump();
+        ColStaffObjsBuilder builder;
+        CHECK( pScore->get_staffobjs_table() == pTable );
+        CHECK( pTable->num_entries() == 23 );
+        CHECK( builder.verify(pScore) == true );
+
+        std::vector< pair<ImoStaffObj*, ColStaffObjsEntry*> >::iterator it;
+        int numKept = 0;
+        for (it = oldEntries.begin(); it != oldEntries.end(); ++it)
+        {
+            if (replaced.find(it->first) == replaced.end())
+            {
+                CHECK( *(pTable->find(it->first)) == it->second );
+                ++numKept;
+            }
+        }
+        CHECK( numKept == 19 );
+        CHECK( (*pTable->find(pNext))->order() == nextOrder + 1 );
+
+        //only the modified measure is replaced in the measures table
+        CHECK( pMeasures->num_entries() == 4 );
+        CHECK( pMeasures->get_measure(0) == oldMeasures[0] );
+        CHECK( pMeasures->get_measure(1) != oldMeasures[1] );
+        CHECK( pMeasures->get_measure(1)->get_table_index() == 1 );
+        CHECK( pMeasures->get_measure(2) == oldMeasures[2] );
+        CHECK( pMeasures->get_measure(3) == oldMeasures[3] );
+    }
+
+    TEST_FIXTURE(ColStaffObjsBuilderTestFixture, ColStaffObjsUpdateShiftsNextMeasures)
+    {
+        Document doc(m_libraryScope);
+        doc.from_string("(score (vers 2.0)"
+            "(instrument (musicData (clef G)(key D)(time 2 4)(n c4 q)(n d4 q)(barline)"
+                "(n f4 q)(n +f4 q)(barline)(n f4 q)(n a4 q)(barline)"
+                "(n g4 h)(barline)))"
+            "(instrument (musicData (clef F4)(key D)(time 2 4)(n c3 h)(barline)"
+                "(n e3 h)(barline)(n g3 h)(barline)(n b3 h)(barline)))"
+            ")");
+        ImoScore* pScore =
+            static_cast<ImoScore*>( doc.get_im_root()->get_content_item(0) );
+        ColStaffObjs* pTable = pScore->get_staffobjs_table();
+        ImoInstrument* pInstr = pScore->get_instrument(0);
+        ImoMusicData* pMD = pInstr->get_musicdata();
+        ImoNote* pNote = static_cast<ImoNote*>( pMD->get_child(9) );  //(n f4 q)
+        CHECK( pNote->get_notated_accidentals() == k_no_accidentals );
+
+        //new measure: next measures and times shift
+        ImoTreeAlgoritms::insert_staffobjs(pInstr, pNote, "(n g4 h)(barline)");
+
+//        cout << test_name() << endl;
+//        cout << pTable->dump();
+        ColStaffObjsBuilder builder;
+        CHECK( builder.verify(pScore) == true );
+        CHECK( (*pTable->find(pNote))->measure() == 3 );
+        CHECK( is_equal_time(pNote->get_time(), 384.0) );
+        CHECK( pNote->get_notated_accidentals() == k_no_accidentals );
+        ImMeasuresTable* pMeasures = pInstr->get_measures_table();
+        CHECK( pMeasures->num_entries() == 5 );
+        for (int i=0; i < pMeasures->num_entries(); ++i)
+        {
+            ImMeasuresTableEntry* pMeasure = pMeasures->get_measure(i);
+            CHECK( pMeasure->get_table_index() == i );
+            CHECK( pMeasure->get_entry()->measure() == i );
+            CHECK( is_equal_time(pMeasure->get_timepos(), 128.0 * i) );
+        }
+
+        //new key: the key for next measures changes
+        ImoTreeAlgoritms::insert_staffobjs(pInstr, pNote, "(key C)");
+
+        CHECK( builder.verify(pScore) == true );
+        CHECK( pNote->get_notated_accidentals() == k_sharp );
+        pMeasures = pInstr->get_measures_table();
+        CHECK( pMeasures->get_measure(3)->get_key()->get_key_type() == k_key_D );
+        CHECK( pMeasures->get_measure(4)->get_key()->get_key_type() == k_key_C );
+    }
+
     TEST_FIXTURE(ColStaffObjsBuilderTestFixture, ColStaffObjsAssigLineToClef)
     {
         Document doc(m_libraryScope);
@@ -29,6 +29,7 @@
 
 #include <UnitTest++.h>
 #include <sstream>
+#include <thread>
 #include "lomse_build_options.h"
 
 //classes related to these tests
@@ -38,6 +39,7 @@
 #include "lomse_text_engraver.h"
 #include "lomse_document.h"
 #include "lomse_score_meter.h"
+#include "lomse_font_storage.h"
 
 using namespace UnitTest;
 using namespace std;
@@ -93,6 +95,57 @@ SUITE(TextEngraverTest)
         CHECK( width > 0.0f );
     }
 
+    TEST_FIXTURE(TextEngraverTestFixture, TextEngraver_MeasureWidthInOtherThread)
+    {
+        //each thread uses its own FontStorage but measurements must be the same
+        string text("This is a test");
+        TextMeter meter(m_libraryScope);
+        meter.select_font("en", "", "Liberation serif", 12.0);
+        LUnits width = meter.measure_width(text);
+        URect box = meter.bounding_rectangle('T');
+
+        FontStorage* pFonts = m_libraryScope.font_storage();
+        bool fOtherFonts = false;
+        LUnits otherWidth = 0.0f;
+        URect otherBox;
+        std::thread worker([&]() {
+            fOtherFonts = (m_libraryScope.font_storage() != pFonts);
+            TextMeter otherMeter(m_libraryScope);
+            otherMeter.select_font("en", "", "Liberation serif", 12.0);
+            otherWidth = otherMeter.measure_width(text);
+            otherBox = otherMeter.bounding_rectangle('T');
+        });
+        worker.join();
+
+        CHECK( fOtherFonts );
+        CHECK( width > 0.0f );
+        CHECK( otherWidth == width );
+        CHECK( box.width > 0.0f );
+        CHECK( otherBox.x == box.x );
+        CHECK( otherBox.y == box.y );
+        CHECK( otherBox.width == box.width );
+        CHECK( otherBox.height == box.height );
+    }
+
+    TEST_FIXTURE(TextEngraverTestFixture, TextEngraver_MeterUsesStorageOfCallingThread)
+    {
+        //a TextMeter does not keep the FontStorage of the thread that created it
+        TextMeter meter(m_libraryScope);
+        meter.select_font("en", "", "Liberation serif", 12.0);
+        LUnits height = meter.get_font_height();
+
+        LUnits otherHeight = 0.0f;
+        std::thread worker([&]() {
+            meter.select_font("en", "", "Liberation serif", 24.0);
+            otherHeight = meter.get_font_height();
+        });
+        worker.join();
+
+        CHECK( height > 0.0f );
+        CHECK( otherHeight > height );
+        CHECK( meter.get_font_height() == height );
+    }
+
 }
 
 
@@ -39,6 +39,10 @@
 #include "lomse_doorway.h"
 #include "lomse_screen_drawer.h"
 #include "lomse_interactor.h"
+#include "lomse_graphical_model.h"
+#include "lomse_im_note.h"
+#include "lomse_staffobjs_table.h"
+#include "lomse_gm_basic.h"
 
 using namespace UnitTest;
 using namespace std;
@@ -140,6 +144,60 @@ public:
 SUITE(GraphicViewTest)
 {
 
+    bool same_pixels_but_last_row_and_column(vector<int8u>& bytes1,
+                                             vector<int8u>& bytes2,
+                                             unsigned width, unsigned height)
+    {
+        for (unsigned y=0; y < height - 1; ++y)
+        {
+            size_t start = size_t(y * width) * 4;
+            if (memcmp(&bytes1[start], &bytes2[start], (width - 1) * 4) != 0)
+                return false;
+        }
+        return true;
+    }
+
+    //-----------------------------------------------------------------------------------
+    bool culled_render_as_unculled(LibraryScope& libraryScope, SpDocument& spDoc,
+                                   GraphicView* pView1, vector<int8u>& bytes1,
+                                   unsigned width1, URect area)
+    {
+        //Renders in a second view the area of page 0 and compares it with the bitmap
+        //already rendered by pView1, with its viewport at (0,0). As the renderer
+        //does not paint the last row and column, they are not compared
+
+        double xLeft = double(area.left());
+        double yTop = double(area.top());
+        double xRight = double(area.right());
+        double yBottom = double(area.bottom());
+        pView1->model_point_to_screen(&xLeft, &yTop, 0);
+        pView1->model_point_to_screen(&xRight, &yBottom, 0);
+        const unsigned width2 = unsigned(xRight - xLeft);
+        const unsigned height2 = unsigned(yBottom - yTop);
+        if (width2 < 3 || height2 < 3)
+            return false;
+
+        vector<int8u> bytes2(width2 * height2 * 4, 0);
+        RenderingBuffer rbuf2(&bytes2[0], width2, height2, width2 * 4);
+        VerticalBookView* pView2 = Injector::inject_VerticalBookView(libraryScope, spDoc.get());
+        Interactor* pIntor2 = Injector::inject_Interactor(libraryScope, spDoc, pView2, nullptr);
+        pView2->set_interactor(pIntor2);
+        pView2->set_rendering_buffer(&rbuf2);
+        pView2->new_viewport(Pixels(xLeft), Pixels(yTop));
+        pView2->redraw_bitmap();
+
+        bool fEqual = true;
+        for (unsigned y=0; y < height2 - 1 && fEqual; ++y)
+        {
+            size_t start1 = size_t((y + unsigned(yTop)) * width1 + unsigned(xLeft)) * 4;
+            size_t start2 = size_t(y * width2) * 4;
+            fEqual = memcmp(&bytes1[start1], &bytes2[start2], (width2 - 1) * 4) == 0;
+        }
+
+        delete pIntor2;
+        return fEqual;
+    }
+
     //-- coordinates conversion ---------------------------------------------------------
 
     TEST_FIXTURE(GraphicViewTestFixture, EditView_ScreenPointToPage_None)
@@ -571,6 +629,222 @@ SUITE(GraphicViewTest)
         rectangles.clear();
     }
 
+
+    //-- overlays -----------------------------------------------------------------------
+
+    TEST_FIXTURE(GraphicViewTestFixture, overlays_restore_only_damaged_area)
+    {
+        //when an overlay is moved only the area covered by previous overlays is
+        //restored from the clean copy of the rendering buffer. Rows are padded
+
+        MyDoorway platform;
+        LibraryScope libraryScope(cout, &platform);
+        SpDocument spDoc( new Document(libraryScope) );
+        spDoc->from_string("(lenmusdoc (vers 0.0) (content (score (vers 1.6) "
+            "(instrument (musicData (clef G)(key e)(n c4 q)(r q)(barline simple))))))" );
+        VerticalBookView* pView = Injector::inject_VerticalBookView(libraryScope, spDoc.get());
+        Interactor* pIntor = Injector::inject_Interactor(libraryScope, spDoc, pView, nullptr);
+        pView->set_interactor(pIntor);
+
+        const unsigned width = 400;
+        const unsigned height = 400;
+        const unsigned stride = width * 4 + width;
+        vector<int8u> bytes(stride * height, 0);
+        RenderingBuffer rbuf(&bytes[0], width, height, stride);
+        pView->set_rendering_buffer(&rbuf);
+        pView->redraw_bitmap();
+        vector<int8u> clean(bytes);
+
+        //draw a selection rectangle and take note of its top-left corner
+        pView->start_selection_rectangle(2000.0, 2000.0);
+        pView->update_selection_rectangle(4000.0, 4000.0);
+        pView->draw_selection_rectangle();
+        double vx = 2000.0;
+        double vy = 2000.0;
+        pIntor->model_point_to_screen(&vx, &vy, 0);
+        size_t corner = size_t(vy) * stride + size_t(vx) * 4;
+        CHECK( memcmp(&bytes[corner], &clean[corner], 4) != 0 );
+
+        //modify a pixel far from any overlay
+        size_t other = 1 * stride + 1 * 4;
+        bytes[other] = int8u(~clean[other]);
+
+        //move the selection rectangle
+        pView->start_selection_rectangle(6000.0, 6000.0);
+        pView->update_selection_rectangle(8000.0, 8000.0);
+        pView->draw_selection_rectangle();
+
+        CHECK( memcmp(&bytes[corner], &clean[corner], 4) == 0 );
+        CHECK( bytes[other] == int8u(~clean[other]) );
+
+        delete pIntor;
+    }
+
+    //-- viewport culling ---------------------------------------------------------------
+
+    TEST_FIXTURE(GraphicViewTestFixture, culled_render_as_unculled_render)
+    {
+        //pixels inside the viewport do not depend on the shapes culled. Slurs, ties
+        //and barlines only set the fill color of their paths, so they must not
+        //inherit the stroke attributes of the shape drawn before them
+
+        MyDoorway platform;
+        LibraryScope libraryScope(cout, &platform);
+        libraryScope.set_default_fonts_path(TESTLIB_FONTS_PATH);
+        SpDocument spDoc( new Document(libraryScope) );
+        spDoc->from_string("(lenmusdoc (vers 0.0) (content (score (vers 2.0) "
+            "(instrument (staves 2)(musicData (clef G p1)(clef F4 p2)(time 2 4)"
+            "(n g5 q p1 (stem down)(slur 1 start))(n g5 q (stem down)(slur 1 stop))"
+            "(barline)"
+            "(n g5 q (stem down)(tie 2 start))(n g5 q (stem down)(tie 2 stop))"
+            "(barline))))))" );
+
+        //view 1 draws the whole system
+        const unsigned width1 = 600;
+        const unsigned height1 = 400;
+        vector<int8u> bytes1(width1 * height1 * 4, 0);
+        RenderingBuffer rbuf1(&bytes1[0], width1, height1, width1 * 4);
+        VerticalBookView* pView1 = Injector::inject_VerticalBookView(libraryScope, spDoc.get());
+        Interactor* pIntor1 = Injector::inject_Interactor(libraryScope, spDoc, pView1, nullptr);
+        pView1->set_interactor(pIntor1);
+        pView1->set_rendering_buffer(&rbuf1);
+        pView1->new_viewport(0, 0);
+        pView1->redraw_bitmap();
+
+        //central part of the slur, placed above the staff
+        ImoScore* pScore = static_cast<ImoScore*>(
+                                    spDoc->get_im_root()->get_content_item(0) );
+        ColStaffObjsIterator it = pScore->get_staffobjs_table()->begin();
+        while (!(*it)->imo_object()->is_note())
+            ++it;
+        ImoNote* pNote = static_cast<ImoNote*>( (*it)->imo_object() );
+        ImoRelObj* pSlur = pNote->find_relation(k_imo_slur);
+        CHECK( pSlur != nullptr );
+        GraphicModel* pGModel = pIntor1->get_graphic_model();
+        URect bounds = pGModel->get_main_shape_for_imo(pSlur->get_id())->get_bounds();
+        URect slurArea(bounds.left() + bounds.width / 4.0f, bounds.top(),
+                       bounds.width / 2.0f, bounds.height);
+        CHECK( culled_render_as_unculled(libraryScope, spDoc, pView1, bytes1, width1,
+                                         slurArea) );
+
+        //first barline, between both staves
+        while (!(*it)->imo_object()->is_barline())
+            ++it;
+        bounds = pGModel->get_main_shape_for_imo((*it)->imo_object()->get_id())->get_bounds();
+        URect barlineArea(bounds.left() - 100.0f,
+                          bounds.top() + bounds.height * 0.45f,
+                          bounds.width + 200.0f, bounds.height * 0.1f);
+        CHECK( culled_render_as_unculled(libraryScope, spDoc, pView1, bytes1, width1,
+                                         barlineArea) );
+
+        delete pIntor1;
+    }
+
+    //-- tiles cache --------------------------------------------------------------------
+
+    TEST_FIXTURE(GraphicViewTestFixture, tiles_cache_renders_as_without_cache)
+    {
+        //rendering from cached tiles produces the same bitmap, also after scrolling.
+        //Shapes crossing tile borders, such as slurs, ties and staff lines, are
+        //culled in some tiles.
+        //AWARE: the renderer does not paint the last row and column of the rendering
+        //buffer but tiles are copied there. Therefore, they are not compared.
+
+        MyDoorway platform;
+        LibraryScope libraryScope(cout, &platform);
+        libraryScope.set_default_fonts_path(TESTLIB_FONTS_PATH);
+        SpDocument spDoc( new Document(libraryScope) );
+        spDoc->from_string("(lenmusdoc (vers 0.0) (content (score (vers 2.0) "
+            "(instrument (musicData (clef G)(key e)(time 2 4)"
+            "(n c4 q (slur 1 start))(n e4 q)(barline)"
+            "(n g4 q (slur 1 stop))(n c5 q (tie 2 start))(barline)"
+            "(n c5 q (tie 2 stop))(n e5 q (slur 3 start))(barline)"
+            "(n c5 q (slur 3 stop))(r q)(barline))))))" );
+
+        const unsigned width = 300;
+        const unsigned height = 200;
+        vector<int8u> bytes1(width * height * 4, 0);
+        vector<int8u> bytes2(width * height * 4, 0);
+        RenderingBuffer rbuf1(&bytes1[0], width, height, width * 4);
+        RenderingBuffer rbuf2(&bytes2[0], width, height, width * 4);
+
+        VerticalBookView* pView1 = Injector::inject_VerticalBookView(libraryScope, spDoc.get());
+        Interactor* pIntor1 = Injector::inject_Interactor(libraryScope, spDoc, pView1, nullptr);
+        pView1->set_interactor(pIntor1);
+        pView1->set_rendering_buffer(&rbuf1);
+
+        VerticalBookView* pView2 = Injector::inject_VerticalBookView(libraryScope, spDoc.get());
+        Interactor* pIntor2 = Injector::inject_Interactor(libraryScope, spDoc, pView2, nullptr);
+        pView2->set_interactor(pIntor2);
+        pView2->set_rendering_buffer(&rbuf2);
+        pIntor2->enable_tiles_cache(true);
+        CHECK( pView2->is_tiles_cache_enabled() == true );
+
+        pView1->new_viewport(-10, 30);
+        pView2->new_viewport(-10, 30);
+        pView1->redraw_bitmap();
+        pView2->redraw_bitmap();
+        CHECK( same_pixels_but_last_row_and_column(bytes1, bytes2, width, height) );
+
+        pView1->new_viewport(120, 250);
+        pView2->new_viewport(120, 250);
+        pView1->redraw_bitmap();
+        pView2->redraw_bitmap();
+        CHECK( same_pixels_but_last_row_and_column(bytes1, bytes2, width, height) );
+
+        delete pIntor1;
+        delete pIntor2;
+    }
+
+    TEST_FIXTURE(GraphicViewTestFixture, rendering_in_bands_as_single_thread)
+    {
+        //rendering in parallel bands produces the same bitmap than a single thread
+
+        MyDoorway platform;
+        LibraryScope libraryScope1(cout, &platform);
+        libraryScope1.set_default_fonts_path(TESTLIB_FONTS_PATH);
+        LibraryScope libraryScope2(cout, &platform);
+        libraryScope2.set_default_fonts_path(TESTLIB_FONTS_PATH);
+        libraryScope2.set_rendering_threads(4);
+
+        const char* src = "(lenmusdoc (vers 0.0) (content (score (vers 1.6) "
+            "(instrument (musicData (clef G)(key e)(time 2 4)"
+            "(n c4 e g+ (slur 1 start))(n e4 e g-)(n g4 q (slur 1 stop))"
+            "(barline simple)(n a5 s g+)(n g5 s)(n f5 s)(n e5 s g-)"
+            "(n d5 q (tie 1 start))(barline simple)(n d5 h (tie 1 stop))"
+            "(barline end))))))";
+        SpDocument spDoc1( new Document(libraryScope1) );
+        spDoc1->from_string(src);
+        SpDocument spDoc2( new Document(libraryScope2) );
+        spDoc2->from_string(src);
+
+        const unsigned width = 600;
+        const unsigned height = 800;
+        vector<int8u> bytes1(width * height * 4, 0);
+        vector<int8u> bytes2(width * height * 4, 0);
+        RenderingBuffer rbuf1(&bytes1[0], width, height, width * 4);
+        RenderingBuffer rbuf2(&bytes2[0], width, height, width * 4);
+
+        VerticalBookView* pView1 = Injector::inject_VerticalBookView(libraryScope1, spDoc1.get());
+        Interactor* pIntor1 = Injector::inject_Interactor(libraryScope1, spDoc1, pView1, nullptr);
+        pView1->set_interactor(pIntor1);
+        pView1->set_rendering_buffer(&rbuf1);
+
+        VerticalBookView* pView2 = Injector::inject_VerticalBookView(libraryScope2, spDoc2.get());
+        Interactor* pIntor2 = Injector::inject_Interactor(libraryScope2, spDoc2, pView2, nullptr);
+        pView2->set_interactor(pIntor2);
+        pView2->set_rendering_buffer(&rbuf2);
+
+        pView1->set_scale(3.0);
+        pView2->set_scale(3.0);
+        pView1->redraw_bitmap();
+        pView2->redraw_bitmap();
+        CHECK( bytes1 == bytes2 );
+
+        delete pIntor1;
+        delete pIntor2;
+    }
+
     //TEST_FIXTURE(GraphicViewTestFixture, EditView_UpdateWindow)
     //{
     //    MyDoorway platform;
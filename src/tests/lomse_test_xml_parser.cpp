@@ -34,6 +34,7 @@
 //classes related to these tests
 #include "lomse_injectors.h"
 #include "lomse_xml_parser.h"
+#include "lomse_file_system.h"
 
 using namespace UnitTest;
 using namespace std;
@@ -151,6 +152,40 @@ SUITE(XmlParserTest)
 
     }
 
+#if (LOMSE_ENABLE_COMPRESSION == 1)
+    TEST_FIXTURE(XmlParserTestFixture, read_doc_from_zip_stream)
+    {
+        string path = m_scores_path + "10014-compressed-flat-lmd.zip#zip:lenmusdoc-example.lmd";
+        InputStream* file = FileSystem::open_input_stream(path);
+        long size = 8364L;      //uncompressed size of lenmusdoc-example.lmd
+
+        XmlParser parser;
+        parser.parse_stream(file, size);
+        XmlNode* root = parser.get_tree_root();
+
+        CHECK( parser.get_error() == "" );
+        CHECK( root->name() == "lenmusdoc" );
+        CHECK( root->first_child().name() == "styles" );
+        delete file;
+    }
+#endif
+
+    TEST_FIXTURE(XmlParserTestFixture, find_xml_tag)
+    {
+        static const XmlTagName table[] = {
+            { "beam",       1 },
+            { "note",       2 },
+            { "note-size",  3 },
+            { "rest",       4 },
+        };
+        CHECK( find_xml_tag(table, "beam", 0) == 1 );
+        CHECK( find_xml_tag(table, "note", 0) == 2 );
+        CHECK( find_xml_tag(table, "note-size", 0) == 3 );
+        CHECK( find_xml_tag(table, "rest", 0) == 4 );
+        CHECK( find_xml_tag(table, "not", 0) == 0 );
+        CHECK( find_xml_tag(table, "aaa", 0) == 0 );
+        CHECK( find_xml_tag(table, "zzz", 0) == 0 );
+    }
 
 };
 
@@ -271,6 +271,33 @@ SUITE(ZipInputStreamTest)
         delete file;
     }
 
+    TEST_FIXTURE(ZipInputStreamTestFixture, read_5)
+    {
+        //big reads bypass the internal buffer
+        string path = m_scores_path + "10012-source-and-image.zip#zip:test-image-1.png";
+        InputStream* file = FileSystem::open_input_stream(path);
+        MyZipInputStream* zs  = static_cast<MyZipInputStream*>(file);
+
+        long size = zs->get_size();
+        unsigned char* expected = LOMSE_NEW unsigned char[size];
+        long i=0;
+        for (i=0; i < size && !zs->eof(); ++i)
+            expected[i] = zs->get_char();
+        CHECK( i == size );
+
+        zs->move_to_entry("test-image-1.png");
+        CHECK( zs->open_current_entry() == true );
+        unsigned char* actual = LOMSE_NEW unsigned char[size + 100];
+        CHECK( zs->read(actual, 100) == 100 );
+        CHECK( zs->read(actual+100, size) == size - 100 );
+        CHECK( zs->eof() == true );
+        CHECK ( memcmp((void*)actual, (void*)expected, size) == 0 );
+
+        delete[] expected;
+        delete[] actual;
+        delete file;
+    }
+
     TEST_FIXTURE(ZipInputStreamTestFixture, get_char_1)
     {
         string path = m_scores_path + "10011-read-png-image.zip#zip:";